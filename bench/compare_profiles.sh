@@ -0,0 +1,71 @@
+#!/bin/bash
+#
+# Build webvulkan_bench under each build profile and compare per-draw
+# recording cost. With EMSDK set, also build the WASM samples under the same
+# profile and report the size of triangle.wasm.
+#
+#   bench/compare_profiles.sh [build-root] [min-time-ms]
+#
+# Extra configure arguments can be passed in CMAKE_ARGS.
+
+set -e
+
+SOURCE_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_ROOT="${1:-build-profiles}"
+MIN_TIME_MS="${2:-200}"
+JOBS="$(nproc 2>/dev/null || sysctl -n hw.ncpu)"
+
+PROFILES=(
+    "default:"
+    "size:-DWEBVULKAN_OPT_PROFILE=SIZE"
+    "speed:-DWEBVULKAN_OPT_PROFILE=SPEED"
+    "unity:-DWEBVULKAN_UNITY_BUILD=ON"
+    "lto:-DWEBVULKAN_LTO=ON"
+    "unity-lto-speed:-DWEBVULKAN_UNITY_BUILD=ON -DWEBVULKAN_LTO=ON -DWEBVULKAN_OPT_PROFILE=SPEED"
+)
+
+# ns_per_op of one benchmark from webvulkan_bench JSON on stdin
+ns_per_op() {
+    grep "\"name\": \"$1\"" | sed 's/.*"ns_per_op": \([0-9.]*\).*/\1/'
+}
+
+# Run a build step quietly, showing its log only when it fails
+quiet() {
+    local log="$BUILD_ROOT/last-step.log"
+    "$@" > "$log" 2>&1 || { cat "$log"; exit 1; }
+}
+
+file_size() {
+    wc -c < "$1" | tr -d ' '
+}
+
+mkdir -p "$BUILD_ROOT"
+printf "%-16s %14s %19s %12s\n" "profile" "record_draw ns" "record_bind_draw ns" "wasm bytes"
+for entry in "${PROFILES[@]}"; do
+    name="${entry%%:*}"
+    flags="${entry#*:}"
+
+    native_dir="$BUILD_ROOT/$name-native"
+    # shellcheck disable=SC2086
+    quiet cmake -S "$SOURCE_DIR" -B "$native_dir" -DCMAKE_BUILD_TYPE=Release \
+        -DWEBVULKAN_BUILD_TESTS=OFF -DWEBVULKAN_BUILD_SAMPLES=OFF $flags $CMAKE_ARGS
+    quiet cmake --build "$native_dir" --target webvulkan_bench -j"$JOBS"
+    results="$("$native_dir/bench/webvulkan_bench" --min-time-ms "$MIN_TIME_MS" record_)"
+
+    wasm_size="-"
+    if [ -n "$EMSDK" ]; then
+        wasm_dir="$BUILD_ROOT/$name-wasm"
+        # shellcheck disable=SC2086
+        quiet cmake -S "$SOURCE_DIR" -B "$wasm_dir" \
+            -DCMAKE_TOOLCHAIN_FILE="${EMSDK}/upstream/emscripten/cmake/Modules/Platform/Emscripten.cmake" \
+            -DCMAKE_BUILD_TYPE=Release -DWEBVULKAN_WASM=ON -DWEBVULKAN_BUILD_SAMPLES=ON \
+            -DWEBVULKAN_BUILD_TESTS=OFF $flags $CMAKE_ARGS
+        quiet cmake --build "$wasm_dir" -j"$JOBS"
+        wasm_size="$(file_size "$wasm_dir/samples/triangle.wasm")"
+    fi
+
+    printf "%-16s %14s %19s %12s\n" "$name" \
+        "$(echo "$results" | ns_per_op record_draw)" \
+        "$(echo "$results" | ns_per_op record_bind_draw)" \
+        "$wasm_size"
+done
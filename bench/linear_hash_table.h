@@ -0,0 +1,21 @@
+/**
+ * @file linear_hash_table.h
+ * @brief Previous pointer-keyed linear-probe table, the benchmark baseline
+ */
+
+#ifndef WGVK_LINEAR_HASH_TABLE_H
+#define WGVK_LINEAR_HASH_TABLE_H
+
+#include <stddef.h>
+
+typedef struct WgvkLinearTable WgvkLinearTable;
+
+WgvkLinearTable *wgvk_linear_table_create(size_t bucket_count);
+void wgvk_linear_table_destroy(WgvkLinearTable *table);
+
+/* Keys must not be NULL or (void *)1. */
+void wgvk_linear_table_insert(WgvkLinearTable *table, void *key, void *value);
+void *wgvk_linear_table_lookup(WgvkLinearTable *table, void *key);
+void wgvk_linear_table_remove(WgvkLinearTable *table, void *key);
+
+#endif
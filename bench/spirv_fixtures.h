@@ -0,0 +1,94 @@
+/*
+ * Hand-assembled SPIR-V modules for the shader_transpile benchmark: one
+ * per stage, each moving a vec4 between its interface variables.
+ */
+
+#ifndef WGVK_BENCH_SPIRV_FIXTURES_H
+#define WGVK_BENCH_SPIRV_FIXTURES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct WgvkSpirvFixture {
+	const char *name;
+	uint32_t exec_model;
+	const uint32_t *code;
+	size_t word_count;
+} WgvkSpirvFixture;
+
+/* in vec4 (location 0) -> gl_Position */
+static const uint32_t wgvk_fixture_vertex[] = {
+    0x07230203, 0x00010000, 0x00000000, 13, 0,
+    0x00020011, 1,                                 /* OpCapability Shader */
+    0x0003000E, 0, 1,                              /* OpMemoryModel Logical GLSL450 */
+    0x0007000F, 0, 1, 0x6E69616D, 0, 8, 10,        /* OpEntryPoint Vertex %1 "main" %8 %10 */
+    0x00040047, 8, 11, 0,                          /* OpDecorate %8 BuiltIn Position */
+    0x00040047, 10, 30, 0,                         /* OpDecorate %10 Location 0 */
+    0x00020013, 2,                                 /* %2 = OpTypeVoid */
+    0x00030021, 3, 2,                              /* %3 = OpTypeFunction %2 */
+    0x00030016, 5, 32,                             /* %5 = OpTypeFloat 32 */
+    0x00040017, 6, 5, 4,                           /* %6 = OpTypeVector %5 4 */
+    0x00040020, 7, 3, 6,                           /* %7 = OpTypePointer Output %6 */
+    0x0004003B, 7, 8, 3,                           /* %8 = OpVariable %7 Output */
+    0x00040020, 9, 1, 6,                           /* %9 = OpTypePointer Input %6 */
+    0x0004003B, 9, 10, 1,                          /* %10 = OpVariable %9 Input */
+    0x00050036, 2, 1, 0, 3,                        /* %1 = OpFunction %2 None %3 */
+    0x000200F8, 4,                                 /* %4 = OpLabel */
+    0x0004003D, 6, 12, 10,                         /* %12 = OpLoad %6 %10 */
+    0x0003003E, 8, 12,                             /* OpStore %8 %12 */
+    0x000100FD,                                    /* OpReturn */
+    0x00010038,                                    /* OpFunctionEnd */
+};
+
+/* in vec4 (location 0) -> out vec4 (location 0) */
+static const uint32_t wgvk_fixture_fragment[] = {
+    0x07230203, 0x00010000, 0x00000000, 13, 0,
+    0x00020011, 1,                                 /* OpCapability Shader */
+    0x0003000E, 0, 1,                              /* OpMemoryModel Logical GLSL450 */
+    0x0007000F, 4, 1, 0x6E69616D, 0, 8, 10,        /* OpEntryPoint Fragment %1 "main" %8 %10 */
+    0x00030010, 1, 7,                              /* OpExecutionMode %1 OriginUpperLeft */
+    0x00040047, 8, 30, 0,                          /* OpDecorate %8 Location 0 */
+    0x00040047, 10, 30, 0,                         /* OpDecorate %10 Location 0 */
+    0x00020013, 2,                                 /* %2 = OpTypeVoid */
+    0x00030021, 3, 2,                              /* %3 = OpTypeFunction %2 */
+    0x00030016, 5, 32,                             /* %5 = OpTypeFloat 32 */
+    0x00040017, 6, 5, 4,                           /* %6 = OpTypeVector %5 4 */
+    0x00040020, 7, 3, 6,                           /* %7 = OpTypePointer Output %6 */
+    0x0004003B, 7, 8, 3,                           /* %8 = OpVariable %7 Output */
+    0x00040020, 9, 1, 6,                           /* %9 = OpTypePointer Input %6 */
+    0x0004003B, 9, 10, 1,                          /* %10 = OpVariable %9 Input */
+    0x00050036, 2, 1, 0, 3,                        /* %1 = OpFunction %2 None %3 */
+    0x000200F8, 4,                                 /* %4 = OpLabel */
+    0x0004003D, 6, 12, 10,                         /* %12 = OpLoad %6 %10 */
+    0x0003003E, 8, 12,                             /* OpStore %8 %12 */
+    0x000100FD,                                    /* OpReturn */
+    0x00010038,                                    /* OpFunctionEnd */
+};
+
+/* 8x8x1 workgroup with an empty body */
+static const uint32_t wgvk_fixture_compute[] = {
+    0x07230203, 0x00010000, 0x00000000, 5, 0,
+    0x00020011, 1,                                 /* OpCapability Shader */
+    0x0003000E, 0, 1,                              /* OpMemoryModel Logical GLSL450 */
+    0x0005000F, 5, 1, 0x6E69616D, 0,               /* OpEntryPoint GLCompute %1 "main" */
+    0x00060010, 1, 17, 8, 8, 1,                    /* OpExecutionMode %1 LocalSize 8 8 1 */
+    0x00020013, 2,                                 /* %2 = OpTypeVoid */
+    0x00030021, 3, 2,                              /* %3 = OpTypeFunction %2 */
+    0x00050036, 2, 1, 0, 3,                        /* %1 = OpFunction %2 None %3 */
+    0x000200F8, 4,                                 /* %4 = OpLabel */
+    0x000100FD,                                    /* OpReturn */
+    0x00010038,                                    /* OpFunctionEnd */
+};
+
+#define WGVK_SPIRV_FIXTURE(name, model, code) \
+	{name, model, code, sizeof(code) / sizeof((code)[0])}
+
+static const WgvkSpirvFixture wgvk_spirv_fixtures[] = {
+    WGVK_SPIRV_FIXTURE("vertex_passthrough", 0, wgvk_fixture_vertex),
+    WGVK_SPIRV_FIXTURE("fragment_passthrough", 4, wgvk_fixture_fragment),
+    WGVK_SPIRV_FIXTURE("compute_empty", 5, wgvk_fixture_compute),
+};
+
+#define WGVK_SPIRV_FIXTURE_COUNT (sizeof(wgvk_spirv_fixtures) / sizeof(wgvk_spirv_fixtures[0]))
+
+#endif
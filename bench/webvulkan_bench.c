@@ -0,0 +1,537 @@
+/*
+ * Translation-layer microbenchmarks over the WebGPU stubs.
+ *
+ * Each benchmark runs with doubling iteration counts until one run takes at
+ * least the minimum time, then reports that run as JSON on stdout:
+ *
+ *   webvulkan_bench [--min-time-ms N] [--call-cost-ns N] [filter]
+ *
+ * Only benchmarks whose name contains filter are run. Allocation counts
+ * cover malloc, calloc and realloc and are reported when the linker can
+ * wrap them (allocs_per_op is -1 otherwise). wgpu_calls_per_op counts the
+ * WebGPU calls each op makes; --call-cost-ns makes every one of them spin
+ * for N ns, as a stand-in for the WASM-to-JS boundary.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webvulkan_internal.h"
+#include "shaders/spirv_parser.h"
+#include "shaders/wgsl_gen.h"
+#include "util/hash_table.h"
+#include "util/log.h"
+#include "linear_hash_table.h"
+#include "spirv_fixtures.h"
+#include "webgpu_recorder.h"
+
+#ifdef WGVK_BENCH_COUNT_ALLOCS
+static uint64_t g_allocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+	g_allocs++;
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+	g_allocs++;
+	return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+	g_allocs++;
+	return __real_realloc(ptr, size);
+}
+#endif
+
+typedef struct Bench {
+	const char *name;
+	void (*setup)(void);
+	void (*run)(uint64_t iterations);
+	void (*teardown)(void);
+} Bench;
+
+static VkInstance g_instance;
+static VkDevice g_device;
+static VkQueue g_queue;
+
+static VkPipelineLayout g_pipeline_layout;
+static VkDescriptorSetLayout g_set_layout;
+static VkDescriptorPool g_descriptor_pool;
+static VkDescriptorSet g_descriptor_set;
+static VkPipeline g_pipeline;
+static VkBuffer g_buffer;
+static VkDeviceMemory g_memory;
+static VkCommandBuffer g_cmd;
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void check(VkResult result, const char *what) {
+	if (result != VK_SUCCESS) {
+		fprintf(stderr, "webvulkan_bench: %s failed (%d)\n", what, result);
+		exit(1);
+	}
+}
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	check(vkCreateInstance(&info, NULL, &g_instance), "vkCreateInstance");
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	check(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev), "vkEnumeratePhysicalDevices");
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	check(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device), "vkCreateDevice");
+	vkGetDeviceQueue(g_device, 0, 0, &g_queue);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+/* A uniform buffer, a set that points at it and a pipeline using both. */
+static void setup_resources(void) {
+	VkDescriptorSetLayoutBinding binding = {
+	    .binding = 0,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	    .descriptorCount = 1,
+	    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+	};
+	VkDescriptorSetLayoutCreateInfo set_layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 1,
+	    .pBindings = &binding,
+	};
+	check(vkCreateDescriptorSetLayout(g_device, &set_layout_info, NULL, &g_set_layout),
+	      "vkCreateDescriptorSetLayout");
+
+	VkPipelineLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	    .setLayoutCount = 1,
+	    .pSetLayouts = &g_set_layout,
+	};
+	check(vkCreatePipelineLayout(g_device, &layout_info, NULL, &g_pipeline_layout),
+	      "vkCreatePipelineLayout");
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	check(vkCreateDescriptorPool(g_device, &pool_info, NULL, &g_descriptor_pool),
+	      "vkCreateDescriptorPool");
+	VkDescriptorSetAllocateInfo set_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = g_descriptor_pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &g_set_layout,
+	};
+	check(vkAllocateDescriptorSets(g_device, &set_info, &g_descriptor_set),
+	      "vkAllocateDescriptorSets");
+
+	VkBufferCreateInfo buffer_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 4096,
+	    .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+	};
+	check(vkCreateBuffer(g_device, &buffer_info, NULL, &g_buffer), "vkCreateBuffer");
+	VkMemoryAllocateInfo alloc = {
+	    .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+	    .allocationSize = 4096,
+	};
+	check(vkAllocateMemory(g_device, &alloc, NULL, &g_memory), "vkAllocateMemory");
+	check(vkBindBufferMemory(g_device, g_buffer, g_memory, 0), "vkBindBufferMemory");
+
+	VkCommandBufferAllocateInfo cmd_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	check(vkAllocateCommandBuffers(g_device, &cmd_info, &g_cmd), "vkAllocateCommandBuffers");
+}
+
+static void teardown_resources(void) {
+	vkFreeCommandBuffers(g_device, NULL, 1, &g_cmd);
+	vkDestroyBuffer(g_device, g_buffer, NULL);
+	vkFreeMemory(g_device, g_memory, NULL);
+	vkFreeDescriptorSets(g_device, g_descriptor_pool, 1, &g_descriptor_set);
+	vkDestroyDescriptorPool(g_device, g_descriptor_pool, NULL);
+	vkDestroyPipelineLayout(g_device, g_pipeline_layout, NULL);
+	vkDestroyDescriptorSetLayout(g_device, g_set_layout, NULL);
+}
+
+static VkResult create_pipeline(VkPipeline *pipeline) {
+	VkPipelineShaderStageCreateInfo stages[] = {
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_VERTEX_BIT,
+	     .pName = "main"},
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+	     .pName = "main"},
+	};
+	VkVertexInputBindingDescription vertex_binding = {
+	    .binding = 0,
+	    .stride = 16,
+	    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+	};
+	VkVertexInputAttributeDescription vertex_attribute = {
+	    .location = 0,
+	    .binding = 0,
+	    .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+	};
+	VkPipelineVertexInputStateCreateInfo vertex_input = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+	    .vertexBindingDescriptionCount = 1,
+	    .pVertexBindingDescriptions = &vertex_binding,
+	    .vertexAttributeDescriptionCount = 1,
+	    .pVertexAttributeDescriptions = &vertex_attribute,
+	};
+	VkPipelineColorBlendAttachmentState blend = {.colorWriteMask = 0xf};
+	VkPipelineColorBlendStateCreateInfo blend_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+	    .attachmentCount = 1,
+	    .pAttachments = &blend,
+	};
+	VkGraphicsPipelineCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+	    .stageCount = 2,
+	    .pStages = stages,
+	    .pVertexInputState = &vertex_input,
+	    .pColorBlendState = &blend_state,
+	    .layout = g_pipeline_layout,
+	};
+	return vkCreateGraphicsPipelines(g_device, NULL, 1, &info, NULL, pipeline);
+}
+
+static void setup_recording(void) {
+	setup_resources();
+	check(create_pipeline(&g_pipeline), "vkCreateGraphicsPipelines");
+}
+
+static void teardown_recording(void) {
+	vkDestroyPipeline(g_device, g_pipeline, NULL);
+	teardown_resources();
+}
+
+/* One op: bind pipeline, set and vertex buffer, then draw. */
+static void run_record_bind_draw(uint64_t iterations) {
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	vkBeginCommandBuffer(g_cmd, &begin);
+	VkRenderPassBeginInfo pass = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+	vkCmdBeginRenderPass(g_cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	VkDeviceSize offset = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		vkCmdBindPipeline(g_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipeline);
+		vkCmdBindDescriptorSets(g_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipeline_layout, 0, 1,
+		                        &g_descriptor_set, 0, NULL);
+		vkCmdBindVertexBuffers(g_cmd, 0, 1, &g_buffer, &offset);
+		vkCmdDraw(g_cmd, 3, 1, 0, 0);
+	}
+	vkCmdEndRenderPass(g_cmd);
+	vkEndCommandBuffer(g_cmd);
+}
+
+/* One op: a single draw in an open pass with all state already bound, the
+ * per-draw cost the build profiles are compared on. */
+static void run_record_draw(uint64_t iterations) {
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	vkBeginCommandBuffer(g_cmd, &begin);
+	VkRenderPassBeginInfo pass = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+	vkCmdBeginRenderPass(g_cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	VkDeviceSize offset = 0;
+	vkCmdBindPipeline(g_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipeline);
+	vkCmdBindDescriptorSets(g_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipeline_layout, 0, 1,
+	                        &g_descriptor_set, 0, NULL);
+	vkCmdBindVertexBuffers(g_cmd, 0, 1, &g_buffer, &offset);
+	for (uint64_t i = 0; i < iterations; i++) {
+		vkCmdDraw(g_cmd, 3, 1, (uint32_t)i & 0xffff, 0);
+	}
+	vkCmdEndRenderPass(g_cmd);
+	vkEndCommandBuffer(g_cmd);
+}
+
+static void run_descriptor_update(uint64_t iterations) {
+	VkDescriptorBufferInfo buffer_info = {.buffer = g_buffer, .offset = 0, .range = 256};
+	VkWriteDescriptorSet write = {
+	    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	    .dstSet = g_descriptor_set,
+	    .dstBinding = 0,
+	    .descriptorCount = 1,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	    .pBufferInfo = &buffer_info,
+	};
+	for (uint64_t i = 0; i < iterations; i++) {
+		buffer_info.offset = (i & 7) * 256;
+		vkUpdateDescriptorSets(g_device, 1, &write, 0, NULL);
+	}
+}
+
+static void run_pipeline_create(uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		VkPipeline pipeline = NULL;
+		check(create_pipeline(&pipeline), "vkCreateGraphicsPipelines");
+		vkDestroyPipeline(g_device, pipeline, NULL);
+	}
+}
+
+/* One op: parse and generate WGSL for one module of the corpus. */
+static void run_shader_transpile(uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		const WgvkSpirvFixture *fixture = &wgvk_spirv_fixtures[i % WGVK_SPIRV_FIXTURE_COUNT];
+		WgvkSpvModule *module = calloc(1, sizeof(WgvkSpvModule));
+		if (!module || wgvk_spirv_parse(module, fixture->code, fixture->word_count) != 0) {
+			fprintf(stderr, "webvulkan_bench: fixture %s does not parse\n", fixture->name);
+			exit(1);
+		}
+		WgvkWgslGenerator gen = {0};
+		char *wgsl = NULL;
+		if (wgvk_wgsl_init(&gen, module, fixture->exec_model) == 0) {
+			wgsl = wgvk_wgsl_generate(&gen);
+			wgvk_wgsl_free(&gen);
+		}
+		if (!wgsl) {
+			fprintf(stderr, "webvulkan_bench: fixture %s does not transpile\n", fixture->name);
+			exit(1);
+		}
+		free(wgsl);
+		wgvk_spirv_free(module);
+		free(module);
+	}
+}
+
+/* One op: record an empty command buffer and submit it. */
+static void run_queue_submit(uint64_t iterations) {
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	VkSubmitInfo submit = {
+	    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+	    .commandBufferCount = 1,
+	    .pCommandBuffers = &g_cmd,
+	};
+	for (uint64_t i = 0; i < iterations; i++) {
+		vkBeginCommandBuffer(g_cmd, &begin);
+		vkEndCommandBuffer(g_cmd);
+		vkQueueSubmit(g_queue, 1, &submit, VK_NULL_HANDLE);
+	}
+}
+
+static void run_map_unmap(uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		void *data = NULL;
+		check(vkMapMemory(g_device, g_memory, 0, VK_WHOLE_SIZE, 0, &data), "vkMapMemory");
+		((uint8_t *)data)[i & 4095] = (uint8_t)i;
+		vkUnmapMemory(g_device, g_memory);
+	}
+}
+
+/* Cache-style lookups: descriptor-sized keys built on the stack and found
+ * among HASH_BENCH_ENTRIES others, through the Swiss table and through the
+ * linear-probe table with the FNV-1a hash and same-hash chains it replaced. */
+#define HASH_BENCH_ENTRIES 1024
+#define HASH_BENCH_KEY_WORDS 16
+
+typedef struct HashBenchEntry {
+	struct HashBenchEntry *next;
+	uint32_t key[HASH_BENCH_KEY_WORDS];
+} HashBenchEntry;
+
+static HashBenchEntry *g_hash_entries;
+static WgvkHashTable *g_swiss_table;
+static WgvkLinearTable *g_linear_table;
+
+static uintptr_t fnv1a_words(const uint32_t *key, uint32_t key_words) {
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (uint32_t i = 0; i < key_words; i++) {
+		h ^= key[i];
+		h *= 0x100000001b3ULL;
+	}
+	uintptr_t folded = (uintptr_t)(h ^ (h >> 32));
+	return folded < 2 ? folded + 2 : folded;
+}
+
+static void setup_hash_tables(void) {
+	g_hash_entries = calloc(HASH_BENCH_ENTRIES, sizeof(HashBenchEntry));
+	// Both start at the caches' initial size and grow as they fill
+	g_swiss_table = wgvk_hash_table_create(64);
+	g_linear_table = wgvk_linear_table_create(64);
+	if (!g_hash_entries || !g_swiss_table || !g_linear_table) {
+		fprintf(stderr, "webvulkan_bench: out of memory\n");
+		exit(1);
+	}
+	for (uint32_t i = 0; i < HASH_BENCH_ENTRIES; i++) {
+		HashBenchEntry *entry = &g_hash_entries[i];
+		// Mostly shared words, like descriptors that differ in one field
+		for (uint32_t w = 0; w < HASH_BENCH_KEY_WORDS; w++) {
+			entry->key[w] = w == 3 ? i : 0x1000u + w;
+		}
+		wgvk_hash_table_insert_key(g_swiss_table, wgvk_hash_bytes(entry->key, sizeof(entry->key)),
+		                           entry->key, sizeof(entry->key), entry);
+		void *hash = (void *)fnv1a_words(entry->key, HASH_BENCH_KEY_WORDS);
+		entry->next = wgvk_linear_table_lookup(g_linear_table, hash);
+		wgvk_linear_table_insert(g_linear_table, hash, entry);
+	}
+}
+
+static void teardown_hash_tables(void) {
+	wgvk_hash_table_destroy(g_swiss_table);
+	wgvk_linear_table_destroy(g_linear_table);
+	free(g_hash_entries);
+}
+
+static void hash_bench_key(uint64_t i, uint32_t *key) {
+	// A stride coprime to the entry count visits them all in scattered order
+	memcpy(key, g_hash_entries[(i * 617) % HASH_BENCH_ENTRIES].key,
+	       HASH_BENCH_KEY_WORDS * sizeof(uint32_t));
+}
+
+static HashBenchEntry *linear_find(const uint32_t *key) {
+	void *hash = (void *)fnv1a_words(key, HASH_BENCH_KEY_WORDS);
+	HashBenchEntry *entry = wgvk_linear_table_lookup(g_linear_table, hash);
+	while (entry && memcmp(entry->key, key, sizeof(entry->key)) != 0) {
+		entry = entry->next;
+	}
+	return entry;
+}
+
+static void check_found(uint64_t found, uint64_t iterations) {
+	if (found != iterations) {
+		fprintf(stderr, "webvulkan_bench: hash table lost entries\n");
+		exit(1);
+	}
+}
+
+static void run_hash_table_lookup_swiss(uint64_t iterations) {
+	uint32_t key[HASH_BENCH_KEY_WORDS];
+	uint64_t found = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		hash_bench_key(i, key);
+		found += wgvk_hash_table_find(g_swiss_table, wgvk_hash_bytes(key, sizeof(key)), key,
+		                              sizeof(key)) != NULL;
+	}
+	check_found(found, iterations);
+}
+
+static void run_hash_table_lookup_linear(uint64_t iterations) {
+	uint32_t key[HASH_BENCH_KEY_WORDS];
+	uint64_t found = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		hash_bench_key(i, key);
+		found += linear_find(key) != NULL;
+	}
+	check_found(found, iterations);
+}
+
+/* One op: remove an entry and insert it again. */
+static void run_hash_table_churn_swiss(uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		HashBenchEntry *entry = &g_hash_entries[(i * 617) % HASH_BENCH_ENTRIES];
+		uint64_t hash = wgvk_hash_bytes(entry->key, sizeof(entry->key));
+		wgvk_hash_table_erase(g_swiss_table, hash, entry->key, sizeof(entry->key));
+		wgvk_hash_table_insert_key(g_swiss_table, hash, entry->key, sizeof(entry->key), entry);
+	}
+}
+
+static void run_hash_table_churn_linear(uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		HashBenchEntry *entry = &g_hash_entries[(i * 617) % HASH_BENCH_ENTRIES];
+		void *hash = (void *)fnv1a_words(entry->key, HASH_BENCH_KEY_WORDS);
+		wgvk_linear_table_remove(g_linear_table, hash);
+		wgvk_linear_table_insert(g_linear_table, hash, entry);
+	}
+}
+
+static const Bench g_benches[] = {
+    {"record_bind_draw", setup_recording, run_record_bind_draw, teardown_recording},
+    {"record_draw", setup_recording, run_record_draw, teardown_recording},
+    {"descriptor_update", setup_resources, run_descriptor_update, teardown_resources},
+    {"pipeline_create", setup_resources, run_pipeline_create, teardown_resources},
+    {"shader_transpile", NULL, run_shader_transpile, NULL},
+    {"queue_submit", setup_resources, run_queue_submit, teardown_resources},
+    {"map_unmap", setup_resources, run_map_unmap, teardown_resources},
+    {"hash_table_lookup_swiss", setup_hash_tables, run_hash_table_lookup_swiss,
+     teardown_hash_tables},
+    {"hash_table_lookup_linear", setup_hash_tables, run_hash_table_lookup_linear,
+     teardown_hash_tables},
+    {"hash_table_churn_swiss", setup_hash_tables, run_hash_table_churn_swiss, teardown_hash_tables},
+    {"hash_table_churn_linear", setup_hash_tables, run_hash_table_churn_linear,
+     teardown_hash_tables},
+};
+
+int main(int argc, char **argv) {
+	uint64_t min_time_ns = 200000000u;
+	uint64_t call_cost_ns = 0;
+	const char *filter = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+			min_time_ns = strtoull(argv[++i], NULL, 10) * 1000000u;
+		} else if (strcmp(argv[i], "--call-cost-ns") == 0 && i + 1 < argc) {
+			call_cost_ns = strtoull(argv[++i], NULL, 10);
+		} else {
+			filter = argv[i];
+		}
+	}
+
+	// Warnings about unsupported state would otherwise be timed as well
+	wgvk_log_set_level(WGVK_LOG_ERROR);
+	wgvk_rec_set_default_cost(call_cost_ns);
+	setup_device();
+
+	printf("{\n  \"benchmarks\": [");
+	const char *separator = "\n";
+	for (size_t b = 0; b < sizeof(g_benches) / sizeof(g_benches[0]); b++) {
+		const Bench *bench = &g_benches[b];
+		if (filter && !strstr(bench->name, filter)) {
+			continue;
+		}
+		if (bench->setup) {
+			bench->setup();
+		}
+
+		uint64_t iterations = 1;
+		uint64_t elapsed = 0;
+		uint64_t calls = 0;
+		int64_t allocs = -1;
+		for (;;) {
+#ifdef WGVK_BENCH_COUNT_ALLOCS
+			uint64_t allocs_before = g_allocs;
+#endif
+			wgvk_rec_begin(call_cost_ns ? WGVK_REC_SPIN : 0);
+			uint64_t start = now_ns();
+			bench->run(iterations);
+			elapsed = now_ns() - start;
+			wgvk_rec_end();
+			calls = wgvk_rec_total_calls();
+#ifdef WGVK_BENCH_COUNT_ALLOCS
+			allocs = (int64_t)(g_allocs - allocs_before);
+#endif
+			if (elapsed >= min_time_ns || iterations >= (UINT64_C(1) << 40)) {
+				break;
+			}
+			iterations *= 2;
+		}
+
+		if (bench->teardown) {
+			bench->teardown();
+		}
+		printf("%s    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.2f, "
+		       "\"allocs_per_op\": %.3f, \"wgpu_calls_per_op\": %.3f}",
+		       separator, bench->name, (unsigned long long)iterations,
+		       (double)elapsed / (double)iterations,
+		       allocs < 0 ? -1.0 : (double)allocs / (double)iterations,
+		       (double)calls / (double)iterations);
+		separator = ",\n";
+	}
+	printf("\n  ]\n}\n");
+
+	teardown_device();
+	return 0;
+}
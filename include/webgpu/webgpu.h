@@ -34,6 +34,8 @@ typedef struct WGPUBindGroupImpl *WGPUBindGroup;
 typedef struct WGPUSamplerImpl *WGPUSampler;
 typedef struct WGPUCommandBufferImpl *WGPUCommandBuffer;
 
+typedef uint32_t WGPUBool;
+
 /* ---- String view ---- */
 typedef struct WGPUStringView {
     const char *data;
@@ -115,6 +117,44 @@ typedef enum WGPUTextureFormat {
     WGPUTextureFormat_BC5RGSnorm = 53,
     WGPUTextureFormat_BC7RGBAUnorm = 54,
     WGPUTextureFormat_BC7RGBAUnormSrgb = 55,
+    WGPUTextureFormat_ETC2RGB8Unorm = 56,
+    WGPUTextureFormat_ETC2RGB8UnormSrgb = 57,
+    WGPUTextureFormat_ETC2RGB8A1Unorm = 58,
+    WGPUTextureFormat_ETC2RGB8A1UnormSrgb = 59,
+    WGPUTextureFormat_ETC2RGBA8Unorm = 60,
+    WGPUTextureFormat_ETC2RGBA8UnormSrgb = 61,
+    WGPUTextureFormat_EACR11Unorm = 62,
+    WGPUTextureFormat_EACR11Snorm = 63,
+    WGPUTextureFormat_EACRG11Unorm = 64,
+    WGPUTextureFormat_EACRG11Snorm = 65,
+    WGPUTextureFormat_ASTC4x4Unorm = 66,
+    WGPUTextureFormat_ASTC4x4UnormSrgb = 67,
+    WGPUTextureFormat_ASTC5x4Unorm = 68,
+    WGPUTextureFormat_ASTC5x4UnormSrgb = 69,
+    WGPUTextureFormat_ASTC5x5Unorm = 70,
+    WGPUTextureFormat_ASTC5x5UnormSrgb = 71,
+    WGPUTextureFormat_ASTC6x5Unorm = 72,
+    WGPUTextureFormat_ASTC6x5UnormSrgb = 73,
+    WGPUTextureFormat_ASTC6x6Unorm = 74,
+    WGPUTextureFormat_ASTC6x6UnormSrgb = 75,
+    WGPUTextureFormat_ASTC8x5Unorm = 76,
+    WGPUTextureFormat_ASTC8x5UnormSrgb = 77,
+    WGPUTextureFormat_ASTC8x6Unorm = 78,
+    WGPUTextureFormat_ASTC8x6UnormSrgb = 79,
+    WGPUTextureFormat_ASTC8x8Unorm = 80,
+    WGPUTextureFormat_ASTC8x8UnormSrgb = 81,
+    WGPUTextureFormat_ASTC10x5Unorm = 82,
+    WGPUTextureFormat_ASTC10x5UnormSrgb = 83,
+    WGPUTextureFormat_ASTC10x6Unorm = 84,
+    WGPUTextureFormat_ASTC10x6UnormSrgb = 85,
+    WGPUTextureFormat_ASTC10x8Unorm = 86,
+    WGPUTextureFormat_ASTC10x8UnormSrgb = 87,
+    WGPUTextureFormat_ASTC10x10Unorm = 88,
+    WGPUTextureFormat_ASTC10x10UnormSrgb = 89,
+    WGPUTextureFormat_ASTC12x10Unorm = 90,
+    WGPUTextureFormat_ASTC12x10UnormSrgb = 91,
+    WGPUTextureFormat_ASTC12x12Unorm = 92,
+    WGPUTextureFormat_ASTC12x12UnormSrgb = 93,
 } WGPUTextureFormat;
 
 typedef enum WGPUTextureDimension {
@@ -146,6 +186,14 @@ typedef uint32_t WGPUTextureUsage;
 #define WGPUTextureUsage_TextureBinding ((WGPUTextureUsage)4)
 #define WGPUTextureUsage_StorageBinding ((WGPUTextureUsage)8)
 #define WGPUTextureUsage_RenderAttachment ((WGPUTextureUsage)16)
+#define WGPUTextureUsage_TransientAttachment ((WGPUTextureUsage)32)
+
+typedef enum WGPUFeatureName {
+    WGPUFeatureName_TextureCompressionBC = 0x00000004,
+    WGPUFeatureName_TextureCompressionETC2 = 0x00000006,
+    WGPUFeatureName_TextureCompressionASTC = 0x00000007,
+    WGPUFeatureName_TransientAttachments = 0x00050009,
+} WGPUFeatureName;
 
 typedef uint32_t WGPUBufferUsage;
 #define WGPUBufferUsage_None ((WGPUBufferUsage)0)
@@ -167,6 +215,7 @@ typedef uint32_t WGPUShaderStage;
 #define WGPUShaderStage_Compute ((WGPUShaderStage)4)
 
 #define WGPU_COPY_STRIDE_UNDEFINED (0xFFFFFFFFu)
+#define WGPU_DEPTH_SLICE_UNDEFINED (0xFFFFFFFFu)
 typedef uint32_t WGPUColorWriteMask;
 #define WGPUColorWriteMask_None ((WGPUColorWriteMask)0)
 #define WGPUColorWriteMask_Red ((WGPUColorWriteMask)1)
@@ -261,6 +310,36 @@ typedef enum WGPUCompareFunction {
     WGPUCompareFunction_Always = 8,
 } WGPUCompareFunction;
 
+typedef enum WGPUBlendFactor {
+    WGPUBlendFactor_Undefined = 0,
+    WGPUBlendFactor_Zero = 1,
+    WGPUBlendFactor_One = 2,
+    WGPUBlendFactor_Src = 3,
+    WGPUBlendFactor_OneMinusSrc = 4,
+    WGPUBlendFactor_SrcAlpha = 5,
+    WGPUBlendFactor_OneMinusSrcAlpha = 6,
+    WGPUBlendFactor_Dst = 7,
+    WGPUBlendFactor_OneMinusDst = 8,
+    WGPUBlendFactor_DstAlpha = 9,
+    WGPUBlendFactor_OneMinusDstAlpha = 10,
+    WGPUBlendFactor_SrcAlphaSaturated = 11,
+    WGPUBlendFactor_Constant = 12,
+    WGPUBlendFactor_OneMinusConstant = 13,
+    WGPUBlendFactor_Src1 = 14,
+    WGPUBlendFactor_OneMinusSrc1 = 15,
+    WGPUBlendFactor_Src1Alpha = 16,
+    WGPUBlendFactor_OneMinusSrc1Alpha = 17,
+} WGPUBlendFactor;
+
+typedef enum WGPUBlendOperation {
+    WGPUBlendOperation_Undefined = 0,
+    WGPUBlendOperation_Add = 1,
+    WGPUBlendOperation_Subtract = 2,
+    WGPUBlendOperation_ReverseSubtract = 3,
+    WGPUBlendOperation_Min = 4,
+    WGPUBlendOperation_Max = 5,
+} WGPUBlendOperation;
+
 typedef enum WGPUBufferBindingType {
     WGPUBufferBindingType_BindingNotUsed = 0,
     WGPUBufferBindingType_Uniform = 1,
@@ -314,6 +393,8 @@ typedef struct WGPUInstanceDescriptor {
 typedef struct WGPUDeviceDescriptor {
     const WGPUChainedStruct *nextInChain;
     WGPUStringView label;
+    size_t requiredFeatureCount;
+    const WGPUFeatureName *requiredFeatures;
 } WGPUDeviceDescriptor;
 #define WGPU_DEVICE_DESCRIPTOR_INIT \
     {                               \
@@ -338,6 +419,8 @@ typedef struct WGPUTextureDescriptor {
     WGPUTextureFormat format;
     uint32_t mipLevelCount;
     uint32_t sampleCount;
+    size_t viewFormatCount;
+    const WGPUTextureFormat *viewFormats;
 } WGPUTextureDescriptor;
 
 typedef struct WGPUTextureViewDescriptor {
@@ -473,9 +556,9 @@ typedef struct WGPUVertexState {
 } WGPUVertexState;
 
 typedef struct WGPUBlendComponent {
-    uint32_t operation;
-    uint32_t srcFactor;
-    uint32_t dstFactor;
+    WGPUBlendOperation operation;
+    WGPUBlendFactor srcFactor;
+    WGPUBlendFactor dstFactor;
 } WGPUBlendComponent;
 
 typedef struct WGPUBlendState {
@@ -605,6 +688,8 @@ void wgpuInstanceRelease(WGPUInstance instance);
 void wgpuAdapterRelease(WGPUAdapter adapter);
 WGPUDevice wgpuAdapterRequestDeviceSync(WGPUAdapter adapter,
                                         const WGPUDeviceDescriptor *descriptor);
+WGPUBool wgpuAdapterHasFeature(WGPUAdapter adapter, WGPUFeatureName feature);
+WGPUBool wgpuDeviceHasFeature(WGPUDevice device, WGPUFeatureName feature);
 void wgpuDeviceRelease(WGPUDevice device);
 WGPUQueue wgpuDeviceGetQueue(WGPUDevice device);
 void wgpuQueueRelease(WGPUQueue queue);
@@ -661,6 +746,10 @@ void wgpuCommandEncoderCopyTextureToBuffer(WGPUCommandEncoder encoder,
                                            const WGPUTexelCopyTextureInfo *src,
                                            const WGPUTexelCopyBufferInfo *dst,
                                            const WGPUExtent3D *copySize);
+void wgpuCommandEncoderCopyTextureToTexture(WGPUCommandEncoder encoder,
+                                            const WGPUTexelCopyTextureInfo *src,
+                                            const WGPUTexelCopyTextureInfo *dst,
+                                            const WGPUExtent3D *copySize);
 WGPURenderPassEncoder wgpuCommandEncoderBeginRenderPass(
     WGPUCommandEncoder encoder, const WGPURenderPassDescriptor *descriptor);
 void wgpuRenderPassEncoderEnd(WGPURenderPassEncoder encoder);
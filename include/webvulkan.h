@@ -39,6 +39,80 @@ WgvkResult wgvkCompileShaders(const WgvkShaderCompileInfo *pCompileInfos, uint32
 
 void wgvkFreeWgslOutput(char *pWgslOutput);
 
+typedef struct WgvkCallStatistics {
+	const char *name;
+	uint64_t callCount;
+	uint64_t totalNanoseconds; /* inclusive; 0 for WebGPU functions */
+} WgvkCallStatistics;
+
+typedef struct WgvkObjectStatistics {
+	const char *typeName;
+	uint64_t createdCount;
+	uint64_t destroyedCount;
+} WgvkObjectStatistics;
+
+/* Counters accumulated since the last wgvkResetStatistics(). The arrays stay
+ * valid until the next wgvkGetStatistics() call. Counting is compiled in
+ * with the WEBVULKAN_STATS CMake option; otherwise enabled is 0 and every
+ * count stays 0. */
+typedef struct WgvkStatistics {
+	uint32_t enabled;
+	uint32_t entryPointCount;
+	const WgvkCallStatistics *pEntryPoints;
+	uint32_t webgpuFunctionCount;
+	const WgvkCallStatistics *pWebGPUFunctions;
+	uint64_t webgpuCallCount;
+	uint64_t bytesUploaded; /* through wgpuQueueWriteBuffer */
+	uint32_t objectTypeCount;
+	const WgvkObjectStatistics *pObjectTypes;
+} WgvkStatistics;
+
+void wgvkGetStatistics(WgvkStatistics *pStatistics);
+
+/* Zero every counter; call once per frame for per-frame figures. */
+void wgvkResetStatistics(void);
+
+/* Record begin/end spans for shader transpilation, pipeline creation,
+ * render pass encoding and queue submission into per-thread buffers.
+ * Enabling starts a new trace and discards the previous one. */
+void wgvkSetTracing(uint32_t enable);
+
+/* Write the current trace as Chrome trace-event JSON, loadable in
+ * chrome://tracing or Perfetto. Timestamps come from the monotonic clock.
+ * Returns the length of the full JSON without its terminator; like snprintf,
+ * output is truncated to bufferSize. Call with tracing off, or from the only
+ * recording thread. */
+size_t wgvkGetTraceJson(char *pBuffer, size_t bufferSize);
+
+#ifdef VK_VERSION_1_0
+/* Fill mip levels 1..N-1 of every layer by successive blits from level 0,
+ * recorded into the command buffer's encoder. Include <vulkan/vulkan.h>
+ * first to get this declaration. */
+void wgvkCmdGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkFilter filter);
+
+/* Keep the textures of destroyed images and hand them to later images with
+ * an identical description (format, dimension, size, mips, samples and
+ * usage). Pooled textures left unused for maxFrames frames are released;
+ * 0 keeps the default. At most 32 textures are kept, oldest released
+ * first. Transient attachments are pooled either way. */
+void wgvkSetTexturePool(VkDevice device, VkBool32 enable, uint32_t maxFrames);
+
+/* Mark the end of a frame, aging the texture pool and draining queued log
+ * messages. Optional: without it, each vkQueueSubmit ages the pool. Once
+ * called, only these calls count as frames. */
+void wgvkDeviceEndFrame(VkDevice device);
+
+/* The 32-bit handle-table id of a Vulkan object, passed as its uint64_t
+ * value. Ids carry a generation, so an id outlives its object without ever
+ * resolving to a later one. Returns 0 for destroyed objects, and always
+ * unless built with WEBVULKAN_HANDLE_TABLE. */
+uint32_t wgvkGetObjectHandle(uint64_t objectHandle);
+
+/* The object of the given type behind an id from wgvkGetObjectHandle(), or
+ * 0 when it has been destroyed or the handle table is compiled out. */
+uint64_t wgvkLookupObjectHandle(VkObjectType objectType, uint32_t handle);
+#endif
+
 uint32_t wgvkGetVersion(void);
 const char *wgvkGetVersionString(void);
 
@@ -0,0 +1,525 @@
+#include "blit.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../util/log.h"
+
+/* minUniformBufferOffsetAlignment guaranteed by every WebGPU device */
+#define WGVK_BLIT_UNIFORM_STRIDE 256
+
+/* Draws a triangle covering the viewport; uv maps the viewport onto the
+ * source rectangle given in normalized coordinates. */
+static const char blit_wgsl[] =
+    "struct BlitParams { rect: vec4<f32> };\n"
+    "@group(0) @binding(0) var src_tex: texture_2d<f32>;\n"
+    "@group(0) @binding(1) var src_smp: sampler;\n"
+    "@group(0) @binding(2) var<uniform> params: BlitParams;\n"
+    "struct VsOut { @builtin(position) pos: vec4<f32>, @location(0) uv: vec2<f32> };\n"
+    "@vertex fn vs_main(@builtin(vertex_index) i: u32) -> VsOut {\n"
+    "  let t = vec2<f32>(f32((i << 1u) & 2u), f32(i & 2u));\n"
+    "  var out: VsOut;\n"
+    "  out.pos = vec4<f32>(t * vec2<f32>(2.0, -2.0) + vec2<f32>(-1.0, 1.0), 0.0, 1.0);\n"
+    "  out.uv = mix(params.rect.xy, params.rect.zw, t);\n"
+    "  return out;\n"
+    "}\n"
+    "@fragment fn fs_main(in: VsOut) -> @location(0) vec4<f32> {\n"
+    "  return textureSampleLevel(src_tex, src_smp, in.uv, 0.0);\n"
+    "}\n";
+
+/* One draw: a source rectangle of one subresource scaled onto a
+ * destination rectangle. Rectangles are x0, y0, x1, y1 and may be mirrored. */
+typedef struct {
+	uint32_t src_level;
+	uint32_t src_layer;
+	uint32_t dst_level;
+	uint32_t dst_layer;
+	int32_t src[4];
+	int32_t dst[4];
+} WgvkBlitRegion;
+
+static uint32_t level_extent(uint32_t extent, uint32_t level) {
+	uint32_t e = extent >> level;
+	return e > 0 ? e : 1;
+}
+
+static struct WgvkBlitState *get_blit_state(VkDevice device) {
+	if (device->blit_state) {
+		return device->blit_state;
+	}
+
+	struct WgvkBlitState *state = wgvk_alloc(sizeof(struct WgvkBlitState));
+	if (!state) {
+		return NULL;
+	}
+	memset(state, 0, sizeof(*state));
+	device->blit_state = state;
+
+	WGPUShaderSourceWGSL wgsl_desc = {
+	    .chain = {.next = NULL, .sType = WGPUSType_ShaderSourceWGSL},
+	    .code = (WGPUStringView){.data = blit_wgsl, .length = WGPU_STRLEN},
+	};
+	WGPUShaderModuleDescriptor shader_desc = {
+	    .nextInChain = (const WGPUChainedStruct *)&wgsl_desc,
+	};
+	state->shader = wgpuDeviceCreateShaderModule(device->wgpu_device, &shader_desc);
+
+	// Nearest blits bind the source as unfilterable so that 32-bit float
+	// formats work without the float32-filterable feature.
+	for (uint32_t linear = 0; linear < 2; linear++) {
+		WGPUBindGroupLayoutEntry entries[3] = {
+		    {.binding = 0,
+		     .visibility = WGPUShaderStage_Fragment,
+		     .texture = {.sampleType = linear ? WGPUTextureSampleType_Float
+		                                      : WGPUTextureSampleType_UnfilterableFloat,
+		                 .viewDimension = WGPUTextureViewDimension_2D}},
+		    {.binding = 1,
+		     .visibility = WGPUShaderStage_Fragment,
+		     .sampler = {.type = linear ? WGPUSamplerBindingType_Filtering
+		                                : WGPUSamplerBindingType_NonFiltering}},
+		    {.binding = 2,
+		     .visibility = WGPUShaderStage_Vertex,
+		     .buffer = {.type = WGPUBufferBindingType_Uniform,
+		                .hasDynamicOffset = 1,
+		                .minBindingSize = 16}},
+		};
+		WGPUBindGroupLayoutDescriptor bgl_desc = {.entryCount = 3, .entries = entries};
+		state->bind_group_layouts[linear] =
+		    wgpuDeviceCreateBindGroupLayout(device->wgpu_device, &bgl_desc);
+
+		WGPUPipelineLayoutDescriptor layout_desc = {
+		    .bindGroupLayoutCount = 1,
+		    .bindGroupLayouts = &state->bind_group_layouts[linear],
+		};
+		state->pipeline_layouts[linear] =
+		    wgpuDeviceCreatePipelineLayout(device->wgpu_device, &layout_desc);
+
+		WGPUFilterMode filter = linear ? WGPUFilterMode_Linear : WGPUFilterMode_Nearest;
+		WGPUSamplerDescriptor sampler_desc = {
+		    .addressModeU = WGPUAddressMode_ClampToEdge,
+		    .addressModeV = WGPUAddressMode_ClampToEdge,
+		    .addressModeW = WGPUAddressMode_ClampToEdge,
+		    .magFilter = filter,
+		    .minFilter = filter,
+		    .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+		    .lodMinClamp = 0.0f,
+		    .lodMaxClamp = 32.0f,
+		    .maxAnisotropy = 1,
+		};
+		state->samplers[linear] = wgpuDeviceCreateSampler(device->wgpu_device, &sampler_desc);
+	}
+
+	return state;
+}
+
+void wgvk_blit_cleanup(VkDevice device) {
+	struct WgvkBlitState *state = device ? device->blit_state : NULL;
+	if (!state) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < state->pipeline_count; i++) {
+		wgpuRenderPipelineRelease(state->pipelines[i].pipeline);
+	}
+	free(state->pipelines);
+	if (state->rect_buffer)
+		wgpuBufferRelease(state->rect_buffer);
+	for (uint32_t i = 0; i < 2; i++) {
+		if (state->samplers[i])
+			wgpuSamplerRelease(state->samplers[i]);
+		if (state->pipeline_layouts[i])
+			wgpuPipelineLayoutRelease(state->pipeline_layouts[i]);
+		if (state->bind_group_layouts[i])
+			wgpuBindGroupLayoutRelease(state->bind_group_layouts[i]);
+	}
+	if (state->shader)
+		wgpuShaderModuleRelease(state->shader);
+	wgvk_free(state);
+	device->blit_state = NULL;
+}
+
+/* Pipelines depend only on the destination format and the filter: every
+ * float source is read through the same texture_2d<f32> binding. */
+static WGPURenderPipeline get_blit_pipeline(VkDevice device, struct WgvkBlitState *state,
+                                            WGPUTextureFormat dst_format, uint32_t linear) {
+	// A handful of destination formats at most, so a linear scan is enough
+	for (uint32_t i = 0; i < state->pipeline_count; i++) {
+		if (state->pipelines[i].format == dst_format && state->pipelines[i].linear == linear) {
+			return state->pipelines[i].pipeline;
+		}
+	}
+
+	WGPUColorTargetState target = {
+	    .format = dst_format,
+	    .writeMask = WGPUColorWriteMask_All,
+	};
+	WGPUFragmentState fragment = {
+	    .module = state->shader,
+	    .entryPoint = (WGPUStringView){.data = "fs_main", .length = WGPU_STRLEN},
+	    .targetCount = 1,
+	    .targets = &target,
+	};
+	WGPURenderPipelineDescriptor desc = {
+	    .layout = state->pipeline_layouts[linear],
+	    .vertex =
+	        {
+	            .module = state->shader,
+	            .entryPoint = (WGPUStringView){.data = "vs_main", .length = WGPU_STRLEN},
+	        },
+	    .primitive =
+	        {
+	            .topology = WGPUPrimitiveTopology_TriangleList,
+	            .frontFace = WGPUFrontFace_CCW,
+	            .cullMode = WGPUCullMode_None,
+	        },
+	    .multisample = {.count = 1, .mask = 0xFFFFFFFF},
+	    .fragment = &fragment,
+	};
+	WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(device->wgpu_device, &desc);
+	if (!pipeline) {
+		return NULL;
+	}
+
+	if (state->pipeline_count == state->pipeline_capacity) {
+		uint32_t capacity = state->pipeline_capacity ? state->pipeline_capacity * 2 : 8;
+		WgvkBlitPipeline *pipelines =
+		    realloc(state->pipelines, capacity * sizeof(WgvkBlitPipeline));
+		if (!pipelines) {
+			wgpuRenderPipelineRelease(pipeline);
+			return NULL;
+		}
+		state->pipelines = pipelines;
+		state->pipeline_capacity = capacity;
+	}
+
+	// The device owns the pipeline until it is destroyed
+	state->pipelines[state->pipeline_count++] =
+	    (WgvkBlitPipeline){.format = dst_format, .linear = linear, .pipeline = pipeline};
+	return pipeline;
+}
+
+/* Uniform slot holding rect, written on first use. Mip chains and repeated
+ * blits of the same rectangles share slots instead of uploading again. */
+static VkBool32 get_rect_slot(VkDevice device, struct WgvkBlitState *state, const float rect[4],
+                              uint32_t *slot) {
+	for (uint32_t i = 0; i < state->rect_count; i++) {
+		if (memcmp(state->rects[i], rect, sizeof(state->rects[i])) == 0) {
+			*slot = i;
+			return VK_TRUE;
+		}
+	}
+
+	if (state->rect_buffer && state->rect_count == WGVK_BLIT_RECT_SLOTS) {
+		// Recorded commands keep the old buffer alive until they have executed
+		wgpuBufferRelease(state->rect_buffer);
+		state->rect_buffer = NULL;
+		state->rect_count = 0;
+	}
+	if (!state->rect_buffer) {
+		WGPUBufferDescriptor desc = {
+		    .label = (WGPUStringView){.data = "BlitParams", .length = WGPU_STRLEN},
+		    .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+		    .size = (uint64_t)WGVK_BLIT_RECT_SLOTS * WGVK_BLIT_UNIFORM_STRIDE,
+		};
+		state->rect_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &desc);
+		if (!state->rect_buffer) {
+			return VK_FALSE;
+		}
+	}
+
+	*slot = state->rect_count++;
+	memcpy(state->rects[*slot], rect, sizeof(state->rects[*slot]));
+	wgpuQueueWriteBuffer(device->wgpu_queue, state->rect_buffer,
+	                     (uint64_t)*slot * WGVK_BLIT_UNIFORM_STRIDE, rect,
+	                     sizeof(state->rects[*slot]));
+	return VK_TRUE;
+}
+
+static WGPUTextureView create_subresource_view(VkImage image, uint32_t level, uint32_t layer) {
+	WGPUTextureViewDescriptor desc = {
+	    .format = image->wgpu_format,
+	    .dimension = WGPUTextureViewDimension_2D,
+	    .baseMipLevel = level,
+	    .mipLevelCount = 1,
+	    .baseArrayLayer = layer,
+	    .arrayLayerCount = 1,
+	    .aspect = WGPUTextureAspect_All,
+	};
+	return wgpuTextureCreateView(image->wgpu_texture, &desc);
+}
+
+/* Record every region into the command buffer's encoder, one render pass
+ * per region. Source rectangles come from the device's uniform slots. */
+static void record_blits(VkCommandBuffer cmd, VkImage src, VkImage dst,
+                         const WgvkBlitRegion *regions, uint32_t count, uint32_t filter) {
+	VkDevice device = cmd->device;
+	WGPUTextureSampleType src_type = wgvk_format_sample_type(src->format);
+	WGPUTextureSampleType dst_type = wgvk_format_sample_type(dst->format);
+
+	if ((src_type != WGPUTextureSampleType_Float &&
+	     src_type != WGPUTextureSampleType_UnfilterableFloat) ||
+	    (dst_type != WGPUTextureSampleType_Float &&
+	     dst_type != WGPUTextureSampleType_UnfilterableFloat) ||
+	    !wgvk_format_is_color_renderable(dst->format)) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+		          "vkCmdBlitImage: format %u -> %u unsupported, only float color formats blit",
+		          src->format, dst->format);
+		return;
+	}
+	if (src->image_type == VK_IMAGE_TYPE_3D || dst->image_type == VK_IMAGE_TYPE_3D) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND, "vkCmdBlitImage: 3D images unsupported");
+		return;
+	}
+
+	uint32_t linear = filter == VK_FILTER_LINEAR;
+	if (linear && src_type != WGPUTextureSampleType_Float) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+		          "vkCmdBlitImage: format %u is not filterable, using nearest", src->format);
+		linear = 0;
+	}
+
+	struct WgvkBlitState *state = get_blit_state(device);
+	if (!state) {
+		return;
+	}
+	WGPURenderPipeline pipeline =
+	    get_blit_pipeline(device, state, wgvk_format_to_wgpu(dst->format), linear);
+	if (!pipeline) {
+		return;
+	}
+
+	// Consecutive regions reading the same subresource share a bind group
+	WGPUBindGroup bind_group = NULL;
+	WGPUTextureView src_view = NULL;
+	WGPUBuffer bound_buffer = NULL;
+	uint32_t bound_level = UINT32_MAX;
+	uint32_t bound_layer = UINT32_MAX;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const WgvkBlitRegion *r = &regions[i];
+		int32_t x0 = r->dst[0] < r->dst[2] ? r->dst[0] : r->dst[2];
+		int32_t x1 = r->dst[0] < r->dst[2] ? r->dst[2] : r->dst[0];
+		int32_t y0 = r->dst[1] < r->dst[3] ? r->dst[1] : r->dst[3];
+		int32_t y1 = r->dst[1] < r->dst[3] ? r->dst[3] : r->dst[1];
+		if (x1 <= x0 || y1 <= y0 || x0 < 0 || y0 < 0) {
+			continue;
+		}
+
+		float src_w = (float)level_extent(src->width, r->src_level);
+		float src_h = (float)level_extent(src->height, r->src_level);
+		float rect[4] = {r->src[0] / src_w, r->src[1] / src_h, r->src[2] / src_w,
+		                 r->src[3] / src_h};
+
+		// Draw into a positive viewport and mirror the source instead
+		if (r->dst[0] > r->dst[2]) {
+			float t = rect[0];
+			rect[0] = rect[2];
+			rect[2] = t;
+		}
+		if (r->dst[1] > r->dst[3]) {
+			float t = rect[1];
+			rect[1] = rect[3];
+			rect[3] = t;
+		}
+		uint32_t slot = 0;
+		if (!get_rect_slot(device, state, rect, &slot)) {
+			break;
+		}
+
+		if (!bind_group || bound_buffer != state->rect_buffer || bound_level != r->src_level ||
+		    bound_layer != r->src_layer) {
+			if (bind_group)
+				wgpuBindGroupRelease(bind_group);
+			if (src_view)
+				wgpuTextureViewRelease(src_view);
+			src_view = create_subresource_view(src, r->src_level, r->src_layer);
+			WGPUBindGroupEntry entries[3] = {
+			    {.binding = 0, .textureView = src_view},
+			    {.binding = 1, .sampler = state->samplers[linear]},
+			    {.binding = 2, .buffer = state->rect_buffer, .offset = 0, .size = 16},
+			};
+			WGPUBindGroupDescriptor bg_desc = {
+			    .layout = state->bind_group_layouts[linear],
+			    .entryCount = 3,
+			    .entries = entries,
+			};
+			bind_group = wgpuDeviceCreateBindGroup(device->wgpu_device, &bg_desc);
+			bound_buffer = state->rect_buffer;
+			bound_level = r->src_level;
+			bound_layer = r->src_layer;
+		}
+
+		WGPUTextureView dst_view = create_subresource_view(dst, r->dst_level, r->dst_layer);
+
+		// A blit covering the whole level need not load the old contents
+		VkBool32 covers = x0 == 0 && y0 == 0 &&
+		                  (uint32_t)x1 == level_extent(dst->width, r->dst_level) &&
+		                  (uint32_t)y1 == level_extent(dst->height, r->dst_level);
+		WGPURenderPassColorAttachment color = {
+		    .view = dst_view,
+		    .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
+		    .loadOp = covers ? WGPULoadOp_Clear : WGPULoadOp_Load,
+		    .storeOp = WGPUStoreOp_Store,
+		};
+		WGPURenderPassDescriptor pass_desc = {
+		    .colorAttachmentCount = 1,
+		    .colorAttachments = &color,
+		};
+		uint32_t offset = slot * WGVK_BLIT_UNIFORM_STRIDE;
+		WGPURenderPassEncoder pass =
+		    wgpuCommandEncoderBeginRenderPass(cmd->wgpu_encoder, &pass_desc);
+		wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+		wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 1, &offset);
+		wgpuRenderPassEncoderSetViewport(pass, (float)x0, (float)y0, (float)(x1 - x0),
+		                                 (float)(y1 - y0), 0.0f, 1.0f);
+		wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+		wgpuRenderPassEncoderEnd(pass);
+		wgpuRenderPassEncoderRelease(pass);
+
+		if (dst_view)
+			wgpuTextureViewRelease(dst_view);
+	}
+
+	if (bind_group)
+		wgpuBindGroupRelease(bind_group);
+	if (src_view)
+		wgpuTextureViewRelease(src_view);
+}
+
+void vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcImage, uint32_t srcImageLayout,
+                    VkImage dstImage, uint32_t dstImageLayout, uint32_t regionCount,
+                    const void *pRegions, uint32_t filter) {
+	WGVK_STAT_CALL(vkCmdBlitImage);
+	(void)srcImageLayout;
+	(void)dstImageLayout;
+
+	if (!commandBuffer || !srcImage || !dstImage || !pRegions || !commandBuffer->wgpu_encoder) {
+		return;
+	}
+
+	const VkImageBlit *blits = pRegions;
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < regionCount; i++) {
+		count += blits[i].srcSubresource.layerCount;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	WgvkBlitRegion *regions = wgvk_alloc(count * sizeof(WgvkBlitRegion));
+	if (!regions) {
+		return;
+	}
+
+	uint32_t n = 0;
+	for (uint32_t i = 0; i < regionCount; i++) {
+		const VkImageBlit *b = &blits[i];
+		for (uint32_t l = 0; l < b->srcSubresource.layerCount; l++) {
+			WgvkBlitRegion *r = &regions[n++];
+			r->src_level = b->srcSubresource.mipLevel;
+			r->src_layer = b->srcSubresource.baseArrayLayer + l;
+			r->dst_level = b->dstSubresource.mipLevel;
+			r->dst_layer = b->dstSubresource.baseArrayLayer + l;
+			r->src[0] = b->srcOffsets[0].x;
+			r->src[1] = b->srcOffsets[0].y;
+			r->src[2] = b->srcOffsets[1].x;
+			r->src[3] = b->srcOffsets[1].y;
+			r->dst[0] = b->dstOffsets[0].x;
+			r->dst[1] = b->dstOffsets[0].y;
+			r->dst[2] = b->dstOffsets[1].x;
+			r->dst[3] = b->dstOffsets[1].y;
+		}
+	}
+
+	record_blits(commandBuffer, srcImage, dstImage, regions, count, filter);
+	wgvk_free(regions);
+}
+
+void wgvkCmdGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkFilter filter) {
+	if (!commandBuffer || !image || !commandBuffer->wgpu_encoder || image->mip_levels < 2) {
+		return;
+	}
+
+	// Each level is drawn from the one above it, all in the same encoder;
+	// WebGPU orders the passes, so no barriers are needed between levels.
+	uint32_t layers = image->array_layers > 0 ? image->array_layers : 1;
+	uint32_t count = (image->mip_levels - 1) * layers;
+	WgvkBlitRegion *regions = wgvk_alloc(count * sizeof(WgvkBlitRegion));
+	if (!regions) {
+		return;
+	}
+
+	uint32_t n = 0;
+	for (uint32_t level = 1; level < image->mip_levels; level++) {
+		for (uint32_t layer = 0; layer < layers; layer++) {
+			WgvkBlitRegion *r = &regions[n++];
+			r->src_level = level - 1;
+			r->src_layer = layer;
+			r->dst_level = level;
+			r->dst_layer = layer;
+			r->src[0] = 0;
+			r->src[1] = 0;
+			r->src[2] = (int32_t)level_extent(image->width, level - 1);
+			r->src[3] = (int32_t)level_extent(image->height, level - 1);
+			r->dst[0] = 0;
+			r->dst[1] = 0;
+			r->dst[2] = (int32_t)level_extent(image->width, level);
+			r->dst[3] = (int32_t)level_extent(image->height, level);
+		}
+	}
+
+	record_blits(commandBuffer, image, image, regions, count, filter);
+	wgvk_free(regions);
+}
+
+void vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, uint32_t srcImageLayout,
+                       VkImage dstImage, uint32_t dstImageLayout, uint32_t regionCount,
+                       const void *pRegions) {
+	WGVK_STAT_CALL(vkCmdResolveImage);
+	(void)srcImageLayout;
+	(void)dstImageLayout;
+
+	if (!commandBuffer || !srcImage || !dstImage || !pRegions || !commandBuffer->wgpu_encoder) {
+		return;
+	}
+
+	// WebGPU only resolves at the end of a render pass, and always the
+	// whole subresource. An empty pass with a resolve target does exactly that.
+	const VkImageResolve *resolves = pRegions;
+	for (uint32_t i = 0; i < regionCount; i++) {
+		const VkImageResolve *r = &resolves[i];
+		uint32_t width = level_extent(dstImage->width, r->dstSubresource.mipLevel);
+		uint32_t height = level_extent(dstImage->height, r->dstSubresource.mipLevel);
+		if (r->dstOffset.x != 0 || r->dstOffset.y != 0 || r->extent.width != width ||
+		    r->extent.height != height) {
+			WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+			          "vkCmdResolveImage: partial resolve, whole subresource resolved");
+		}
+
+		for (uint32_t l = 0; l < r->srcSubresource.layerCount; l++) {
+			WGPUTextureView src_view = create_subresource_view(
+			    srcImage, r->srcSubresource.mipLevel, r->srcSubresource.baseArrayLayer + l);
+			WGPUTextureView dst_view = create_subresource_view(
+			    dstImage, r->dstSubresource.mipLevel, r->dstSubresource.baseArrayLayer + l);
+
+			WGPURenderPassColorAttachment color = {
+			    .view = src_view,
+			    .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
+			    .resolveTarget = dst_view,
+			    .loadOp = WGPULoadOp_Load,
+			    .storeOp = WGPUStoreOp_Store,
+			};
+			WGPURenderPassDescriptor pass_desc = {
+			    .colorAttachmentCount = 1,
+			    .colorAttachments = &color,
+			};
+			WGPURenderPassEncoder pass =
+			    wgpuCommandEncoderBeginRenderPass(commandBuffer->wgpu_encoder, &pass_desc);
+			wgpuRenderPassEncoderEnd(pass);
+			wgpuRenderPassEncoderRelease(pass);
+
+			if (src_view)
+				wgpuTextureViewRelease(src_view);
+			if (dst_view)
+				wgpuTextureViewRelease(dst_view);
+		}
+	}
+}
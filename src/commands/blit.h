@@ -0,0 +1,36 @@
+#ifndef WGVK_BLIT_H
+#define WGVK_BLIT_H
+
+#include "webvulkan_internal.h"
+
+/* Uniform slots per buffer; one slot holds one source rectangle. */
+#define WGVK_BLIT_RECT_SLOTS 256
+
+typedef struct {
+	WGPUTextureFormat format;
+	uint32_t linear;
+	WGPURenderPipeline pipeline;
+} WgvkBlitPipeline;
+
+/* Per-device objects shared by every blit. WebGPU has no blit command, so
+ * blits draw a full-screen triangle sampling the source subresource. */
+struct WgvkBlitState {
+	WGPUShaderModule shader;
+	WGPUBindGroupLayout bind_group_layouts[2]; /* indexed by VkFilter */
+	WGPUPipelineLayout pipeline_layouts[2];
+	WGPUSampler samplers[2];
+	WgvkBlitPipeline *pipelines; /* one per (destination format, filter) */
+	uint32_t pipeline_count;
+	uint32_t pipeline_capacity;
+
+	/* Source rectangles, bound with a dynamic offset. A slot is written
+	 * once and never changes, so commands recorded earlier keep reading
+	 * their own rectangle; a full buffer is replaced rather than reused. */
+	WGPUBuffer rect_buffer;
+	float rects[WGVK_BLIT_RECT_SLOTS][4];
+	uint32_t rect_count;
+};
+
+void wgvk_blit_cleanup(VkDevice device);
+
+#endif
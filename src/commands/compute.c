@@ -2,6 +2,7 @@
 
 void vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY,
                    uint32_t groupCountZ) {
+	WGVK_STAT_CALL(vkCmdDispatch);
 	if (!commandBuffer || !commandBuffer->wgpu_compute_pass) {
 		return;
 	}
@@ -11,6 +12,7 @@ void vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t
 }
 
 void vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) {
+	WGVK_STAT_CALL(vkCmdDispatchIndirect);
 	if (!commandBuffer || !buffer || !commandBuffer->wgpu_compute_pass) {
 		return;
 	}
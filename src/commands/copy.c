@@ -1,7 +1,10 @@
 #include "webvulkan_internal.h"
+#include "transcode.h"
+#include "../util/log.h"
 
 void vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
                      uint32_t regionCount, const void *pRegions) {
+	WGVK_STAT_CALL(vkCmdCopyBuffer);
 	if (!commandBuffer || !srcBuffer || !dstBuffer || !commandBuffer->wgpu_encoder) {
 		return;
 	}
@@ -19,163 +22,509 @@ void vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer
 	}
 }
 
+/* WebGPU requires buffer rows of multi-row texture copies to be a multiple
+ * of this; Vulkan only requires whole texel blocks. */
+#define WGVK_COPY_ROW_ALIGNMENT 256
+#define WGVK_REPACK_WORKGROUP_SIZE 64
+/* minStorageBufferOffsetAlignment guaranteed by every WebGPU device */
+#define WGVK_STORAGE_OFFSET_ALIGNMENT 256
+
+/* Copies rows of bytes between buffers with different pitches. Sources may
+ * start at any byte; destinations are written in whole words, so they must
+ * be word aligned. */
+static const char repack_wgsl[] =
+    "struct Params {\n"
+    "  src_offset: u32, src_pitch: u32, src_image_pitch: u32,\n"
+    "  dst_offset: u32, dst_pitch: u32, dst_image_pitch: u32,\n"
+    "  row_words: u32, rows: u32,\n"
+    "};\n"
+    "@group(0) @binding(0) var<storage, read> src: array<u32>;\n"
+    "@group(0) @binding(1) var<storage, read_write> dst: array<u32>;\n"
+    "@group(0) @binding(2) var<uniform> params: Params;\n"
+    "fn load_word(addr: u32) -> u32 {\n"
+    "  let shift = (addr & 3u) * 8u;\n"
+    "  let lo = src[addr >> 2u];\n"
+    "  if (shift == 0u) { return lo; }\n"
+    "  return (lo >> shift) | (src[(addr >> 2u) + 1u] << (32u - shift));\n"
+    "}\n"
+    "@compute @workgroup_size(64)\n"
+    "fn main(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (id.x >= params.row_words || id.y >= params.rows) { return; }\n"
+    "  let src_addr = params.src_offset + id.z * params.src_image_pitch +\n"
+    "                 id.y * params.src_pitch + id.x * 4u;\n"
+    "  let dst_addr = params.dst_offset + id.z * params.dst_image_pitch +\n"
+    "                 id.y * params.dst_pitch + id.x * 4u;\n"
+    "  dst[dst_addr >> 2u] = load_word(src_addr);\n"
+    "}\n";
+
+/* Buffer side of a buffer/image copy, in bytes and block rows. */
+typedef struct {
+	uint32_t row_bytes;   /* one block row of the copied region */
+	uint32_t rows;        /* block rows per image */
+	uint32_t images;      /* depth slices or array layers */
+	uint64_t pitch;       /* Vulkan buffer row pitch */
+	uint64_t image_pitch; /* Vulkan buffer image pitch */
+} WgvkCopyLayout;
+
+static VkBool32 compute_copy_layout(VkImage image, const VkBufferImageCopy *region,
+                                    WgvkCopyLayout *layout) {
+	WgvkFormatBlock block = wgvk_format_block(image->format, region->imageSubresource.aspectMask);
+	if (block.block_size == 0) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND, "buffer/image copy: format %u aspect 0x%x not copyable",
+		          image->format, region->imageSubresource.aspectMask);
+		return VK_FALSE;
+	}
+
+	uint32_t row_length =
+	    region->bufferRowLength ? region->bufferRowLength : region->imageExtent.width;
+	uint32_t image_height =
+	    region->bufferImageHeight ? region->bufferImageHeight : region->imageExtent.height;
+
+	layout->row_bytes =
+	    wgvk_div_round_up(region->imageExtent.width, block.block_width) * block.block_size;
+	layout->rows = wgvk_div_round_up(region->imageExtent.height, block.block_height);
+	layout->images = image->image_type == VK_IMAGE_TYPE_3D ? region->imageExtent.depth
+	                                                       : region->imageSubresource.layerCount;
+	layout->pitch = (uint64_t)wgvk_div_round_up(row_length, block.block_width) * block.block_size;
+	layout->image_pitch = layout->pitch * wgvk_div_round_up(image_height, block.block_height);
+	return layout->rows > 0 && layout->images > 0 && layout->row_bytes > 0;
+}
+
+static WGPUTexelCopyTextureInfo texture_copy_info(VkImage image,
+                                                  const VkImageSubresourceLayers *subresource,
+                                                  const VkOffset3D *offset) {
+	WGPUTexelCopyTextureInfo info = {
+	    .texture = image->wgpu_texture,
+	    .mipLevel = subresource->mipLevel,
+	    .origin =
+	        {
+	            .x = (uint32_t)offset->x,
+	            .y = (uint32_t)offset->y,
+	            .z = image->image_type == VK_IMAGE_TYPE_3D ? (uint32_t)offset->z
+	                                                       : subresource->baseArrayLayer,
+	        },
+	    .aspect = wgvk_aspect_to_wgpu(subresource->aspectMask),
+	};
+	return info;
+}
+
+/* Direct copies need WebGPU-legal row pitches; a single row has none. */
+static VkBool32 layout_is_direct(const WgvkCopyLayout *layout) {
+	if (layout->rows == 1 && layout->images == 1)
+		return VK_TRUE;
+	return layout->pitch % WGVK_COPY_ROW_ALIGNMENT == 0 &&
+	       (layout->images == 1 || layout->image_pitch % layout->pitch == 0);
+}
+
+/* Buffer layout of a direct copy. A single row has no pitch to validate,
+ * so its strides are left undefined rather than passed unaligned. */
+static WGPUTexelCopyBufferLayout direct_buffer_layout(const WgvkCopyLayout *layout,
+                                                      uint64_t offset) {
+	if (layout->rows == 1 && layout->images == 1) {
+		return (WGPUTexelCopyBufferLayout){
+		    .offset = offset,
+		    .bytesPerRow = WGPU_COPY_STRIDE_UNDEFINED,
+		    .rowsPerImage = WGPU_COPY_STRIDE_UNDEFINED,
+		};
+	}
+	return (WGPUTexelCopyBufferLayout){
+	    .offset = offset,
+	    .bytesPerRow = (uint32_t)layout->pitch,
+	    .rowsPerImage = (uint32_t)(layout->image_pitch / layout->pitch),
+	};
+}
+
+static WGPUComputePipeline get_repack_pipeline(VkDevice device) {
+	if (device->repack_pipeline) {
+		return device->repack_pipeline;
+	}
+
+	WGPUShaderSourceWGSL wgsl_desc = {
+	    .chain = {.next = NULL, .sType = WGPUSType_ShaderSourceWGSL},
+	    .code = (WGPUStringView){.data = repack_wgsl, .length = WGPU_STRLEN},
+	};
+	WGPUShaderModuleDescriptor shader_desc = {
+	    .nextInChain = (const WGPUChainedStruct *)&wgsl_desc,
+	};
+	WGPUShaderModule shader = wgpuDeviceCreateShaderModule(device->wgpu_device, &shader_desc);
+	if (!shader) {
+		return NULL;
+	}
+
+	WGPUBindGroupLayoutEntry entries[3] = {
+	    {.binding = 0,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage}},
+	    {.binding = 1,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_Storage}},
+	    {.binding = 2,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_Uniform, .minBindingSize = 32}},
+	};
+	WGPUBindGroupLayoutDescriptor bgl_desc = {.entryCount = 3, .entries = entries};
+	device->repack_layout = wgpuDeviceCreateBindGroupLayout(device->wgpu_device, &bgl_desc);
+
+	WGPUPipelineLayoutDescriptor layout_desc = {
+	    .bindGroupLayoutCount = 1,
+	    .bindGroupLayouts = &device->repack_layout,
+	};
+	WGPUPipelineLayout layout = wgpuDeviceCreatePipelineLayout(device->wgpu_device, &layout_desc);
+
+	WGPUComputePipelineDescriptor desc = {
+	    .layout = layout,
+	    .compute =
+	        {
+	            .module = shader,
+	            .entryPoint = (WGPUStringView){.data = "main", .length = WGPU_STRLEN},
+	        },
+	};
+	device->repack_pipeline = wgpuDeviceCreateComputePipeline(device->wgpu_device, &desc);
+
+	if (layout)
+		wgpuPipelineLayoutRelease(layout);
+	wgpuShaderModuleRelease(shader);
+	return device->repack_pipeline;
+}
+
+/* Binds the words of a buffer one side of a repack touches, rebasing the
+ * side's start offset onto the binding. params are offset, pitch and image
+ * pitch. Reads of an unaligned source may spill one word past the region. */
+static WGPUBindGroupEntry repack_binding(uint32_t binding, WGPUBuffer buffer, uint64_t buffer_size,
+                                         uint32_t params[3], const WgvkCopyLayout *layout) {
+	uint64_t start = params[0] - params[0] % WGVK_STORAGE_OFFSET_ALIGNMENT;
+	uint64_t end = (uint64_t)params[0] + (uint64_t)(layout->images - 1) * params[2] +
+	               (uint64_t)(layout->rows - 1) * params[1] + layout->row_bytes;
+	end = wgvk_align_up(end, 4) + 4;
+	// Storage bindings must be a whole number of words
+	if (end > (buffer_size & ~(uint64_t)3)) {
+		end = buffer_size & ~(uint64_t)3;
+	}
+	params[0] -= (uint32_t)start;
+	return (WGPUBindGroupEntry){
+	    .binding = binding,
+	    .buffer = buffer,
+	    .offset = start,
+	    .size = end - start,
+	};
+}
+
+/* Record a compute pass copying layout->rows x layout->images rows of
+ * layout->row_bytes from src to dst, each side with its own pitches. */
+static VkBool32 record_repack(VkCommandBuffer cmd, WGPUBuffer src, uint64_t src_size,
+                              const uint32_t src_params[3], WGPUBuffer dst, uint64_t dst_size,
+                              const uint32_t dst_params[3], const WgvkCopyLayout *layout) {
+	VkDevice device = cmd->device;
+	WGPUComputePipeline pipeline = get_repack_pipeline(device);
+	if (!pipeline) {
+		return VK_FALSE;
+	}
+
+	uint32_t row_words = wgvk_div_round_up(layout->row_bytes, 4);
+	uint32_t params[8] = {src_params[0], src_params[1], src_params[2], dst_params[0],
+	                      dst_params[1], dst_params[2], row_words,     layout->rows};
+	WGPUBindGroupEntry entries[3] = {
+	    repack_binding(0, src, src_size, &params[0], layout),
+	    repack_binding(1, dst, dst_size, &params[3], layout),
+	    {.binding = 2, .offset = 0, .size = sizeof(params)},
+	};
+	WGPUBufferDescriptor params_desc = {
+	    .label = (WGPUStringView){.data = "RepackParams", .length = WGPU_STRLEN},
+	    .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+	    .size = sizeof(params),
+	};
+	WGPUBuffer params_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &params_desc);
+	if (!params_buffer) {
+		return VK_FALSE;
+	}
+	// The buffer is new, so writing it ahead of submission is safe
+	wgpuQueueWriteBuffer(device->wgpu_queue, params_buffer, 0, params, sizeof(params));
+
+	entries[2].buffer = params_buffer;
+	WGPUBindGroupDescriptor bg_desc = {
+	    .layout = device->repack_layout,
+	    .entryCount = 3,
+	    .entries = entries,
+	};
+	WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(device->wgpu_device, &bg_desc);
+
+	WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(cmd->wgpu_encoder, NULL);
+	wgpuComputePassEncoderSetPipeline(pass, pipeline);
+	wgpuComputePassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+	wgpuComputePassEncoderDispatchWorkgroups(
+	    pass, wgvk_div_round_up(row_words, WGVK_REPACK_WORKGROUP_SIZE), layout->rows,
+	    layout->images);
+	wgpuComputePassEncoderEnd(pass);
+	wgpuComputePassEncoderRelease(pass);
+
+	if (bind_group)
+		wgpuBindGroupRelease(bind_group);
+	wgpuBufferRelease(params_buffer);
+	return VK_TRUE;
+}
+
+/* Intermediate buffer with WebGPU-aligned rows for one region. */
+static WGPUBuffer create_staging(VkDevice device, const WgvkCopyLayout *layout, uint64_t *pitch,
+                                 uint64_t *size) {
+	*pitch = wgvk_align_up(layout->row_bytes, WGVK_COPY_ROW_ALIGNMENT);
+	*size = *pitch * layout->rows * layout->images;
+	WGPUBufferDescriptor desc = {
+	    .label = (WGPUStringView){.data = "CopyStaging", .length = WGPU_STRLEN},
+	    .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst,
+	    .size = *size,
+	};
+	return wgpuDeviceCreateBuffer(device->wgpu_device, &desc);
+}
+
 void vkCmdCopyImage(VkCommandBuffer commandBuffer, VkImage srcImage, uint32_t srcImageLayout,
                     VkImage dstImage, uint32_t dstImageLayout, uint32_t regionCount,
                     const void *pRegions) {
+	WGVK_STAT_CALL(vkCmdCopyImage);
 	(void)srcImageLayout;
 	(void)dstImageLayout;
 
-	if (!commandBuffer || !srcImage || !dstImage || !commandBuffer->wgpu_encoder) {
+	if (!commandBuffer || !srcImage || !dstImage || !pRegions || !commandBuffer->wgpu_encoder) {
 		return;
 	}
 
-	const struct {
-		uint32_t srcSubresource[5];
-		uint32_t srcOffset[3];
-		uint32_t dstSubresource[5];
-		uint32_t dstOffset[3];
-		uint32_t extent[3];
-	} *regions = pRegions;
+	// WebGPU copies between formats that differ at most in sRGB-ness;
+	// Vulkan's other size-compatible pairs go through a buffer
+	WGPUTextureFormat src_format = srcImage->wgpu_format;
+	WGPUTextureFormat dst_format = dstImage->wgpu_format;
+	VkBool32 direct =
+	    src_format == dst_format || wgvk_format_srgb_pair(src_format) == dst_format;
+	if (!direct && (srcImage->transcoded || dstImage->transcoded)) {
+		// Decoded texels no longer have the block layout Vulkan copies
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+		          "vkCmdCopyImage: cannot reinterpret transcoded format %u as %u",
+		          srcImage->format, dstImage->format);
+		return;
+	}
 
+	const VkImageCopy *regions = pRegions;
 	for (uint32_t i = 0; i < regionCount; i++) {
-		(void)regions;
+		const VkImageCopy *r = &regions[i];
+		WGPUTexelCopyTextureInfo src =
+		    texture_copy_info(srcImage, &r->srcSubresource, &r->srcOffset);
+		WGPUTexelCopyTextureInfo dst =
+		    texture_copy_info(dstImage, &r->dstSubresource, &r->dstOffset);
+		uint32_t images = srcImage->image_type == VK_IMAGE_TYPE_3D ? r->extent.depth
+		                                                           : r->srcSubresource.layerCount;
+		WGPUExtent3D size = {
+		    .width = r->extent.width,
+		    .height = r->extent.height,
+		    .depthOrArrayLayers = images,
+		};
+
+		if (direct) {
+			wgpuCommandEncoderCopyTextureToTexture(commandBuffer->wgpu_encoder, &src, &dst,
+			                                       &size);
+			continue;
+		}
+
+		WgvkFormatBlock src_block =
+		    wgvk_format_block(srcImage->format, r->srcSubresource.aspectMask);
+		WgvkFormatBlock dst_block =
+		    wgvk_format_block(dstImage->format, r->dstSubresource.aspectMask);
+		if (src_block.block_size == 0 || src_block.block_size != dst_block.block_size) {
+			WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+			          "vkCmdCopyImage: formats %u and %u are not size-compatible",
+			          srcImage->format, dstImage->format);
+			continue;
+		}
+
+		WgvkCopyLayout layout = {
+		    .row_bytes = wgvk_div_round_up(r->extent.width, src_block.block_width) *
+		                 src_block.block_size,
+		    .rows = wgvk_div_round_up(r->extent.height, src_block.block_height),
+		    .images = images,
+		};
+		uint64_t pitch = 0;
+		uint64_t staging_size = 0;
+		WGPUBuffer staging =
+		    create_staging(commandBuffer->device, &layout, &pitch, &staging_size);
+		if (!staging) {
+			continue;
+		}
+
+		WGPUTexelCopyBufferInfo buffer = {
+		    .layout = {.offset = 0, .bytesPerRow = (uint32_t)pitch, .rowsPerImage = layout.rows},
+		    .buffer = staging,
+		};
+		wgpuCommandEncoderCopyTextureToBuffer(commandBuffer->wgpu_encoder, &src, &buffer, &size);
+
+		// The same blocks, measured in destination texels
+		WGPUExtent3D dst_size = {
+		    .width = layout.row_bytes / dst_block.block_size * dst_block.block_width,
+		    .height = layout.rows * dst_block.block_height,
+		    .depthOrArrayLayers = images,
+		};
+		wgpuCommandEncoderCopyBufferToTexture(commandBuffer->wgpu_encoder, &buffer, &dst,
+		                                      &dst_size);
+		wgpuBufferRelease(staging);
 	}
 }
 
 void vkCmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkImage dstImage,
                             uint32_t dstImageLayout, uint32_t regionCount, const void *pRegions) {
+	WGVK_STAT_CALL(vkCmdCopyBufferToImage);
 	(void)dstImageLayout;
 
-	if (!commandBuffer || !srcBuffer || !dstImage || !commandBuffer->wgpu_encoder) {
+	if (!commandBuffer || !srcBuffer || !dstImage || !pRegions || !commandBuffer->wgpu_encoder) {
 		return;
 	}
 
-	const struct {
-		VkDeviceSize bufferOffset;
-		uint32_t bufferRowLength;
-		uint32_t bufferImageHeight;
-		uint32_t imageSubresource[5];
-		uint32_t imageOffset[3];
-		uint32_t imageExtent[3];
-	} *regions = pRegions;
-
+	const VkBufferImageCopy *regions = pRegions;
 	for (uint32_t i = 0; i < regionCount; i++) {
-		WGPUTexelCopyBufferInfo src = {
-		    .layout =
-		        {
-		            .offset = regions[i].bufferOffset,
-		            .bytesPerRow = regions[i].bufferRowLength > 0 ? regions[i].bufferRowLength * 4
-		                                                          : WGPU_COPY_STRIDE_UNDEFINED,
-		            .rowsPerImage = regions[i].bufferImageHeight > 0 ? regions[i].bufferImageHeight
-		                                                             : WGPU_COPY_STRIDE_UNDEFINED,
-		        },
-		    .buffer = srcBuffer->wgpu_buffer,
-		};
-
-		WGPUTexelCopyTextureInfo dst = {
-		    .texture = dstImage->wgpu_texture,
-		    .mipLevel = regions[i].imageSubresource[0],
-		    .origin =
-		        {
-		            .x = regions[i].imageOffset[0],
-		            .y = regions[i].imageOffset[1],
-		            .z = regions[i].imageOffset[2],
-		        },
-		    .aspect = WGPUTextureAspect_All,
-		};
-
+		const VkBufferImageCopy *r = &regions[i];
+		if (dstImage->transcoded) {
+			wgvk_transcode_copy(commandBuffer, srcBuffer, dstImage, r);
+			continue;
+		}
+		WgvkCopyLayout layout;
+		if (!compute_copy_layout(dstImage, r, &layout)) {
+			continue;
+		}
+
+		WGPUTexelCopyTextureInfo dst =
+		    texture_copy_info(dstImage, &r->imageSubresource, &r->imageOffset);
 		WGPUExtent3D size = {
-		    .width = regions[i].imageExtent[0],
-		    .height = regions[i].imageExtent[1],
-		    .depthOrArrayLayers = regions[i].imageExtent[2],
+		    .width = r->imageExtent.width,
+		    .height = r->imageExtent.height,
+		    .depthOrArrayLayers = layout.images,
 		};
 
-		wgpuCommandEncoderCopyBufferToTexture(commandBuffer->wgpu_encoder, &src, &dst, &size);
+		if (layout_is_direct(&layout)) {
+			WGPUTexelCopyBufferInfo src = {
+			    .layout = direct_buffer_layout(&layout, r->bufferOffset),
+			    .buffer = srcBuffer->wgpu_buffer,
+			};
+			wgpuCommandEncoderCopyBufferToTexture(commandBuffer->wgpu_encoder, &src, &dst, &size);
+			continue;
+		}
+
+		// Repitch into aligned rows on the GPU, then copy from there
+		uint64_t pitch = 0;
+		uint64_t staging_size = 0;
+		WGPUBuffer staging = create_staging(commandBuffer->device, &layout, &pitch, &staging_size);
+		if (!staging) {
+			continue;
+		}
+		uint32_t src_params[3] = {(uint32_t)r->bufferOffset, (uint32_t)layout.pitch,
+		                          (uint32_t)layout.image_pitch};
+		uint32_t dst_params[3] = {0, (uint32_t)pitch, (uint32_t)(pitch * layout.rows)};
+		if (record_repack(commandBuffer, srcBuffer->wgpu_buffer, srcBuffer->size, src_params,
+		                  staging, staging_size, dst_params, &layout)) {
+			WGPUTexelCopyBufferInfo src = {
+			    .layout =
+			        {
+			            .offset = 0,
+			            .bytesPerRow = (uint32_t)pitch,
+			            .rowsPerImage = layout.rows,
+			        },
+			    .buffer = staging,
+			};
+			wgpuCommandEncoderCopyBufferToTexture(commandBuffer->wgpu_encoder, &src, &dst, &size);
+		}
+		wgpuBufferRelease(staging);
 	}
 }
 
 void vkCmdCopyImageToBuffer(VkCommandBuffer commandBuffer, VkImage srcImage,
                             uint32_t srcImageLayout, VkBuffer dstBuffer, uint32_t regionCount,
                             const void *pRegions) {
+	WGVK_STAT_CALL(vkCmdCopyImageToBuffer);
 	(void)srcImageLayout;
 
-	if (!commandBuffer || !srcImage || !dstBuffer || !commandBuffer->wgpu_encoder) {
+	if (!commandBuffer || !srcImage || !dstBuffer || !pRegions || !commandBuffer->wgpu_encoder) {
+		return;
+	}
+	if (srcImage->transcoded) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+		          "vkCmdCopyImageToBuffer: transcoded format %u cannot be read back",
+		          srcImage->format);
 		return;
 	}
 
-	const struct {
-		VkDeviceSize bufferOffset;
-		uint32_t bufferRowLength;
-		uint32_t bufferImageHeight;
-		uint32_t imageSubresource[5];
-		uint32_t imageOffset[3];
-		uint32_t imageExtent[3];
-	} *regions = pRegions;
-
+	const VkBufferImageCopy *regions = pRegions;
 	for (uint32_t i = 0; i < regionCount; i++) {
-		WGPUTexelCopyTextureInfo src = {
-		    .texture = srcImage->wgpu_texture,
-		    .mipLevel = regions[i].imageSubresource[0],
-		    .origin =
-		        {
-		            .x = regions[i].imageOffset[0],
-		            .y = regions[i].imageOffset[1],
-		            .z = regions[i].imageOffset[2],
-		        },
-		    .aspect = WGPUTextureAspect_All,
+		const VkBufferImageCopy *r = &regions[i];
+		WgvkCopyLayout layout;
+		if (!compute_copy_layout(srcImage, r, &layout)) {
+			continue;
+		}
+
+		WGPUTexelCopyTextureInfo src =
+		    texture_copy_info(srcImage, &r->imageSubresource, &r->imageOffset);
+		WGPUExtent3D size = {
+		    .width = r->imageExtent.width,
+		    .height = r->imageExtent.height,
+		    .depthOrArrayLayers = layout.images,
 		};
 
+		if (layout_is_direct(&layout)) {
+			WGPUTexelCopyBufferInfo dst = {
+			    .layout = direct_buffer_layout(&layout, r->bufferOffset),
+			    .buffer = dstBuffer->wgpu_buffer,
+			};
+			wgpuCommandEncoderCopyTextureToBuffer(commandBuffer->wgpu_encoder, &src, &dst, &size);
+			continue;
+		}
+
+		// The repack shader writes whole words, which would clobber bytes
+		// around unaligned rows; those fall back to one copy per block row.
+		VkBool32 word_aligned = r->bufferOffset % 4 == 0 && layout.pitch % 4 == 0 &&
+		                        layout.image_pitch % 4 == 0 && layout.row_bytes % 4 == 0;
+		if (!word_aligned) {
+			WgvkFormatBlock block =
+			    wgvk_format_block(srcImage->format, r->imageSubresource.aspectMask);
+			for (uint32_t z = 0; z < layout.images; z++) {
+				for (uint32_t y = 0; y < layout.rows; y++) {
+					WGPUTexelCopyTextureInfo row_src = src;
+					row_src.origin.y += y * block.block_height;
+					row_src.origin.z += z;
+					WGPUTexelCopyBufferInfo row_dst = {
+					    .layout =
+					        {
+					            .offset = r->bufferOffset + z * layout.image_pitch +
+					                      y * layout.pitch,
+					            .bytesPerRow = WGPU_COPY_STRIDE_UNDEFINED,
+					            .rowsPerImage = WGPU_COPY_STRIDE_UNDEFINED,
+					        },
+					    .buffer = dstBuffer->wgpu_buffer,
+					};
+					WGPUExtent3D row_size = {r->imageExtent.width, block.block_height, 1};
+					wgpuCommandEncoderCopyTextureToBuffer(commandBuffer->wgpu_encoder, &row_src,
+					                                      &row_dst, &row_size);
+				}
+			}
+			continue;
+		}
+
+		uint64_t pitch = 0;
+		uint64_t staging_size = 0;
+		WGPUBuffer staging = create_staging(commandBuffer->device, &layout, &pitch, &staging_size);
+		if (!staging) {
+			continue;
+		}
 		WGPUTexelCopyBufferInfo dst = {
-		    .layout =
-		        {
-		            .offset = regions[i].bufferOffset,
-		            .bytesPerRow = regions[i].bufferRowLength > 0 ? regions[i].bufferRowLength * 4
-		                                                          : WGPU_COPY_STRIDE_UNDEFINED,
-		            .rowsPerImage = regions[i].bufferImageHeight > 0 ? regions[i].bufferImageHeight
-		                                                             : WGPU_COPY_STRIDE_UNDEFINED,
-		        },
-		    .buffer = dstBuffer->wgpu_buffer,
+		    .layout = {.offset = 0, .bytesPerRow = (uint32_t)pitch, .rowsPerImage = layout.rows},
+		    .buffer = staging,
 		};
-
-		WGPUExtent3D size = {
-		    .width = regions[i].imageExtent[0],
-		    .height = regions[i].imageExtent[1],
-		    .depthOrArrayLayers = regions[i].imageExtent[2],
-		};
-
 		wgpuCommandEncoderCopyTextureToBuffer(commandBuffer->wgpu_encoder, &src, &dst, &size);
-	}
-}
-
-void vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcImage, uint32_t srcImageLayout,
-                    VkImage dstImage, uint32_t dstImageLayout, uint32_t regionCount,
-                    const void *pRegions, uint32_t filter) {
-	(void)srcImageLayout;
-	(void)dstImageLayout;
-	(void)regionCount;
-	(void)pRegions;
-	(void)filter;
 
-	if (!commandBuffer || !srcImage || !dstImage) {
-		return;
-	}
-}
-
-void vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, uint32_t srcImageLayout,
-                       VkImage dstImage, uint32_t dstImageLayout, uint32_t regionCount,
-                       const void *pRegions) {
-	(void)srcImageLayout;
-	(void)dstImageLayout;
-	(void)regionCount;
-	(void)pRegions;
-
-	if (!commandBuffer || !srcImage || !dstImage) {
-		return;
+		uint32_t src_params[3] = {0, (uint32_t)pitch, (uint32_t)(pitch * layout.rows)};
+		uint32_t dst_params[3] = {(uint32_t)r->bufferOffset, (uint32_t)layout.pitch,
+		                          (uint32_t)layout.image_pitch};
+		record_repack(commandBuffer, staging, staging_size, src_params, dstBuffer->wgpu_buffer,
+		              dstBuffer->size, dst_params, &layout);
+		wgpuBufferRelease(staging);
 	}
 }
 
 void vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset,
                      VkDeviceSize size, uint32_t data) {
+	WGVK_STAT_CALL(vkCmdFillBuffer);
 	(void)data;
 
 	if (!commandBuffer || !dstBuffer || !commandBuffer->wgpu_encoder) {
@@ -188,6 +537,7 @@ void vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDevice
 
 void vkCmdUpdateBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset,
                        VkDeviceSize dataSize, const void *pData) {
+	WGVK_STAT_CALL(vkCmdUpdateBuffer);
 	(void)pData;
 
 	if (!commandBuffer || !dstBuffer || !commandBuffer->wgpu_encoder) {
@@ -201,6 +551,7 @@ void vkCmdUpdateBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDevi
 void vkCmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, void *queryPool, uint32_t firstQuery,
                                uint32_t queryCount, VkBuffer dstBuffer, VkDeviceSize dstOffset,
                                VkDeviceSize stride, VkFlags flags) {
+	WGVK_STAT_CALL(vkCmdCopyQueryPoolResults);
 	(void)queryPool;
 	(void)firstQuery;
 	(void)queryCount;
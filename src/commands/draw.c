@@ -1,7 +1,9 @@
 #include "webvulkan_internal.h"
+#include "../util/log.h"
 
 void vkCmdBindPipeline(VkCommandBuffer commandBuffer, uint32_t pipelineBindPoint,
                        VkPipeline pipeline) {
+	WGVK_STAT_CALL(vkCmdBindPipeline);
 	if (!commandBuffer || !pipeline) {
 		return;
 	}
@@ -22,9 +24,45 @@ void vkCmdBindPipeline(VkCommandBuffer commandBuffer, uint32_t pipelineBindPoint
 	}
 }
 
+static void apply_vertex_buffer(VkCommandBuffer cmd, uint32_t slot) {
+	VkBuffer buffer = cmd->bound_vertex_buffers[slot];
+	if (!cmd->wgpu_render_pass || !buffer) {
+		return;
+	}
+	VkDeviceSize offset = cmd->bound_vertex_offsets[slot];
+	wgpuRenderPassEncoderSetVertexBuffer(cmd->wgpu_render_pass, slot, buffer->wgpu_buffer, offset,
+	                                     buffer->size - offset);
+}
+
+static void apply_index_buffer(VkCommandBuffer cmd) {
+	VkBuffer buffer = cmd->bound_index_buffer;
+	if (!cmd->wgpu_render_pass || !buffer) {
+		return;
+	}
+	WGPUIndexFormat format = WGPUIndexFormat_Uint32;
+	if (cmd->bound_index_type == VK_INDEX_TYPE_UINT16) {
+		format = WGPUIndexFormat_Uint16;
+	}
+	VkDeviceSize offset = cmd->bound_index_offset;
+	wgpuRenderPassEncoderSetIndexBuffer(cmd->wgpu_render_pass, buffer->wgpu_buffer, format, offset,
+	                                    buffer->size - offset);
+}
+
+void wgvk_cmd_rebind_vertex_input(VkCommandBuffer cmd) {
+	if (!cmd) {
+		return;
+	}
+
+	for (uint32_t slot = 0; slot < WGVK_MAX_VERTEX_BUFFERS; slot++) {
+		apply_vertex_buffer(cmd, slot);
+	}
+	apply_index_buffer(cmd);
+}
+
 void vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding,
                             uint32_t bindingCount, const VkBuffer *pBuffers,
                             const VkDeviceSize *pOffsets) {
+	WGVK_STAT_CALL(vkCmdBindVertexBuffers);
 	if (!commandBuffer || !pBuffers || !pOffsets) {
 		return;
 	}
@@ -34,18 +72,14 @@ void vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding
 		if (slot < WGVK_MAX_VERTEX_BUFFERS) {
 			commandBuffer->bound_vertex_buffers[slot] = pBuffers[i];
 			commandBuffer->bound_vertex_offsets[slot] = pOffsets[i];
-
-			if (commandBuffer->wgpu_render_pass && pBuffers[i]) {
-				wgpuRenderPassEncoderSetVertexBuffer(commandBuffer->wgpu_render_pass, slot,
-				                                     pBuffers[i]->wgpu_buffer, pOffsets[i],
-				                                     pBuffers[i]->size - pOffsets[i]);
-			}
+			apply_vertex_buffer(commandBuffer, slot);
 		}
 	}
 }
 
 void vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
                           uint32_t indexType) {
+	WGVK_STAT_CALL(vkCmdBindIndexBuffer);
 	if (!commandBuffer || !buffer) {
 		return;
 	}
@@ -53,17 +87,35 @@ void vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDevi
 	commandBuffer->bound_index_buffer = buffer;
 	commandBuffer->bound_index_offset = offset;
 	commandBuffer->bound_index_type = indexType;
+	apply_index_buffer(commandBuffer);
+}
 
-	if (commandBuffer->wgpu_render_pass) {
-		WGPUIndexFormat format = WGPUIndexFormat_Uint32;
-		if (indexType == VK_INDEX_TYPE_UINT16) {
-			format = WGPUIndexFormat_Uint16;
-		} else if (indexType == VK_INDEX_TYPE_UINT32) {
-			format = WGPUIndexFormat_Uint32;
-		}
+static void apply_descriptor_set(VkCommandBuffer cmd, VkPipelineBindPoint bind_point,
+                                 uint32_t slot) {
+	VkDescriptorSet set = cmd->bound_descriptor_sets[slot];
+	if (!set || !set->wgpu_bind_group) {
+		return;
+	}
+
+	uint32_t offset_count = cmd->bound_dynamic_offset_counts[slot];
+	const uint32_t *offsets = offset_count > 0 ? cmd->bound_dynamic_offsets[slot] : NULL;
+
+	if (bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS && cmd->wgpu_render_pass) {
+		wgpuRenderPassEncoderSetBindGroup(cmd->wgpu_render_pass, slot, set->wgpu_bind_group,
+		                                  offset_count, offsets);
+	} else if (bind_point == VK_PIPELINE_BIND_POINT_COMPUTE && cmd->wgpu_compute_pass) {
+		wgpuComputePassEncoderSetBindGroup(cmd->wgpu_compute_pass, slot, set->wgpu_bind_group,
+		                                   offset_count, offsets);
+	}
+}
 
-		wgpuRenderPassEncoderSetIndexBuffer(commandBuffer->wgpu_render_pass, buffer->wgpu_buffer,
-		                                    format, offset, buffer->size - offset);
+void wgvk_cmd_rebind_descriptor_sets(VkCommandBuffer cmd, VkPipelineBindPoint bind_point) {
+	if (!cmd) {
+		return;
+	}
+
+	for (uint32_t slot = 0; slot < WGVK_MAX_BIND_GROUPS; slot++) {
+		apply_descriptor_set(cmd, bind_point, slot);
 	}
 }
 
@@ -71,39 +123,51 @@ void vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, uint32_t pipelineBin
                              VkPipelineLayout layout, uint32_t firstSet,
                              uint32_t descriptorSetCount, const VkDescriptorSet *pDescriptorSets,
                              uint32_t dynamicOffsetCount, const uint32_t *pDynamicOffsets) {
+	WGVK_STAT_CALL(vkCmdBindDescriptorSets);
 	(void)layout;
-	(void)dynamicOffsetCount;
-	(void)pDynamicOffsets;
 
 	if (!commandBuffer || !pDescriptorSets) {
 		return;
 	}
 
+	// pDynamicOffsets is one flat array: each set consumes as many entries as
+	// its layout has dynamic bindings, in binding-number order.
+	uint32_t offset_index = 0;
+
 	for (uint32_t i = 0; i < descriptorSetCount; i++) {
 		uint32_t slot = firstSet + i;
+		VkDescriptorSet set = pDescriptorSets[i];
+
+		uint32_t needed = (set && set->layout) ? set->layout->dynamic_offset_count : 0;
+		uint32_t available = pDynamicOffsets ? dynamicOffsetCount - offset_index : 0;
+		if (needed > available) {
+			WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+			          "vkCmdBindDescriptorSets: set %u needs %u dynamic offsets, %u left", slot,
+			          needed, available);
+			needed = available;
+		}
+
 		if (slot < WGVK_MAX_BIND_GROUPS) {
-			commandBuffer->bound_descriptor_sets[slot] = pDescriptorSets[i];
-
-			if (pipelineBindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS &&
-			    commandBuffer->wgpu_render_pass) {
-				if (pDescriptorSets[i] && pDescriptorSets[i]->wgpu_bind_group) {
-					wgpuRenderPassEncoderSetBindGroup(commandBuffer->wgpu_render_pass, slot,
-					                                  pDescriptorSets[i]->wgpu_bind_group, 0, NULL);
-				}
-			} else if (pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE &&
-			           commandBuffer->wgpu_compute_pass) {
-				if (pDescriptorSets[i] && pDescriptorSets[i]->wgpu_bind_group) {
-					wgpuComputePassEncoderSetBindGroup(commandBuffer->wgpu_compute_pass, slot,
-					                                   pDescriptorSets[i]->wgpu_bind_group, 0,
-					                                   NULL);
-				}
+			// Layouts with more than WGVK_MAX_DYNAMIC_OFFSETS are rejected, and
+			// WebGPU takes the offsets in its own binding order
+			commandBuffer->bound_descriptor_sets[slot] = set;
+			commandBuffer->bound_dynamic_offset_counts[slot] = needed;
+			for (uint32_t k = 0; k < needed; k++) {
+				uint32_t source = set->layout->dynamic_offset_order[k];
+				commandBuffer->bound_dynamic_offsets[slot][k] =
+				    source < needed ? pDynamicOffsets[offset_index + source] : 0;
 			}
+
+			apply_descriptor_set(commandBuffer, pipelineBindPoint, slot);
 		}
+
+		offset_index += needed;
 	}
 }
 
 void vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount,
                uint32_t firstVertex, uint32_t firstInstance) {
+	WGVK_STAT_CALL(vkCmdDraw);
 	if (!commandBuffer || !commandBuffer->wgpu_render_pass) {
 		return;
 	}
@@ -114,6 +178,7 @@ void vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t ins
 
 void vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount,
                       uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) {
+	WGVK_STAT_CALL(vkCmdDrawIndexed);
 	if (!commandBuffer || !commandBuffer->wgpu_render_pass) {
 		return;
 	}
@@ -124,6 +189,7 @@ void vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32
 
 void vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
                        uint32_t drawCount, uint32_t stride) {
+	WGVK_STAT_CALL(vkCmdDrawIndirect);
 	if (!commandBuffer || !buffer || !commandBuffer->wgpu_render_pass) {
 		return;
 	}
@@ -136,6 +202,7 @@ void vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceS
 
 void vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
                               uint32_t drawCount, uint32_t stride) {
+	WGVK_STAT_CALL(vkCmdDrawIndexedIndirect);
 	if (!commandBuffer || !buffer || !commandBuffer->wgpu_render_pass) {
 		return;
 	}
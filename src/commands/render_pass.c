@@ -1,142 +1,205 @@
 #include "webvulkan_internal.h"
+#include "subpass.h"
+#include "../util/trace.h"
+
+static void apply_dynamic_state(VkCommandBuffer cmd) {
+	WGPURenderPassEncoder pass = cmd->wgpu_render_pass;
+	uint32_t set = cmd->dynamic_state_set;
+	if (!pass) {
+		return;
+	}
+
+	if (set & WGVK_DYNAMIC_VIEWPORT) {
+		const VkViewport *v = &cmd->viewport;
+		wgpuRenderPassEncoderSetViewport(pass, v->x, v->y, v->width, v->height, v->minDepth,
+		                                 v->maxDepth);
+	}
+	if (set & WGVK_DYNAMIC_SCISSOR) {
+		const VkRect2D *r = &cmd->scissor;
+		wgpuRenderPassEncoderSetScissorRect(pass, (uint32_t)r->offset.x, (uint32_t)r->offset.y,
+		                                    r->extent.width, r->extent.height);
+	}
+	if (set & WGVK_DYNAMIC_BLEND_CONSTANTS) {
+		const float *c = cmd->blend_constants;
+		wgpuRenderPassEncoderSetBlendConstant(pass, &(WGPUColor){c[0], c[1], c[2], c[3]});
+	}
+	if (set & WGVK_DYNAMIC_STENCIL_REFERENCE) {
+		wgpuRenderPassEncoderSetStencilReference(pass, cmd->stencil_reference);
+	}
+}
+
+/* Restore the state a fresh pass encoder has lost. Vulkan keeps bound
+ * state and dynamic state across subpasses and render passes. */
+static void restore_pass_state(VkCommandBuffer commandBuffer) {
+	if (commandBuffer->bound_pipeline && commandBuffer->bound_pipeline->bind_point == 0 &&
+	    commandBuffer->bound_pipeline->wgpu_pipeline.render) {
+		wgpuRenderPassEncoderSetPipeline(commandBuffer->wgpu_render_pass,
+		                                 commandBuffer->bound_pipeline->wgpu_pipeline.render);
+	}
+
+	// Sets bound before the pass began are re-applied with their dynamic offsets.
+	wgvk_cmd_rebind_descriptor_sets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+	wgvk_cmd_rebind_vertex_input(commandBuffer);
+	apply_dynamic_state(commandBuffer);
+}
+
+/* Begin the WebGPU pass for the active subpass. */
+static void begin_active_subpass(VkCommandBuffer commandBuffer) {
+	VkRenderPass rp = commandBuffer->active_render_pass;
+	VkFramebuffer fb = commandBuffer->active_framebuffer;
+
+	if (rp && fb && rp->subpass_info) {
+		commandBuffer->wgpu_render_pass = wgvk_subpass_begin(
+		    commandBuffer->wgpu_encoder, rp, fb, commandBuffer->active_subpass,
+		    commandBuffer->clear_values, commandBuffer->clear_value_count);
+	} else {
+		WGPURenderPassDescriptor desc = {0};
+		commandBuffer->wgpu_render_pass =
+		    wgpuCommandEncoderBeginRenderPass(commandBuffer->wgpu_encoder, &desc);
+	}
+
+	restore_pass_state(commandBuffer);
+}
 
 void vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const void *pRenderPassBegin,
                           uint32_t contents) {
+	WGVK_STAT_CALL(vkCmdBeginRenderPass);
 	(void)contents;
 
 	if (!commandBuffer || !pRenderPassBegin || commandBuffer->in_render_pass) {
 		return;
 	}
 
-	struct {
-		VkStructureType sType;
-		const void *pNext;
-		VkRenderPass renderPass;
-		VkFramebuffer framebuffer;
-		VkRect2D renderArea;
-		uint32_t clearValueCount;
-		const void *pClearValues;
-	} const *begin_info = pRenderPassBegin;
+	const VkRenderPassBeginInfo *begin_info = pRenderPassBegin;
 
+	// Spans the whole render pass instance, closed by vkCmdEndRenderPass
+	commandBuffer->pass_span = wgvk_trace_span_begin(WGVK_LOG_CAT_COMMAND, "render pass");
 	commandBuffer->in_render_pass = VK_TRUE;
-
-	WGPURenderPassColorAttachment color_attachments[WGVK_MAX_COLOR_ATTACHMENTS] = {0};
-	uint32_t color_count = 0;
-
-	WGPURenderPassDepthStencilAttachment depth_attachment = {0};
-	VkBool32 has_depth = VK_FALSE;
-
-	if (begin_info->framebuffer) {
-		VkFramebuffer fb = begin_info->framebuffer;
-		VkRenderPass rp = begin_info->renderPass;
-
-		uint32_t color_attach_count = fb->attachment_count;
-		if (rp && rp->depth_stencil_format != 0) {
-			color_attach_count = fb->attachment_count > 0 ? fb->attachment_count - 1 : 0;
-		}
-
-		for (uint32_t i = 0; i < color_attach_count && i < WGVK_MAX_COLOR_ATTACHMENTS; i++) {
-			VkImageView view = fb->attachments[i];
-			if (view && view->wgpu_view) {
-				color_attachments[color_count].view = view->wgpu_view;
-				color_attachments[color_count].loadOp = WGPULoadOp_Clear;
-				color_attachments[color_count].storeOp = WGPUStoreOp_Store;
-				color_attachments[color_count].clearValue = (WGPUColor){0.0f, 0.0f, 0.0f, 1.0f};
-				color_count++;
-			}
-		}
-
-		if (rp && rp->depth_stencil_format != 0 && rp->depth_stencil_index != UINT32_MAX &&
-		    rp->depth_stencil_index < fb->attachment_count) {
-			VkImageView depth_view = fb->attachments[rp->depth_stencil_index];
-			if (depth_view && depth_view->wgpu_view) {
-				depth_attachment.view = depth_view->wgpu_view;
-				depth_attachment.depthLoadOp = WGPULoadOp_Clear;
-				depth_attachment.depthStoreOp = WGPUStoreOp_Store;
-				depth_attachment.depthClearValue = 1.0f;
-				depth_attachment.stencilLoadOp = WGPULoadOp_Clear;
-				depth_attachment.stencilStoreOp = WGPUStoreOp_Store;
-				depth_attachment.stencilClearValue = 0;
-				has_depth = VK_TRUE;
-			}
-		}
-	}
-
-	WGPURenderPassDescriptor desc = {
-	    .colorAttachmentCount = color_count,
-	    .colorAttachments = color_attachments,
-	};
-
-	if (has_depth) {
-		desc.depthStencilAttachment = &depth_attachment;
+	commandBuffer->active_render_pass = begin_info->renderPass;
+	commandBuffer->active_framebuffer = begin_info->framebuffer;
+	commandBuffer->active_subpass = 0;
+
+	// Later subpasses may clear attachments, so keep the values for the
+	// whole render pass instance. Values past the last attachment are
+	// ignored, as Vulkan allows more than the render pass uses.
+	uint32_t clear_count = begin_info->pClearValues ? begin_info->clearValueCount : 0;
+	if (begin_info->renderPass && clear_count > begin_info->renderPass->attachment_count) {
+		clear_count = begin_info->renderPass->attachment_count;
 	}
-
-	commandBuffer->wgpu_render_pass =
-	    wgpuCommandEncoderBeginRenderPass(commandBuffer->wgpu_encoder, &desc);
-
-	if (commandBuffer->bound_pipeline && commandBuffer->bound_pipeline->bind_point == 0 &&
-	    commandBuffer->bound_pipeline->wgpu_pipeline.render) {
-		wgpuRenderPassEncoderSetPipeline(commandBuffer->wgpu_render_pass,
-		                                 commandBuffer->bound_pipeline->wgpu_pipeline.render);
+	if (clear_count > 0) {
+		memcpy(commandBuffer->clear_values, begin_info->pClearValues,
+		       clear_count * sizeof(VkClearValue));
 	}
+	commandBuffer->clear_value_count = clear_count;
+
+	begin_active_subpass(commandBuffer);
 }
 
 void vkCmdEndRenderPass(VkCommandBuffer commandBuffer) {
+	WGVK_STAT_CALL(vkCmdEndRenderPass);
 	if (!commandBuffer || !commandBuffer->in_render_pass) {
 		return;
 	}
 
-	if (commandBuffer->wgpu_render_pass) {
-		wgpuRenderPassEncoderEnd(commandBuffer->wgpu_render_pass);
-		wgpuRenderPassEncoderRelease(commandBuffer->wgpu_render_pass);
-		commandBuffer->wgpu_render_pass = NULL;
-	}
-
+	wgvk_subpass_end(commandBuffer->wgpu_render_pass);
+	commandBuffer->wgpu_render_pass = NULL;
+	commandBuffer->active_render_pass = NULL;
+	commandBuffer->active_framebuffer = NULL;
 	commandBuffer->in_render_pass = VK_FALSE;
+	wgvk_trace_span_end(&commandBuffer->pass_span);
 }
 
 void vkCmdNextSubpass(VkCommandBuffer commandBuffer, uint32_t contents) {
-	(void)commandBuffer;
+	WGVK_STAT_CALL(vkCmdNextSubpass);
 	(void)contents;
+
+	if (!commandBuffer || !commandBuffer->in_render_pass) {
+		return;
+	}
+
+	VkRenderPass rp = commandBuffer->active_render_pass;
+	uint32_t next = commandBuffer->active_subpass + 1;
+	if (next >= wgvk_subpass_get_count(rp)) {
+		return;
+	}
+	commandBuffer->active_subpass = next;
+
+	// Merged subpasses keep recording into the current WebGPU pass
+	if (rp->subpass_info->subpasses[next].merged) {
+		return;
+	}
+
+	wgvk_subpass_end(commandBuffer->wgpu_render_pass);
+	commandBuffer->wgpu_render_pass = NULL;
+	begin_active_subpass(commandBuffer);
 }
 
+void vkCmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo *pRenderingInfo) {
+	WGVK_STAT_CALL(vkCmdBeginRendering);
+	if (!commandBuffer || !pRenderingInfo || commandBuffer->in_render_pass) {
+		return;
+	}
+
+	commandBuffer->pass_span = wgvk_trace_span_begin(WGVK_LOG_CAT_COMMAND, "rendering");
+	commandBuffer->in_render_pass = VK_TRUE;
+	commandBuffer->active_render_pass = NULL;
+	commandBuffer->active_framebuffer = NULL;
+	commandBuffer->active_subpass = 0;
+	commandBuffer->clear_value_count = 0;
+
+	commandBuffer->wgpu_render_pass =
+	    wgvk_rendering_begin(commandBuffer->wgpu_encoder, pRenderingInfo);
+	restore_pass_state(commandBuffer);
+}
+
+void vkCmdEndRendering(VkCommandBuffer commandBuffer) {
+	WGVK_STAT_CALL(vkCmdEndRendering);
+	vkCmdEndRenderPass(commandBuffer);
+}
+
+/* WebGPU has a single viewport and scissor rect, so only index 0 is kept. */
 void vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount,
                       const void *pViewports) {
-	if (!commandBuffer || !pViewports || !commandBuffer->wgpu_render_pass) {
+	WGVK_STAT_CALL(vkCmdSetViewport);
+	if (!commandBuffer || !pViewports || firstViewport != 0 || viewportCount == 0) {
 		return;
 	}
 
-	const VkViewport *viewports = (const VkViewport *)pViewports;
-
-	for (uint32_t i = 0; i < viewportCount; i++) {
-		wgpuRenderPassEncoderSetViewport(commandBuffer->wgpu_render_pass, viewports[i].x,
-		                                 viewports[i].y, viewports[i].width, viewports[i].height,
-		                                 viewports[i].minDepth, viewports[i].maxDepth);
+	commandBuffer->viewport = *(const VkViewport *)pViewports;
+	commandBuffer->dynamic_state_set |= WGVK_DYNAMIC_VIEWPORT;
+	if (commandBuffer->wgpu_render_pass) {
+		const VkViewport *v = &commandBuffer->viewport;
+		wgpuRenderPassEncoderSetViewport(commandBuffer->wgpu_render_pass, v->x, v->y, v->width,
+		                                 v->height, v->minDepth, v->maxDepth);
 	}
 }
 
 void vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount,
                      const void *pScissors) {
-	if (!commandBuffer || !pScissors || !commandBuffer->wgpu_render_pass) {
+	WGVK_STAT_CALL(vkCmdSetScissor);
+	if (!commandBuffer || !pScissors || firstScissor != 0 || scissorCount == 0) {
 		return;
 	}
 
-	const VkRect2D *scissors = (const VkRect2D *)pScissors;
-
-	for (uint32_t i = 0; i < scissorCount; i++) {
-		wgpuRenderPassEncoderSetScissorRect(commandBuffer->wgpu_render_pass, scissors[i].offset.x,
-		                                    scissors[i].offset.y, scissors[i].extent.width,
-		                                    scissors[i].extent.height);
+	commandBuffer->scissor = *(const VkRect2D *)pScissors;
+	commandBuffer->dynamic_state_set |= WGVK_DYNAMIC_SCISSOR;
+	if (commandBuffer->wgpu_render_pass) {
+		const VkRect2D *r = &commandBuffer->scissor;
+		wgpuRenderPassEncoderSetScissorRect(commandBuffer->wgpu_render_pass,
+		                                    (uint32_t)r->offset.x, (uint32_t)r->offset.y,
+		                                    r->extent.width, r->extent.height);
 	}
 }
 
 void vkCmdSetLineWidth(VkCommandBuffer commandBuffer, float lineWidth) {
+	WGVK_STAT_CALL(vkCmdSetLineWidth);
 	(void)commandBuffer;
 	(void)lineWidth;
 }
 
 void vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasConstantFactor,
                        float depthBiasClamp, float depthBiasSlopeFactor) {
+	WGVK_STAT_CALL(vkCmdSetDepthBias);
 	(void)commandBuffer;
 	(void)depthBiasConstantFactor;
 	(void)depthBiasClamp;
@@ -144,20 +207,27 @@ void vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasConstantFac
 }
 
 void vkCmdSetBlendConstants(VkCommandBuffer commandBuffer, const float blendConstants[4]) {
-	if (!commandBuffer || !blendConstants || !commandBuffer->wgpu_render_pass) {
+	WGVK_STAT_CALL(vkCmdSetBlendConstants);
+	if (!commandBuffer || !blendConstants) {
 		return;
 	}
 
-	wgpuRenderPassEncoderSetBlendConstant(commandBuffer->wgpu_render_pass, &(WGPUColor){
-	                                                                           blendConstants[0],
-	                                                                           blendConstants[1],
-	                                                                           blendConstants[2],
-	                                                                           blendConstants[3],
-	                                                                       });
+	memcpy(commandBuffer->blend_constants, blendConstants, sizeof(commandBuffer->blend_constants));
+	commandBuffer->dynamic_state_set |= WGVK_DYNAMIC_BLEND_CONSTANTS;
+	if (commandBuffer->wgpu_render_pass) {
+		wgpuRenderPassEncoderSetBlendConstant(commandBuffer->wgpu_render_pass,
+		                                      &(WGPUColor){
+		                                          blendConstants[0],
+		                                          blendConstants[1],
+		                                          blendConstants[2],
+		                                          blendConstants[3],
+		                                      });
+	}
 }
 
 void vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float minDepthBounds,
                          float maxDepthBounds) {
+	WGVK_STAT_CALL(vkCmdSetDepthBounds);
 	(void)commandBuffer;
 	(void)minDepthBounds;
 	(void)maxDepthBounds;
@@ -165,6 +235,7 @@ void vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float minDepthBounds,
 
 void vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer, uint32_t faceMask,
                                 uint32_t compareMask) {
+	WGVK_STAT_CALL(vkCmdSetStencilCompareMask);
 	(void)commandBuffer;
 	(void)faceMask;
 	(void)compareMask;
@@ -172,6 +243,7 @@ void vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer, uint32_t faceMask
 
 void vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer, uint32_t faceMask,
                               uint32_t writeMask) {
+	WGVK_STAT_CALL(vkCmdSetStencilWriteMask);
 	(void)commandBuffer;
 	(void)faceMask;
 	(void)writeMask;
@@ -179,10 +251,16 @@ void vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer, uint32_t faceMask,
 
 void vkCmdSetStencilReference(VkCommandBuffer commandBuffer, uint32_t faceMask,
                               uint32_t reference) {
-	if (!commandBuffer || !commandBuffer->wgpu_render_pass) {
+	WGVK_STAT_CALL(vkCmdSetStencilReference);
+	if (!commandBuffer) {
 		return;
 	}
 
+	// WebGPU has one reference for both faces
 	(void)faceMask;
-	wgpuRenderPassEncoderSetStencilReference(commandBuffer->wgpu_render_pass, reference);
+	commandBuffer->stencil_reference = reference;
+	commandBuffer->dynamic_state_set |= WGVK_DYNAMIC_STENCIL_REFERENCE;
+	if (commandBuffer->wgpu_render_pass) {
+		wgpuRenderPassEncoderSetStencilReference(commandBuffer->wgpu_render_pass, reference);
+	}
 }
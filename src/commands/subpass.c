@@ -1,37 +1,416 @@
 #include "subpass.h"
 #include <string.h>
+#include "../util/log.h"
 
-void wgvk_subpass_analyze(VkRenderPass renderPass, WgvkRenderPassInfo *info) {
-	if (!renderPass || !info)
+static WGPULoadOp translate_load_op(uint32_t op) {
+	switch (op) {
+	case VK_ATTACHMENT_LOAD_OP_LOAD:
+	case VK_ATTACHMENT_LOAD_OP_NONE:
+		return WGPULoadOp_Load;
+	default:
+		// WebGPU has no don't-care load; clearing avoids reading the old
+		// contents back into tile memory.
+		return WGPULoadOp_Clear;
+	}
+}
+
+static WGPUStoreOp translate_store_op(uint32_t op) {
+	return op == VK_ATTACHMENT_STORE_OP_DONT_CARE ? WGPUStoreOp_Discard : WGPUStoreOp_Store;
+}
+
+/* Transient attachments never outlive the render pass that uses them, so
+ * there is nothing to load before it and nothing to keep after it. */
+static void discard_transient(VkImageView view, VkBool32 first, VkBool32 last, WGPULoadOp *load,
+                              WGPUStoreOp *store) {
+	if (!view->image || !(view->image->usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
 		return;
+	if (first && *load == WGPULoadOp_Load)
+		*load = WGPULoadOp_Clear;
+	if (last)
+		*store = WGPUStoreOp_Discard;
+}
 
-	memset(info, 0, sizeof(*info));
-	info->subpass_count = 1;
-	info->subpasses[0].subpass_index = 0;
-	info->subpasses[0].color_attachment_count = renderPass->attachment_count;
-	for (uint32_t i = 0; i < renderPass->attachment_count && i < 8; i++) {
-		info->subpasses[0].color_attachments[i] = i;
+static WGPUColor translate_clear_color(uint32_t format, const VkClearColorValue *value) {
+	switch (format) {
+	case VK_FORMAT_R8_UINT:
+	case VK_FORMAT_R8G8_UINT:
+	case VK_FORMAT_R8G8B8A8_UINT:
+	case VK_FORMAT_B8G8R8A8_UINT:
+	case VK_FORMAT_R16_UINT:
+	case VK_FORMAT_R16G16_UINT:
+	case VK_FORMAT_R16G16B16A16_UINT:
+	case VK_FORMAT_R32_UINT:
+	case VK_FORMAT_R32G32_UINT:
+	case VK_FORMAT_R32G32B32A32_UINT:
+		return (WGPUColor){value->uint32[0], value->uint32[1], value->uint32[2], value->uint32[3]};
+	case VK_FORMAT_R8_SINT:
+	case VK_FORMAT_R8G8_SINT:
+	case VK_FORMAT_R8G8B8A8_SINT:
+	case VK_FORMAT_B8G8R8A8_SINT:
+	case VK_FORMAT_R16_SINT:
+	case VK_FORMAT_R16G16_SINT:
+	case VK_FORMAT_R16G16B16A16_SINT:
+	case VK_FORMAT_R32_SINT:
+	case VK_FORMAT_R32G32_SINT:
+	case VK_FORMAT_R32G32B32A32_SINT:
+		return (WGPUColor){value->int32[0], value->int32[1], value->int32[2], value->int32[3]};
+	default:
+		return (WGPUColor){value->float32[0], value->float32[1], value->float32[2],
+		                   value->float32[3]};
+	}
+}
+
+static uint32_t read_reference(const VkAttachmentReference *ref, uint32_t attachment_count) {
+	if (!ref || ref->attachment >= attachment_count) {
+		return VK_ATTACHMENT_UNUSED;
+	}
+	return ref->attachment;
+}
+
+/* Without subpass descriptions every color attachment is written by a
+ * single subpass, which is what the render pass used to assume. */
+static void synthesize_single_subpass(VkRenderPass renderPass, WgvkSubpassInfo *sp) {
+	for (uint32_t i = 0; i < renderPass->attachment_count; i++) {
+		if (i == renderPass->depth_stencil_index) {
+			sp->depth_stencil_attachment = i;
+			sp->has_depth_stencil = VK_TRUE;
+		} else if (sp->color_attachment_count < WGVK_MAX_COLOR_ATTACHMENTS) {
+			sp->resolve_attachments[sp->color_attachment_count] = VK_ATTACHMENT_UNUSED;
+			sp->color_attachments[sp->color_attachment_count++] = i;
+		}
+	}
+}
+
+static VkBool32 same_attachments(const WgvkSubpassInfo *a, const WgvkSubpassInfo *b) {
+	if (a->color_attachment_count != b->color_attachment_count ||
+	    a->has_depth_stencil != b->has_depth_stencil ||
+	    (a->has_depth_stencil && a->depth_stencil_attachment != b->depth_stencil_attachment)) {
+		return VK_FALSE;
+	}
+	for (uint32_t i = 0; i < a->color_attachment_count; i++) {
+		if (a->color_attachments[i] != b->color_attachments[i] ||
+		    a->resolve_attachments[i] != b->resolve_attachments[i]) {
+			return VK_FALSE;
+		}
 	}
+	return VK_TRUE;
+}
+
+/* Attachment writes are ordered within a WebGPU pass, but shader writes to
+ * other resources are only visible after a pass boundary. */
+static VkBool32 needs_pass_break(const VkRenderPassCreateInfo *create_info,
+                                 const WgvkRenderPassInfo *info, uint32_t subpass) {
+	uint32_t pass = info->subpasses[subpass - 1].pass_index;
+	for (uint32_t i = 0; i < create_info->dependencyCount; i++) {
+		const VkSubpassDependency *dep = &create_info->pDependencies[i];
+		if (dep->dstSubpass != subpass || dep->srcSubpass >= subpass) {
+			continue;
+		}
+		if (info->subpasses[dep->srcSubpass].pass_index == pass &&
+		    (dep->srcAccessMask & VK_ACCESS_SHADER_WRITE_BIT)) {
+			return VK_TRUE;
+		}
+	}
+	return VK_FALSE;
+}
+
+static void note_use(WgvkRenderPassInfo *info, uint32_t attachment, uint32_t pass) {
+	if (attachment == VK_ATTACHMENT_UNUSED) {
+		return;
+	}
+	if (info->attachment_first_pass[attachment] == UINT32_MAX) {
+		info->attachment_first_pass[attachment] = pass;
+	}
+	info->attachment_last_pass[attachment] = pass;
+}
+
+VkResult wgvk_subpass_analyze(const VkRenderPassCreateInfo *create_info, VkRenderPass renderPass,
+                              WgvkRenderPassInfo *info) {
+	if (!renderPass || !info)
+		return VK_ERROR_INITIALIZATION_FAILED;
+
+	memset(info, 0, sizeof(*info));
 	info->attachment_count = renderPass->attachment_count;
-	for (uint32_t i = 0; i < renderPass->attachment_count && i < 16; i++) {
-		info->attachment_formats[i] = (WGPUTextureFormat)renderPass->color_formats[i];
+
+	if (create_info && create_info->subpassCount > 0 && create_info->pSubpasses) {
+		if (create_info->subpassCount > WGVK_MAX_SUBPASSES) {
+			WGVK_ERROR(WGVK_LOG_CAT_COMMAND,
+			           "vkCreateRenderPass: %u subpasses, at most %u supported",
+			           create_info->subpassCount, WGVK_MAX_SUBPASSES);
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		info->subpass_count = create_info->subpassCount;
+		for (uint32_t s = 0; s < info->subpass_count; s++) {
+			const VkSubpassDescription *desc = &create_info->pSubpasses[s];
+			WgvkSubpassInfo *sp = &info->subpasses[s];
+
+			if (desc->colorAttachmentCount > WGVK_MAX_COLOR_ATTACHMENTS ||
+			    desc->inputAttachmentCount > 8) {
+				WGVK_ERROR(WGVK_LOG_CAT_COMMAND,
+				           "vkCreateRenderPass: subpass %u uses too many attachments", s);
+				return VK_ERROR_INITIALIZATION_FAILED;
+			}
+
+			sp->subpass_index = s;
+			sp->color_attachment_count = desc->colorAttachmentCount;
+			for (uint32_t i = 0; i < desc->colorAttachmentCount; i++) {
+				sp->color_attachments[i] =
+				    read_reference(&desc->pColorAttachments[i], info->attachment_count);
+				sp->resolve_attachments[i] =
+				    desc->pResolveAttachments
+				        ? read_reference(&desc->pResolveAttachments[i], info->attachment_count)
+				        : VK_ATTACHMENT_UNUSED;
+			}
+			sp->input_attachment_count = desc->inputAttachmentCount;
+			for (uint32_t i = 0; i < desc->inputAttachmentCount; i++) {
+				sp->input_attachments[i] =
+				    read_reference(&desc->pInputAttachments[i], info->attachment_count);
+			}
+			sp->depth_stencil_attachment =
+			    read_reference(desc->pDepthStencilAttachment, info->attachment_count);
+			sp->has_depth_stencil = sp->depth_stencil_attachment != VK_ATTACHMENT_UNUSED;
+		}
+	} else {
+		info->subpass_count = 1;
+		synthesize_single_subpass(renderPass, &info->subpasses[0]);
+	}
+
+	// Group subpasses into WebGPU passes. Input attachment reads need the
+	// previous pass's attachment writes to have landed.
+	info->pass_count = 1;
+	for (uint32_t s = 1; s < info->subpass_count; s++) {
+		WgvkSubpassInfo *sp = &info->subpasses[s];
+		const WgvkSubpassInfo *prev = &info->subpasses[s - 1];
+
+		sp->merged = same_attachments(prev, sp) && sp->input_attachment_count == 0 &&
+		             !(create_info && needs_pass_break(create_info, info, s));
+		sp->pass_index = sp->merged ? prev->pass_index : prev->pass_index + 1;
+		if (!sp->merged) {
+			info->pass_count++;
+		}
+	}
+
+	// Load ops apply only on an attachment's first pass and store ops only
+	// on its last; between passes the contents must survive.
+	for (uint32_t i = 0; i < info->attachment_count; i++) {
+		info->attachment_first_pass[i] = UINT32_MAX;
+		info->attachment_last_pass[i] = UINT32_MAX;
+	}
+	for (uint32_t s = 0; s < info->subpass_count; s++) {
+		const WgvkSubpassInfo *sp = &info->subpasses[s];
+		for (uint32_t i = 0; i < sp->input_attachment_count; i++) {
+			note_use(info, sp->input_attachments[i], sp->pass_index);
+		}
+		for (uint32_t i = 0; i < sp->color_attachment_count; i++) {
+			note_use(info, sp->color_attachments[i], sp->pass_index);
+			note_use(info, sp->resolve_attachments[i], sp->pass_index);
+		}
+		if (sp->has_depth_stencil) {
+			note_use(info, sp->depth_stencil_attachment, sp->pass_index);
+		}
+	}
+
+	return VK_SUCCESS;
+}
+
+WGPURenderPassEncoder wgvk_subpass_begin(WGPUCommandEncoder encoder, VkRenderPass renderPass,
+                                         VkFramebuffer framebuffer, uint32_t subpass,
+                                         const VkClearValue *clear_values,
+                                         uint32_t clear_value_count) {
+	const WgvkRenderPassInfo *info = renderPass->subpass_info;
+	const WgvkSubpassInfo *sp = &info->subpasses[subpass];
+	uint32_t pass = sp->pass_index;
+
+	WGPURenderPassColorAttachment color_attachments[WGVK_MAX_COLOR_ATTACHMENTS] = {0};
+	WGPURenderPassDepthStencilAttachment depth_attachment = {0};
+	WGPURenderPassDescriptor desc = {
+	    .colorAttachmentCount = sp->color_attachment_count,
+	    .colorAttachments = color_attachments,
+	};
+
+	// pClearValues is indexed by attachment number; entries for attachments
+	// that are not cleared may be absent.
+	for (uint32_t c = 0; c < sp->color_attachment_count; c++) {
+		WGPURenderPassColorAttachment *color = &color_attachments[c];
+		uint32_t att = sp->color_attachments[c];
+		color->depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+
+		// Unused slots keep a NULL view, which WebGPU treats as sparse
+		if (att == VK_ATTACHMENT_UNUSED || att >= framebuffer->attachment_count ||
+		    !framebuffer->attachments[att]) {
+			continue;
+		}
+
+		const WgvkAttachmentInfo *ai = &renderPass->attachments[att];
+		color->view = framebuffer->attachments[att]->wgpu_view;
+		color->loadOp = info->attachment_first_pass[att] == pass ? translate_load_op(ai->load_op)
+		                                                         : WGPULoadOp_Load;
+		color->storeOp = info->attachment_last_pass[att] == pass
+		                     ? translate_store_op(ai->store_op)
+		                     : WGPUStoreOp_Store;
+		color->clearValue = att < clear_value_count && clear_values
+		                        ? translate_clear_color(ai->format, &clear_values[att].color)
+		                        : (WGPUColor){0.0f, 0.0f, 0.0f, 1.0f};
+		discard_transient(framebuffer->attachments[att], info->attachment_first_pass[att] == pass,
+		                  info->attachment_last_pass[att] == pass, &color->loadOp,
+		                  &color->storeOp);
+
+		// Multisampled attachments resolve when the WebGPU pass ends
+		uint32_t resolve = sp->resolve_attachments[c];
+		if (resolve != VK_ATTACHMENT_UNUSED && resolve < framebuffer->attachment_count &&
+		    framebuffer->attachments[resolve]) {
+			color->resolveTarget = framebuffer->attachments[resolve]->wgpu_view;
+		}
+	}
+
+	uint32_t att = sp->depth_stencil_attachment;
+	if (sp->has_depth_stencil && att < framebuffer->attachment_count &&
+	    framebuffer->attachments[att]) {
+		const WgvkAttachmentInfo *ai = &renderPass->attachments[att];
+		VkBool32 first = info->attachment_first_pass[att] == pass;
+		VkBool32 last = info->attachment_last_pass[att] == pass;
+		const VkClearValue *clear =
+		    att < clear_value_count && clear_values ? &clear_values[att] : NULL;
+
+		depth_attachment.view = framebuffer->attachments[att]->wgpu_view;
+		// WebGPU rejects ops for an aspect the format does not have
+		if (wgvk_format_has_depth(ai->format)) {
+			depth_attachment.depthLoadOp = first ? translate_load_op(ai->load_op) : WGPULoadOp_Load;
+			depth_attachment.depthStoreOp =
+			    last ? translate_store_op(ai->store_op) : WGPUStoreOp_Store;
+			depth_attachment.depthClearValue = clear ? clear->depthStencil.depth : 1.0f;
+			discard_transient(framebuffer->attachments[att], first, last,
+			                  &depth_attachment.depthLoadOp, &depth_attachment.depthStoreOp);
+		}
+		if (wgvk_format_has_stencil(ai->format)) {
+			depth_attachment.stencilLoadOp =
+			    first ? translate_load_op(ai->stencil_load_op) : WGPULoadOp_Load;
+			depth_attachment.stencilStoreOp =
+			    last ? translate_store_op(ai->stencil_store_op) : WGPUStoreOp_Store;
+			depth_attachment.stencilClearValue = clear ? clear->depthStencil.stencil : 0;
+			discard_transient(framebuffer->attachments[att], first, last,
+			                  &depth_attachment.stencilLoadOp, &depth_attachment.stencilStoreOp);
+		}
+		desc.depthStencilAttachment = &depth_attachment;
+	}
+
+	return wgpuCommandEncoderBeginRenderPass(encoder, &desc);
+}
+
+/*
+ * A suspended instance continues in the next resumed one, so attachment
+ * contents carry across the WebGPU pass boundary: a resumed pass loads
+ * instead of clearing and a suspending pass stores instead of discarding.
+ */
+static void split_rendering_ops(VkRenderingFlags flags, VkImageView view, WGPULoadOp *load,
+                                WGPUStoreOp *store) {
+	VkBool32 resuming = (flags & VK_RENDERING_RESUMING_BIT) != 0;
+	VkBool32 suspending = (flags & VK_RENDERING_SUSPENDING_BIT) != 0;
+	if (resuming)
+		*load = WGPULoadOp_Load;
+	if (suspending)
+		*store = WGPUStoreOp_Store;
+	discard_transient(view, !resuming, !suspending, load, store);
+}
+
+static void translate_rendering_color(VkRenderingFlags flags, const VkRenderingAttachmentInfo *info,
+                                      WGPURenderPassColorAttachment *color) {
+	color->depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+	if (!info->imageView) {
+		return;
+	}
+
+	color->view = info->imageView->wgpu_view;
+	color->loadOp = translate_load_op(info->loadOp);
+	color->storeOp = translate_store_op(info->storeOp);
+	color->clearValue = translate_clear_color(info->imageView->format, &info->clearValue.color);
+	split_rendering_ops(flags, info->imageView, &color->loadOp, &color->storeOp);
+
+	// WebGPU resolves color by averaging, which every Vulkan resolve mode
+	// for float formats matches closely enough. A suspended instance
+	// resolves only when its last resumed part ends.
+	if (info->resolveMode != VK_RESOLVE_MODE_NONE && info->resolveImageView &&
+	    !(flags & VK_RENDERING_SUSPENDING_BIT)) {
+		color->resolveTarget = info->resolveImageView->wgpu_view;
 	}
 }
 
-void wgvk_subpass_begin(WGPUCommandEncoder encoder, VkRenderPass renderPass,
-                        VkFramebuffer framebuffer, uint32_t subpass) {
-	(void)encoder;
-	(void)renderPass;
-	(void)framebuffer;
-	(void)subpass;
+WGPURenderPassEncoder wgvk_rendering_begin(WGPUCommandEncoder encoder,
+                                           const VkRenderingInfo *rendering_info) {
+	WGPURenderPassColorAttachment color_attachments[WGVK_MAX_COLOR_ATTACHMENTS] = {0};
+	WGPURenderPassDepthStencilAttachment depth_attachment = {0};
+	uint32_t color_count = rendering_info->pColorAttachments
+	                           ? rendering_info->colorAttachmentCount
+	                           : 0;
+	if (color_count > WGVK_MAX_COLOR_ATTACHMENTS) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND, "vkCmdBeginRendering: %u color attachments, limit is %d",
+		          color_count, WGVK_MAX_COLOR_ATTACHMENTS);
+		color_count = WGVK_MAX_COLOR_ATTACHMENTS;
+	}
+
+	WGPURenderPassDescriptor desc = {
+	    .colorAttachmentCount = color_count,
+	    .colorAttachments = color_attachments,
+	};
+	for (uint32_t c = 0; c < color_count; c++) {
+		translate_rendering_color(rendering_info->flags, &rendering_info->pColorAttachments[c],
+		                          &color_attachments[c]);
+	}
+
+	// Depth and stencil are separate attachments in Vulkan but must name
+	// the same view in WebGPU.
+	const VkRenderingAttachmentInfo *depth = rendering_info->pDepthAttachment;
+	const VkRenderingAttachmentInfo *stencil = rendering_info->pStencilAttachment;
+	if (depth && !depth->imageView)
+		depth = NULL;
+	if (stencil && !stencil->imageView)
+		stencil = NULL;
+	if (depth && stencil && depth->imageView->wgpu_view != stencil->imageView->wgpu_view) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND,
+		          "vkCmdBeginRendering: separate depth and stencil views unsupported");
+		stencil = NULL;
+	}
+
+	VkImageView ds_view = depth ? depth->imageView : stencil ? stencil->imageView : NULL;
+	if (ds_view) {
+		depth_attachment.view = ds_view->wgpu_view;
+		// An aspect without an attachment is not rendered to, so its
+		// contents are kept as they are.
+		if (wgvk_format_has_depth(ds_view->format)) {
+			depth_attachment.depthLoadOp =
+			    depth ? translate_load_op(depth->loadOp) : WGPULoadOp_Load;
+			depth_attachment.depthStoreOp =
+			    depth ? translate_store_op(depth->storeOp) : WGPUStoreOp_Store;
+			depth_attachment.depthClearValue = depth ? depth->clearValue.depthStencil.depth : 1.0f;
+			split_rendering_ops(rendering_info->flags, ds_view, &depth_attachment.depthLoadOp,
+			                    &depth_attachment.depthStoreOp);
+		}
+		if (wgvk_format_has_stencil(ds_view->format)) {
+			depth_attachment.stencilLoadOp =
+			    stencil ? translate_load_op(stencil->loadOp) : WGPULoadOp_Load;
+			depth_attachment.stencilStoreOp =
+			    stencil ? translate_store_op(stencil->storeOp) : WGPUStoreOp_Store;
+			depth_attachment.stencilClearValue =
+			    stencil ? stencil->clearValue.depthStencil.stencil : 0;
+			split_rendering_ops(rendering_info->flags, ds_view, &depth_attachment.stencilLoadOp,
+			                    &depth_attachment.stencilStoreOp);
+		}
+		desc.depthStencilAttachment = &depth_attachment;
+	}
+
+	return wgpuCommandEncoderBeginRenderPass(encoder, &desc);
 }
 
-void wgvk_subpass_end(WGPUCommandEncoder encoder) {
-	(void)encoder;
+void wgvk_subpass_end(WGPURenderPassEncoder pass) {
+	if (pass) {
+		wgpuRenderPassEncoderEnd(pass);
+		wgpuRenderPassEncoderRelease(pass);
+	}
 }
 
 uint32_t wgvk_subpass_get_count(VkRenderPass renderPass) {
-	if (!renderPass)
+	if (!renderPass || !renderPass->subpass_info)
 		return 0;
-	return 1;
+	return renderPass->subpass_info->subpass_count;
 }
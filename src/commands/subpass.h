@@ -3,27 +3,44 @@
 
 #include "webvulkan_internal.h"
 
+#define WGVK_MAX_SUBPASSES 8
+
 typedef struct {
 	uint32_t subpass_index;
 	uint32_t input_attachment_count;
 	uint32_t input_attachments[8];
 	uint32_t color_attachment_count;
-	uint32_t color_attachments[8];
+	uint32_t color_attachments[8]; /* VK_ATTACHMENT_UNUSED allowed */
+	uint32_t resolve_attachments[8];
 	uint32_t depth_stencil_attachment;
 	VkBool32 has_depth_stencil;
+	uint32_t pass_index;       /* WebGPU render pass this subpass records into */
+	VkBool32 merged;           /* shares its pass with the previous subpass */
 } WgvkSubpassInfo;
 
-typedef struct {
+/* Subpasses of a VkRenderPass grouped into WebGPU render passes. A WebGPU
+ * pass boundary is the only synchronization WebGPU offers inside a command
+ * encoder, so every subpass starts a new pass unless it can be merged. */
+struct WgvkRenderPassInfo {
 	uint32_t subpass_count;
-	WgvkSubpassInfo subpasses[8];
+	WgvkSubpassInfo subpasses[WGVK_MAX_SUBPASSES];
+	uint32_t pass_count;
 	uint32_t attachment_count;
-	WGPUTextureFormat attachment_formats[16];
-} WgvkRenderPassInfo;
+	uint32_t attachment_first_pass[WGVK_MAX_COLOR_ATTACHMENTS + 1];
+	uint32_t attachment_last_pass[WGVK_MAX_COLOR_ATTACHMENTS + 1];
+};
+typedef struct WgvkRenderPassInfo WgvkRenderPassInfo;
 
-void wgvk_subpass_analyze(VkRenderPass renderPass, WgvkRenderPassInfo *info);
-void wgvk_subpass_begin(WGPUCommandEncoder encoder, VkRenderPass renderPass,
-                        VkFramebuffer framebuffer, uint32_t subpass);
-void wgvk_subpass_end(WGPUCommandEncoder encoder);
+VkResult wgvk_subpass_analyze(const VkRenderPassCreateInfo *create_info, VkRenderPass renderPass,
+                              WgvkRenderPassInfo *info);
+WGPURenderPassEncoder wgvk_subpass_begin(WGPUCommandEncoder encoder, VkRenderPass renderPass,
+                                         VkFramebuffer framebuffer, uint32_t subpass,
+                                         const VkClearValue *clear_values,
+                                         uint32_t clear_value_count);
+/* Dynamic rendering: one WebGPU pass built straight from VkRenderingInfo. */
+WGPURenderPassEncoder wgvk_rendering_begin(WGPUCommandEncoder encoder,
+                                           const VkRenderingInfo *rendering_info);
+void wgvk_subpass_end(WGPURenderPassEncoder pass);
 uint32_t wgvk_subpass_get_count(VkRenderPass renderPass);
 
 #endif
@@ -1,6 +1,7 @@
 #include "webvulkan_internal.h"
 
 void vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkFlags stageMask) {
+	WGVK_STAT_CALL(vkCmdSetEvent);
 	(void)commandBuffer;
 	(void)event;
 	(void)stageMask;
@@ -10,6 +11,7 @@ void vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkFlags stageMa
 }
 
 void vkCmdResetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkFlags stageMask) {
+	WGVK_STAT_CALL(vkCmdResetEvent);
 	(void)commandBuffer;
 	(void)event;
 	(void)stageMask;
@@ -20,6 +22,7 @@ void vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const V
                      const void *pMemoryBarriers, uint32_t bufferMemoryBarrierCount,
                      const void *pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount,
                      const void *pImageMemoryBarriers) {
+	WGVK_STAT_CALL(vkCmdWaitEvents);
 	(void)commandBuffer;
 	(void)eventCount;
 	(void)pEvents;
@@ -0,0 +1,608 @@
+#include "transcode.h"
+#include "../util/log.h"
+
+/* WebGPU requires buffer rows of multi-row texture copies to be a multiple
+ * of this. */
+#define WGVK_TRANSCODE_ROW_ALIGNMENT 256
+#define WGVK_TRANSCODE_WORKGROUP_SIZE 8
+
+/* One invocation decodes one 4x4 block into 16 RGBA8 words of the staging
+ * buffer. Blocks are read in whole words; Vulkan already requires block
+ * aligned buffer offsets and pitches. ETC2 and EAC blocks are big-endian
+ * 64-bit values, so their words are byte-swapped into hi and lo halves.
+ * Snorm formats decode to RGBA8Snorm, the rest to RGBA8Unorm. */
+static const char transcode_wgsl[] =
+    "struct Params {\n"
+    "  src_offset: u32, src_pitch: u32, src_image_pitch: u32, dst_pitch: u32,\n"
+    "  dst_image_pitch: u32, blocks_x: u32, blocks_y: u32, pad: u32,\n"
+    "};\n"
+    "@group(0) @binding(0) var<storage, read> src: array<u32>;\n"
+    "@group(0) @binding(1) var<storage, read_write> dst: array<u32>;\n"
+    "@group(0) @binding(2) var<uniform> params: Params;\n"
+    "var<private> etc_modifiers: array<vec4<i32>, 8> = array<vec4<i32>, 8>(\n"
+    "  vec4<i32>(2, 8, -2, -8), vec4<i32>(5, 17, -5, -17), vec4<i32>(9, 29, -9, -29),\n"
+    "  vec4<i32>(13, 42, -13, -42), vec4<i32>(18, 60, -18, -60), vec4<i32>(24, 80, -24, -80),\n"
+    "  vec4<i32>(33, 106, -33, -106), vec4<i32>(47, 183, -47, -183));\n"
+    "var<private> etc_distances: array<i32, 8> = array<i32, 8>(3, 6, 11, 16, 23, 32, 41, 64);\n"
+    "var<private> eac_modifiers: array<array<i32, 8>, 16> = array<array<i32, 8>, 16>(\n"
+    "  array<i32, 8>(-3, -6, -9, -15, 2, 5, 8, 14), array<i32, 8>(-3, -7, -10, -13, 2, 6, 9, 12),\n"
+    "  array<i32, 8>(-2, -5, -8, -13, 1, 4, 7, 12), array<i32, 8>(-2, -4, -6, -13, 1, 3, 5, 12),\n"
+    "  array<i32, 8>(-3, -6, -8, -12, 2, 5, 7, 11), array<i32, 8>(-3, -7, -9, -11, 2, 6, 8, 10),\n"
+    "  array<i32, 8>(-4, -7, -8, -11, 3, 6, 7, 10), array<i32, 8>(-3, -5, -8, -11, 2, 4, 7, 10),\n"
+    "  array<i32, 8>(-2, -6, -8, -10, 1, 5, 7, 9), array<i32, 8>(-2, -5, -8, -10, 1, 4, 7, 9),\n"
+    "  array<i32, 8>(-2, -4, -8, -10, 1, 3, 7, 9), array<i32, 8>(-2, -5, -7, -10, 1, 4, 6, 9),\n"
+    "  array<i32, 8>(-3, -4, -7, -10, 2, 3, 6, 9), array<i32, 8>(-1, -2, -3, -10, 0, 1, 2, 9),\n"
+    "  array<i32, 8>(-4, -6, -8, -9, 3, 5, 7, 8), array<i32, 8>(-3, -5, -7, -9, 2, 4, 6, 8));\n"
+    "fn in_range(id: vec3<u32>) -> bool {\n"
+    "  return id.x < params.blocks_x && id.y < params.blocks_y;\n"
+    "}\n"
+    "fn block_word(id: vec3<u32>, size: u32, i: u32) -> u32 {\n"
+    "  let addr = params.src_offset + id.z * params.src_image_pitch + id.y * params.src_pitch +\n"
+    "             id.x * size;\n"
+    "  return src[(addr >> 2u) + i];\n"
+    "}\n"
+    "fn store_texel(id: vec3<u32>, i: u32, texel: u32) {\n"
+    "  let row = id.z * params.dst_image_pitch + (id.y * 4u + (i >> 2u)) * params.dst_pitch;\n"
+    "  dst[(row >> 2u) + id.x * 4u + (i & 3u)] = texel;\n"
+    "}\n"
+    "fn pack_unorm(c: vec4<u32>) -> u32 {\n"
+    "  return c.x | (c.y << 8u) | (c.z << 16u) | (c.w << 24u);\n"
+    "}\n"
+    "fn pack_snorm(c: vec4<i32>) -> u32 {\n"
+    "  return pack_unorm(bitcast<vec4<u32>>(c) & vec4<u32>(255u));\n"
+    "}\n"
+    "fn bits64(lo: u32, hi: u32, bit: u32, count: u32) -> u32 {\n"
+    "  var v: u32;\n"
+    "  if (bit >= 32u) { v = hi >> (bit - 32u); }\n"
+    "  else if (bit == 0u) { v = lo; }\n"
+    "  else { v = (lo >> bit) | (hi << (32u - bit)); }\n"
+    "  return v & ((1u << count) - 1u);\n"
+    "}\n"
+    "fn sext(v: u32, bits: u32) -> i32 {\n"
+    "  return bitcast<i32>(v << (32u - bits)) >> (32u - bits);\n"
+    "}\n"
+    "fn bswap(v: u32) -> u32 {\n"
+    "  return (v >> 24u) | ((v >> 8u) & 0xff00u) | ((v << 8u) & 0xff0000u) | (v << 24u);\n"
+    "}\n"
+    "fn expand(v: u32, bits: u32) -> u32 {\n"
+    "  return (v << (8u - bits)) | (v >> (2u * bits - 8u));\n"
+    "}\n"
+    "fn rgb565(c: u32) -> vec3<u32> {\n"
+    "  return vec3<u32>(expand(c >> 11u, 5u), expand((c >> 5u) & 63u, 6u), expand(c & 31u, 5u));\n"
+    "}\n"
+    "fn bc1_texel(w0: u32, w1: u32, i: u32, four_color: bool) -> vec4<u32> {\n"
+    "  let c0 = w0 & 0xffffu;\n"
+    "  let c1 = w0 >> 16u;\n"
+    "  let a = rgb565(c0);\n"
+    "  let b = rgb565(c1);\n"
+    "  let idx = (w1 >> (2u * i)) & 3u;\n"
+    "  if (idx == 0u) { return vec4<u32>(a, 255u); }\n"
+    "  if (idx == 1u) { return vec4<u32>(b, 255u); }\n"
+    "  if (four_color || c0 > c1) {\n"
+    "    if (idx == 2u) { return vec4<u32>((2u * a + b) / 3u, 255u); }\n"
+    "    return vec4<u32>((a + 2u * b) / 3u, 255u);\n"
+    "  }\n"
+    "  if (idx == 2u) { return vec4<u32>((a + b) / 2u, 255u); }\n"
+    "  return vec4<u32>(0u);\n"
+    "}\n"
+    "fn bc4_value(lo: u32, hi: u32, i: u32) -> u32 {\n"
+    "  let a0 = lo & 255u;\n"
+    "  let a1 = (lo >> 8u) & 255u;\n"
+    "  let idx = bits64(lo, hi, 16u + 3u * i, 3u);\n"
+    "  if (idx == 0u) { return a0; }\n"
+    "  if (idx == 1u) { return a1; }\n"
+    "  if (a0 > a1) { return ((8u - idx) * a0 + (idx - 1u) * a1) / 7u; }\n"
+    "  if (idx == 6u) { return 0u; }\n"
+    "  if (idx == 7u) { return 255u; }\n"
+    "  return ((6u - idx) * a0 + (idx - 1u) * a1) / 5u;\n"
+    "}\n"
+    "fn bc4_signed(lo: u32, hi: u32, i: u32) -> i32 {\n"
+    "  let a0 = max(sext(lo & 255u, 8u), -127);\n"
+    "  let a1 = max(sext((lo >> 8u) & 255u, 8u), -127);\n"
+    "  let idx = bits64(lo, hi, 16u + 3u * i, 3u);\n"
+    "  let k = i32(idx);\n"
+    "  if (idx == 0u) { return a0; }\n"
+    "  if (idx == 1u) { return a1; }\n"
+    "  if (a0 > a1) { return ((8 - k) * a0 + (k - 1) * a1) / 7; }\n"
+    "  if (idx == 6u) { return -127; }\n"
+    "  if (idx == 7u) { return 127; }\n"
+    "  return ((6 - k) * a0 + (k - 1) * a1) / 5;\n"
+    "}\n"
+    "fn etc_clamp(c: vec3<i32>) -> vec4<u32> {\n"
+    "  return vec4<u32>(vec3<u32>(clamp(c, vec3<i32>(0), vec3<i32>(255))), 255u);\n"
+    "}\n"
+    "fn etc2_texel(hi: u32, lo: u32, x: u32, y: u32, punchthrough: bool) -> vec4<u32> {\n"
+    "  let p = x * 4u + y;\n"
+    "  let idx = (((lo >> (16u + p)) & 1u) << 1u) | ((lo >> p) & 1u);\n"
+    "  let diff = (hi & 2u) != 0u;\n"
+    "  let transparent = punchthrough && !diff;\n"
+    "  let second = select(x, y, (hi & 1u) != 0u) >= 2u;\n"
+    "  let cw = select((hi >> 5u) & 7u, (hi >> 2u) & 7u, second);\n"
+    "  if (!punchthrough && !diff) {\n"
+    "    let s = select(28u, 24u, second);\n"
+    "    let c = vec3<u32>((hi >> s) & 15u, (hi >> (s - 8u)) & 15u, (hi >> (s - 16u)) & 15u);\n"
+    "    return etc_clamp(vec3<i32>(c * 17u) + vec3<i32>(etc_modifiers[cw][idx]));\n"
+    "  }\n"
+    "  let r = i32((hi >> 27u) & 31u) + sext((hi >> 24u) & 7u, 3u);\n"
+    "  let g = i32((hi >> 19u) & 31u) + sext((hi >> 16u) & 7u, 3u);\n"
+    "  let b = i32((hi >> 11u) & 31u) + sext((hi >> 8u) & 7u, 3u);\n"
+    "  let planar = r >= 0 && r <= 31 && g >= 0 && g <= 31 && (b < 0 || b > 31);\n"
+    "  if (transparent && idx == 2u && !planar) { return vec4<u32>(0u); }\n"
+    "  if (r < 0 || r > 31) {\n"
+    "    let c1 = vec3<u32>((((hi >> 27u) & 3u) << 2u) | ((hi >> 24u) & 3u), (hi >> 20u) & 15u,\n"
+    "                       (hi >> 16u) & 15u);\n"
+    "    let c2 = vec3<u32>((hi >> 12u) & 15u, (hi >> 8u) & 15u, (hi >> 4u) & 15u);\n"
+    "    let d = etc_distances[(((hi >> 2u) & 3u) << 1u) | (hi & 1u)];\n"
+    "    if (idx == 0u) { return etc_clamp(vec3<i32>(c1 * 17u)); }\n"
+    "    let m = select(select(-d, 0, idx == 2u), d, idx == 1u);\n"
+    "    return etc_clamp(vec3<i32>(c2 * 17u) + vec3<i32>(m));\n"
+    "  }\n"
+    "  if (g < 0 || g > 31) {\n"
+    "    let c1 = vec3<u32>((hi >> 27u) & 15u, (((hi >> 24u) & 7u) << 1u) | ((hi >> 20u) & 1u),\n"
+    "                       (((hi >> 19u) & 1u) << 3u) | ((hi >> 15u) & 7u));\n"
+    "    let c2 = vec3<u32>((hi >> 11u) & 15u, (hi >> 7u) & 15u, (hi >> 3u) & 15u);\n"
+    "    let v1 = (c1.x << 8u) | (c1.y << 4u) | c1.z;\n"
+    "    let v2 = (c2.x << 8u) | (c2.y << 4u) | c2.z;\n"
+    "    let order = select(0u, 1u, v1 >= v2);\n"
+    "    let d = etc_distances[(((hi >> 2u) & 1u) << 2u) | ((hi & 1u) << 1u) | order];\n"
+    "    let c = select(c1, c2, idx >= 2u) * 17u;\n"
+    "    return etc_clamp(vec3<i32>(c) + vec3<i32>(select(d, -d, (idx & 1u) != 0u)));\n"
+    "  }\n"
+    "  if (b < 0 || b > 31) {\n"
+    "    let o = vec3<i32>(vec3<u32>(\n"
+    "        expand((hi >> 25u) & 63u, 6u),\n"
+    "        expand((((hi >> 24u) & 1u) << 6u) | ((hi >> 17u) & 63u), 7u),\n"
+    "        expand((((hi >> 16u) & 1u) << 5u) | (((hi >> 11u) & 3u) << 3u) | ((hi >> 7u) & 7u),\n"
+    "               6u)));\n"
+    "    let h = vec3<i32>(vec3<u32>(\n"
+    "        expand((((hi >> 2u) & 31u) << 1u) | (hi & 1u), 6u), expand((lo >> 25u) & 127u, 7u),\n"
+    "        expand((((lo >> 24u) & 1u) << 5u) | ((lo >> 19u) & 31u), 6u)));\n"
+    "    let v = vec3<i32>(vec3<u32>(expand((lo >> 13u) & 63u, 6u),\n"
+    "                                expand((lo >> 6u) & 127u, 7u), expand(lo & 63u, 6u)));\n"
+    "    let c = i32(x) * (h - o) + i32(y) * (v - o) + 4 * o + vec3<i32>(2);\n"
+    "    return etc_clamp(c >> vec3<u32>(2u));\n"
+    "  }\n"
+    "  let c1 = vec3<i32>(vec3<u32>((hi >> 27u) & 31u, (hi >> 19u) & 31u, (hi >> 11u) & 31u));\n"
+    "  let c5 = select(c1, vec3<i32>(r, g, b), second);\n"
+    "  let base = (c5 << vec3<u32>(3u)) | (c5 >> vec3<u32>(2u));\n"
+    "  let m = select(etc_modifiers[cw][idx], 0, transparent && idx == 0u);\n"
+    "  return etc_clamp(base + vec3<i32>(m));\n"
+    "}\n"
+    "fn eac_modifier(hi: u32, lo: u32, x: u32, y: u32) -> i32 {\n"
+    "  let p = x * 4u + y;\n"
+    "  return eac_modifiers[(hi >> 16u) & 15u][bits64(lo, hi, 45u - 3u * p, 3u)];\n"
+    "}\n"
+    "fn eac_alpha(hi: u32, lo: u32, x: u32, y: u32) -> u32 {\n"
+    "  let v = i32(hi >> 24u) + eac_modifier(hi, lo, x, y) * i32((hi >> 20u) & 15u);\n"
+    "  return u32(clamp(v, 0, 255));\n"
+    "}\n"
+    "fn eac_r11(hi: u32, lo: u32, x: u32, y: u32) -> u32 {\n"
+    "  let mul = i32((hi >> 20u) & 15u);\n"
+    "  let m = eac_modifier(hi, lo, x, y);\n"
+    "  let v = clamp(i32(hi >> 24u) * 8 + 4 + select(m * mul * 8, m, mul == 0), 0, 2047);\n"
+    "  return u32(round(f32(v) * 255.0 / 2047.0));\n"
+    "}\n"
+    "fn eac_r11_signed(hi: u32, lo: u32, x: u32, y: u32) -> i32 {\n"
+    "  let mul = i32((hi >> 20u) & 15u);\n"
+    "  let m = eac_modifier(hi, lo, x, y);\n"
+    "  let base = max(sext(hi >> 24u, 8u), -127);\n"
+    "  let v = clamp(base * 8 + select(m * mul * 8, m, mul == 0), -1023, 1023);\n"
+    "  return i32(round(f32(v) * 127.0 / 1023.0));\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc1(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 8u, 0u);\n"
+    "  let w1 = block_word(id, 8u, 1u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    store_texel(id, i, pack_unorm(bc1_texel(w0, w1, i, false)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc2(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 16u, 0u);\n"
+    "  let w1 = block_word(id, 16u, 1u);\n"
+    "  let w2 = block_word(id, 16u, 2u);\n"
+    "  let w3 = block_word(id, 16u, 3u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let a = ((select(w1, w0, i < 8u) >> (4u * (i & 7u))) & 15u) * 17u;\n"
+    "    store_texel(id, i, pack_unorm(vec4<u32>(bc1_texel(w2, w3, i, true).xyz, a)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc3(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 16u, 0u);\n"
+    "  let w1 = block_word(id, 16u, 1u);\n"
+    "  let w2 = block_word(id, 16u, 2u);\n"
+    "  let w3 = block_word(id, 16u, 3u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let a = bc4_value(w0, w1, i);\n"
+    "    store_texel(id, i, pack_unorm(vec4<u32>(bc1_texel(w2, w3, i, true).xyz, a)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc4_unorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 8u, 0u);\n"
+    "  let w1 = block_word(id, 8u, 1u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    store_texel(id, i, pack_unorm(vec4<u32>(bc4_value(w0, w1, i), 0u, 0u, 255u)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc4_snorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 8u, 0u);\n"
+    "  let w1 = block_word(id, 8u, 1u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    store_texel(id, i, pack_snorm(vec4<i32>(bc4_signed(w0, w1, i), 0, 0, 127)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc5_unorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 16u, 0u);\n"
+    "  let w1 = block_word(id, 16u, 1u);\n"
+    "  let w2 = block_word(id, 16u, 2u);\n"
+    "  let w3 = block_word(id, 16u, 3u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let c = vec4<u32>(bc4_value(w0, w1, i), bc4_value(w2, w3, i), 0u, 255u);\n"
+    "    store_texel(id, i, pack_unorm(c));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_bc5_snorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let w0 = block_word(id, 16u, 0u);\n"
+    "  let w1 = block_word(id, 16u, 1u);\n"
+    "  let w2 = block_word(id, 16u, 2u);\n"
+    "  let w3 = block_word(id, 16u, 3u);\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let c = vec4<i32>(bc4_signed(w0, w1, i), bc4_signed(w2, w3, i), 0, 127);\n"
+    "    store_texel(id, i, pack_snorm(c));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_etc2_rgb8(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let hi = bswap(block_word(id, 8u, 0u));\n"
+    "  let lo = bswap(block_word(id, 8u, 1u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    store_texel(id, i, pack_unorm(etc2_texel(hi, lo, i & 3u, i >> 2u, false)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_etc2_rgb8a1(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let hi = bswap(block_word(id, 8u, 0u));\n"
+    "  let lo = bswap(block_word(id, 8u, 1u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    store_texel(id, i, pack_unorm(etc2_texel(hi, lo, i & 3u, i >> 2u, true)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_etc2_rgba8(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let ahi = bswap(block_word(id, 16u, 0u));\n"
+    "  let alo = bswap(block_word(id, 16u, 1u));\n"
+    "  let hi = bswap(block_word(id, 16u, 2u));\n"
+    "  let lo = bswap(block_word(id, 16u, 3u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let c = etc2_texel(hi, lo, i & 3u, i >> 2u, false);\n"
+    "    store_texel(id, i, pack_unorm(vec4<u32>(c.xyz, eac_alpha(ahi, alo, i & 3u, i >> 2u))));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_eac_r11_unorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let hi = bswap(block_word(id, 8u, 0u));\n"
+    "  let lo = bswap(block_word(id, 8u, 1u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let r = eac_r11(hi, lo, i & 3u, i >> 2u);\n"
+    "    store_texel(id, i, pack_unorm(vec4<u32>(r, 0u, 0u, 255u)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_eac_r11_snorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let hi = bswap(block_word(id, 8u, 0u));\n"
+    "  let lo = bswap(block_word(id, 8u, 1u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let r = eac_r11_signed(hi, lo, i & 3u, i >> 2u);\n"
+    "    store_texel(id, i, pack_snorm(vec4<i32>(r, 0, 0, 127)));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_eac_rg11_unorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let rhi = bswap(block_word(id, 16u, 0u));\n"
+    "  let rlo = bswap(block_word(id, 16u, 1u));\n"
+    "  let ghi = bswap(block_word(id, 16u, 2u));\n"
+    "  let glo = bswap(block_word(id, 16u, 3u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let x = i & 3u;\n"
+    "    let y = i >> 2u;\n"
+    "    let c = vec4<u32>(eac_r11(rhi, rlo, x, y), eac_r11(ghi, glo, x, y), 0u, 255u);\n"
+    "    store_texel(id, i, pack_unorm(c));\n"
+    "  }\n"
+    "}\n"
+    "@compute @workgroup_size(8, 8)\n"
+    "fn decode_eac_rg11_snorm(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+    "  if (!in_range(id)) { return; }\n"
+    "  let rhi = bswap(block_word(id, 16u, 0u));\n"
+    "  let rlo = bswap(block_word(id, 16u, 1u));\n"
+    "  let ghi = bswap(block_word(id, 16u, 2u));\n"
+    "  let glo = bswap(block_word(id, 16u, 3u));\n"
+    "  for (var i = 0u; i < 16u; i = i + 1u) {\n"
+    "    let x = i & 3u;\n"
+    "    let y = i >> 2u;\n"
+    "    let r = eac_r11_signed(rhi, rlo, x, y);\n"
+    "    let g = eac_r11_signed(ghi, glo, x, y);\n"
+    "    store_texel(id, i, pack_snorm(vec4<i32>(r, g, 0, 127)));\n"
+    "  }\n"
+    "}\n";
+
+/* Indexed by WgvkTranscodeCodec */
+static const char *const entry_points[WGVK_TRANSCODE_CODEC_COUNT] = {
+    "decode_bc1",
+    "decode_bc2",
+    "decode_bc3",
+    "decode_bc4_unorm",
+    "decode_bc4_snorm",
+    "decode_bc5_unorm",
+    "decode_bc5_snorm",
+    "decode_etc2_rgb8",
+    "decode_etc2_rgb8a1",
+    "decode_etc2_rgba8",
+    "decode_eac_r11_unorm",
+    "decode_eac_r11_snorm",
+    "decode_eac_rg11_unorm",
+    "decode_eac_rg11_snorm",
+};
+
+typedef struct {
+	uint32_t vk_format;
+	WgvkTranscodeCodec codec;
+	WGPUTextureFormat format; /* what the texture is created as */
+} WgvkTranscodeFormat;
+
+static const WgvkTranscodeFormat transcode_formats[] = {
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, WGVK_TRANSCODE_BC1, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, WGVK_TRANSCODE_BC1, WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_BC2_UNORM_BLOCK, WGVK_TRANSCODE_BC2, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_BC2_SRGB_BLOCK, WGVK_TRANSCODE_BC2, WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_BC3_UNORM_BLOCK, WGVK_TRANSCODE_BC3, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_BC3_SRGB_BLOCK, WGVK_TRANSCODE_BC3, WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_BC4_UNORM_BLOCK, WGVK_TRANSCODE_BC4_UNORM, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_BC4_SNORM_BLOCK, WGVK_TRANSCODE_BC4_SNORM, WGPUTextureFormat_RGBA8Snorm},
+    {VK_FORMAT_BC5_UNORM_BLOCK, WGVK_TRANSCODE_BC5_UNORM, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_BC5_SNORM_BLOCK, WGVK_TRANSCODE_BC5_SNORM, WGPUTextureFormat_RGBA8Snorm},
+    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, WGVK_TRANSCODE_ETC2_RGB8, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, WGVK_TRANSCODE_ETC2_RGB8,
+     WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK, WGVK_TRANSCODE_ETC2_RGB8A1,
+     WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, WGVK_TRANSCODE_ETC2_RGB8A1,
+     WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, WGVK_TRANSCODE_ETC2_RGBA8,
+     WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, WGVK_TRANSCODE_ETC2_RGBA8,
+     WGPUTextureFormat_RGBA8UnormSrgb},
+    {VK_FORMAT_EAC_R11_UNORM_BLOCK, WGVK_TRANSCODE_EAC_R11_UNORM, WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_EAC_R11_SNORM_BLOCK, WGVK_TRANSCODE_EAC_R11_SNORM, WGPUTextureFormat_RGBA8Snorm},
+    {VK_FORMAT_EAC_R11G11_UNORM_BLOCK, WGVK_TRANSCODE_EAC_RG11_UNORM,
+     WGPUTextureFormat_RGBA8Unorm},
+    {VK_FORMAT_EAC_R11G11_SNORM_BLOCK, WGVK_TRANSCODE_EAC_RG11_SNORM,
+     WGPUTextureFormat_RGBA8Snorm},
+};
+
+static const WgvkTranscodeFormat *find_format(uint32_t vk_format) {
+	for (uint32_t i = 0; i < sizeof(transcode_formats) / sizeof(transcode_formats[0]); i++) {
+		if (transcode_formats[i].vk_format == vk_format)
+			return &transcode_formats[i];
+	}
+	return NULL;
+}
+
+WGPUTextureFormat wgvk_transcode_format(uint32_t vk_format) {
+	const WgvkTranscodeFormat *entry = find_format(vk_format);
+	return entry ? entry->format : WGPUTextureFormat_Undefined;
+}
+
+static struct WgvkTranscodeState *get_transcode_state(VkDevice device) {
+	if (device->transcode_state) {
+		return device->transcode_state;
+	}
+
+	struct WgvkTranscodeState *state = wgvk_alloc(sizeof(struct WgvkTranscodeState));
+	if (!state) {
+		return NULL;
+	}
+	device->transcode_state = state;
+
+	WGPUShaderSourceWGSL wgsl_desc = {
+	    .chain = {.next = NULL, .sType = WGPUSType_ShaderSourceWGSL},
+	    .code = (WGPUStringView){.data = transcode_wgsl, .length = WGPU_STRLEN},
+	};
+	WGPUShaderModuleDescriptor shader_desc = {
+	    .nextInChain = (const WGPUChainedStruct *)&wgsl_desc,
+	};
+	state->shader = wgpuDeviceCreateShaderModule(device->wgpu_device, &shader_desc);
+
+	WGPUBindGroupLayoutEntry entries[3] = {
+	    {.binding = 0,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage}},
+	    {.binding = 1,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_Storage}},
+	    {.binding = 2,
+	     .visibility = WGPUShaderStage_Compute,
+	     .buffer = {.type = WGPUBufferBindingType_Uniform, .minBindingSize = 32}},
+	};
+	WGPUBindGroupLayoutDescriptor bgl_desc = {.entryCount = 3, .entries = entries};
+	state->bind_group_layout = wgpuDeviceCreateBindGroupLayout(device->wgpu_device, &bgl_desc);
+
+	WGPUPipelineLayoutDescriptor layout_desc = {
+	    .bindGroupLayoutCount = 1,
+	    .bindGroupLayouts = &state->bind_group_layout,
+	};
+	state->pipeline_layout = wgpuDeviceCreatePipelineLayout(device->wgpu_device, &layout_desc);
+	return state;
+}
+
+static WGPUComputePipeline get_transcode_pipeline(VkDevice device, WgvkTranscodeCodec codec) {
+	struct WgvkTranscodeState *state = get_transcode_state(device);
+	if (!state || !state->shader) {
+		return NULL;
+	}
+	if (state->pipelines[codec]) {
+		return state->pipelines[codec];
+	}
+
+	WGPUComputePipelineDescriptor desc = {
+	    .layout = state->pipeline_layout,
+	    .compute =
+	        {
+	            .module = state->shader,
+	            .entryPoint = (WGPUStringView){.data = entry_points[codec], .length = WGPU_STRLEN},
+	        },
+	};
+	state->pipelines[codec] = wgpuDeviceCreateComputePipeline(device->wgpu_device, &desc);
+	return state->pipelines[codec];
+}
+
+void wgvk_transcode_copy(VkCommandBuffer cmd, VkBuffer src, VkImage dst,
+                         const VkBufferImageCopy *region) {
+	VkDevice device = cmd->device;
+	const WgvkTranscodeFormat *entry = find_format(dst->format);
+	WGPUComputePipeline pipeline = entry ? get_transcode_pipeline(device, entry->codec) : NULL;
+	if (!pipeline) {
+		WGVK_WARN(WGVK_LOG_CAT_COMMAND, "no decoder for compressed format %u", dst->format);
+		return;
+	}
+
+	// Every transcoded format has 4x4 blocks
+	WgvkFormatBlock block = wgvk_format_block(dst->format, VK_IMAGE_ASPECT_COLOR_BIT);
+	uint32_t row_length =
+	    region->bufferRowLength ? region->bufferRowLength : region->imageExtent.width;
+	uint32_t image_height =
+	    region->bufferImageHeight ? region->bufferImageHeight : region->imageExtent.height;
+	uint32_t blocks_x = wgvk_div_round_up(region->imageExtent.width, block.block_width);
+	uint32_t blocks_y = wgvk_div_round_up(region->imageExtent.height, block.block_height);
+	uint32_t images = dst->image_type == VK_IMAGE_TYPE_3D ? region->imageExtent.depth
+	                                                      : region->imageSubresource.layerCount;
+	if (blocks_x == 0 || blocks_y == 0 || images == 0) {
+		return;
+	}
+
+	uint32_t src_pitch = wgvk_div_round_up(row_length, block.block_width) * block.block_size;
+	uint32_t src_image_pitch = src_pitch * wgvk_div_round_up(image_height, block.block_height);
+	uint64_t dst_pitch = wgvk_align_up((uint64_t)blocks_x * block.block_width * 4,
+	                                   WGVK_TRANSCODE_ROW_ALIGNMENT);
+	uint32_t dst_rows = blocks_y * block.block_height;
+	uint64_t staging_size = dst_pitch * dst_rows * images;
+
+	WGPUBufferDescriptor staging_desc = {
+	    .label = (WGPUStringView){.data = "TranscodeStaging", .length = WGPU_STRLEN},
+	    .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc,
+	    .size = staging_size,
+	};
+	WGPUBuffer staging = wgpuDeviceCreateBuffer(device->wgpu_device, &staging_desc);
+	if (!staging) {
+		return;
+	}
+
+	uint32_t params[8] = {(uint32_t)region->bufferOffset,
+	                      src_pitch,
+	                      src_image_pitch,
+	                      (uint32_t)dst_pitch,
+	                      (uint32_t)(dst_pitch * dst_rows),
+	                      blocks_x,
+	                      blocks_y,
+	                      0};
+	WGPUBufferDescriptor params_desc = {
+	    .label = (WGPUStringView){.data = "TranscodeParams", .length = WGPU_STRLEN},
+	    .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+	    .size = sizeof(params),
+	};
+	WGPUBuffer params_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &params_desc);
+	if (!params_buffer) {
+		wgpuBufferRelease(staging);
+		return;
+	}
+	// The buffer is new, so writing it ahead of submission is safe
+	wgpuQueueWriteBuffer(device->wgpu_queue, params_buffer, 0, params, sizeof(params));
+
+	WGPUBindGroupEntry entries[3] = {
+	    {.binding = 0, .buffer = src->wgpu_buffer, .offset = 0, .size = src->size & ~(uint64_t)3},
+	    {.binding = 1, .buffer = staging, .offset = 0, .size = staging_size},
+	    {.binding = 2, .buffer = params_buffer, .offset = 0, .size = sizeof(params)},
+	};
+	WGPUBindGroupDescriptor bg_desc = {
+	    .layout = device->transcode_state->bind_group_layout,
+	    .entryCount = 3,
+	    .entries = entries,
+	};
+	WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(device->wgpu_device, &bg_desc);
+
+	WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(cmd->wgpu_encoder, NULL);
+	wgpuComputePassEncoderSetPipeline(pass, pipeline);
+	wgpuComputePassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
+	wgpuComputePassEncoderDispatchWorkgroups(
+	    pass, wgvk_div_round_up(blocks_x, WGVK_TRANSCODE_WORKGROUP_SIZE),
+	    wgvk_div_round_up(blocks_y, WGVK_TRANSCODE_WORKGROUP_SIZE), images);
+	wgpuComputePassEncoderEnd(pass);
+	wgpuComputePassEncoderRelease(pass);
+
+	// Partial edge blocks decode whole, but only the region's texels land
+	WGPUTexelCopyBufferInfo copy_src = {
+	    .layout = {.offset = 0, .bytesPerRow = (uint32_t)dst_pitch, .rowsPerImage = dst_rows},
+	    .buffer = staging,
+	};
+	WGPUTexelCopyTextureInfo copy_dst = {
+	    .texture = dst->wgpu_texture,
+	    .mipLevel = region->imageSubresource.mipLevel,
+	    .origin =
+	        {
+	            .x = (uint32_t)region->imageOffset.x,
+	            .y = (uint32_t)region->imageOffset.y,
+	            .z = dst->image_type == VK_IMAGE_TYPE_3D ? (uint32_t)region->imageOffset.z
+	                                                     : region->imageSubresource.baseArrayLayer,
+	        },
+	    .aspect = WGPUTextureAspect_All,
+	};
+	WGPUExtent3D size = {
+	    .width = region->imageExtent.width,
+	    .height = region->imageExtent.height,
+	    .depthOrArrayLayers = images,
+	};
+	wgpuCommandEncoderCopyBufferToTexture(cmd->wgpu_encoder, &copy_src, &copy_dst, &size);
+
+	if (bind_group)
+		wgpuBindGroupRelease(bind_group);
+	wgpuBufferRelease(params_buffer);
+	wgpuBufferRelease(staging);
+}
+
+void wgvk_transcode_cleanup(VkDevice device) {
+	struct WgvkTranscodeState *state = device ? device->transcode_state : NULL;
+	if (!state) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < WGVK_TRANSCODE_CODEC_COUNT; i++) {
+		if (state->pipelines[i])
+			wgpuComputePipelineRelease(state->pipelines[i]);
+	}
+	if (state->pipeline_layout)
+		wgpuPipelineLayoutRelease(state->pipeline_layout);
+	if (state->bind_group_layout)
+		wgpuBindGroupLayoutRelease(state->bind_group_layout);
+	if (state->shader)
+		wgpuShaderModuleRelease(state->shader);
+	wgvk_free(state);
+	device->transcode_state = NULL;
+}
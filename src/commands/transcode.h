@@ -0,0 +1,45 @@
+#ifndef WGVK_TRANSCODE_H
+#define WGVK_TRANSCODE_H
+
+#include "webvulkan_internal.h"
+
+/* Block-compressed formats the device cannot sample are stored as RGBA8
+ * textures. Uploads run a compute pass that expands each 4x4 block into a
+ * staging buffer, which is then copied into the texture. */
+typedef enum WgvkTranscodeCodec {
+	WGVK_TRANSCODE_BC1,
+	WGVK_TRANSCODE_BC2,
+	WGVK_TRANSCODE_BC3,
+	WGVK_TRANSCODE_BC4_UNORM,
+	WGVK_TRANSCODE_BC4_SNORM,
+	WGVK_TRANSCODE_BC5_UNORM,
+	WGVK_TRANSCODE_BC5_SNORM,
+	WGVK_TRANSCODE_ETC2_RGB8,
+	WGVK_TRANSCODE_ETC2_RGB8A1,
+	WGVK_TRANSCODE_ETC2_RGBA8,
+	WGVK_TRANSCODE_EAC_R11_UNORM,
+	WGVK_TRANSCODE_EAC_R11_SNORM,
+	WGVK_TRANSCODE_EAC_RG11_UNORM,
+	WGVK_TRANSCODE_EAC_RG11_SNORM,
+	WGVK_TRANSCODE_CODEC_COUNT
+} WgvkTranscodeCodec;
+
+/* Per-device decoder objects, created on first transcoded upload. */
+struct WgvkTranscodeState {
+	WGPUShaderModule shader;
+	WGPUBindGroupLayout bind_group_layout;
+	WGPUPipelineLayout pipeline_layout;
+	WGPUComputePipeline pipelines[WGVK_TRANSCODE_CODEC_COUNT]; /* created per codec */
+};
+
+/* Uncompressed format a compressed format decodes to, or Undefined when
+ * there is no decoder for it (BC7 and ASTC). */
+WGPUTextureFormat wgvk_transcode_format(uint32_t vk_format);
+
+/* Decode one buffer-to-image copy region into a transcoded image. */
+void wgvk_transcode_copy(VkCommandBuffer cmd, VkBuffer src, VkImage dst,
+                         const VkBufferImageCopy *region);
+
+void wgvk_transcode_cleanup(VkDevice device);
+
+#endif
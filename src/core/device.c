@@ -1,70 +1,158 @@
 #include "webvulkan_internal.h"
+#include "../commands/blit.h"
+#include "../commands/transcode.h"
+#include "../util/log.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
+static void release_bind_group_layout(void *object) {
+	wgpuBindGroupLayoutRelease((WGPUBindGroupLayout)object);
+}
+
+static void release_pipeline_layout(void *object) {
+	wgpuPipelineLayoutRelease((WGPUPipelineLayout)object);
+}
+
+static void release_sampler(void *object) {
+	wgpuSamplerRelease((WGPUSampler)object);
+}
+
 static void destroy_device(void *obj) {
 	VkDevice device = (VkDevice)obj;
-#ifndef __EMSCRIPTEN__
+	if (device->queue) {
+		wgvk_object_release(&device->queue->base);
+	}
 	if (device->wgpu_device) {
 		wgpuDeviceRelease(device->wgpu_device);
 	}
-#endif
 	if (device->wgpu_queue) {
 		wgpuQueueRelease(device->wgpu_queue);
 	}
 	if (device->push_constant_buffer) {
 		wgpuBufferRelease(device->push_constant_buffer);
 	}
-	wgvk_free(device);
+	if (device->placeholder_buffer) {
+		wgpuBufferRelease(device->placeholder_buffer);
+	}
+	if (device->placeholder_sampler) {
+		wgpuSamplerRelease(device->placeholder_sampler);
+	}
+	for (uint32_t i = 0; i < WGVK_PLACEHOLDER_TEXTURE_COUNT; i++) {
+		if (device->placeholder_views[i]) {
+			wgpuTextureViewRelease(device->placeholder_views[i]);
+		}
+		if (device->placeholder_textures[i]) {
+			wgpuTextureRelease(device->placeholder_textures[i]);
+		}
+	}
+	wgvk_blit_cleanup(device);
+	wgvk_transcode_cleanup(device);
+	wgvk_texture_pool_destroy(&device->texture_pool);
+	if (device->repack_pipeline) {
+		wgpuComputePipelineRelease(device->repack_pipeline);
+	}
+	if (device->repack_layout) {
+		wgpuBindGroupLayoutRelease(device->repack_layout);
+	}
+	wgvk_cache_destroy(&device->sampler_cache);
+	wgvk_cache_destroy(&device->pipeline_layout_cache);
+	wgvk_cache_destroy(&device->bind_group_layout_cache);
+	wgvk_object_free(device);
+	/* With its children gone, the slabs they came from can go as well */
+	wgvk_object_pools_trim();
 }
 
 VkResult vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCreateInfo,
                         const VkAllocationCallbacks *pAllocator, VkDevice *pDevice) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateDevice);
 	(void)pCreateInfo;
 
 	if (!physicalDevice || !pDevice) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkDevice device = wgvk_alloc(sizeof(struct VkDevice_T));
+	VkDevice device = wgvk_object_alloc(sizeof(struct VkDevice_T), VK_OBJECT_TYPE_DEVICE,
+	                                    pAllocator, physicalDevice->instance->base.allocator);
 	if (!device) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&device->base, destroy_device);
+	wgvk_object_init(&device->base, VK_OBJECT_TYPE_DEVICE, destroy_device);
 	device->physical_device = physicalDevice;
 	device->wgpu_device = NULL;
 	device->wgpu_queue = NULL;
+	device->queue = NULL;
 	device->queue_family_index = 0;
 	device->push_constant_buffer = NULL;
+	device->placeholder_buffer = NULL;
+	device->placeholder_sampler = NULL;
+	for (uint32_t i = 0; i < WGVK_PLACEHOLDER_TEXTURE_COUNT; i++) {
+		device->placeholder_textures[i] = NULL;
+		device->placeholder_views[i] = NULL;
+	}
+	device->blit_state = NULL;
+	device->repack_pipeline = NULL;
+	device->repack_layout = NULL;
+	device->transient_attachments = VK_FALSE;
+	device->texture_compression_bc = VK_FALSE;
+	device->texture_compression_etc2 = VK_FALSE;
+	device->texture_compression_astc = VK_FALSE;
+	device->transcode_state = NULL;
+	wgvk_texture_pool_init(&device->texture_pool);
+	wgvk_cache_init(&device->bind_group_layout_cache, release_bind_group_layout);
+	wgvk_cache_init(&device->pipeline_layout_cache, release_pipeline_layout);
+	wgvk_cache_init(&device->sampler_cache, release_sampler);
 
 #ifdef __EMSCRIPTEN__
+	// Each call hands out a new reference to the page's device, which the
+	// VkDevice owns like a requested one
 	device->wgpu_device = emscripten_webgpu_get_device();
 	if (!device->wgpu_device) {
-		wgvk_free(device);
+		wgvk_object_free(device);
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 #else
 	if (physicalDevice->wgpu_adapter) {
+		// Optional features are enabled whenever the adapter has them
+		static const WGPUFeatureName optional_features[] = {
+		    WGPUFeatureName_TransientAttachments,
+		    WGPUFeatureName_TextureCompressionBC,
+		    WGPUFeatureName_TextureCompressionETC2,
+		    WGPUFeatureName_TextureCompressionASTC,
+		};
+		WGPUFeatureName features[sizeof(optional_features) / sizeof(optional_features[0])];
+		uint32_t feature_count = 0;
+		for (uint32_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+			if (wgvk_physical_device_has_feature(physicalDevice, optional_features[i]))
+				features[feature_count++] = optional_features[i];
+		}
+
 		WGPUDeviceDescriptor desc = WGPU_DEVICE_DESCRIPTOR_INIT;
+		desc.requiredFeatureCount = feature_count;
+		desc.requiredFeatures = features;
 		device->wgpu_device = wgpuAdapterRequestDeviceSync(physicalDevice->wgpu_adapter, &desc);
 	}
 	if (!device->wgpu_device) {
-		wgvk_free(device);
+		wgvk_object_free(device);
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 #endif
 
+	device->transient_attachments =
+	    wgpuDeviceHasFeature(device->wgpu_device, WGPUFeatureName_TransientAttachments);
+	device->texture_compression_bc =
+	    wgpuDeviceHasFeature(device->wgpu_device, WGPUFeatureName_TextureCompressionBC);
+	device->texture_compression_etc2 =
+	    wgpuDeviceHasFeature(device->wgpu_device, WGPUFeatureName_TextureCompressionETC2);
+	device->texture_compression_astc =
+	    wgpuDeviceHasFeature(device->wgpu_device, WGPUFeatureName_TextureCompressionASTC);
 	device->wgpu_queue = wgpuDeviceGetQueue(device->wgpu_device);
 
 	if (!device->wgpu_queue) {
-#ifndef __EMSCRIPTEN__
 		wgpuDeviceRelease(device->wgpu_device);
-#endif
-		wgvk_free(device);
+		wgvk_object_free(device);
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
@@ -72,7 +160,27 @@ VkResult vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInf
 	return VK_SUCCESS;
 }
 
+void wgvkSetTexturePool(VkDevice device, VkBool32 enable, uint32_t maxFrames) {
+	if (!device) {
+		return;
+	}
+	device->texture_pool.all_images = enable;
+	device->texture_pool.max_frames = maxFrames > 0 ? maxFrames : WGVK_TEXTURE_POOL_DEFAULT_FRAMES;
+	if (!enable) {
+		wgvk_texture_pool_trim(&device->texture_pool, 0);
+	}
+}
+
+void wgvkDeviceEndFrame(VkDevice device) {
+	if (!device) {
+		return;
+	}
+	wgvk_texture_pool_end_frame(&device->texture_pool, VK_TRUE);
+	wgvk_log_flush();
+}
+
 void vkDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyDevice);
 	(void)pAllocator;
 	if (device) {
 		wgvk_object_release(&device->base);
@@ -84,32 +192,40 @@ static void destroy_queue(void *obj) {
 	if (queue->wgpu_queue) {
 		wgpuQueueRelease(queue->wgpu_queue);
 	}
-	wgvk_free(queue);
+	wgvk_object_free(queue);
 }
 
 void vkGetDeviceQueue(VkDevice device, uint32_t queueFamilyIndex, uint32_t queueIndex,
                       VkQueue *pQueue) {
+	WGVK_STAT_CALL(vkGetDeviceQueue);
 	if (!device || !pQueue) {
 		return;
 	}
 
-	VkQueue queue = wgvk_alloc(sizeof(struct VkQueue_T));
-	if (!queue) {
-		*pQueue = NULL;
-		return;
+	// Queues belong to the device: every call returns the same handle, and
+	// vkDestroyDevice frees it
+	if (!device->queue) {
+		VkQueue queue = wgvk_object_alloc(sizeof(struct VkQueue_T), VK_OBJECT_TYPE_QUEUE, NULL,
+		                                  device->base.allocator);
+		if (!queue) {
+			*pQueue = NULL;
+			return;
+		}
+
+		wgvk_object_init(&queue->base, VK_OBJECT_TYPE_QUEUE, destroy_queue);
+		queue->device = device;
+		queue->wgpu_queue = device->wgpu_queue;
+		wgpuQueueAddRef(queue->wgpu_queue);
+		queue->queue_family_index = queueFamilyIndex;
+		queue->queue_index = queueIndex;
+		device->queue = queue;
 	}
 
-	wgvk_object_init(&queue->base, destroy_queue);
-	queue->device = device;
-	queue->wgpu_queue = device->wgpu_queue;
-	wgpuQueueAddRef(queue->wgpu_queue);
-	queue->queue_family_index = queueFamilyIndex;
-	queue->queue_index = queueIndex;
-
-	*pQueue = queue;
+	*pQueue = device->queue;
 }
 
 VkResult vkDeviceWaitIdle(VkDevice device) {
+	WGVK_STAT_CALL(vkDeviceWaitIdle);
 	(void)device;
 	/* WebGPU does not expose a synchronous CPU-GPU fence.  Work submission is
 	 * fully asynchronous; callers that need ordering must use semaphores or
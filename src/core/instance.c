@@ -8,7 +8,7 @@ static void destroy_physical_device(void *obj) {
 		wgpuAdapterRelease(phys_dev->wgpu_adapter);
 	}
 #endif
-	wgvk_free(phys_dev);
+	wgvk_object_free(phys_dev);
 }
 
 static void destroy_instance(void *obj) {
@@ -21,23 +21,24 @@ static void destroy_instance(void *obj) {
 	}
 	wgvk_free(instance->application_name);
 	wgvk_free(instance->engine_name);
-	wgvk_free(instance);
+	wgvk_object_free(instance);
 }
 
 VkResult vkCreateInstance(const VkInstanceCreateInfo *pCreateInfo,
                           const VkAllocationCallbacks *pAllocator, VkInstance *pInstance) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateInstance);
 
 	if (!pCreateInfo || !pInstance) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkInstance instance = wgvk_alloc(sizeof(struct VkInstance_T));
+	VkInstance instance =
+	    wgvk_object_alloc(sizeof(struct VkInstance_T), VK_OBJECT_TYPE_INSTANCE, pAllocator, NULL);
 	if (!instance) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&instance->base, destroy_instance);
+	wgvk_object_init(&instance->base, VK_OBJECT_TYPE_INSTANCE, destroy_instance);
 
 	instance->api_version = VK_API_VERSION_1_0;
 	instance->application_name = NULL;
@@ -61,7 +62,7 @@ VkResult vkCreateInstance(const VkInstanceCreateInfo *pCreateInfo,
 	if (!instance->wgpu_instance) {
 		wgvk_free(instance->application_name);
 		wgvk_free(instance->engine_name);
-		wgvk_free(instance);
+		wgvk_object_free(instance);
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
@@ -70,6 +71,7 @@ VkResult vkCreateInstance(const VkInstanceCreateInfo *pCreateInfo,
 }
 
 void vkDestroyInstance(VkInstance instance, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyInstance);
 	(void)pAllocator;
 	if (instance) {
 		wgvk_object_release(&instance->base);
@@ -78,6 +80,7 @@ void vkDestroyInstance(VkInstance instance, const VkAllocationCallbacks *pAlloca
 
 VkResult vkEnumeratePhysicalDevices(VkInstance instance, uint32_t *pPhysicalDeviceCount,
                                     VkPhysicalDevice *pPhysicalDevices) {
+	WGVK_STAT_CALL(vkEnumeratePhysicalDevices);
 	if (!instance || !pPhysicalDeviceCount) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
@@ -94,19 +97,20 @@ VkResult vkEnumeratePhysicalDevices(VkInstance instance, uint32_t *pPhysicalDevi
 	/* Return the cached physical device if already created.  Repeated calls
 	 * to vkEnumeratePhysicalDevices MUST return the same handle. */
 	if (!instance->phys_dev) {
-		VkPhysicalDevice phys_dev = wgvk_alloc(sizeof(struct VkPhysicalDevice_T));
+		VkPhysicalDevice phys_dev =
+		    wgvk_object_alloc(sizeof(struct VkPhysicalDevice_T), VK_OBJECT_TYPE_PHYSICAL_DEVICE,
+		                      NULL, instance->base.allocator);
 		if (!phys_dev) {
 			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
-		wgvk_object_init(&phys_dev->base, destroy_physical_device);
+		wgvk_object_init(&phys_dev->base, VK_OBJECT_TYPE_PHYSICAL_DEVICE, destroy_physical_device);
 		phys_dev->instance = instance;
 		phys_dev->wgpu_adapter = NULL;
 		phys_dev->api_version = instance->api_version;
 		instance->phys_dev = phys_dev;
 	}
 
-	/* Retain so the caller's copy keeps the object alive independently. */
-	wgvk_object_retain(&instance->phys_dev->base);
+	/* The instance owns the physical device; vkDestroyInstance frees it. */
 	pPhysicalDevices[0] = instance->phys_dev;
 	*pPhysicalDeviceCount = 1;
 
@@ -0,0 +1,76 @@
+#include "webvulkan_internal.h"
+#include "../util/log.h"
+
+uint64_t wgvk_hash_words(const uint32_t *key, uint32_t key_words) {
+	return wgvk_hash_bytes(key, key_words * sizeof(uint32_t));
+}
+
+void wgvk_cache_init(WgvkObjectCache *cache, void (*release)(void *object)) {
+	cache->table = NULL;
+	cache->release = release;
+	cache->entry_count = 0;
+}
+
+void wgvk_cache_destroy(WgvkObjectCache *cache) {
+	if (cache->entry_count > 0) {
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "%u cached objects still referenced at device destroy",
+		          cache->entry_count);
+	}
+	wgvk_hash_table_destroy(cache->table);
+	cache->table = NULL;
+}
+
+WgvkCacheEntry *wgvk_cache_acquire(WgvkObjectCache *cache, const uint32_t *key,
+                                   uint32_t key_words) {
+	size_t key_size = key_words * sizeof(uint32_t);
+	WgvkCacheEntry *entry =
+	    wgvk_hash_table_find(cache->table, wgvk_hash_words(key, key_words), key, key_size);
+	if (entry) {
+		entry->ref_count++;
+	}
+	return entry;
+}
+
+WgvkCacheEntry *wgvk_cache_insert(WgvkObjectCache *cache, const uint32_t *key, uint32_t key_words,
+                                  void *object) {
+	if (!cache->table) {
+		cache->table = wgvk_hash_table_create(64);
+		if (!cache->table) {
+			return NULL;
+		}
+	}
+
+	size_t key_size = key_words * sizeof(uint32_t);
+	WgvkCacheEntry *entry = wgvk_alloc(sizeof(WgvkCacheEntry) + key_size);
+	if (!entry) {
+		return NULL;
+	}
+
+	entry->hash = wgvk_hash_words(key, key_words);
+	entry->ref_count = 1;
+	entry->key_words = key_words;
+	entry->object = object;
+	memcpy(entry->key, key, key_size);
+
+	// The table points at the entry's own copy of the key
+	if (wgvk_hash_table_insert_key(cache->table, entry->hash, entry->key, key_size, entry) != 0) {
+		wgvk_free(entry);
+		return NULL;
+	}
+	cache->entry_count++;
+	return entry;
+}
+
+void wgvk_cache_release(WgvkObjectCache *cache, WgvkCacheEntry *entry) {
+	if (!entry || --entry->ref_count > 0) {
+		return;
+	}
+
+	wgvk_hash_table_erase(cache->table, entry->hash, entry->key,
+	                      entry->key_words * sizeof(uint32_t));
+	if (entry->object && cache->release) {
+		cache->release(entry->object);
+	}
+	cache->entry_count--;
+	wgvk_free(entry);
+}
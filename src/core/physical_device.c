@@ -1,6 +1,36 @@
 #include "webvulkan_internal.h"
+#include "../commands/transcode.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+/* Features come from wherever vkCreateDevice gets its device: the adapter
+ * it requests the device from, or on the web the device the page created,
+ * so the caps reported here are the ones the device ends up with. The
+ * page's device is handed out as a new reference on every call, so the
+ * one taken here is released again. */
+VkBool32 wgvk_physical_device_has_feature(VkPhysicalDevice physicalDevice,
+                                          WGPUFeatureName feature) {
+	if (!physicalDevice) {
+		return VK_FALSE;
+	}
+#ifdef __EMSCRIPTEN__
+	WGPUDevice device = emscripten_webgpu_get_device();
+	if (!device) {
+		return VK_FALSE;
+	}
+	VkBool32 has = wgpuDeviceHasFeature(device, feature) ? VK_TRUE : VK_FALSE;
+	wgpuDeviceRelease(device);
+	return has;
+#else
+	return physicalDevice->wgpu_adapter &&
+	       wgpuAdapterHasFeature(physicalDevice->wgpu_adapter, feature);
+#endif
+}
 
 void vkGetPhysicalDeviceProperties(VkPhysicalDevice physicalDevice, void *pProperties) {
+	WGVK_STAT_CALL(vkGetPhysicalDeviceProperties);
 	if (!physicalDevice || !pProperties) {
 		return;
 	}
@@ -28,6 +58,7 @@ void vkGetPhysicalDeviceProperties(VkPhysicalDevice physicalDevice, void *pPrope
 
 void vkGetPhysicalDeviceFeatures(VkPhysicalDevice physicalDevice,
                                  VkPhysicalDeviceFeatures *pFeatures) {
+	WGVK_STAT_CALL(vkGetPhysicalDeviceFeatures);
 	if (!physicalDevice || !pFeatures) {
 		return;
 	}
@@ -45,9 +76,17 @@ void vkGetPhysicalDeviceFeatures(VkPhysicalDevice physicalDevice,
 	pFeatures->samplerAnisotropy = VK_TRUE;
 	pFeatures->shaderUniformBufferArrayDynamicIndexing = VK_TRUE;
 	pFeatures->shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+	/* Only native support counts: BC7 and ASTC have no decoder fallback. */
+	pFeatures->textureCompressionBC =
+	    wgvk_physical_device_has_feature(physicalDevice, WGPUFeatureName_TextureCompressionBC);
+	pFeatures->textureCompressionETC2 =
+	    wgvk_physical_device_has_feature(physicalDevice, WGPUFeatureName_TextureCompressionETC2);
+	pFeatures->textureCompressionASTC_LDR =
+	    wgvk_physical_device_has_feature(physicalDevice, WGPUFeatureName_TextureCompressionASTC);
 }
 
 void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, void *pMemoryProperties) {
+	WGVK_STAT_CALL(vkGetPhysicalDeviceMemoryProperties);
 	if (!physicalDevice || !pMemoryProperties) {
 		return;
 	}
@@ -67,9 +106,12 @@ void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, void *
 
 	memset(mem_props, 0, sizeof(*mem_props));
 
-	mem_props->memoryTypeCount = 1;
-	mem_props->memoryTypes[0].propertyFlags = 0x7;
-	mem_props->memoryTypes[0].heapIndex = 0;
+	mem_props->memoryTypeCount = 2;
+	mem_props->memoryTypes[WGVK_MEMORY_TYPE_GENERAL].propertyFlags = 0x7;
+	mem_props->memoryTypes[WGVK_MEMORY_TYPE_GENERAL].heapIndex = 0;
+	/* DEVICE_LOCAL | LAZILY_ALLOCATED: transient attachments need no backing. */
+	mem_props->memoryTypes[WGVK_MEMORY_TYPE_LAZY].propertyFlags = 0x11;
+	mem_props->memoryTypes[WGVK_MEMORY_TYPE_LAZY].heapIndex = 0;
 
 	mem_props->memoryHeapCount = 1;
 	mem_props->memoryHeaps[0].size = 256ULL * 1024 * 1024 * 1024;
@@ -79,6 +121,7 @@ void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, void *
 void vkGetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice physicalDevice,
                                               uint32_t *pQueueFamilyPropertyCount,
                                               void *pQueueFamilyProperties) {
+	WGVK_STAT_CALL(vkGetPhysicalDeviceQueueFamilyProperties);
 	if (!physicalDevice || !pQueueFamilyPropertyCount) {
 		return;
 	}
@@ -105,15 +148,59 @@ void vkGetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice physicalDevice,
 
 void vkGetPhysicalDeviceFormatProperties(VkPhysicalDevice physicalDevice, uint32_t format,
                                          void *pFormatProperties) {
-	(void)physicalDevice;
-	(void)format;
-
+	WGVK_STAT_CALL(vkGetPhysicalDeviceFormatProperties);
 	if (!pFormatProperties) {
 		return;
 	}
 
-	uint32_t *props = pFormatProperties;
-	props[0] = 0x1F;
-	props[1] = 0x1F;
-	props[2] = 0x1F;
+	VkFormatProperties *props = pFormatProperties;
+	memset(props, 0, sizeof(*props));
+	if (wgvk_format_to_wgpu(format) == WGPUTextureFormat_Undefined) {
+		return;
+	}
+
+	/* Without the compression feature, uploads decode into an RGBA8
+	 * texture: it samples, but no longer holds blocks to copy out. */
+	WGPUFeatureName feature;
+	if (wgvk_format_feature(format, &feature) &&
+	    !wgvk_physical_device_has_feature(physicalDevice, feature)) {
+		if (wgvk_transcode_format(format) != WGPUTextureFormat_Undefined) {
+			props->optimalTilingFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+			                               VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT |
+			                               VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+		}
+		props->linearTilingFeatures = props->optimalTilingFeatures;
+		return;
+	}
+
+	VkFormatFeatureFlags features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+	WGPUTextureSampleType sample_type = wgvk_format_sample_type(format);
+	VkImageAspectFlags aspect =
+	    wgvk_format_has_depth(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+	if (wgvk_format_block(format, aspect).block_size > 0 || wgvk_format_has_stencil(format)) {
+		features |= VK_FORMAT_FEATURE_TRANSFER_SRC_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+	}
+	if (sample_type == WGPUTextureSampleType_Float) {
+		features |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	}
+	/* Blits sample the source as float and render into the destination. */
+	if (sample_type == WGPUTextureSampleType_Float ||
+	    sample_type == WGPUTextureSampleType_UnfilterableFloat) {
+		features |= VK_FORMAT_FEATURE_BLIT_SRC_BIT;
+	}
+	if (wgvk_format_is_color_renderable(format)) {
+		features |= VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
+		if (sample_type == WGPUTextureSampleType_Float) {
+			features |= VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT |
+			            VK_FORMAT_FEATURE_BLIT_DST_BIT;
+		}
+	}
+	if (sample_type == WGPUTextureSampleType_Depth || wgvk_format_has_stencil(format)) {
+		features |= VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	}
+
+	/* Tiling is not observable through WebGPU; texel buffers are not
+	 * implemented. */
+	props->optimalTilingFeatures = features;
+	props->linearTilingFeatures = features;
 }
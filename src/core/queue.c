@@ -1,7 +1,10 @@
 #include "webvulkan_internal.h"
+#include "../util/trace.h"
 
 VkResult vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits,
                        VkFence fence) {
+	WGVK_STAT_CALL(vkQueueSubmit);
+	WGVK_SPAN(WGVK_LOG_CAT_SYNC, "vkQueueSubmit");
 	if (!queue) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
@@ -43,10 +46,12 @@ VkResult vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *
 		fence->signaled = VK_TRUE;
 	}
 
+	wgvk_texture_pool_end_frame(&queue->device->texture_pool, VK_FALSE);
 	return VK_SUCCESS;
 }
 
 VkResult vkQueueWaitIdle(VkQueue queue) {
+	WGVK_STAT_CALL(vkQueueWaitIdle);
 	if (!queue) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
@@ -5,7 +5,7 @@ static void destroy_device_memory(void *obj) {
 	if (mem->wgpu_buffer) {
 		wgpuBufferRelease(mem->wgpu_buffer);
 	}
-	wgvk_free(mem);
+	wgvk_object_free(mem);
 }
 
 static uint32_t vk_format_bytes_per_pixel(uint32_t format) {
@@ -87,24 +87,33 @@ static uint32_t vk_format_bytes_per_pixel(uint32_t format) {
 
 VkResult vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo *pAllocateInfo,
                           const VkAllocationCallbacks *pAllocator, VkDeviceMemory *pMemory) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkAllocateMemory);
 
 	if (!device || !pMemory) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkDeviceMemory mem = wgvk_alloc(sizeof(struct VkDeviceMemory_T));
+	VkDeviceMemory mem =
+	    wgvk_object_alloc(sizeof(struct VkDeviceMemory_T), VK_OBJECT_TYPE_DEVICE_MEMORY, pAllocator,
+	                      device->base.allocator);
 	if (!mem) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&mem->base, destroy_device_memory);
+	wgvk_object_init(&mem->base, VK_OBJECT_TYPE_DEVICE_MEMORY, destroy_device_memory);
 	mem->device = device;
 	mem->size = pAllocateInfo->allocationSize;
 	mem->memory_type_index = pAllocateInfo->memoryTypeIndex;
 	mem->mapped_ptr = NULL;
 	mem->wgpu_buffer = NULL;
 
+	// Lazily allocated memory only ever backs transient attachments, whose
+	// textures own their storage
+	if (pAllocateInfo->memoryTypeIndex == WGVK_MEMORY_TYPE_LAZY) {
+		*pMemory = mem;
+		return VK_SUCCESS;
+	}
+
 	WGPUBufferDescriptor desc = {
 	    .size = pAllocateInfo->allocationSize,
 	    .usage = WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst | WGPUBufferUsage_Uniform |
@@ -115,7 +124,7 @@ VkResult vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo *pAllocate
 	mem->wgpu_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &desc);
 
 	if (!mem->wgpu_buffer) {
-		wgvk_free(mem);
+		wgvk_object_free(mem);
 		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
 	}
 
@@ -124,6 +133,7 @@ VkResult vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo *pAllocate
 }
 
 void vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkFreeMemory);
 	(void)device;
 	(void)pAllocator;
 	if (memory) {
@@ -133,6 +143,7 @@ void vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCall
 
 VkResult vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size,
                      VkFlags flags, void **ppData) {
+	WGVK_STAT_CALL(vkMapMemory);
 	(void)flags;
 	(void)size; /* We map the full allocation; offset is applied to the returned pointer */
 
@@ -163,6 +174,7 @@ VkResult vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset
 }
 
 void vkUnmapMemory(VkDevice device, VkDeviceMemory memory) {
+	WGVK_STAT_CALL(vkUnmapMemory);
 	if (!memory || !memory->wgpu_buffer || !memory->mapped_ptr) {
 		return;
 	}
@@ -177,6 +189,7 @@ void vkUnmapMemory(VkDevice device, VkDeviceMemory memory) {
 
 VkResult vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory memory,
                             VkDeviceSize memoryOffset) {
+	WGVK_STAT_CALL(vkBindBufferMemory);
 	(void)device;
 	(void)memory;
 	(void)memoryOffset;
@@ -193,6 +206,7 @@ VkResult vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory mem
 
 VkResult vkBindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory,
                            VkDeviceSize memoryOffset) {
+	WGVK_STAT_CALL(vkBindImageMemory);
 	(void)device;
 	(void)memory;
 	(void)memoryOffset;
@@ -208,6 +222,7 @@ VkResult vkBindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory
 }
 
 void vkGetBufferMemoryRequirements(VkDevice device, VkBuffer buffer, void *pMemoryRequirements) {
+	WGVK_STAT_CALL(vkGetBufferMemoryRequirements);
 	(void)device;
 	(void)buffer;
 
@@ -227,6 +242,7 @@ void vkGetBufferMemoryRequirements(VkDevice device, VkBuffer buffer, void *pMemo
 }
 
 void vkGetImageMemoryRequirements(VkDevice device, VkImage image, void *pMemoryRequirements) {
+	WGVK_STAT_CALL(vkGetImageMemoryRequirements);
 	(void)device;
 
 	if (!pMemoryRequirements) {
@@ -246,6 +262,15 @@ void vkGetImageMemoryRequirements(VkDevice device, VkImage image, void *pMemoryR
 		return;
 	}
 
+	/* Transient attachments live only inside render passes; the texture
+	 * holds them, so memory bound to the image is never touched. */
+	if (image->usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) {
+		reqs->size = 256;
+		reqs->alignment = 256;
+		reqs->memoryTypeBits = (1u << WGVK_MEMORY_TYPE_GENERAL) | (1u << WGVK_MEMORY_TYPE_LAZY);
+		return;
+	}
+
 	/* Sum all mip levels: each level halves width and height. */
 	uint32_t bpp = vk_format_bytes_per_pixel(image->format);
 	uint32_t depth = (image->depth > 0) ? image->depth : 1;
@@ -0,0 +1,307 @@
+#include "webvulkan_internal.h"
+#include "../util/log.h"
+#include "../util/handle_table.h"
+#include "../util/hash_table.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define WGVK_OBJECT_ALIGN _Alignof(max_align_t)
+/* Objects carved out of each slab allocation. */
+#define WGVK_SLAB_OBJECTS 64
+
+/* ASan cannot see a use after free inside a slab, and the handle table
+ * cannot tell a stale pointer from the object reusing its slot, so both
+ * builds give every object its own allocation. */
+#if defined(__SANITIZE_ADDRESS__) || defined(WGVK_ENABLE_HANDLE_TABLE)
+#define WGVK_USE_SLABS 0
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define WGVK_USE_SLABS 0
+#endif
+#endif
+#ifndef WGVK_USE_SLABS
+#define WGVK_USE_SLABS 1
+#endif
+
+typedef struct WgvkSlab {
+	struct WgvkSlab *next;
+} WgvkSlab;
+
+/* Fixed-size pool for one object type. Freed objects go on a free list
+ * threaded through their first bytes; slabs are only released by
+ * wgvk_object_pools_trim once no object of the type is live. */
+typedef struct WgvkSlabPool {
+	VkObjectType type;
+	size_t object_size;
+	atomic_flag lock;
+	void *free_list;
+	WgvkSlab *slabs;
+	uint32_t live;
+} WgvkSlabPool;
+
+#define WGVK_SLAB_POOL(object_type, object) \
+	{.type = object_type, .object_size = sizeof(struct object), .lock = ATOMIC_FLAG_INIT}
+
+static WgvkSlabPool g_pools[] = {
+    WGVK_SLAB_POOL(VK_OBJECT_TYPE_COMMAND_BUFFER, VkCommandBuffer_T),
+    WGVK_SLAB_POOL(VK_OBJECT_TYPE_DESCRIPTOR_SET, VkDescriptorSet_T),
+    WGVK_SLAB_POOL(VK_OBJECT_TYPE_FENCE, VkFence_T),
+    WGVK_SLAB_POOL(VK_OBJECT_TYPE_SEMAPHORE, VkSemaphore_T),
+    WGVK_SLAB_POOL(VK_OBJECT_TYPE_IMAGE_VIEW, VkImageView_T),
+};
+
+#define WGVK_POOL_COUNT (sizeof(g_pools) / sizeof(g_pools[0]))
+
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+/* One table per object type, so each type's live objects pack densely. */
+static WgvkHandleTable g_handle_tables[WGVK_STAT_OBJECT_COUNT];
+/* Live object address -> its id. Checks go through the address alone, so
+ * a stale pointer is never dereferenced. */
+static WgvkHashTable *g_live_objects;
+static atomic_flag g_live_lock = ATOMIC_FLAG_INIT;
+
+static WgvkHandleTable *handle_table(VkObjectType type) {
+	return &g_handle_tables[wgvk_stat_object_index(type)];
+}
+
+static void live_lock(void) {
+	while (atomic_flag_test_and_set_explicit(&g_live_lock, memory_order_acquire)) {
+	}
+}
+
+static void live_unlock(void) {
+	atomic_flag_clear_explicit(&g_live_lock, memory_order_release);
+}
+
+/* The id of a live object, 0 when obj is not one. */
+static uint32_t live_handle(const void *obj) {
+	live_lock();
+	void *value = wgvk_hash_table_lookup(g_live_objects, (void *)obj);
+	live_unlock();
+	return (uint32_t)(uintptr_t)value;
+}
+
+static int register_object(struct WgvkObject *obj) {
+	uint32_t handle = wgvk_handle_alloc(handle_table(obj->type), obj);
+	if (!handle) {
+		return 0;
+	}
+	live_lock();
+	if (!g_live_objects) {
+		g_live_objects = wgvk_hash_table_create(256);
+	}
+	int result = wgvk_hash_table_insert(g_live_objects, obj, (void *)(uintptr_t)handle);
+	live_unlock();
+	if (result != 0) {
+		wgvk_handle_free(handle_table(obj->type), handle);
+		return 0;
+	}
+	return 1;
+}
+
+/* Freed objects are held back this many frees before their memory goes
+ * back to malloc, so a stale pointer keeps failing the check instead of
+ * naming the next object of the same size. */
+#define WGVK_QUARANTINE_OBJECTS 256
+static void *g_quarantine[WGVK_QUARANTINE_OBJECTS];
+static uint32_t g_quarantine_next;
+
+static void quarantine_free(void *obj) {
+	live_lock();
+	void *oldest = g_quarantine[g_quarantine_next];
+	g_quarantine[g_quarantine_next] = obj;
+	g_quarantine_next = (g_quarantine_next + 1) % WGVK_QUARANTINE_OBJECTS;
+	live_unlock();
+	free(oldest);
+}
+
+static void unregister_object(struct WgvkObject *obj) {
+	live_lock();
+	uint32_t handle = (uint32_t)(uintptr_t)wgvk_hash_table_lookup(g_live_objects, obj);
+	wgvk_hash_table_remove(g_live_objects, obj);
+	live_unlock();
+	if (handle) {
+		wgvk_handle_free(handle_table(obj->type), handle);
+	}
+}
+
+int wgvk_object_handle_valid(const struct WgvkObject *obj) {
+	if (live_handle(obj)) {
+		return 1;
+	}
+	WGVK_ERROR(WGVK_LOG_CAT_CORE, "use of destroyed object %p", (const void *)obj);
+	return 0;
+}
+#endif
+
+static WgvkSlabPool *find_pool(VkObjectType type) {
+	if (!WGVK_USE_SLABS) {
+		return NULL;
+	}
+	for (uint32_t i = 0; i < WGVK_POOL_COUNT; i++) {
+		if (g_pools[i].type == type) {
+			return &g_pools[i];
+		}
+	}
+	return NULL;
+}
+
+static void pool_lock(WgvkSlabPool *pool) {
+	while (atomic_flag_test_and_set_explicit(&pool->lock, memory_order_acquire)) {
+	}
+}
+
+static void pool_unlock(WgvkSlabPool *pool) {
+	atomic_flag_clear_explicit(&pool->lock, memory_order_release);
+}
+
+static void *slab_alloc(WgvkSlabPool *pool) {
+	size_t header = wgvk_align_up(sizeof(WgvkSlab), WGVK_OBJECT_ALIGN);
+	size_t stride = wgvk_align_up(pool->object_size, WGVK_OBJECT_ALIGN);
+
+	pool_lock(pool);
+	void *obj = pool->free_list;
+	if (obj) {
+		pool->free_list = *(void **)obj;
+	} else {
+		WgvkSlab *slab = malloc(header + stride * WGVK_SLAB_OBJECTS);
+		if (slab) {
+			slab->next = pool->slabs;
+			pool->slabs = slab;
+			uint8_t *first = (uint8_t *)slab + header;
+			/* Hand out the first object and chain the rest in address order */
+			for (uint32_t i = WGVK_SLAB_OBJECTS - 1; i > 0; i--) {
+				void **free_obj = (void **)(first + i * stride);
+				*free_obj = pool->free_list;
+				pool->free_list = free_obj;
+			}
+			obj = first;
+		}
+	}
+	if (obj) {
+		pool->live++;
+	}
+	pool_unlock(pool);
+
+	if (obj) {
+		memset(obj, 0, pool->object_size);
+	}
+	return obj;
+}
+
+static void slab_free(WgvkSlabPool *pool, void *obj) {
+	pool_lock(pool);
+	*(void **)obj = pool->free_list;
+	pool->free_list = obj;
+	pool->live--;
+	pool_unlock(pool);
+}
+
+static VkSystemAllocationScope object_scope(VkObjectType type) {
+	switch (type) {
+	case VK_OBJECT_TYPE_INSTANCE:
+	case VK_OBJECT_TYPE_PHYSICAL_DEVICE:
+		return VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE;
+	case VK_OBJECT_TYPE_DEVICE:
+	case VK_OBJECT_TYPE_QUEUE:
+		return VK_SYSTEM_ALLOCATION_SCOPE_DEVICE;
+	case VK_OBJECT_TYPE_PIPELINE_CACHE:
+		return VK_SYSTEM_ALLOCATION_SCOPE_CACHE;
+	default:
+		return VK_SYSTEM_ALLOCATION_SCOPE_OBJECT;
+	}
+}
+
+void *wgvk_object_alloc(size_t size, VkObjectType type, const VkAllocationCallbacks *pAllocator,
+                        const VkAllocationCallbacks *parent) {
+	const VkAllocationCallbacks *callbacks = pAllocator ? pAllocator : parent;
+	struct WgvkObject *obj;
+
+	if (callbacks) {
+		size_t offset = wgvk_align_up(size, _Alignof(VkAllocationCallbacks));
+		obj = callbacks->pfnAllocation(callbacks->pUserData, offset + sizeof(VkAllocationCallbacks),
+		                               WGVK_OBJECT_ALIGN, object_scope(type));
+		if (!obj) {
+			return NULL;
+		}
+		memset(obj, 0, offset);
+		VkAllocationCallbacks *copy = (VkAllocationCallbacks *)((uint8_t *)obj + offset);
+		*copy = *callbacks;
+		obj->allocator = copy;
+	} else {
+		WgvkSlabPool *pool = find_pool(type);
+		obj = pool ? slab_alloc(pool) : calloc(1, size);
+		if (!obj) {
+			return NULL;
+		}
+	}
+	obj->type = type;
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+	if (!register_object(obj)) {
+		wgvk_object_free(obj);
+		return NULL;
+	}
+#endif
+	return obj;
+}
+
+void wgvk_object_free(void *ptr) {
+	struct WgvkObject *obj = ptr;
+	if (!obj) {
+		return;
+	}
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+	unregister_object(obj);
+#endif
+	if (obj->allocator) {
+		/* The callbacks live inside the allocation being freed */
+		VkAllocationCallbacks callbacks = *obj->allocator;
+		callbacks.pfnFree(callbacks.pUserData, obj);
+		return;
+	}
+	WgvkSlabPool *pool = find_pool(obj->type);
+	if (pool) {
+		slab_free(pool, obj);
+	} else {
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+		quarantine_free(obj);
+#else
+		free(obj);
+#endif
+	}
+}
+
+void wgvk_object_pools_trim(void) {
+	for (uint32_t i = 0; i < WGVK_POOL_COUNT; i++) {
+		WgvkSlabPool *pool = &g_pools[i];
+		pool_lock(pool);
+		if (pool->live == 0) {
+			while (pool->slabs) {
+				WgvkSlab *next = pool->slabs->next;
+				free(pool->slabs);
+				pool->slabs = next;
+			}
+			pool->free_list = NULL;
+		}
+		pool_unlock(pool);
+	}
+}
+
+uint32_t wgvkGetObjectHandle(uint64_t objectHandle) {
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+	return live_handle((const void *)(uintptr_t)objectHandle);
+#else
+	(void)objectHandle;
+	return 0;
+#endif
+}
+
+uint64_t wgvkLookupObjectHandle(VkObjectType objectType, uint32_t handle) {
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+	return (uint64_t)(uintptr_t)wgvk_handle_lookup(handle_table(objectType), handle);
+#else
+	(void)objectType;
+	(void)handle;
+	return 0;
+#endif
+}
@@ -0,0 +1,140 @@
+#include "webvulkan_internal.h"
+
+void wgvk_texture_pool_init(WgvkTexturePool *pool) {
+	pool->table = NULL;
+	pool->oldest = NULL;
+	pool->newest = NULL;
+	pool->free_count = 0;
+	pool->frame = 0;
+	pool->max_frames = WGVK_TEXTURE_POOL_DEFAULT_FRAMES;
+	pool->all_images = VK_FALSE;
+	pool->explicit_frames = VK_FALSE;
+}
+
+void wgvk_texture_pool_destroy(WgvkTexturePool *pool) {
+	wgvk_texture_pool_trim(pool, 0);
+	wgvk_hash_table_destroy(pool->table);
+	pool->table = NULL;
+}
+
+void wgvk_texture_pool_key(const WGPUTextureDescriptor *desc, uint32_t *key) {
+	key[0] = (uint32_t)desc->format;
+	key[1] = (uint32_t)desc->dimension;
+	key[2] = desc->size.width;
+	key[3] = desc->size.height;
+	key[4] = desc->size.depthOrArrayLayers;
+	key[5] = desc->mipLevelCount;
+	key[6] = desc->sampleCount;
+	/* The only view format ever declared is the sRGB twin, which the
+	 * format already determines. */
+	key[7] = (uint32_t)desc->usage | (desc->viewFormatCount ? 0x80000000u : 0);
+}
+
+/* Unlink an entry from both its key chain and the release-order list. */
+static void unlink_entry(WgvkTexturePool *pool, WgvkPooledTexture *entry) {
+	WgvkPooledTexture *head =
+	    wgvk_hash_table_find(pool->table, entry->hash, entry->key, sizeof(entry->key));
+	if (head == entry) {
+		if (entry->next) {
+			// The table keys on the head's copy of the key, so move it along
+			wgvk_hash_table_insert_key(pool->table, entry->hash, entry->next->key,
+			                           sizeof(entry->key), entry->next);
+		} else {
+			wgvk_hash_table_erase(pool->table, entry->hash, entry->key, sizeof(entry->key));
+		}
+	} else {
+		while (head && head->next != entry) {
+			head = head->next;
+		}
+		if (head) {
+			head->next = entry->next;
+		}
+	}
+
+	if (entry->older)
+		entry->older->newer = entry->newer;
+	else
+		pool->oldest = entry->newer;
+	if (entry->newer)
+		entry->newer->older = entry->older;
+	else
+		pool->newest = entry->older;
+	pool->free_count--;
+}
+
+WGPUTexture wgvk_texture_pool_acquire(VkDevice device, const WGPUTextureDescriptor *desc,
+                                      const uint32_t *key) {
+	if (device->texture_pool.table) {
+		uint64_t hash = wgvk_hash_words(key, WGVK_TEXTURE_KEY_WORDS);
+		WgvkPooledTexture *entry = wgvk_hash_table_find(
+		    device->texture_pool.table, hash, key, WGVK_TEXTURE_KEY_WORDS * sizeof(uint32_t));
+		if (entry) {
+			WGPUTexture texture = entry->texture;
+			unlink_entry(&device->texture_pool, entry);
+			wgvk_free(entry);
+			return texture;
+		}
+	}
+	return wgpuDeviceCreateTexture(device->wgpu_device, desc);
+}
+
+void wgvk_texture_pool_release(WgvkTexturePool *pool, const uint32_t *key, WGPUTexture texture) {
+	if (!pool->table) {
+		pool->table = wgvk_hash_table_create(64);
+	}
+	WgvkPooledTexture *entry = pool->table ? wgvk_alloc(sizeof(WgvkPooledTexture)) : NULL;
+	if (!entry) {
+		wgpuTextureRelease(texture);
+		return;
+	}
+
+	entry->hash = wgvk_hash_words(key, WGVK_TEXTURE_KEY_WORDS);
+	entry->frame = pool->frame;
+	entry->texture = texture;
+	memcpy(entry->key, key, sizeof(entry->key));
+
+	entry->next = wgvk_hash_table_find(pool->table, entry->hash, entry->key, sizeof(entry->key));
+	if (wgvk_hash_table_insert_key(pool->table, entry->hash, entry->key, sizeof(entry->key),
+	                               entry) != 0) {
+		wgvk_free(entry);
+		wgpuTextureRelease(texture);
+		return;
+	}
+
+	entry->older = pool->newest;
+	entry->newer = NULL;
+	if (pool->newest)
+		pool->newest->newer = entry;
+	else
+		pool->oldest = entry;
+	pool->newest = entry;
+	pool->free_count++;
+
+	// Frames may never be marked, so bound the pool by count as well
+	if (pool->free_count > WGVK_TEXTURE_POOL_MAX_TEXTURES) {
+		WgvkPooledTexture *oldest = pool->oldest;
+		unlink_entry(pool, oldest);
+		wgpuTextureRelease(oldest->texture);
+		wgvk_free(oldest);
+	}
+}
+
+void wgvk_texture_pool_trim(WgvkTexturePool *pool, uint32_t max_frames) {
+	// The list is in release order, so idle entries are all at the front
+	while (pool->oldest && pool->frame - pool->oldest->frame >= max_frames) {
+		WgvkPooledTexture *entry = pool->oldest;
+		unlink_entry(pool, entry);
+		wgpuTextureRelease(entry->texture);
+		wgvk_free(entry);
+	}
+}
+
+void wgvk_texture_pool_end_frame(WgvkTexturePool *pool, VkBool32 explicit_frame) {
+	if (explicit_frame) {
+		pool->explicit_frames = VK_TRUE;
+	} else if (pool->explicit_frames) {
+		return;
+	}
+	pool->frame++;
+	wgvk_texture_pool_trim(pool, pool->max_frames);
+}
@@ -5,23 +5,24 @@ static void destroy_buffer(void *obj) {
 	if (buffer->wgpu_buffer) {
 		wgpuBufferRelease(buffer->wgpu_buffer);
 	}
-	wgvk_free(buffer);
+	wgvk_object_free(buffer);
 }
 
 VkResult vkCreateBuffer(VkDevice device, const VkBufferCreateInfo *pCreateInfo,
                         const VkAllocationCallbacks *pAllocator, VkBuffer *pBuffer) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateBuffer);
 
 	if (!device || !pCreateInfo || !pBuffer) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkBuffer buffer = wgvk_alloc(sizeof(struct VkBuffer_T));
+	VkBuffer buffer = wgvk_object_alloc(sizeof(struct VkBuffer_T), VK_OBJECT_TYPE_BUFFER,
+	                                    pAllocator, device->base.allocator);
 	if (!buffer) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&buffer->base, destroy_buffer);
+	wgvk_object_init(&buffer->base, VK_OBJECT_TYPE_BUFFER, destroy_buffer);
 	buffer->device = device;
 	buffer->size = pCreateInfo->size;
 	buffer->usage = pCreateInfo->usage;
@@ -42,6 +43,13 @@ VkResult vkCreateBuffer(VkDevice device, const VkBufferCreateInfo *pCreateInfo,
 		wgpu_usage |= WGPUBufferUsage_CopySrc;
 	if (pCreateInfo->usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT)
 		wgpu_usage |= WGPUBufferUsage_CopyDst;
+	// Usages are fixed at creation, and any transfer buffer may later take
+	// part in an image copy whose rows WebGPU cannot take directly. Those go
+	// through the repitch shader in commands/copy.c, which binds the copied
+	// region of the buffer as storage, so transfer buffers always allow it.
+	if (pCreateInfo->usage &
+	    (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+		wgpu_usage |= WGPUBufferUsage_Storage;
 	if (pCreateInfo->usage & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
 		wgpu_usage |= WGPUBufferUsage_Indirect;
 
@@ -53,7 +61,7 @@ VkResult vkCreateBuffer(VkDevice device, const VkBufferCreateInfo *pCreateInfo,
 
 	buffer->wgpu_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &desc);
 	if (!buffer->wgpu_buffer) {
-		wgvk_free(buffer);
+		wgvk_object_free(buffer);
 		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
 	}
 
@@ -62,6 +70,7 @@ VkResult vkCreateBuffer(VkDevice device, const VkBufferCreateInfo *pCreateInfo,
 }
 
 void vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyBuffer);
 	(void)device;
 	(void)pAllocator;
 	if (buffer) {
@@ -5,17 +5,41 @@ static void destroy_command_buffer(void *obj) {
 	if (cmd->wgpu_encoder) {
 		wgpuCommandEncoderRelease(cmd->wgpu_encoder);
 	}
-	wgvk_free(cmd);
+	wgvk_object_free(cmd);
+}
+
+/* Forget bindings and dynamic state, which each recording starts without. */
+static void reset_bound_state(VkCommandBuffer cmd) {
+	cmd->bound_pipeline = NULL;
+	cmd->bound_layout = NULL;
+	cmd->bound_index_buffer = NULL;
+	cmd->bound_index_offset = 0;
+	cmd->bound_index_type = 0;
+
+	for (int j = 0; j < WGVK_MAX_VERTEX_BUFFERS; j++) {
+		cmd->bound_vertex_buffers[j] = NULL;
+		cmd->bound_vertex_offsets[j] = 0;
+	}
+	for (int j = 0; j < WGVK_MAX_BIND_GROUPS; j++) {
+		cmd->bound_descriptor_sets[j] = NULL;
+		cmd->bound_dynamic_offset_counts[j] = 0;
+	}
+	cmd->dynamic_state_set = 0;
 }
 
 VkResult vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo *pAllocateInfo,
                                   VkCommandBuffer *pCommandBuffers) {
+	WGVK_STAT_CALL(vkAllocateCommandBuffers);
 	if (!device || !pAllocateInfo || !pCommandBuffers) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
+	/* Command buffers use the callbacks their pool was created with */
+	VkCommandPool pool = pAllocateInfo->commandPool;
+	const VkAllocationCallbacks *allocator = pool ? pool->base.allocator : device->base.allocator;
 	for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; i++) {
-		VkCommandBuffer cmd = wgvk_alloc(sizeof(struct VkCommandBuffer_T));
+		VkCommandBuffer cmd = wgvk_object_alloc(sizeof(struct VkCommandBuffer_T),
+		                                        VK_OBJECT_TYPE_COMMAND_BUFFER, NULL, allocator);
 		if (!cmd) {
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pCommandBuffers[j]->base);
@@ -23,7 +47,7 @@ VkResult vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocate
 			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
 
-		wgvk_object_init(&cmd->base, destroy_command_buffer);
+		wgvk_object_init(&cmd->base, VK_OBJECT_TYPE_COMMAND_BUFFER, destroy_command_buffer);
 		cmd->device = device;
 		cmd->pool = pAllocateInfo->commandPool;
 		cmd->wgpu_encoder = NULL;
@@ -33,19 +57,8 @@ VkResult vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocate
 		cmd->recording = VK_FALSE;
 		cmd->in_render_pass = VK_FALSE;
 		cmd->in_compute_pass = VK_FALSE;
-		cmd->bound_pipeline = NULL;
-		cmd->bound_layout = NULL;
-		cmd->bound_index_buffer = NULL;
-		cmd->bound_index_offset = 0;
-		cmd->bound_index_type = 0;
-
-		for (int j = 0; j < WGVK_MAX_VERTEX_BUFFERS; j++) {
-			cmd->bound_vertex_buffers[j] = NULL;
-			cmd->bound_vertex_offsets[j] = 0;
-		}
-		for (int j = 0; j < WGVK_MAX_BIND_GROUPS; j++) {
-			cmd->bound_descriptor_sets[j] = NULL;
-		}
+		cmd->pass_span.trace = 0;
+		reset_bound_state(cmd);
 
 		pCommandBuffers[i] = cmd;
 	}
@@ -55,6 +68,7 @@ VkResult vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocate
 
 void vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount,
                           const VkCommandBuffer *pCommandBuffers) {
+	WGVK_STAT_CALL(vkFreeCommandBuffers);
 	(void)device;
 	(void)commandPool;
 
@@ -67,6 +81,7 @@ void vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t c
 
 VkResult vkBeginCommandBuffer(VkCommandBuffer commandBuffer,
                               const VkCommandBufferBeginInfo *pBeginInfo) {
+	WGVK_STAT_CALL(vkBeginCommandBuffer);
 	(void)pBeginInfo;
 
 	if (!commandBuffer) {
@@ -88,11 +103,14 @@ VkResult vkBeginCommandBuffer(VkCommandBuffer commandBuffer,
 	commandBuffer->recording = VK_TRUE;
 	commandBuffer->in_render_pass = VK_FALSE;
 	commandBuffer->in_compute_pass = VK_FALSE;
+	commandBuffer->pass_span.trace = 0;
+	reset_bound_state(commandBuffer);
 
 	return VK_SUCCESS;
 }
 
 VkResult vkEndCommandBuffer(VkCommandBuffer commandBuffer) {
+	WGVK_STAT_CALL(vkEndCommandBuffer);
 	if (!commandBuffer) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
@@ -105,6 +123,7 @@ VkResult vkEndCommandBuffer(VkCommandBuffer commandBuffer) {
 		wgpuRenderPassEncoderRelease(commandBuffer->wgpu_render_pass);
 		commandBuffer->wgpu_render_pass = NULL;
 		commandBuffer->in_render_pass = VK_FALSE;
+		wgvk_trace_span_end(&commandBuffer->pass_span);
 	}
 
 	if (commandBuffer->in_compute_pass) {
@@ -2,23 +2,25 @@
 
 static void destroy_command_pool(void *obj) {
 	VkCommandPool pool = (VkCommandPool)obj;
-	wgvk_free(pool);
+	wgvk_object_free(pool);
 }
 
 VkResult vkCreateCommandPool(VkDevice device, const VkCommandPoolCreateInfo *pCreateInfo,
                              const VkAllocationCallbacks *pAllocator, VkCommandPool *pCommandPool) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateCommandPool);
 
 	if (!device || !pCreateInfo || !pCommandPool) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkCommandPool pool = wgvk_alloc(sizeof(struct VkCommandPool_T));
+	VkCommandPool pool =
+	    wgvk_object_alloc(sizeof(struct VkCommandPool_T), VK_OBJECT_TYPE_COMMAND_POOL, pAllocator,
+	                      device->base.allocator);
 	if (!pool) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&pool->base, destroy_command_pool);
+	wgvk_object_init(&pool->base, VK_OBJECT_TYPE_COMMAND_POOL, destroy_command_pool);
 	pool->device = device;
 	pool->queue_family_index = pCreateInfo->queueFamilyIndex;
 
@@ -28,6 +30,7 @@ VkResult vkCreateCommandPool(VkDevice device, const VkCommandPoolCreateInfo *pCr
 
 void vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool,
                           const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyCommandPool);
 	(void)device;
 	(void)pAllocator;
 
@@ -37,6 +40,7 @@ void vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool,
 }
 
 VkResult vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkFlags flags) {
+	WGVK_STAT_CALL(vkResetCommandPool);
 	(void)device;
 	(void)commandPool;
 	(void)flags;
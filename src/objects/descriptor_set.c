@@ -1,26 +1,32 @@
 #include "webvulkan_internal.h"
 
+/* WebGPU's default maxUniformBufferBindingSize, so the stand-in meets the
+ * minimum binding size of any uniform block a shader can declare. */
+#define WGVK_PLACEHOLDER_BUFFER_SIZE 65536
+
 static void destroy_descriptor_pool(void *obj) {
 	VkDescriptorPool pool = (VkDescriptorPool)obj;
-	wgvk_free(pool);
+	wgvk_object_free(pool);
 }
 
 VkResult vkCreateDescriptorPool(VkDevice device, const void *pCreateInfo,
                                 const VkAllocationCallbacks *pAllocator,
                                 VkDescriptorPool *pDescriptorPool) {
+	WGVK_STAT_CALL(vkCreateDescriptorPool);
 	(void)pCreateInfo;
-	(void)pAllocator;
 
 	if (!device || !pDescriptorPool) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkDescriptorPool pool = wgvk_alloc(sizeof(struct VkDescriptorPool_T));
+	VkDescriptorPool pool =
+	    wgvk_object_alloc(sizeof(struct VkDescriptorPool_T), VK_OBJECT_TYPE_DESCRIPTOR_POOL,
+	                      pAllocator, device->base.allocator);
 	if (!pool) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&pool->base, destroy_descriptor_pool);
+	wgvk_object_init(&pool->base, VK_OBJECT_TYPE_DESCRIPTOR_POOL, destroy_descriptor_pool);
 	pool->device = device;
 
 	*pDescriptorPool = pool;
@@ -29,6 +35,7 @@ VkResult vkCreateDescriptorPool(VkDevice device, const void *pCreateInfo,
 
 void vkDestroyDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool,
                              const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyDescriptorPool);
 	(void)device;
 	(void)pAllocator;
 	if (descriptorPool) {
@@ -41,11 +48,13 @@ static void destroy_descriptor_set(void *obj) {
 	if (set->wgpu_bind_group) {
 		wgpuBindGroupRelease(set->wgpu_bind_group);
 	}
-	wgvk_free(set);
+	wgvk_free(set->entries);
+	wgvk_object_free(set);
 }
 
 VkResult vkAllocateDescriptorSets(VkDevice device, const void *pAllocateInfo,
                                   VkDescriptorSet *pDescriptorSets) {
+	WGVK_STAT_CALL(vkAllocateDescriptorSets);
 	if (!device || !pAllocateInfo || !pDescriptorSets) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
@@ -58,20 +67,44 @@ VkResult vkAllocateDescriptorSets(VkDevice device, const void *pAllocateInfo,
 		const VkDescriptorSetLayout *pSetLayouts;
 	} *alloc_info = pAllocateInfo;
 
+	/* Sets use the callbacks their pool was created with */
+	VkDescriptorPool pool = alloc_info->descriptorPool;
+	const VkAllocationCallbacks *allocator = pool ? pool->base.allocator : device->base.allocator;
 	for (uint32_t i = 0; i < alloc_info->descriptorSetCount; i++) {
-		VkDescriptorSet set = wgvk_alloc(sizeof(struct VkDescriptorSet_T));
-		if (!set) {
+		VkDescriptorSetLayout layout = alloc_info->pSetLayouts[i];
+		uint32_t entry_count = layout ? layout->entry_count : 0;
+
+		VkDescriptorSet set = wgvk_object_alloc(sizeof(struct VkDescriptorSet_T),
+		                                        VK_OBJECT_TYPE_DESCRIPTOR_SET, NULL, allocator);
+		if (set) {
+			set->entries = wgvk_alloc(sizeof(WGPUBindGroupEntry) * (entry_count + 1));
+		}
+		if (!set || !set->entries) {
+			wgvk_object_free(set);
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pDescriptorSets[j]->base);
 			}
 			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
 
-		wgvk_object_init(&set->base, destroy_descriptor_set);
+		wgvk_object_init(&set->base, VK_OBJECT_TYPE_DESCRIPTOR_SET, destroy_descriptor_set);
 		set->device = device;
-		set->layout = alloc_info->pSetLayouts[i];
+		set->layout = layout;
 		set->wgpu_bind_group = NULL;
-		set->entry_count = 0;
+		set->entry_count = entry_count;
+		set->dirty = VK_FALSE;
+
+		// One entry slot per layout entry, so writes and templates can address
+		// descriptors by a fixed index instead of appending.
+		if (layout) {
+			for (uint32_t b = 0; b < layout->binding_count; b++) {
+				const WgvkDescriptorBinding *info = &layout->bindings[b];
+				for (uint32_t e = 0; e < info->descriptor_count; e++) {
+					set->entries[info->entry_index + e].binding =
+					    wgvk_descriptor_wgpu_binding(info, e);
+				}
+			}
+		}
 
 		pDescriptorSets[i] = set;
 	}
@@ -81,6 +114,7 @@ VkResult vkAllocateDescriptorSets(VkDevice device, const void *pAllocateInfo,
 
 VkResult vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool,
                               uint32_t descriptorSetCount, const VkDescriptorSet *pDescriptorSets) {
+	WGVK_STAT_CALL(vkFreeDescriptorSets);
 	(void)device;
 	(void)descriptorPool;
 
@@ -93,98 +127,336 @@ VkResult vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool,
 	return VK_SUCCESS;
 }
 
+static const WgvkDescriptorBinding *find_binding(VkDescriptorSetLayout layout, uint32_t binding) {
+	uint32_t lo = 0;
+	uint32_t hi = layout->binding_count;
+
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (layout->bindings[mid].binding < binding) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo < layout->binding_count && layout->bindings[lo].binding == binding) {
+		return &layout->bindings[lo];
+	}
+	return NULL;
+}
+
+static uint32_t op_kind_for_type(uint32_t descriptor_type) {
+	switch (descriptor_type) {
+	case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+	case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+	case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+	case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+		return WGVK_TEMPLATE_OP_BUFFER;
+	case VK_DESCRIPTOR_TYPE_SAMPLER:
+		return WGVK_TEMPLATE_OP_SAMPLER;
+	case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+	case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+	case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+	case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+		return WGVK_TEMPLATE_OP_TEXTURE;
+	default:
+		return UINT32_MAX;
+	}
+}
+
+static void write_entry(WGPUBindGroupEntry *entry, uint32_t kind, const void *src) {
+	if (kind == WGVK_TEMPLATE_OP_BUFFER) {
+		const VkDescriptorBufferInfo *buf_info = src;
+		if (buf_info->buffer && buf_info->buffer->wgpu_buffer) {
+			entry->buffer = buf_info->buffer->wgpu_buffer;
+			entry->offset = buf_info->offset;
+			entry->size = (buf_info->range == VK_WHOLE_SIZE)
+			                  ? buf_info->buffer->size - buf_info->offset
+			                  : buf_info->range;
+		}
+	} else if (kind == WGVK_TEMPLATE_OP_SAMPLER) {
+		const VkDescriptorImageInfo *img_info = src;
+		if (img_info->sampler && img_info->sampler->wgpu_sampler) {
+			entry->sampler = img_info->sampler->wgpu_sampler;
+		}
+	} else if (kind == WGVK_TEMPLATE_OP_TEXTURE) {
+		const VkDescriptorImageInfo *img_info = src;
+		if (img_info->imageView && img_info->imageView->wgpu_view) {
+			entry->textureView = img_info->imageView->wgpu_view;
+		}
+	}
+}
+
+static WGPUTextureView placeholder_view(VkDevice device, enum WgvkPlaceholderTexture which) {
+	if (!device->placeholder_views[which]) {
+		VkBool32 storage =
+		    which == WGVK_PLACEHOLDER_STORAGE_2D || which == WGVK_PLACEHOLDER_STORAGE_1D;
+		VkBool32 one_d =
+		    which == WGVK_PLACEHOLDER_SAMPLED_1D || which == WGVK_PLACEHOLDER_STORAGE_1D;
+		WGPUTextureDescriptor desc = {
+		    .label = {.data = "wgvk placeholder texture", .length = WGPU_STRLEN},
+		    .usage = storage ? WGPUTextureUsage_StorageBinding : WGPUTextureUsage_TextureBinding,
+		    .dimension = one_d ? WGPUTextureDimension_1D : WGPUTextureDimension_2D,
+		    .size = {1, 1, 1},
+		    .format = storage ? WGVK_STORAGE_TEXTURE_FORMAT : WGPUTextureFormat_RGBA8Unorm,
+		    .mipLevelCount = 1,
+		    .sampleCount = 1,
+		};
+		device->placeholder_textures[which] = wgpuDeviceCreateTexture(device->wgpu_device, &desc);
+		if (device->placeholder_textures[which]) {
+			device->placeholder_views[which] =
+			    wgpuTextureCreateView(device->placeholder_textures[which], NULL);
+		}
+	}
+	return device->placeholder_views[which];
+}
+
+/* Unwritten slots (partially bound arrays, or bindings the app never
+ * touches) get device-wide stand-ins so WebGPU accepts the bind group. */
+static VkBool32 fill_placeholder(VkDevice device, WGPUBindGroupEntry *entry,
+                                 uint32_t descriptor_type) {
+	// Storage and texel buffer bindings need textures of their own shape
+	switch (descriptor_type) {
+	case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+		entry->textureView = placeholder_view(device, WGVK_PLACEHOLDER_STORAGE_2D);
+		return entry->textureView != NULL;
+	case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+		entry->textureView = placeholder_view(device, WGVK_PLACEHOLDER_SAMPLED_1D);
+		return entry->textureView != NULL;
+	case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+		entry->textureView = placeholder_view(device, WGVK_PLACEHOLDER_STORAGE_1D);
+		return entry->textureView != NULL;
+	default:
+		break;
+	}
+
+	switch (op_kind_for_type(descriptor_type)) {
+	case WGVK_TEMPLATE_OP_BUFFER:
+		if (!device->placeholder_buffer) {
+			WGPUBufferDescriptor desc = {
+			    .label = {.data = "wgvk placeholder buffer", .length = WGPU_STRLEN},
+			    .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_Storage,
+			    .size = WGVK_PLACEHOLDER_BUFFER_SIZE,
+			};
+			device->placeholder_buffer = wgpuDeviceCreateBuffer(device->wgpu_device, &desc);
+		}
+		entry->buffer = device->placeholder_buffer;
+		entry->offset = 0;
+		entry->size = WGVK_PLACEHOLDER_BUFFER_SIZE;
+		return entry->buffer != NULL;
+	case WGVK_TEMPLATE_OP_SAMPLER:
+		if (!device->placeholder_sampler) {
+			WGPUSamplerDescriptor desc = {
+			    .addressModeU = WGPUAddressMode_ClampToEdge,
+			    .addressModeV = WGPUAddressMode_ClampToEdge,
+			    .addressModeW = WGPUAddressMode_ClampToEdge,
+			    .magFilter = WGPUFilterMode_Nearest,
+			    .minFilter = WGPUFilterMode_Nearest,
+			    .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+			    .lodMinClamp = 0.0f,
+			    .lodMaxClamp = 32.0f,
+			    .maxAnisotropy = 1,
+			};
+			device->placeholder_sampler = wgpuDeviceCreateSampler(device->wgpu_device, &desc);
+		}
+		entry->sampler = device->placeholder_sampler;
+		return entry->sampler != NULL;
+	case WGVK_TEMPLATE_OP_TEXTURE:
+		entry->textureView = placeholder_view(device, WGVK_PLACEHOLDER_SAMPLED_2D);
+		return entry->textureView != NULL;
+	default:
+		return VK_FALSE;
+	}
+}
+
+/* Recreate the bind group once all writes of an update call have landed.
+ * Bind groups are immutable, so an update after bind only affects binds
+ * recorded from here on. */
+static void flush_descriptor_set(VkDevice device, VkDescriptorSet set) {
+	if (!set->dirty) {
+		return;
+	}
+	set->dirty = VK_FALSE;
+
+	if (set->wgpu_bind_group) {
+		wgpuBindGroupRelease(set->wgpu_bind_group);
+		set->wgpu_bind_group = NULL;
+	}
+
+	const VkDescriptorSetLayout layout = set->layout;
+	for (uint32_t b = 0; b < layout->binding_count; b++) {
+		const WgvkDescriptorBinding *info = &layout->bindings[b];
+		for (uint32_t e = 0; e < info->descriptor_count; e++) {
+			WGPUBindGroupEntry *entry = &set->entries[info->entry_index + e];
+			if (entry->buffer || entry->sampler || entry->textureView) {
+				continue;
+			}
+			// Without a stand-in the set waits for the app to write it
+			if (!fill_placeholder(device, entry, info->descriptor_type)) {
+				return;
+			}
+		}
+	}
+
+	if (layout->wgpu_layout) {
+		WGPUBindGroupDescriptor desc = {
+		    .layout = layout->wgpu_layout,
+		    .entryCount = set->entry_count,
+		    .entries = set->entries,
+		};
+		set->wgpu_bind_group = wgpuDeviceCreateBindGroup(device->wgpu_device, &desc);
+	}
+}
+
 void vkUpdateDescriptorSets(VkDevice device, uint32_t descriptorWriteCount,
                             const void *pDescriptorWrites, uint32_t descriptorCopyCount,
                             const void *pDescriptorCopies) {
+	WGVK_STAT_CALL(vkUpdateDescriptorSets);
 	(void)descriptorCopyCount;
 	(void)pDescriptorCopies;
 
-	if (!pDescriptorWrites || descriptorWriteCount == 0) {
+	if (!device || !pDescriptorWrites || descriptorWriteCount == 0) {
 		return;
 	}
 
-	const struct {
-		VkStructureType sType;
-		const void *pNext;
-		VkDescriptorSet dstSet;
-		uint32_t dstBinding;
-		uint32_t dstArrayElement;
-		uint32_t descriptorCount;
-		uint32_t descriptorType;
-		const void *pImageInfo;
-		const void *pBufferInfo;
-		const void *pTexelBufferView;
-	} *writes = pDescriptorWrites;
-
-	const struct VkDescriptorBufferInfo_T {
-		VkBuffer buffer;
-		VkDeviceSize offset;
-		VkDeviceSize range;
-	} *buf_info;
-
-	const struct VkDescriptorImageInfo_T {
-		VkSampler sampler;
-		VkImageView imageView;
-		uint32_t imageLayout;
-	} *img_info;
+	const VkWriteDescriptorSet *writes = pDescriptorWrites;
 
 	for (uint32_t i = 0; i < descriptorWriteCount; i++) {
 		VkDescriptorSet set = writes[i].dstSet;
 		if (!set || !set->layout)
 			continue;
 
-		uint32_t binding = writes[i].dstBinding;
-		uint32_t desc_type = writes[i].descriptorType;
+		const WgvkDescriptorBinding *info = find_binding(set->layout, writes[i].dstBinding);
+		uint32_t kind = op_kind_for_type(writes[i].descriptorType);
+		if (!info || kind == UINT32_MAX)
+			continue;
+
+		const void *src = kind == WGVK_TEMPLATE_OP_BUFFER ? (const void *)writes[i].pBufferInfo
+		                                                  : (const void *)writes[i].pImageInfo;
+		size_t stride = kind == WGVK_TEMPLATE_OP_BUFFER ? sizeof(VkDescriptorBufferInfo)
+		                                                : sizeof(VkDescriptorImageInfo);
+		if (!src)
+			continue;
 
 		for (uint32_t d = 0; d < writes[i].descriptorCount; d++) {
-			if (set->entry_count >= 32)
+			uint32_t element = writes[i].dstArrayElement + d;
+			if (element >= info->descriptor_count)
 				break;
 
-			WGPUBindGroupEntry *entry = &set->entries[set->entry_count];
-			memset(entry, 0, sizeof(*entry));
-			entry->binding = binding + d;
-
-			if (desc_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-			    desc_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
-			    desc_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
-			    desc_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) {
-				buf_info = (const struct VkDescriptorBufferInfo_T *)writes[i].pBufferInfo + d;
-				if (buf_info && buf_info->buffer && buf_info->buffer->wgpu_buffer) {
-					entry->buffer = buf_info->buffer->wgpu_buffer;
-					entry->offset = buf_info->offset;
-					entry->size = (buf_info->range == (VkDeviceSize)-1)
-					                  ? buf_info->buffer->size - buf_info->offset
-					                  : buf_info->range;
-					set->entry_count++;
-				}
-			} else if (desc_type == VK_DESCRIPTOR_TYPE_SAMPLER) {
-				img_info = (const struct VkDescriptorImageInfo_T *)writes[i].pImageInfo + d;
-				if (img_info && img_info->sampler && img_info->sampler->wgpu_sampler) {
-					entry->sampler = img_info->sampler->wgpu_sampler;
-					set->entry_count++;
-				}
-			} else if (desc_type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
-			           desc_type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-				img_info = (const struct VkDescriptorImageInfo_T *)writes[i].pImageInfo + d;
-				if (img_info && img_info->imageView && img_info->imageView->wgpu_view) {
-					entry->textureView = img_info->imageView->wgpu_view;
-					set->entry_count++;
-				}
-			}
+			write_entry(&set->entries[info->entry_index + element], kind,
+			            (const uint8_t *)src + d * stride);
 		}
+		set->dirty = VK_TRUE;
+	}
 
-		if (set->wgpu_bind_group) {
-			wgpuBindGroupRelease(set->wgpu_bind_group);
-			set->wgpu_bind_group = NULL;
+	for (uint32_t i = 0; i < descriptorWriteCount; i++) {
+		if (writes[i].dstSet && writes[i].dstSet->layout) {
+			flush_descriptor_set(device, writes[i].dstSet);
 		}
+	}
+}
 
-		if (set->layout->wgpu_layout) {
-			WGPUBindGroupDescriptor desc = {
-			    .layout = set->layout->wgpu_layout,
-			    .entryCount = set->entry_count,
-			    .entries = set->entries,
-			};
-			set->wgpu_bind_group = wgpuDeviceCreateBindGroup(device->wgpu_device, &desc);
+static void destroy_descriptor_update_template(void *obj) {
+	VkDescriptorUpdateTemplate tmpl = (VkDescriptorUpdateTemplate)obj;
+	wgvk_free(tmpl->ops);
+	wgvk_object_free(tmpl);
+}
+
+VkResult vkCreateDescriptorUpdateTemplate(VkDevice device,
+                                          const VkDescriptorUpdateTemplateCreateInfo *pCreateInfo,
+                                          const VkAllocationCallbacks *pAllocator,
+                                          VkDescriptorUpdateTemplate *pDescriptorUpdateTemplate) {
+	WGVK_STAT_CALL(vkCreateDescriptorUpdateTemplate);
+
+	if (!device || !pCreateInfo || !pDescriptorUpdateTemplate) {
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
+
+	VkDescriptorSetLayout layout = pCreateInfo->descriptorSetLayout;
+	if (pCreateInfo->templateType != VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET || !layout) {
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
+
+	uint32_t max_ops = 0;
+	for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
+		max_ops += pCreateInfo->pDescriptorUpdateEntries[i].descriptorCount;
+	}
+
+	VkDescriptorUpdateTemplate tmpl =
+	    wgvk_object_alloc(sizeof(struct VkDescriptorUpdateTemplate_T),
+	                      VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE, pAllocator,
+	                      device->base.allocator);
+	if (!tmpl) {
+		return VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	tmpl->ops = wgvk_alloc(sizeof(WgvkTemplateOp) * (max_ops + 1));
+	if (!tmpl->ops) {
+		wgvk_object_free(tmpl);
+		return VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	wgvk_object_init(&tmpl->base, VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE,
+	                 destroy_descriptor_update_template);
+	tmpl->device = device;
+	tmpl->op_count = 0;
+
+	// Resolve bindings, descriptor kinds and strides once so updates only copy.
+	for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
+		const VkDescriptorUpdateTemplateEntry *e = &pCreateInfo->pDescriptorUpdateEntries[i];
+		const WgvkDescriptorBinding *info = find_binding(layout, e->dstBinding);
+		uint32_t kind = op_kind_for_type(e->descriptorType);
+		if (!info || kind == UINT32_MAX)
+			continue;
+
+		for (uint32_t d = 0; d < e->descriptorCount; d++) {
+			uint32_t element = e->dstArrayElement + d;
+			if (element >= info->descriptor_count)
+				break;
+
+			WgvkTemplateOp *op = &tmpl->ops[tmpl->op_count++];
+			op->src_offset = e->offset + (size_t)d * e->stride;
+			op->entry_index = info->entry_index + element;
+			op->kind = kind;
+		}
+	}
+
+	*pDescriptorUpdateTemplate = tmpl;
+	return VK_SUCCESS;
+}
+
+void vkDestroyDescriptorUpdateTemplate(VkDevice device,
+                                       VkDescriptorUpdateTemplate descriptorUpdateTemplate,
+                                       const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyDescriptorUpdateTemplate);
+	(void)device;
+	(void)pAllocator;
+	if (descriptorUpdateTemplate) {
+		wgvk_object_release(&descriptorUpdateTemplate->base);
+	}
+}
+
+void vkUpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet,
+                                       VkDescriptorUpdateTemplate descriptorUpdateTemplate,
+                                       const void *pData) {
+	WGVK_STAT_CALL(vkUpdateDescriptorSetWithTemplate);
+	if (!device || !descriptorSet || !descriptorSet->layout || !descriptorUpdateTemplate ||
+	    !pData) {
+		return;
+	}
+
+	const uint8_t *base = pData;
+	const WgvkTemplateOp *ops = descriptorUpdateTemplate->ops;
+	uint32_t op_count = descriptorUpdateTemplate->op_count;
+
+	for (uint32_t i = 0; i < op_count; i++) {
+		if (ops[i].entry_index < descriptorSet->entry_count) {
+			write_entry(&descriptorSet->entries[ops[i].entry_index], ops[i].kind,
+			            base + ops[i].src_offset);
 		}
 	}
+
+	descriptorSet->dirty = VK_TRUE;
+	flush_descriptor_set(device, descriptorSet);
 }
@@ -1,113 +1,294 @@
 #include "webvulkan_internal.h"
+#include "../util/log.h"
 
 static void destroy_descriptor_set_layout(void *obj) {
 	VkDescriptorSetLayout layout = (VkDescriptorSetLayout)obj;
 
-	if (layout->wgpu_layout) {
-		wgpuBindGroupLayoutRelease(layout->wgpu_layout);
+	wgvk_cache_release(&layout->device->bind_group_layout_cache, layout->interned);
+
+	wgvk_free(layout->bindings);
+	wgvk_object_free(layout);
+}
+
+/* Order dynamic offsets the way WebGPU consumes them: by WebGPU binding
+ * number. entries holds the layout's entries in Vulkan offset order. */
+static void write_dynamic_offset_order(VkDescriptorSetLayout layout,
+                                       const WGPUBindGroupLayoutEntry *entries,
+                                       uint32_t entry_count) {
+	uint32_t bindings[WGVK_MAX_DYNAMIC_OFFSETS];
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < entry_count; i++) {
+		if (!entries[i].buffer.hasDynamicOffset) {
+			continue;
+		}
+		uint32_t j = count++;
+		while (j > 0 && bindings[j - 1] > entries[i].binding) {
+			bindings[j] = bindings[j - 1];
+			layout->dynamic_offset_order[j] = layout->dynamic_offset_order[j - 1];
+			j--;
+		}
+		bindings[j] = entries[i].binding;
+		layout->dynamic_offset_order[j] = (uint8_t)(count - 1);
+	}
+}
+
+static void sort_bindings(const VkDescriptorSetLayoutBinding **bindings, uint32_t count) {
+	for (uint32_t i = 1; i < count; i++) {
+		const VkDescriptorSetLayoutBinding *key = bindings[i];
+		uint32_t j = i;
+		while (j > 0 && bindings[j - 1]->binding > key->binding) {
+			bindings[j] = bindings[j - 1];
+			j--;
+		}
+		bindings[j] = key;
+	}
+}
+
+/* Fill the type-dependent part of a layout entry. Returns VK_FALSE for
+ * descriptor types that have no WebGPU equivalent. */
+static VkBool32 fill_layout_entry(WGPUBindGroupLayoutEntry *entry, uint32_t descriptor_type) {
+	switch (descriptor_type) {
+	case 0: // VK_DESCRIPTOR_TYPE_SAMPLER
+		entry->sampler.type = WGPUSamplerBindingType_Filtering;
+		return VK_TRUE;
+	case 1: // VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+		entry->texture.sampleType = WGPUTextureSampleType_Float;
+		entry->texture.viewDimension = WGPUTextureViewDimension_2D;
+		entry->sampler.type = WGPUSamplerBindingType_Filtering;
+		return VK_TRUE;
+	case 2: // VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+		entry->texture.sampleType = WGPUTextureSampleType_Float;
+		entry->texture.viewDimension = WGPUTextureViewDimension_2D;
+		return VK_TRUE;
+	case 3: // VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+		entry->storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
+		entry->storageTexture.format = WGVK_STORAGE_TEXTURE_FORMAT;
+		entry->storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+		return VK_TRUE;
+	case 4: // VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+		entry->texture.sampleType = WGPUTextureSampleType_Float;
+		entry->texture.viewDimension = WGPUTextureViewDimension_1D;
+		return VK_TRUE;
+	case 5: // VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+		entry->storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
+		entry->storageTexture.format = WGVK_STORAGE_TEXTURE_FORMAT;
+		entry->storageTexture.viewDimension = WGPUTextureViewDimension_1D;
+		return VK_TRUE;
+	case 6: // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+		entry->buffer.type = WGPUBufferBindingType_Uniform;
+		entry->buffer.hasDynamicOffset = VK_FALSE;
+		return VK_TRUE;
+	case 7: // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+		entry->buffer.type = WGPUBufferBindingType_Storage;
+		entry->buffer.hasDynamicOffset = VK_FALSE;
+		return VK_TRUE;
+	case 8: // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+		entry->buffer.type = WGPUBufferBindingType_Uniform;
+		entry->buffer.hasDynamicOffset = VK_TRUE;
+		return VK_TRUE;
+	case 9: // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+		entry->buffer.type = WGPUBufferBindingType_Storage;
+		entry->buffer.hasDynamicOffset = VK_TRUE;
+		return VK_TRUE;
+	case 10: // VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, read with textureLoad
+		entry->texture.sampleType = WGPUTextureSampleType_UnfilterableFloat;
+		entry->texture.viewDimension = WGPUTextureViewDimension_2D;
+		return VK_TRUE;
+	default:
+		return VK_FALSE;
 	}
+}
+
+#define WGVK_BGL_KEY_WORDS_PER_ENTRY 13
 
-	wgvk_free(layout);
+/* Canonical form of the translated entries: every field WebGPU compares
+ * when matching layouts, with pointers and padding left out. */
+static void write_layout_key(uint32_t *key, const WGPUBindGroupLayoutEntry *entries,
+                             uint32_t entry_count) {
+	for (uint32_t i = 0; i < entry_count; i++) {
+		const WGPUBindGroupLayoutEntry *e = &entries[i];
+		uint32_t *k = &key[i * WGVK_BGL_KEY_WORDS_PER_ENTRY];
+		k[0] = e->binding;
+		k[1] = (uint32_t)e->visibility;
+		k[2] = (uint32_t)e->buffer.type;
+		k[3] = (uint32_t)e->buffer.hasDynamicOffset;
+		k[4] = (uint32_t)e->buffer.minBindingSize;
+		k[5] = (uint32_t)((uint64_t)e->buffer.minBindingSize >> 32);
+		k[6] = (uint32_t)e->sampler.type;
+		k[7] = (uint32_t)e->texture.sampleType;
+		k[8] = (uint32_t)e->texture.viewDimension;
+		k[9] = (uint32_t)e->texture.multisampled;
+		k[10] = (uint32_t)e->storageTexture.access;
+		k[11] = (uint32_t)e->storageTexture.format;
+		k[12] = (uint32_t)e->storageTexture.viewDimension;
+	}
+}
+
+/* Return a shared bind group layout for the entries, creating it on a miss. */
+static WgvkCacheEntry *intern_bind_group_layout(VkDevice device,
+                                                const WGPUBindGroupLayoutEntry *entries,
+                                                uint32_t entry_count) {
+	uint32_t key_words = entry_count * WGVK_BGL_KEY_WORDS_PER_ENTRY;
+	uint32_t *key = wgvk_alloc(sizeof(uint32_t) * (key_words + 1));
+	if (!key) {
+		return NULL;
+	}
+	write_layout_key(key, entries, entry_count);
+
+	WgvkCacheEntry *interned = wgvk_cache_acquire(&device->bind_group_layout_cache, key, key_words);
+	if (!interned) {
+		WGPUBindGroupLayoutDescriptor desc = {0};
+		desc.nextInChain = NULL;
+		desc.label = (WGPUStringView){.data = "VkDescriptorSetLayout", .length = WGPU_STRLEN};
+		desc.entryCount = entry_count;
+		desc.entries = entries;
+
+		WGPUBindGroupLayout wgpu_layout =
+		    wgpuDeviceCreateBindGroupLayout(device->wgpu_device, &desc);
+		interned = wgvk_cache_insert(&device->bind_group_layout_cache, key, key_words, wgpu_layout);
+		if (!interned && wgpu_layout) {
+			wgpuBindGroupLayoutRelease(wgpu_layout);
+		}
+	}
+
+	wgvk_free(key);
+	return interned;
 }
 
 VkResult vkCreateDescriptorSetLayout(VkDevice device,
                                      const VkDescriptorSetLayoutCreateInfo *pCreateInfo,
                                      const VkAllocationCallbacks *pAllocator,
                                      VkDescriptorSetLayout *pSetLayout) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateDescriptorSetLayout);
 
 	if (!device || !pCreateInfo || !pSetLayout) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkDescriptorSetLayout layout = wgvk_alloc(sizeof(struct VkDescriptorSetLayout_T));
-	if (!layout) {
+	uint32_t binding_count = pCreateInfo->bindingCount;
+	uint32_t descriptor_total = 0;
+	for (uint32_t i = 0; i < binding_count; i++) {
+		descriptor_total += pCreateInfo->pBindings[i].descriptorCount;
+	}
+
+	VkDescriptorSetLayout layout =
+	    wgvk_object_alloc(sizeof(struct VkDescriptorSetLayout_T),
+	                      VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, pAllocator, device->base.allocator);
+	const VkDescriptorSetLayoutBinding **sorted =
+	    wgvk_alloc(sizeof(*sorted) * (binding_count + 1));
+	WGPUBindGroupLayoutEntry *entries =
+	    wgvk_alloc(sizeof(WGPUBindGroupLayoutEntry) * (descriptor_total + 1));
+	if (layout) {
+		layout->bindings = wgvk_alloc(sizeof(WgvkDescriptorBinding) * (binding_count + 1));
+	}
+	if (!layout || !layout->bindings || !sorted || !entries) {
+		if (layout) {
+			wgvk_free(layout->bindings);
+		}
+		wgvk_object_free(layout);
+		wgvk_free(sorted);
+		wgvk_free(entries);
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&layout->base, destroy_descriptor_set_layout);
+	wgvk_object_init(&layout->base, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+	                 destroy_descriptor_set_layout);
 	layout->device = device;
 	layout->wgpu_layout = NULL;
-	layout->binding_count = pCreateInfo->bindingCount;
+	layout->interned = NULL;
+	layout->binding_count = 0;
+	layout->dynamic_offset_count = 0;
 
-	// Build WebGPU bind group layout entries
-	WGPUBindGroupLayoutEntry entries[32] = {0};
+	// Vulkan consumes dynamic offsets in binding-number order, so walk the
+	// bindings sorted by number regardless of the order the app declared them.
+	// WebGPU applies them in its own binding order; see
+	// write_dynamic_offset_order.
+	for (uint32_t i = 0; i < binding_count; i++) {
+		sorted[i] = &pCreateInfo->pBindings[i];
+	}
+	sort_bindings(sorted, binding_count);
+
+	// Build WebGPU bind group layout entries. Core WebGPU has no binding
+	// arrays, so each element of an arrayed binding becomes its own entry:
+	// element 0 keeps the Vulkan binding number and the rest are numbered
+	// densely past the highest binding of the set. The WGSL generator gets
+	// the same table, so shaders and bind groups agree.
 	uint32_t entry_count = 0;
+	uint32_t next_extra = 0;
+	for (uint32_t i = 0; i < binding_count; i++) {
+		if (sorted[i]->descriptorCount > 0 && sorted[i]->binding + 1 > next_extra) {
+			next_extra = sorted[i]->binding + 1;
+		}
+	}
+
+	for (uint32_t i = 0; i < binding_count; i++) {
+		const VkDescriptorSetLayoutBinding *binding = sorted[i];
+		WGPUBindGroupLayoutEntry proto = {0};
 
-	for (uint32_t i = 0; i < pCreateInfo->bindingCount && entry_count < 32; i++) {
-		const VkDescriptorSetLayoutBinding *binding = &pCreateInfo->pBindings[i];
-		WGPUBindGroupLayoutEntry *entry = &entries[entry_count];
-
-		entry->binding = binding->binding;
-		entry->visibility =
-		    WGPUShaderStage_Vertex | WGPUShaderStage_Fragment | WGPUShaderStage_Compute;
-
-		switch (binding->descriptorType) {
-		case 0: // VK_DESCRIPTOR_TYPE_SAMPLER
-			entry->sampler.type = WGPUSamplerBindingType_Filtering;
-			entry_count++;
-			break;
-		case 1: // VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
-			entry->texture.sampleType = WGPUTextureSampleType_Float;
-			entry->texture.viewDimension = WGPUTextureViewDimension_2D;
-			entry->sampler.type = WGPUSamplerBindingType_Filtering;
-			entry_count++;
-			break;
-		case 2: // VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
-			entry->texture.sampleType = WGPUTextureSampleType_Float;
-			entry->texture.viewDimension = WGPUTextureViewDimension_2D;
-			entry_count++;
-			break;
-		case 3: // VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
-			entry->storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
-			entry->storageTexture.format = WGPUTextureFormat_RGBA8Unorm;
-			entry->storageTexture.viewDimension = WGPUTextureViewDimension_2D;
-			entry_count++;
-			break;
-		case 4: // VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
-			entry->texture.sampleType = WGPUTextureSampleType_Float;
-			entry->texture.viewDimension = WGPUTextureViewDimension_1D;
-			entry_count++;
-			break;
-		case 5: // VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
-			entry->storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
-			entry->storageTexture.format = WGPUTextureFormat_RGBA8Unorm;
-			entry->storageTexture.viewDimension = WGPUTextureViewDimension_1D;
-			entry_count++;
-			break;
-		case 6: // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
-			entry->buffer.type = WGPUBufferBindingType_Uniform;
-			entry->buffer.hasDynamicOffset = VK_FALSE;
-			entry_count++;
-			break;
-		case 7: // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
-			entry->buffer.type = WGPUBufferBindingType_Storage;
-			entry->buffer.hasDynamicOffset = VK_FALSE;
-			entry_count++;
-			break;
-		case 8: // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
-			entry->buffer.type = WGPUBufferBindingType_Uniform;
-			entry->buffer.hasDynamicOffset = VK_TRUE;
-			entry_count++;
-			break;
-		case 9: // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
-			entry->buffer.type = WGPUBufferBindingType_Storage;
-			entry->buffer.hasDynamicOffset = VK_TRUE;
-			entry_count++;
-			break;
-		default:
-			break;
+		if (binding->descriptorCount == 0 ||
+		    !fill_layout_entry(&proto, binding->descriptorType)) {
+			continue;
+		}
+
+		WgvkDescriptorBinding *info = &layout->bindings[layout->binding_count++];
+		info->binding = binding->binding;
+		info->descriptor_type = binding->descriptorType;
+		info->descriptor_count = binding->descriptorCount;
+		info->entry_index = entry_count;
+		info->first_extra = next_extra;
+		next_extra += binding->descriptorCount - 1;
+
+		if (next_extra > WGVK_MAX_BINDING_NUMBER) {
+			WGVK_ERROR(WGVK_LOG_CAT_PIPELINE,
+			           "vkCreateDescriptorSetLayout: binding %u[%u] needs WebGPU bindings past "
+			           "maxBindingsPerBindGroup",
+			           binding->binding, binding->descriptorCount);
+			wgvk_free(sorted);
+			wgvk_free(entries);
+			wgvk_free(layout->bindings);
+			wgvk_object_free(layout);
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		for (uint32_t e = 0; e < binding->descriptorCount; e++) {
+			WGPUBindGroupLayoutEntry *entry = &entries[entry_count++];
+			*entry = proto;
+			entry->binding = wgvk_descriptor_wgpu_binding(info, e);
+			entry->visibility =
+			    WGPUShaderStage_Vertex | WGPUShaderStage_Fragment | WGPUShaderStage_Compute;
+			if (proto.buffer.hasDynamicOffset) {
+				layout->dynamic_offset_count++;
+			}
 		}
 	}
+	layout->entry_count = entry_count;
 
-	// Create WebGPU bind group layout
-	WGPUBindGroupLayoutDescriptor desc = {0};
-	desc.nextInChain = NULL;
-	desc.label = (WGPUStringView){.data = "VkDescriptorSetLayout", .length = WGPU_STRLEN};
-	desc.entryCount = entry_count;
-	desc.entries = entries;
+	// Offsets are kept per bound set in fixed arrays; WebGPU's own limits
+	// on dynamic buffers are lower still.
+	if (layout->dynamic_offset_count > WGVK_MAX_DYNAMIC_OFFSETS) {
+		WGVK_ERROR(WGVK_LOG_CAT_PIPELINE,
+		           "vkCreateDescriptorSetLayout: %u dynamic buffer descriptors, at most %d",
+		           layout->dynamic_offset_count, WGVK_MAX_DYNAMIC_OFFSETS);
+		wgvk_free(sorted);
+		wgvk_free(entries);
+		wgvk_free(layout->bindings);
+		wgvk_object_free(layout);
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
+	write_dynamic_offset_order(layout, entries, entry_count);
+
+	// Share one WebGPU bind group layout between identical Vulkan layouts
+	layout->interned = intern_bind_group_layout(device, entries, entry_count);
+
+	wgvk_free(sorted);
+	wgvk_free(entries);
 
-	layout->wgpu_layout = wgpuDeviceCreateBindGroupLayout(device->wgpu_device, &desc);
+	if (!layout->interned) {
+		wgvk_free(layout->bindings);
+		wgvk_object_free(layout);
+		return VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+	layout->wgpu_layout = layout->interned->object;
 
 	*pSetLayout = layout;
 	return VK_SUCCESS;
@@ -115,6 +296,7 @@ VkResult vkCreateDescriptorSetLayout(VkDevice device,
 
 void vkDestroyDescriptorSetLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout,
                                   const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyDescriptorSetLayout);
 	(void)device;
 	(void)pAllocator;
 
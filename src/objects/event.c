@@ -2,24 +2,25 @@
 
 static void destroy_event(void *obj) {
 	VkEvent event = (VkEvent)obj;
-	wgvk_free(event);
+	wgvk_object_free(event);
 }
 
 VkResult vkCreateEvent(VkDevice device, const void *pCreateInfo,
                        const VkAllocationCallbacks *pAllocator, VkEvent *pEvent) {
+	WGVK_STAT_CALL(vkCreateEvent);
 	(void)pCreateInfo;
-	(void)pAllocator;
 
 	if (!device || !pEvent) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkEvent event = wgvk_alloc(sizeof(struct VkEvent_T));
+	VkEvent event = wgvk_object_alloc(sizeof(struct VkEvent_T), VK_OBJECT_TYPE_EVENT, pAllocator,
+	                                  device->base.allocator);
 	if (!event) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&event->base, destroy_event);
+	wgvk_object_init(&event->base, VK_OBJECT_TYPE_EVENT, destroy_event);
 	event->device = device;
 	event->signaled = VK_FALSE;
 
@@ -28,6 +29,7 @@ VkResult vkCreateEvent(VkDevice device, const void *pCreateInfo,
 }
 
 void vkDestroyEvent(VkDevice device, VkEvent event, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyEvent);
 	(void)device;
 	(void)pAllocator;
 
@@ -37,6 +39,7 @@ void vkDestroyEvent(VkDevice device, VkEvent event, const VkAllocationCallbacks
 }
 
 VkResult vkSetEvent(VkDevice device, VkEvent event) {
+	WGVK_STAT_CALL(vkSetEvent);
 	(void)device;
 
 	if (!event) {
@@ -48,6 +51,7 @@ VkResult vkSetEvent(VkDevice device, VkEvent event) {
 }
 
 VkResult vkResetEvent(VkDevice device, VkEvent event) {
+	WGVK_STAT_CALL(vkResetEvent);
 	(void)device;
 
 	if (!event) {
@@ -59,6 +63,7 @@ VkResult vkResetEvent(VkDevice device, VkEvent event) {
 }
 
 VkResult vkGetEventStatus(VkDevice device, VkEvent event) {
+	WGVK_STAT_CALL(vkGetEventStatus);
 	(void)device;
 
 	if (!event) {
@@ -2,23 +2,24 @@
 
 static void destroy_fence(void *obj) {
 	VkFence fence = (VkFence)obj;
-	wgvk_free(fence);
+	wgvk_object_free(fence);
 }
 
 VkResult vkCreateFence(VkDevice device, const VkFenceCreateInfo *pCreateInfo,
                        const VkAllocationCallbacks *pAllocator, VkFence *pFence) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateFence);
 
 	if (!device || !pFence) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkFence fence = wgvk_alloc(sizeof(struct VkFence_T));
+	VkFence fence = wgvk_object_alloc(sizeof(struct VkFence_T), VK_OBJECT_TYPE_FENCE, pAllocator,
+	                                  device->base.allocator);
 	if (!fence) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&fence->base, destroy_fence);
+	wgvk_object_init(&fence->base, VK_OBJECT_TYPE_FENCE, destroy_fence);
 	fence->device = device;
 	fence->signaled = (pCreateInfo && (pCreateInfo->flags & 0x00000001)) ? VK_TRUE : VK_FALSE;
 
@@ -27,6 +28,7 @@ VkResult vkCreateFence(VkDevice device, const VkFenceCreateInfo *pCreateInfo,
 }
 
 void vkDestroyFence(VkDevice device, VkFence fence, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyFence);
 	(void)device;
 	(void)pAllocator;
 
@@ -36,6 +38,7 @@ void vkDestroyFence(VkDevice device, VkFence fence, const VkAllocationCallbacks
 }
 
 VkResult vkResetFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences) {
+	WGVK_STAT_CALL(vkResetFences);
 	(void)device;
 
 	if (!pFences) {
@@ -52,6 +55,7 @@ VkResult vkResetFences(VkDevice device, uint32_t fenceCount, const VkFence *pFen
 }
 
 VkResult vkGetFenceStatus(VkDevice device, VkFence fence) {
+	WGVK_STAT_CALL(vkGetFenceStatus);
 	(void)device;
 
 	if (!fence) {
@@ -63,6 +67,7 @@ VkResult vkGetFenceStatus(VkDevice device, VkFence fence) {
 
 VkResult vkWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences,
                          VkBool32 waitAll, uint64_t timeout) {
+	WGVK_STAT_CALL(vkWaitForFences);
 	(void)device;
 	(void)timeout;
 
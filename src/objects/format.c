@@ -0,0 +1,423 @@
+#include "webvulkan_internal.h"
+
+/* Map a Vulkan format to the WebGPU texture format with the same memory
+ * layout. See: https://www.w3.org/TR/webgpu/#texture-format-caps
+ * Returns WGPUTextureFormat_Undefined when WebGPU has no equivalent. */
+WGPUTextureFormat wgvk_format_to_wgpu(uint32_t vk_format) {
+	switch (vk_format) {
+	case VK_FORMAT_R8_UNORM:
+		return WGPUTextureFormat_R8Unorm;
+	case VK_FORMAT_R8_SNORM:
+		return WGPUTextureFormat_R8Snorm;
+	case VK_FORMAT_R8_UINT:
+		return WGPUTextureFormat_R8Uint;
+	case VK_FORMAT_R8_SINT:
+		return WGPUTextureFormat_R8Sint;
+	case VK_FORMAT_R8G8_UNORM:
+		return WGPUTextureFormat_RG8Unorm;
+	case VK_FORMAT_R8G8_SNORM:
+		return WGPUTextureFormat_RG8Snorm;
+	case VK_FORMAT_R8G8_UINT:
+		return WGPUTextureFormat_RG8Uint;
+	case VK_FORMAT_R8G8_SINT:
+		return WGPUTextureFormat_RG8Sint;
+	case VK_FORMAT_R8G8B8A8_UNORM:
+		return WGPUTextureFormat_RGBA8Unorm;
+	case VK_FORMAT_R8G8B8A8_SRGB:
+		return WGPUTextureFormat_RGBA8UnormSrgb;
+	case VK_FORMAT_R8G8B8A8_SNORM:
+		return WGPUTextureFormat_RGBA8Snorm;
+	case VK_FORMAT_R8G8B8A8_UINT:
+		return WGPUTextureFormat_RGBA8Uint;
+	case VK_FORMAT_R8G8B8A8_SINT:
+		return WGPUTextureFormat_RGBA8Sint;
+	case VK_FORMAT_B8G8R8A8_UNORM:
+		return WGPUTextureFormat_BGRA8Unorm;
+	case VK_FORMAT_B8G8R8A8_SRGB:
+		return WGPUTextureFormat_BGRA8UnormSrgb;
+	case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		return WGPUTextureFormat_RGB10A2Unorm;
+	case VK_FORMAT_A2B10G10R10_UINT_PACK32:
+		return WGPUTextureFormat_RGB10A2Uint;
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+		return WGPUTextureFormat_RG11B10Ufloat;
+	case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+		return WGPUTextureFormat_RGB9E5Ufloat;
+	case VK_FORMAT_R16_UINT:
+		return WGPUTextureFormat_R16Uint;
+	case VK_FORMAT_R16_SINT:
+		return WGPUTextureFormat_R16Sint;
+	case VK_FORMAT_R16_SFLOAT:
+		return WGPUTextureFormat_R16Float;
+	case VK_FORMAT_R16G16_UINT:
+		return WGPUTextureFormat_RG16Uint;
+	case VK_FORMAT_R16G16_SINT:
+		return WGPUTextureFormat_RG16Sint;
+	case VK_FORMAT_R16G16_SFLOAT:
+		return WGPUTextureFormat_RG16Float;
+	case VK_FORMAT_R16G16B16A16_UINT:
+		return WGPUTextureFormat_RGBA16Uint;
+	case VK_FORMAT_R16G16B16A16_SINT:
+		return WGPUTextureFormat_RGBA16Sint;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+		return WGPUTextureFormat_RGBA16Float;
+	case VK_FORMAT_R32_UINT:
+		return WGPUTextureFormat_R32Uint;
+	case VK_FORMAT_R32_SINT:
+		return WGPUTextureFormat_R32Sint;
+	case VK_FORMAT_R32_SFLOAT:
+		return WGPUTextureFormat_R32Float;
+	case VK_FORMAT_R32G32_UINT:
+		return WGPUTextureFormat_RG32Uint;
+	case VK_FORMAT_R32G32_SINT:
+		return WGPUTextureFormat_RG32Sint;
+	case VK_FORMAT_R32G32_SFLOAT:
+		return WGPUTextureFormat_RG32Float;
+	case VK_FORMAT_R32G32B32A32_UINT:
+		return WGPUTextureFormat_RGBA32Uint;
+	case VK_FORMAT_R32G32B32A32_SINT:
+		return WGPUTextureFormat_RGBA32Sint;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return WGPUTextureFormat_RGBA32Float;
+	case VK_FORMAT_D16_UNORM:
+		return WGPUTextureFormat_Depth16Unorm;
+	case VK_FORMAT_X8_D24_UNORM_PACK32:
+		return WGPUTextureFormat_Depth24Plus;
+	case VK_FORMAT_D32_SFLOAT:
+		return WGPUTextureFormat_Depth32Float;
+	case VK_FORMAT_S8_UINT:
+		return WGPUTextureFormat_Stencil8;
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+		return WGPUTextureFormat_Depth24PlusStencil8;
+	case VK_FORMAT_D32_SFLOAT_S8_UINT:
+		return WGPUTextureFormat_Depth32FloatStencil8;
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		return WGPUTextureFormat_BC1RGBAUnorm;
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		return WGPUTextureFormat_BC1RGBAUnormSrgb;
+	case VK_FORMAT_BC2_UNORM_BLOCK:
+		return WGPUTextureFormat_BC2RGBAUnorm;
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+		return WGPUTextureFormat_BC2RGBAUnormSrgb;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+		return WGPUTextureFormat_BC3RGBAUnorm;
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		return WGPUTextureFormat_BC3RGBAUnormSrgb;
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		return WGPUTextureFormat_BC4RUnorm;
+	case VK_FORMAT_BC4_SNORM_BLOCK:
+		return WGPUTextureFormat_BC4RSnorm;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		return WGPUTextureFormat_BC5RGUnorm;
+	case VK_FORMAT_BC5_SNORM_BLOCK:
+		return WGPUTextureFormat_BC5RGSnorm;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+		return WGPUTextureFormat_BC7RGBAUnorm;
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return WGPUTextureFormat_BC7RGBAUnormSrgb;
+	case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+		return WGPUTextureFormat_ETC2RGB8Unorm;
+	case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+		return WGPUTextureFormat_ETC2RGB8UnormSrgb;
+	case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+		return WGPUTextureFormat_ETC2RGB8A1Unorm;
+	case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+		return WGPUTextureFormat_ETC2RGB8A1UnormSrgb;
+	case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+		return WGPUTextureFormat_ETC2RGBA8Unorm;
+	case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+		return WGPUTextureFormat_ETC2RGBA8UnormSrgb;
+	case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+		return WGPUTextureFormat_EACR11Unorm;
+	case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+		return WGPUTextureFormat_EACR11Snorm;
+	case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+		return WGPUTextureFormat_EACRG11Unorm;
+	case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+		return WGPUTextureFormat_EACRG11Snorm;
+	default:
+		/* Both APIs list the ASTC block sizes in the same order, each as a
+		 * unorm and sRGB pair. */
+		if (vk_format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK &&
+		    vk_format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+			return (WGPUTextureFormat)(WGPUTextureFormat_ASTC4x4Unorm +
+			                           (vk_format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK));
+		return WGPUTextureFormat_Undefined;
+	}
+}
+
+/* How shaders may read a format, or BindingNotUsed for unmapped formats. */
+WGPUTextureSampleType wgvk_format_sample_type(uint32_t vk_format) {
+	switch (wgvk_format_to_wgpu(vk_format)) {
+	case WGPUTextureFormat_Undefined:
+		return WGPUTextureSampleType_BindingNotUsed;
+	case WGPUTextureFormat_R8Uint:
+	case WGPUTextureFormat_RG8Uint:
+	case WGPUTextureFormat_RGBA8Uint:
+	case WGPUTextureFormat_RGB10A2Uint:
+	case WGPUTextureFormat_R16Uint:
+	case WGPUTextureFormat_RG16Uint:
+	case WGPUTextureFormat_RGBA16Uint:
+	case WGPUTextureFormat_R32Uint:
+	case WGPUTextureFormat_RG32Uint:
+	case WGPUTextureFormat_RGBA32Uint:
+	case WGPUTextureFormat_Stencil8:
+		return WGPUTextureSampleType_Uint;
+	case WGPUTextureFormat_R8Sint:
+	case WGPUTextureFormat_RG8Sint:
+	case WGPUTextureFormat_RGBA8Sint:
+	case WGPUTextureFormat_R16Sint:
+	case WGPUTextureFormat_RG16Sint:
+	case WGPUTextureFormat_RGBA16Sint:
+	case WGPUTextureFormat_R32Sint:
+	case WGPUTextureFormat_RG32Sint:
+	case WGPUTextureFormat_RGBA32Sint:
+		return WGPUTextureSampleType_Sint;
+	case WGPUTextureFormat_Depth16Unorm:
+	case WGPUTextureFormat_Depth24Plus:
+	case WGPUTextureFormat_Depth24PlusStencil8:
+	case WGPUTextureFormat_Depth32Float:
+	case WGPUTextureFormat_Depth32FloatStencil8:
+		return WGPUTextureSampleType_Depth;
+	case WGPUTextureFormat_R32Float:
+	case WGPUTextureFormat_RG32Float:
+	case WGPUTextureFormat_RGBA32Float:
+		/* Filtering these needs the float32-filterable feature. */
+		return WGPUTextureSampleType_UnfilterableFloat;
+	default:
+		return WGPUTextureSampleType_Float;
+	}
+}
+
+/* Whether a format can be a color attachment without optional features. */
+VkBool32 wgvk_format_is_color_renderable(uint32_t vk_format) {
+	switch (wgvk_format_to_wgpu(vk_format)) {
+	case WGPUTextureFormat_Undefined:
+	case WGPUTextureFormat_R8Snorm:
+	case WGPUTextureFormat_RG8Snorm:
+	case WGPUTextureFormat_RGBA8Snorm:
+	case WGPUTextureFormat_RG11B10Ufloat:
+	case WGPUTextureFormat_RGB9E5Ufloat:
+		return VK_FALSE;
+	default:
+		break;
+	}
+	WGPUTextureSampleType type = wgvk_format_sample_type(vk_format);
+	if (type == WGPUTextureSampleType_Depth || vk_format == VK_FORMAT_S8_UINT) {
+		return VK_FALSE;
+	}
+	/* Block-compressed formats are sample-only. */
+	return wgvk_format_to_wgpu(vk_format) < WGPUTextureFormat_BC1RGBAUnorm;
+}
+
+/* Every ASTC block is 16 bytes; only its footprint varies. */
+static const WgvkFormatBlock astc_blocks[] = {
+    {16, 4, 4},  {16, 5, 4},  {16, 5, 5},  {16, 6, 5},   {16, 6, 6},
+    {16, 8, 5},  {16, 8, 6},  {16, 8, 8},  {16, 10, 5},  {16, 10, 6},
+    {16, 10, 8}, {16, 10, 10}, {16, 12, 10}, {16, 12, 12},
+};
+
+/* Size of one texel block of the given aspect, as laid out in buffer
+ * copies. block_size is 0 when the aspect cannot be copied: WebGPU keeps
+ * the depth of 24-bit depth formats opaque. */
+WgvkFormatBlock wgvk_format_block(uint32_t vk_format, VkImageAspectFlags aspect) {
+	WgvkFormatBlock block = {0, 1, 1};
+
+	if (aspect & VK_IMAGE_ASPECT_STENCIL_BIT) {
+		block.block_size = wgvk_format_has_stencil(vk_format) ? 1 : 0;
+		return block;
+	}
+
+	switch (wgvk_format_to_wgpu(vk_format)) {
+	case WGPUTextureFormat_R8Unorm:
+	case WGPUTextureFormat_R8Snorm:
+	case WGPUTextureFormat_R8Uint:
+	case WGPUTextureFormat_R8Sint:
+	case WGPUTextureFormat_Stencil8:
+		block.block_size = 1;
+		break;
+	case WGPUTextureFormat_R16Uint:
+	case WGPUTextureFormat_R16Sint:
+	case WGPUTextureFormat_R16Float:
+	case WGPUTextureFormat_RG8Unorm:
+	case WGPUTextureFormat_RG8Snorm:
+	case WGPUTextureFormat_RG8Uint:
+	case WGPUTextureFormat_RG8Sint:
+	case WGPUTextureFormat_Depth16Unorm:
+		block.block_size = 2;
+		break;
+	case WGPUTextureFormat_R32Float:
+	case WGPUTextureFormat_R32Uint:
+	case WGPUTextureFormat_R32Sint:
+	case WGPUTextureFormat_RG16Uint:
+	case WGPUTextureFormat_RG16Sint:
+	case WGPUTextureFormat_RG16Float:
+	case WGPUTextureFormat_RGBA8Unorm:
+	case WGPUTextureFormat_RGBA8UnormSrgb:
+	case WGPUTextureFormat_RGBA8Snorm:
+	case WGPUTextureFormat_RGBA8Uint:
+	case WGPUTextureFormat_RGBA8Sint:
+	case WGPUTextureFormat_BGRA8Unorm:
+	case WGPUTextureFormat_BGRA8UnormSrgb:
+	case WGPUTextureFormat_RGB10A2Uint:
+	case WGPUTextureFormat_RGB10A2Unorm:
+	case WGPUTextureFormat_RG11B10Ufloat:
+	case WGPUTextureFormat_RGB9E5Ufloat:
+	case WGPUTextureFormat_Depth32Float:
+	case WGPUTextureFormat_Depth32FloatStencil8: /* depth aspect */
+		block.block_size = 4;
+		break;
+	case WGPUTextureFormat_RG32Float:
+	case WGPUTextureFormat_RG32Uint:
+	case WGPUTextureFormat_RG32Sint:
+	case WGPUTextureFormat_RGBA16Float:
+	case WGPUTextureFormat_RGBA16Uint:
+	case WGPUTextureFormat_RGBA16Sint:
+		block.block_size = 8;
+		break;
+	case WGPUTextureFormat_RGBA32Float:
+	case WGPUTextureFormat_RGBA32Uint:
+	case WGPUTextureFormat_RGBA32Sint:
+		block.block_size = 16;
+		break;
+	case WGPUTextureFormat_BC1RGBAUnorm:
+	case WGPUTextureFormat_BC1RGBAUnormSrgb:
+	case WGPUTextureFormat_BC4RUnorm:
+	case WGPUTextureFormat_BC4RSnorm:
+		block = (WgvkFormatBlock){8, 4, 4};
+		break;
+	case WGPUTextureFormat_BC2RGBAUnorm:
+	case WGPUTextureFormat_BC2RGBAUnormSrgb:
+	case WGPUTextureFormat_BC3RGBAUnorm:
+	case WGPUTextureFormat_BC3RGBAUnormSrgb:
+	case WGPUTextureFormat_BC5RGUnorm:
+	case WGPUTextureFormat_BC5RGSnorm:
+	case WGPUTextureFormat_BC7RGBAUnorm:
+	case WGPUTextureFormat_BC7RGBAUnormSrgb:
+	case WGPUTextureFormat_ETC2RGBA8Unorm:
+	case WGPUTextureFormat_ETC2RGBA8UnormSrgb:
+	case WGPUTextureFormat_EACRG11Unorm:
+	case WGPUTextureFormat_EACRG11Snorm:
+		block = (WgvkFormatBlock){16, 4, 4};
+		break;
+	case WGPUTextureFormat_ETC2RGB8Unorm:
+	case WGPUTextureFormat_ETC2RGB8UnormSrgb:
+	case WGPUTextureFormat_ETC2RGB8A1Unorm:
+	case WGPUTextureFormat_ETC2RGB8A1UnormSrgb:
+	case WGPUTextureFormat_EACR11Unorm:
+	case WGPUTextureFormat_EACR11Snorm:
+		block = (WgvkFormatBlock){8, 4, 4};
+		break;
+	default:
+		if (vk_format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK &&
+		    vk_format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+			block = astc_blocks[(vk_format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+		}
+		/* Depth24Plus and friends, and unmapped formats */
+		break;
+	}
+	return block;
+}
+
+VkBool32 wgvk_format_has_depth(uint32_t vk_format) {
+	return vk_format >= VK_FORMAT_D16_UNORM && vk_format <= VK_FORMAT_D32_SFLOAT_S8_UINT &&
+	       vk_format != VK_FORMAT_S8_UINT;
+}
+
+VkBool32 wgvk_format_has_stencil(uint32_t vk_format) {
+	return vk_format >= VK_FORMAT_S8_UINT && vk_format <= VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+WGPUTextureAspect wgvk_aspect_to_wgpu(VkImageAspectFlags aspect) {
+	if (aspect == VK_IMAGE_ASPECT_DEPTH_BIT)
+		return WGPUTextureAspect_DepthOnly;
+	if (aspect == VK_IMAGE_ASPECT_STENCIL_BIT)
+		return WGPUTextureAspect_StencilOnly;
+	return WGPUTextureAspect_All;
+}
+
+WGPUTextureFormat wgvk_format_srgb_pair(WGPUTextureFormat format) {
+	switch (format) {
+	case WGPUTextureFormat_RGBA8Unorm:
+		return WGPUTextureFormat_RGBA8UnormSrgb;
+	case WGPUTextureFormat_RGBA8UnormSrgb:
+		return WGPUTextureFormat_RGBA8Unorm;
+	case WGPUTextureFormat_BGRA8Unorm:
+		return WGPUTextureFormat_BGRA8UnormSrgb;
+	case WGPUTextureFormat_BGRA8UnormSrgb:
+		return WGPUTextureFormat_BGRA8Unorm;
+	case WGPUTextureFormat_BC1RGBAUnorm:
+		return WGPUTextureFormat_BC1RGBAUnormSrgb;
+	case WGPUTextureFormat_BC1RGBAUnormSrgb:
+		return WGPUTextureFormat_BC1RGBAUnorm;
+	case WGPUTextureFormat_BC2RGBAUnorm:
+		return WGPUTextureFormat_BC2RGBAUnormSrgb;
+	case WGPUTextureFormat_BC2RGBAUnormSrgb:
+		return WGPUTextureFormat_BC2RGBAUnorm;
+	case WGPUTextureFormat_BC3RGBAUnorm:
+		return WGPUTextureFormat_BC3RGBAUnormSrgb;
+	case WGPUTextureFormat_BC3RGBAUnormSrgb:
+		return WGPUTextureFormat_BC3RGBAUnorm;
+	case WGPUTextureFormat_BC7RGBAUnorm:
+		return WGPUTextureFormat_BC7RGBAUnormSrgb;
+	case WGPUTextureFormat_BC7RGBAUnormSrgb:
+		return WGPUTextureFormat_BC7RGBAUnorm;
+	case WGPUTextureFormat_ETC2RGB8Unorm:
+		return WGPUTextureFormat_ETC2RGB8UnormSrgb;
+	case WGPUTextureFormat_ETC2RGB8UnormSrgb:
+		return WGPUTextureFormat_ETC2RGB8Unorm;
+	case WGPUTextureFormat_ETC2RGB8A1Unorm:
+		return WGPUTextureFormat_ETC2RGB8A1UnormSrgb;
+	case WGPUTextureFormat_ETC2RGB8A1UnormSrgb:
+		return WGPUTextureFormat_ETC2RGB8A1Unorm;
+	case WGPUTextureFormat_ETC2RGBA8Unorm:
+		return WGPUTextureFormat_ETC2RGBA8UnormSrgb;
+	case WGPUTextureFormat_ETC2RGBA8UnormSrgb:
+		return WGPUTextureFormat_ETC2RGBA8Unorm;
+	default:
+		/* ASTC formats alternate unorm and sRGB. */
+		if (format >= WGPUTextureFormat_ASTC4x4Unorm &&
+		    format <= WGPUTextureFormat_ASTC12x12UnormSrgb)
+			return (WGPUTextureFormat)(format ^ 1);
+		return WGPUTextureFormat_Undefined;
+	}
+}
+
+/* The optional WebGPU feature textures of a format need, or VK_FALSE when
+ * every device supports the format. */
+VkBool32 wgvk_format_feature(uint32_t vk_format, WGPUFeatureName *feature) {
+	WGPUTextureFormat format = wgvk_format_to_wgpu(vk_format);
+	if (format >= WGPUTextureFormat_BC1RGBAUnorm && format <= WGPUTextureFormat_BC7RGBAUnormSrgb) {
+		*feature = WGPUFeatureName_TextureCompressionBC;
+		return VK_TRUE;
+	}
+	if (format >= WGPUTextureFormat_ETC2RGB8Unorm && format <= WGPUTextureFormat_EACRG11Snorm) {
+		*feature = WGPUFeatureName_TextureCompressionETC2;
+		return VK_TRUE;
+	}
+	if (format >= WGPUTextureFormat_ASTC4x4Unorm &&
+	    format <= WGPUTextureFormat_ASTC12x12UnormSrgb) {
+		*feature = WGPUFeatureName_TextureCompressionASTC;
+		return VK_TRUE;
+	}
+	return VK_FALSE;
+}
+
+/* Whether the device creates textures of a format as-is. Block-compressed
+ * formats without their feature are decoded on upload instead, see
+ * commands/transcode.h. */
+VkBool32 wgvk_format_is_native(VkDevice device, uint32_t vk_format) {
+	WGPUFeatureName feature;
+	if (!wgvk_format_feature(vk_format, &feature))
+		return VK_TRUE;
+	switch (feature) {
+	case WGPUFeatureName_TextureCompressionBC:
+		return device->texture_compression_bc;
+	case WGPUFeatureName_TextureCompressionETC2:
+		return device->texture_compression_etc2;
+	case WGPUFeatureName_TextureCompressionASTC:
+		return device->texture_compression_astc;
+	default:
+		return VK_FALSE;
+	}
+}
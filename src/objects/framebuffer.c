@@ -7,23 +7,29 @@ static void destroy_framebuffer(void *obj) {
 			wgvk_object_release(&fb->attachments[i]->base);
 		}
 	}
-	wgvk_free(fb);
+	wgvk_object_free(fb);
 }
 
 VkResult vkCreateFramebuffer(VkDevice device, const VkFramebufferCreateInfo *pCreateInfo,
                              const VkAllocationCallbacks *pAllocator, VkFramebuffer *pFramebuffer) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateFramebuffer);
 
 	if (!device || !pCreateInfo || !pFramebuffer) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
+	if (pCreateInfo->attachmentCount > WGVK_MAX_COLOR_ATTACHMENTS + 1) {
+		WGVK_ERROR(WGVK_LOG_CAT_COMMAND, "vkCreateFramebuffer: %u attachments, at most %d",
+		           pCreateInfo->attachmentCount, WGVK_MAX_COLOR_ATTACHMENTS + 1);
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
 
-	VkFramebuffer fb = wgvk_alloc(sizeof(struct VkFramebuffer_T));
+	VkFramebuffer fb = wgvk_object_alloc(sizeof(struct VkFramebuffer_T), VK_OBJECT_TYPE_FRAMEBUFFER,
+	                                     pAllocator, device->base.allocator);
 	if (!fb) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&fb->base, destroy_framebuffer);
+	wgvk_object_init(&fb->base, VK_OBJECT_TYPE_FRAMEBUFFER, destroy_framebuffer);
 	fb->device = device;
 	fb->render_pass = pCreateInfo->renderPass;
 	fb->width = pCreateInfo->width;
@@ -31,8 +37,7 @@ VkResult vkCreateFramebuffer(VkDevice device, const VkFramebufferCreateInfo *pCr
 	fb->layers = pCreateInfo->layers;
 	fb->attachment_count = pCreateInfo->attachmentCount;
 
-	for (uint32_t i = 0; i < pCreateInfo->attachmentCount && i < WGVK_MAX_COLOR_ATTACHMENTS + 1;
-	     i++) {
+	for (uint32_t i = 0; i < pCreateInfo->attachmentCount; i++) {
 		fb->attachments[i] = (VkImageView)pCreateInfo->pAttachments[i];
 		if (fb->attachments[i]) {
 			wgvk_object_retain(&fb->attachments[i]->base);
@@ -45,6 +50,7 @@ VkResult vkCreateFramebuffer(VkDevice device, const VkFramebufferCreateInfo *pCr
 
 void vkDestroyFramebuffer(VkDevice device, VkFramebuffer framebuffer,
                           const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyFramebuffer);
 	(void)device;
 	(void)pAllocator;
 
@@ -1,11 +1,20 @@
 #include "webvulkan_internal.h"
+#include "../commands/transcode.h"
+
+static void release_view(void *object) {
+	wgpuTextureViewRelease((WGPUTextureView)object);
+}
 
 static void destroy_image(void *obj) {
 	VkImage image = (VkImage)obj;
-	if (image->wgpu_texture) {
+	wgvk_cache_destroy(&image->view_cache);
+	if (image->wgpu_texture && image->pooled) {
+		wgvk_texture_pool_release(&image->device->texture_pool, image->pool_key,
+		                          image->wgpu_texture);
+	} else if (image->wgpu_texture) {
 		wgpuTextureRelease(image->wgpu_texture);
 	}
-	wgvk_free(image);
+	wgvk_object_free(image);
 }
 
 static WGPUTextureDimension image_type_to_dimension(uint32_t image_type) {
@@ -21,127 +30,34 @@ static WGPUTextureDimension image_type_to_dimension(uint32_t image_type) {
 	}
 }
 
-static WGPUTextureFormat vulkan_format_to_webgpu(uint32_t vk_format) {
-	/* Map Vulkan format to WebGPU format */
-	/* See: https://www.w3.org/TR/webgpu/#texture-format-caps */
-	switch (vk_format) {
-	case 37:
-		return WGPUTextureFormat_RGBA8Unorm; /* VK_FORMAT_R8G8B8A8_UNORM */
-	case 38:
-		return WGPUTextureFormat_RGBA8Snorm; /* VK_FORMAT_R8G8B8A8_SNORM */
-	case 39:
-		return WGPUTextureFormat_RGBA8Uint; /* VK_FORMAT_R8G8B8A8_UINT */
-	case 40:
-		return WGPUTextureFormat_RGBA8Sint; /* VK_FORMAT_R8G8B8A8_SINT */
-	case 43:
-		return WGPUTextureFormat_BGRA8Unorm; /* VK_FORMAT_B8G8R8A8_UNORM */
-	case 44:
-		return WGPUTextureFormat_BGRA8UnormSrgb; /* VK_FORMAT_B8G8R8A8_SRGB */
-	case 50:
-		return WGPUTextureFormat_Depth16Unorm; /* VK_FORMAT_D16_UNORM */
-	case 55:
-		return WGPUTextureFormat_Depth24Plus; /* VK_FORMAT_X8_D24_UNORM_PACK32 */
-	case 56:
-		return WGPUTextureFormat_Depth32Float; /* VK_FORMAT_D32_SFLOAT */
-	case 57:
-		return WGPUTextureFormat_Depth24PlusStencil8; /* VK_FORMAT_D24_UNORM_S8_UINT */
-	case 58:
-		return WGPUTextureFormat_Depth32FloatStencil8; /* VK_FORMAT_D32_SFLOAT_S8_UINT */
-	case 64:
-		return WGPUTextureFormat_BC1RGBAUnorm; /* VK_FORMAT_BC1_RGBA_UNORM_BLOCK */
-	case 65:
-		return WGPUTextureFormat_BC1RGBAUnormSrgb; /* VK_FORMAT_BC1_RGBA_SRGB_BLOCK */
-	case 66:
-		return WGPUTextureFormat_BC2RGBAUnorm; /* VK_FORMAT_BC2_RGBA_UNORM_BLOCK */
-	case 67:
-		return WGPUTextureFormat_BC2RGBAUnormSrgb; /* VK_FORMAT_BC2_RGBA_SRGB_BLOCK */
-	case 68:
-		return WGPUTextureFormat_BC3RGBAUnorm; /* VK_FORMAT_BC3_RGBA_UNORM_BLOCK */
-	case 69:
-		return WGPUTextureFormat_BC3RGBAUnormSrgb; /* VK_FORMAT_BC3_RGBA_SRGB_BLOCK */
-	case 70:
-		return WGPUTextureFormat_BC4RUnorm; /* VK_FORMAT_BC4_R_UNORM_BLOCK */
-	case 71:
-		return WGPUTextureFormat_BC4RSnorm; /* VK_FORMAT_BC4_R_SNORM_BLOCK */
-	case 72:
-		return WGPUTextureFormat_BC5RGUnorm; /* VK_FORMAT_BC5_RG_UNORM_BLOCK */
-	case 73:
-		return WGPUTextureFormat_BC5RGSnorm; /* VK_FORMAT_BC5_RG_SNORM_BLOCK */
-	case 77:
-		return WGPUTextureFormat_BC7RGBAUnorm; /* VK_FORMAT_BC7_RGBA_UNORM_BLOCK */
-	case 78:
-		return WGPUTextureFormat_BC7RGBAUnormSrgb; /* VK_FORMAT_BC7_RGBA_SRGB_BLOCK */
-	case 91:
-		return WGPUTextureFormat_R8Unorm; /* VK_FORMAT_R8_UNORM */
-	case 92:
-		return WGPUTextureFormat_R8Snorm; /* VK_FORMAT_R8_SNORM */
-	case 93:
-		return WGPUTextureFormat_R8Uint; /* VK_FORMAT_R8_UINT */
-	case 94:
-		return WGPUTextureFormat_R8Sint; /* VK_FORMAT_R8_SINT */
-	case 95:
-		return WGPUTextureFormat_R16Uint; /* VK_FORMAT_R16_UINT */
-	case 96:
-		return WGPUTextureFormat_R16Sint; /* VK_FORMAT_R16_SINT */
-	case 97:
-		return WGPUTextureFormat_R16Float; /* VK_FORMAT_R16_SFLOAT */
-	case 98:
-		return WGPUTextureFormat_RG8Unorm; /* VK_FORMAT_R8G8_UNORM */
-	case 99:
-		return WGPUTextureFormat_RG8Snorm; /* VK_FORMAT_R8G8_SNORM */
-	case 100:
-		return WGPUTextureFormat_RG8Uint; /* VK_FORMAT_R8G8_UINT */
-	case 101:
-		return WGPUTextureFormat_RG8Sint; /* VK_FORMAT_R8G8_SINT */
-	case 103:
-		return WGPUTextureFormat_R32Float; /* VK_FORMAT_R32_SFLOAT */
-	case 104:
-		return WGPUTextureFormat_R32Uint; /* VK_FORMAT_R32_UINT */
-	case 105:
-		return WGPUTextureFormat_R32Sint; /* VK_FORMAT_R32_SINT */
-	case 106:
-		return WGPUTextureFormat_RG16Uint; /* VK_FORMAT_R16G16_UINT */
-	case 107:
-		return WGPUTextureFormat_RG16Sint; /* VK_FORMAT_R16G16_SINT */
-	case 108:
-		return WGPUTextureFormat_RG16Float; /* VK_FORMAT_R16G16_SFLOAT */
-	case 109:
-		return WGPUTextureFormat_RGBA16Uint; /* VK_FORMAT_R16G16B16A16_UINT */
-	case 110:
-		return WGPUTextureFormat_RGBA16Sint; /* VK_FORMAT_R16G16B16A16_SINT */
-	case 111:
-		return WGPUTextureFormat_RGBA16Float; /* VK_FORMAT_R16G16B16A16_SFLOAT */
-	case 114:
-		return WGPUTextureFormat_RGBA32Float; /* VK_FORMAT_R32G32B32A32_SFLOAT */
-	case 115:
-		return WGPUTextureFormat_RGBA32Uint; /* VK_FORMAT_R32G32B32A32_UINT */
-	case 116:
-		return WGPUTextureFormat_RGBA32Sint; /* VK_FORMAT_R32G32B32A32_SINT */
-	case 122:
-		return WGPUTextureFormat_RG32Float; /* VK_FORMAT_R32G32_SFLOAT */
-	case 123:
-		return WGPUTextureFormat_RG32Uint; /* VK_FORMAT_R32G32_UINT */
-	case 124:
-		return WGPUTextureFormat_RG32Sint; /* VK_FORMAT_R32G32_SINT */
-	default:
-		return WGPUTextureFormat_RGBA8Unorm;
-	}
-}
-
 VkResult vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo,
                        const VkAllocationCallbacks *pAllocator, VkImage *pImage) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateImage);
 
 	if (!device || !pCreateInfo || !pImage) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkImage image = wgvk_alloc(sizeof(struct VkImage_T));
+	/* Compressed formats the device cannot sample are decoded on upload
+	 * into an uncompressed texture. */
+	WGPUTextureFormat format = wgvk_format_to_wgpu(pCreateInfo->format);
+	VkBool32 transcoded = VK_FALSE;
+	if (format != WGPUTextureFormat_Undefined &&
+	    !wgvk_format_is_native(device, pCreateInfo->format)) {
+		format = wgvk_transcode_format(pCreateInfo->format);
+		transcoded = VK_TRUE;
+	}
+	if (format == WGPUTextureFormat_Undefined) {
+		return VK_ERROR_FORMAT_NOT_SUPPORTED;
+	}
+
+	VkImage image = wgvk_object_alloc(sizeof(struct VkImage_T), VK_OBJECT_TYPE_IMAGE, pAllocator,
+	                                  device->base.allocator);
 	if (!image) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&image->base, destroy_image);
+	wgvk_object_init(&image->base, VK_OBJECT_TYPE_IMAGE, destroy_image);
 	image->device = device;
 	image->width = pCreateInfo->extent.width;
 	image->height = pCreateInfo->extent.height;
@@ -149,12 +65,16 @@ VkResult vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo,
 	image->mip_levels = pCreateInfo->mipLevels;
 	image->array_layers = pCreateInfo->arrayLayers;
 	image->format = pCreateInfo->format;
+	image->wgpu_format = format;
+	image->transcoded = transcoded;
 	image->image_type = pCreateInfo->imageType;
 	image->samples = pCreateInfo->samples;
 	image->usage = pCreateInfo->usage;
 	image->bound_memory = NULL;
 	image->memory_offset = 0;
 	image->wgpu_texture = NULL;
+	image->pooled = VK_FALSE;
+	wgvk_cache_init(&image->view_cache, release_view);
 
 	/* Map Vulkan usage flags to WebGPU usage flags */
 	/* Vulkan: TRANSFER_SRC=1, TRANSFER_DST=2, SAMPLED=4, STORAGE=8, COLOR_ATTACH=16,
@@ -173,6 +93,12 @@ VkResult vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo,
 		wgpu_usage |= WGPUTextureUsage_RenderAttachment;
 	if (pCreateInfo->usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
 		wgpu_usage |= WGPUTextureUsage_RenderAttachment;
+	/* vkCmdBlitImage samples the source and renders into the destination. */
+	if (pCreateInfo->usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+		wgpu_usage |= WGPUTextureUsage_TextureBinding;
+	if ((pCreateInfo->usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) &&
+	    wgvk_format_is_color_renderable(pCreateInfo->format))
+		wgpu_usage |= WGPUTextureUsage_RenderAttachment;
 
 	WGPUExtent3D size = {
 	    .width = pCreateInfo->extent.width,
@@ -181,20 +107,51 @@ VkResult vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo,
 	        pCreateInfo->extent.depth > 0 ? pCreateInfo->extent.depth : pCreateInfo->arrayLayers,
 	};
 
+	/* Mutable-format images may be viewed through their sRGB twin; WebGPU
+	 * wants that declared up front. */
+	WGPUTextureFormat view_format = wgvk_format_srgb_pair(format);
+	VkBool32 mutable_format = (pCreateInfo->flags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT) &&
+	                          view_format != WGPUTextureFormat_Undefined;
+
 	WGPUTextureDescriptor desc = {
 	    .nextInChain = NULL,
 	    .label = WGPU_STRING_VIEW_INIT,
 	    .usage = wgpu_usage,
 	    .dimension = image_type_to_dimension(pCreateInfo->imageType),
 	    .size = size,
-	    .format = vulkan_format_to_webgpu(pCreateInfo->format),
+	    .format = format,
 	    .mipLevelCount = pCreateInfo->mipLevels,
 	    .sampleCount = pCreateInfo->samples,
+	    .viewFormatCount = mutable_format ? 1 : 0,
+	    .viewFormats = mutable_format ? &view_format : NULL,
 	};
 
-	image->wgpu_texture = wgpuDeviceCreateTexture(device->wgpu_device, &desc);
+	/* Transient attachments never leave a render pass. With WebGPU's
+	 * transient usage they get no memory at all; otherwise their textures
+	 * are recycled through the device pool, since their contents never
+	 * need to survive the image. Other images share the pool only when the
+	 * application turned it on with wgvkSetTexturePool(). */
+	if (pCreateInfo->usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) {
+		VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+		                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+		                                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		if (device->transient_attachments && !(pCreateInfo->usage & ~attachment_usage)) {
+			desc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TransientAttachment;
+		} else {
+			image->pooled = VK_TRUE;
+		}
+	} else {
+		image->pooled = device->texture_pool.all_images;
+	}
+
+	if (image->pooled) {
+		wgvk_texture_pool_key(&desc, image->pool_key);
+		image->wgpu_texture = wgvk_texture_pool_acquire(device, &desc, image->pool_key);
+	} else {
+		image->wgpu_texture = wgpuDeviceCreateTexture(device->wgpu_device, &desc);
+	}
 	if (!image->wgpu_texture) {
-		wgvk_free(image);
+		wgvk_object_free(image);
 		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
 	}
 
@@ -203,6 +160,7 @@ VkResult vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo,
 }
 
 void vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyImage);
 	(void)device;
 	(void)pAllocator;
 	if (image) {
@@ -1,43 +1,149 @@
 #include "webvulkan_internal.h"
+#include "../commands/transcode.h"
+#include "../util/log.h"
+
+#define WGVK_VIEW_KEY_WORDS 7
 
 static void destroy_image_view(void *obj) {
 	VkImageView view = (VkImageView)obj;
-	if (view->wgpu_view) {
-		wgpuTextureViewRelease(view->wgpu_view);
+	if (view->image) {
+		wgvk_cache_release(&view->image->view_cache, view->interned);
+		wgvk_object_release(&view->image->base);
 	}
-	wgvk_free(view);
+	wgvk_object_free(view);
+}
+
+static WGPUTextureViewDimension translate_view_type(VkImageViewType view_type) {
+	switch (view_type) {
+	case VK_IMAGE_VIEW_TYPE_1D:
+		return WGPUTextureViewDimension_1D;
+	case VK_IMAGE_VIEW_TYPE_3D:
+		return WGPUTextureViewDimension_3D;
+	case VK_IMAGE_VIEW_TYPE_CUBE:
+		return WGPUTextureViewDimension_Cube;
+	case VK_IMAGE_VIEW_TYPE_2D_ARRAY:
+		return WGPUTextureViewDimension_2DArray;
+	case VK_IMAGE_VIEW_TYPE_CUBE_ARRAY:
+		return WGPUTextureViewDimension_CubeArray;
+	case VK_IMAGE_VIEW_TYPE_1D_ARRAY:
+		/* WebGPU has no 1D arrays; a single layer still works as 1D. */
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "1D array image views are not supported, using one layer");
+		return WGPUTextureViewDimension_1D;
+	case VK_IMAGE_VIEW_TYPE_2D:
+	default:
+		return WGPUTextureViewDimension_2D;
+	}
+}
+
+static VkBool32 swizzle_is_identity(VkComponentSwizzle swizzle, VkComponentSwizzle component) {
+	return swizzle == VK_COMPONENT_SWIZZLE_IDENTITY || swizzle == component;
+}
+
+static VkResult translate_view(VkImage image, const VkImageViewCreateInfo *info,
+                               WGPUTextureViewDescriptor *desc) {
+	const VkImageSubresourceRange *range = &info->subresourceRange;
+
+	WGPUTextureFormat image_format = image->wgpu_format;
+	desc->format = image->transcoded ? wgvk_transcode_format(info->format)
+	                                 : wgvk_format_to_wgpu(info->format);
+	if (desc->format == WGPUTextureFormat_Undefined) {
+		return VK_ERROR_FORMAT_NOT_SUPPORTED;
+	}
+	if (desc->format != image_format && desc->format != wgvk_format_srgb_pair(image_format)) {
+		WGVK_WARN(WGVK_LOG_CAT_CORE,
+		          "image view format %u cannot reinterpret image format %u, using the image's",
+		          info->format, image->format);
+		desc->format = image_format;
+	}
+
+	desc->dimension = translate_view_type(info->viewType);
+	desc->baseMipLevel = range->baseMipLevel;
+	desc->mipLevelCount = range->levelCount == VK_REMAINING_MIP_LEVELS
+	                          ? image->mip_levels - range->baseMipLevel
+	                          : range->levelCount;
+	desc->baseArrayLayer = range->baseArrayLayer;
+	desc->arrayLayerCount = range->layerCount == VK_REMAINING_ARRAY_LAYERS
+	                            ? image->array_layers - range->baseArrayLayer
+	                            : range->layerCount;
+	if (desc->dimension == WGPUTextureViewDimension_1D ||
+	    desc->dimension == WGPUTextureViewDimension_3D) {
+		desc->arrayLayerCount = 1;
+	}
+	desc->aspect = wgvk_aspect_to_wgpu(range->aspectMask);
+
+	/* Core WebGPU cannot swizzle; shaders see the texture's own channels. */
+	if (!swizzle_is_identity(info->components.r, VK_COMPONENT_SWIZZLE_R) ||
+	    !swizzle_is_identity(info->components.g, VK_COMPONENT_SWIZZLE_G) ||
+	    !swizzle_is_identity(info->components.b, VK_COMPONENT_SWIZZLE_B) ||
+	    !swizzle_is_identity(info->components.a, VK_COMPONENT_SWIZZLE_A)) {
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "image view component swizzles are ignored");
+	}
+	return VK_SUCCESS;
+}
+
+static void write_view_key(uint32_t *key, const WGPUTextureViewDescriptor *desc) {
+	key[0] = (uint32_t)desc->format;
+	key[1] = (uint32_t)desc->dimension;
+	key[2] = desc->baseMipLevel;
+	key[3] = desc->mipLevelCount;
+	key[4] = desc->baseArrayLayer;
+	key[5] = desc->arrayLayerCount;
+	key[6] = (uint32_t)desc->aspect;
 }
 
 VkResult vkCreateImageView(VkDevice device, const VkImageViewCreateInfo *pCreateInfo,
                            const VkAllocationCallbacks *pAllocator, VkImageView *pView) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateImageView);
 
 	if (!device || !pCreateInfo || !pView) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkImageView view = wgvk_alloc(sizeof(struct VkImageView_T));
+	VkImageView view = wgvk_object_alloc(sizeof(struct VkImageView_T), VK_OBJECT_TYPE_IMAGE_VIEW,
+	                                     pAllocator, device->base.allocator);
 	if (!view) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&view->base, destroy_image_view);
+	wgvk_object_init(&view->base, VK_OBJECT_TYPE_IMAGE_VIEW, destroy_image_view);
 	view->device = device;
-	view->image = (VkImage)pCreateInfo->image;
+	view->image = NULL;
 	view->view_type = pCreateInfo->viewType;
 	view->format = pCreateInfo->format;
 	view->wgpu_view = NULL;
+	view->interned = NULL;
 
-	if (view->image && view->image->wgpu_texture) {
+	VkImage image = (VkImage)pCreateInfo->image;
+	if (image && image->wgpu_texture) {
 		WGPUTextureViewDescriptor desc = {0};
-		desc.format = wgpuTextureGetFormat(view->image->wgpu_texture);
-		desc.dimension = WGPUTextureViewDimension_2D;
-		desc.baseMipLevel = 0;
-		desc.mipLevelCount = view->image->mip_levels;
-		desc.baseArrayLayer = 0;
-		desc.arrayLayerCount = view->image->array_layers;
+		VkResult result = translate_view(image, pCreateInfo, &desc);
+		if (result != VK_SUCCESS) {
+			wgvk_object_free(view);
+			return result;
+		}
 
-		view->wgpu_view = wgpuTextureCreateView(view->image->wgpu_texture, &desc);
+		/* Shadow cascades and mip chains ask for the same slices every
+		 * frame; share one WebGPU view per distinct range. */
+		uint32_t key[WGVK_VIEW_KEY_WORDS];
+		write_view_key(key, &desc);
+		view->interned = wgvk_cache_acquire(&image->view_cache, key, WGVK_VIEW_KEY_WORDS);
+		if (!view->interned) {
+			WGPUTextureView wgpu_view = wgpuTextureCreateView(image->wgpu_texture, &desc);
+			if (!wgpu_view) {
+				wgvk_object_free(view);
+				return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+			}
+			view->interned =
+			    wgvk_cache_insert(&image->view_cache, key, WGVK_VIEW_KEY_WORDS, wgpu_view);
+			if (!view->interned) {
+				wgpuTextureViewRelease(wgpu_view);
+				wgvk_object_free(view);
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+			}
+		}
+		view->wgpu_view = view->interned->object;
+		view->image = image;
+		wgvk_object_retain(&image->base);
 	}
 
 	*pView = view;
@@ -46,6 +152,7 @@ VkResult vkCreateImageView(VkDevice device, const VkImageViewCreateInfo *pCreate
 
 void vkDestroyImageView(VkDevice device, VkImageView imageView,
                         const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyImageView);
 	(void)device;
 	(void)pAllocator;
 
@@ -1,5 +1,8 @@
 #include "webvulkan_internal.h"
 #include "../shaders/spirv_parser.h"
+#include "../commands/subpass.h"
+#include "../util/log.h"
+#include "../util/trace.h"
 
 static void destroy_pipeline(void *obj) {
 	VkPipeline pipeline = (VkPipeline)obj;
@@ -12,12 +15,19 @@ static void destroy_pipeline(void *obj) {
 			wgpuComputePipelineRelease(pipeline->wgpu_pipeline.compute);
 		}
 	}
-	wgvk_free(pipeline);
+	wgvk_object_free(pipeline);
 }
 
-static WGPUShaderModule shader_module_for_stage(VkShaderModule mod, uint32_t exec_model) {
-	if (!mod)
+/* Arrayed bindings need the layout's binding numbers baked into the WGSL, so
+ * such stages are recompiled into @p owned, which the caller releases.
+ * Returns NULL when the stage has no translation. */
+static WGPUShaderModule shader_module_for_stage(VkShaderModule mod, uint32_t exec_model,
+                                                VkPipelineLayout layout, WGPUShaderModule *owned) {
+	*owned = NULL;
+	if (!mod || !wgvk_shader_module_for_layout(mod, exec_model, layout, owned))
 		return NULL;
+	if (*owned)
+		return *owned;
 	if (exec_model < (uint32_t)WGVK_SHADER_STAGE_COUNT && mod->stage_shaders[exec_model])
 		return mod->stage_shaders[exec_model];
 	return mod->wgpu_shader;
@@ -54,13 +64,140 @@ static WGPUVertexFormat vk_format_to_wgpu(uint32_t vk_format) {
 	}
 }
 
+static WGPUBlendFactor translate_blend_factor(VkBlendFactor factor) {
+	static const WGPUBlendFactor vk_blend_factor_to_wgpu[] = {
+	    WGPUBlendFactor_Zero,              /* VK_BLEND_FACTOR_ZERO */
+	    WGPUBlendFactor_One,               /* VK_BLEND_FACTOR_ONE */
+	    WGPUBlendFactor_Src,               /* VK_BLEND_FACTOR_SRC_COLOR */
+	    WGPUBlendFactor_OneMinusSrc,       /* VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR */
+	    WGPUBlendFactor_Dst,               /* VK_BLEND_FACTOR_DST_COLOR */
+	    WGPUBlendFactor_OneMinusDst,       /* VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR */
+	    WGPUBlendFactor_SrcAlpha,          /* VK_BLEND_FACTOR_SRC_ALPHA */
+	    WGPUBlendFactor_OneMinusSrcAlpha,  /* VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA */
+	    WGPUBlendFactor_DstAlpha,          /* VK_BLEND_FACTOR_DST_ALPHA */
+	    WGPUBlendFactor_OneMinusDstAlpha,  /* VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA */
+	    WGPUBlendFactor_Constant,          /* VK_BLEND_FACTOR_CONSTANT_COLOR */
+	    WGPUBlendFactor_OneMinusConstant,  /* VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR */
+	    WGPUBlendFactor_Constant,          /* VK_BLEND_FACTOR_CONSTANT_ALPHA */
+	    WGPUBlendFactor_OneMinusConstant,  /* VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA */
+	    WGPUBlendFactor_SrcAlphaSaturated, /* VK_BLEND_FACTOR_SRC_ALPHA_SATURATE */
+	    WGPUBlendFactor_Src1,              /* VK_BLEND_FACTOR_SRC1_COLOR */
+	    WGPUBlendFactor_OneMinusSrc1,      /* VK_BLEND_FACTOR_ONE_MINUS_SRC1_COLOR */
+	    WGPUBlendFactor_Src1Alpha,         /* VK_BLEND_FACTOR_SRC1_ALPHA */
+	    WGPUBlendFactor_OneMinusSrc1Alpha, /* VK_BLEND_FACTOR_ONE_MINUS_SRC1_ALPHA */
+	};
+	uint32_t idx = (uint32_t)factor;
+	if (idx >= 19)
+		return WGPUBlendFactor_One;
+	if (factor == VK_BLEND_FACTOR_CONSTANT_ALPHA ||
+	    factor == VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA) {
+		WGVK_WARN(WGVK_LOG_CAT_PIPELINE,
+		          "vkCreateGraphicsPipelines: constant alpha blend factors unsupported, "
+		          "using the constant color");
+	}
+	return vk_blend_factor_to_wgpu[idx];
+}
+
+/* WebGPU requires factors of One for min and max, which Vulkan ignores. */
+static void translate_blend_component(VkBlendOp op, VkBlendFactor src, VkBlendFactor dst,
+                                      WGPUBlendComponent *component) {
+	component->srcFactor = translate_blend_factor(src);
+	component->dstFactor = translate_blend_factor(dst);
+	switch (op) {
+	case VK_BLEND_OP_SUBTRACT:
+		component->operation = WGPUBlendOperation_Subtract;
+		break;
+	case VK_BLEND_OP_REVERSE_SUBTRACT:
+		component->operation = WGPUBlendOperation_ReverseSubtract;
+		break;
+	case VK_BLEND_OP_MIN:
+	case VK_BLEND_OP_MAX:
+		component->operation =
+		    op == VK_BLEND_OP_MIN ? WGPUBlendOperation_Min : WGPUBlendOperation_Max;
+		component->srcFactor = WGPUBlendFactor_One;
+		component->dstFactor = WGPUBlendFactor_One;
+		break;
+	default:
+		component->operation = WGPUBlendOperation_Add;
+		break;
+	}
+}
+
+/* Color target formats and sample count of the subpass the pipeline is
+ * used in. Returns the number of color targets. */
+static uint32_t subpass_target_formats(const VkGraphicsPipelineCreateInfo *info,
+                                       WGPUTextureFormat *formats, uint32_t *samples) {
+	VkRenderPass rp = info->renderPass;
+	*samples = 0;
+	if (!rp || !rp->subpass_info || info->subpass >= rp->subpass_info->subpass_count) {
+		return 0;
+	}
+
+	const WgvkSubpassInfo *sp = &rp->subpass_info->subpasses[info->subpass];
+	for (uint32_t c = 0; c < sp->color_attachment_count; c++) {
+		uint32_t att = sp->color_attachments[c];
+		/* Unused attachments map to an empty target slot. */
+		formats[c] = WGPUTextureFormat_Undefined;
+		if (att != VK_ATTACHMENT_UNUSED && att < rp->attachment_count) {
+			formats[c] = wgvk_format_to_wgpu(rp->attachments[att].format);
+			*samples = rp->attachments[att].samples;
+		}
+	}
+	if (sp->has_depth_stencil && sp->depth_stencil_attachment < rp->attachment_count) {
+		*samples = rp->attachments[sp->depth_stencil_attachment].samples;
+	}
+	return sp->color_attachment_count;
+}
+
+/* Depth/stencil attachment format of the subpass or rendering info the
+ * pipeline is used with, or VK_FORMAT_UNDEFINED when there is none. */
+static uint32_t pipeline_depth_format(const VkGraphicsPipelineCreateInfo *info,
+                                      const VkPipelineRenderingCreateInfo *rendering) {
+	if (rendering) {
+		return rendering->depthAttachmentFormat != VK_FORMAT_UNDEFINED
+		           ? rendering->depthAttachmentFormat
+		           : rendering->stencilAttachmentFormat;
+	}
+	VkRenderPass rp = info->renderPass;
+	if (!rp || !rp->subpass_info || info->subpass >= rp->subpass_info->subpass_count) {
+		return VK_FORMAT_UNDEFINED;
+	}
+	const WgvkSubpassInfo *sp = &rp->subpass_info->subpasses[info->subpass];
+	if (!sp->has_depth_stencil || sp->depth_stencil_attachment >= rp->attachment_count) {
+		return VK_FORMAT_UNDEFINED;
+	}
+	return rp->attachments[sp->depth_stencil_attachment].format;
+}
+
+/* Attachment formats for pipelines used with dynamic rendering. */
+static const VkPipelineRenderingCreateInfo *
+find_rendering_info(const VkGraphicsPipelineCreateInfo *info) {
+	if (info->renderPass) {
+		return NULL;
+	}
+	const void *next = info->pNext;
+	while (next) {
+		struct {
+			VkStructureType sType;
+			const void *pNext;
+		} const *header = next;
+
+		if (header->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO) {
+			return next;
+		}
+		next = header->pNext;
+	}
+	return NULL;
+}
+
 VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache,
                                    uint32_t createInfoCount,
                                    const VkGraphicsPipelineCreateInfo *pCreateInfos,
                                    const VkAllocationCallbacks *pAllocator,
                                    VkPipeline *pPipelines) {
+	WGVK_STAT_CALL(vkCreateGraphicsPipelines);
+	WGVK_SPAN(WGVK_LOG_CAT_PIPELINE, "vkCreateGraphicsPipelines");
 	(void)pipelineCache;
-	(void)pAllocator;
 
 	if (!device || !pCreateInfos || !pPipelines) {
 		return VK_ERROR_INITIALIZATION_FAILED;
@@ -69,7 +206,9 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 	for (uint32_t i = 0; i < createInfoCount; i++) {
 		const VkGraphicsPipelineCreateInfo *info = &pCreateInfos[i];
 
-		VkPipeline pipeline = wgvk_alloc(sizeof(struct VkPipeline_T));
+		VkPipeline pipeline =
+		    wgvk_object_alloc(sizeof(struct VkPipeline_T), VK_OBJECT_TYPE_PIPELINE, pAllocator,
+		                      device->base.allocator);
 		if (!pipeline) {
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pPipelines[j]->base);
@@ -77,19 +216,25 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
 
-		wgvk_object_init(&pipeline->base, destroy_pipeline);
+		wgvk_object_init(&pipeline->base, VK_OBJECT_TYPE_PIPELINE, destroy_pipeline);
 		pipeline->device = device;
 		pipeline->layout = info->layout;
 		pipeline->bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
 		pipeline->wgpu_pipeline.render = NULL;
 
 		WGPUVertexState vertex_state = {0};
+		WGPUShaderModule owned_vertex = NULL;
+		WGPUShaderModule owned_fragment = NULL;
+		VkBool32 missing_stage = VK_FALSE;
 		if (info->pStages && info->stageCount > 0) {
 			for (uint32_t s = 0; s < info->stageCount; s++) {
 				if (info->pStages[s].stage == VK_SHADER_STAGE_VERTEX_BIT) {
-					vertex_state.module = shader_module_for_stage(info->pStages[s].module, WGVK_SPV_EXEC_MODEL_VERTEX);
+					vertex_state.module =
+					    shader_module_for_stage(info->pStages[s].module, WGVK_SPV_EXEC_MODEL_VERTEX,
+					                            info->layout, &owned_vertex);
 					vertex_state.entryPoint =
 					    (WGPUStringView){.data = info->pStages[s].pName, .length = WGPU_STRLEN};
+					missing_stage |= info->pStages[s].module && !vertex_state.module;
 				}
 			}
 		}
@@ -148,34 +293,102 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 
 		WGPUFragmentState fragment_state = {0};
 		WGPUColorTargetState color_targets[8] = {0};
+		WGPUBlendState blend_states[8] = {0};
+		WGPUTextureFormat target_formats[8] = {0};
 		uint32_t color_target_count = 0;
+		uint32_t subpass_samples = 0;
+		const VkPipelineRenderingCreateInfo *rendering = find_rendering_info(info);
+
+		if (rendering) {
+			for (uint32_t c = 0; c < rendering->colorAttachmentCount && c < 8; c++) {
+				/* VK_FORMAT_UNDEFINED maps to an unused target slot. */
+				target_formats[c] = wgvk_format_to_wgpu(rendering->pColorAttachmentFormats[c]);
+				color_target_count++;
+			}
+		} else if (info->renderPass) {
+			color_target_count = subpass_target_formats(info, target_formats, &subpass_samples);
+		} else {
+			/* No render target information: assume the swapchain format. */
+			color_target_count = 1;
+			if (info->pColorBlendState && info->pColorBlendState->attachmentCount > 1) {
+				color_target_count = info->pColorBlendState->attachmentCount < 8
+				                         ? info->pColorBlendState->attachmentCount
+				                         : 8;
+			}
+			for (uint32_t c = 0; c < color_target_count; c++) {
+				target_formats[c] = WGPUTextureFormat_BGRA8Unorm;
+			}
+		}
 
-		if (info->pStages && info->stageCount > 1) {
-			for (uint32_t s = 0; s < info->stageCount; s++) {
-				if (info->pStages[s].stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
-					fragment_state.module = shader_module_for_stage(info->pStages[s].module, WGVK_SPV_EXEC_MODEL_FRAGMENT);
-					fragment_state.entryPoint =
-					    (WGPUStringView){.data = info->pStages[s].pName, .length = WGPU_STRLEN};
-				}
+		VkBool32 has_fragment = VK_FALSE;
+		for (uint32_t s = 0; info->pStages && s < info->stageCount; s++) {
+			if (info->pStages[s].stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+				fragment_state.module = shader_module_for_stage(
+				    info->pStages[s].module, WGVK_SPV_EXEC_MODEL_FRAGMENT, info->layout,
+				    &owned_fragment);
+				fragment_state.entryPoint =
+				    (WGPUStringView){.data = info->pStages[s].pName, .length = WGPU_STRLEN};
+				has_fragment = VK_TRUE;
+				missing_stage |= info->pStages[s].module && !fragment_state.module;
 			}
+		}
+
+		/* A fragment stage with no color targets still runs, e.g. for
+		 * depth-only passes that discard or write frag depth. */
+		if (has_fragment) {
+			const VkPipelineColorBlendStateCreateInfo *cb = info->pColorBlendState;
+			for (uint32_t c = 0; c < color_target_count; c++) {
+				color_targets[c].format = target_formats[c];
+				color_targets[c].blend = NULL;
+				color_targets[c].writeMask = WGPUColorWriteMask_All;
+				if (!cb || c >= cb->attachmentCount || !cb->pAttachments) {
+					continue;
+				}
 
-			if (info->pColorBlendState && info->pColorBlendState->attachmentCount > 0) {
-				for (uint32_t c = 0; c < info->pColorBlendState->attachmentCount && c < 8; c++) {
-					color_targets[c].format = WGPUTextureFormat_BGRA8Unorm;
-					color_targets[c].blend = NULL;
-					color_targets[c].writeMask = WGPUColorWriteMask_All;
-					color_target_count++;
+				/* VkColorComponentFlags uses the same bits as WGPUColorWriteMask. */
+				const VkPipelineColorBlendAttachmentState *att = &cb->pAttachments[c];
+				color_targets[c].writeMask = (WGPUColorWriteMask)(att->colorWriteMask & 0xF);
+				if (att->blendEnable) {
+					translate_blend_component(att->colorBlendOp, att->srcColorBlendFactor,
+					                          att->dstColorBlendFactor, &blend_states[c].color);
+					translate_blend_component(att->alphaBlendOp, att->srcAlphaBlendFactor,
+					                          att->dstAlphaBlendFactor, &blend_states[c].alpha);
+					color_targets[c].blend = &blend_states[c];
 				}
-			} else {
-				color_targets[0].format = WGPUTextureFormat_BGRA8Unorm;
-				color_targets[0].blend = NULL;
-				color_targets[0].writeMask = WGPUColorWriteMask_All;
-				color_target_count = 1;
+			}
+			if (cb && cb->logicOpEnable) {
+				WGVK_WARN(WGVK_LOG_CAT_PIPELINE, "vkCreateGraphicsPipelines: logicOp unsupported");
 			}
 			fragment_state.targetCount = color_target_count;
 			fragment_state.targets = color_targets;
 		}
 
+		WGPUMultisampleState multisample_state = {
+		    .count = 1,
+		    .mask = 0xFFFFFFFF,
+		    .alphaToCoverageEnabled = VK_FALSE,
+		};
+		if (info->pMultisampleState) {
+			const VkPipelineMultisampleStateCreateInfo *ms = info->pMultisampleState;
+			multisample_state.count = ms->rasterizationSamples ? ms->rasterizationSamples : 1;
+			multisample_state.mask = ms->pSampleMask ? ms->pSampleMask[0] : 0xFFFFFFFF;
+			multisample_state.alphaToCoverageEnabled = ms->alphaToCoverageEnable ? 1 : 0;
+			if (ms->sampleShadingEnable || ms->alphaToOneEnable) {
+				WGVK_WARN(WGVK_LOG_CAT_PIPELINE,
+				          "vkCreateGraphicsPipelines: sample shading and alphaToOne unsupported");
+			}
+		}
+		if (subpass_samples > 0 && subpass_samples != multisample_state.count) {
+			WGVK_WARN(WGVK_LOG_CAT_PIPELINE,
+			          "vkCreateGraphicsPipelines: %u samples, subpass attachments have %u",
+			          multisample_state.count, subpass_samples);
+		}
+		if (multisample_state.count != 1 && multisample_state.count != 4) {
+			WGVK_WARN(WGVK_LOG_CAT_PIPELINE,
+			          "vkCreateGraphicsPipelines: WebGPU only supports 1 or 4 samples, got %u",
+			          multisample_state.count);
+		}
+
 		WGPUPrimitiveState primitive_state = {
 		    .topology = WGPUPrimitiveTopology_TriangleList,
 		    .stripIndexFormat = WGPUIndexFormat_Undefined,
@@ -224,24 +437,14 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 			    (raster->frontFace == VK_FRONT_FACE_CLOCKWISE) ? WGPUFrontFace_CW : WGPUFrontFace_CCW;
 		}
 
-		/* Map depth/stencil state. */
+		/* Map depth/stencil state. A subpass without a depth/stencil
+		 * attachment takes no depth/stencil state at all. */
 		WGPUDepthStencilState depth_stencil_state = {0};
 		VkBool32 has_depth_stencil = VK_FALSE;
-		if (info->pDepthStencilState) {
+		WGPUTextureFormat depth_format =
+		    wgvk_format_to_wgpu(pipeline_depth_format(info, rendering));
+		if (info->pDepthStencilState && depth_format != WGPUTextureFormat_Undefined) {
 			const VkPipelineDepthStencilStateCreateInfo *ds = info->pDepthStencilState;
-			/* Determine depth format from render pass if available. */
-			WGPUTextureFormat depth_format = WGPUTextureFormat_Depth24Plus;
-			if (info->renderPass) {
-				uint32_t vk_depth_fmt = info->renderPass->depth_stencil_format;
-				if (vk_depth_fmt == 124 /* VK_FORMAT_D16_UNORM */)
-					depth_format = WGPUTextureFormat_Depth16Unorm;
-				else if (vk_depth_fmt == 126 /* VK_FORMAT_D32_SFLOAT */)
-					depth_format = WGPUTextureFormat_Depth32Float;
-				else if (vk_depth_fmt == 129 /* VK_FORMAT_D24_UNORM_S8_UINT */)
-					depth_format = WGPUTextureFormat_Depth24PlusStencil8;
-				else if (vk_depth_fmt == 130 /* VK_FORMAT_D32_SFLOAT_S8_UINT */)
-					depth_format = WGPUTextureFormat_Depth32FloatStencil8;
-			}
 			static const WGPUCompareFunction vk_compare_to_wgpu[] = {
 			    WGPUCompareFunction_Never,       /* VK_COMPARE_OP_NEVER */
 			    WGPUCompareFunction_Less,        /* VK_COMPARE_OP_LESS */
@@ -266,18 +469,25 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 		WGPURenderPipelineDescriptor desc = {
 		    .layout = info->layout ? info->layout->wgpu_layout : NULL,
 		    .vertex = vertex_state,
-		    .fragment = color_target_count > 0 ? &fragment_state : NULL,
+		    .fragment = has_fragment ? &fragment_state : NULL,
 		    .primitive = primitive_state,
 		    .depthStencil = has_depth_stencil ? &depth_stencil_state : NULL,
-		    .multisample =
-		        {
-		            .count = 1,
-		            .mask = 0xFFFFFFFF,
-		            .alphaToCoverageEnabled = VK_FALSE,
-		        },
+		    .multisample = multisample_state,
 		};
 
-		pipeline->wgpu_pipeline.render = wgpuDeviceCreateRenderPipeline(device->wgpu_device, &desc);
+		// A stage without a translation must not fall back to another shader
+		if (missing_stage) {
+			WGVK_ERROR(WGVK_LOG_CAT_PIPELINE,
+			           "vkCreateGraphicsPipelines: a shader stage could not be translated to WGSL");
+		} else {
+			pipeline->wgpu_pipeline.render =
+			    wgpuDeviceCreateRenderPipeline(device->wgpu_device, &desc);
+		}
+
+		if (owned_vertex)
+			wgpuShaderModuleRelease(owned_vertex);
+		if (owned_fragment)
+			wgpuShaderModuleRelease(owned_fragment);
 
 		if (buffer_layouts)
 			wgvk_free(buffer_layouts);
@@ -285,11 +495,11 @@ VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCach
 			wgvk_free(all_attributes);
 
 		if (!pipeline->wgpu_pipeline.render) {
-			wgvk_free(pipeline);
+			wgvk_object_free(pipeline);
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pPipelines[j]->base);
 			}
-			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+			return missing_stage ? VK_ERROR_INVALID_SHADER_NV : VK_ERROR_OUT_OF_DEVICE_MEMORY;
 		}
 
 		pPipelines[i] = pipeline;
@@ -302,8 +512,9 @@ VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache
                                   uint32_t createInfoCount,
                                   const VkComputePipelineCreateInfo *pCreateInfos,
                                   const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines) {
+	WGVK_STAT_CALL(vkCreateComputePipelines);
+	WGVK_SPAN(WGVK_LOG_CAT_PIPELINE, "vkCreateComputePipelines");
 	(void)pipelineCache;
-	(void)pAllocator;
 
 	if (!device || !pCreateInfos || !pPipelines) {
 		return VK_ERROR_INITIALIZATION_FAILED;
@@ -312,7 +523,9 @@ VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache
 	for (uint32_t i = 0; i < createInfoCount; i++) {
 		const VkComputePipelineCreateInfo *info = &pCreateInfos[i];
 
-		VkPipeline pipeline = wgvk_alloc(sizeof(struct VkPipeline_T));
+		VkPipeline pipeline =
+		    wgvk_object_alloc(sizeof(struct VkPipeline_T), VK_OBJECT_TYPE_PIPELINE, pAllocator,
+		                      device->base.allocator);
 		if (!pipeline) {
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pPipelines[j]->base);
@@ -320,30 +533,41 @@ VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache
 			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
 
-		wgvk_object_init(&pipeline->base, destroy_pipeline);
+		wgvk_object_init(&pipeline->base, VK_OBJECT_TYPE_PIPELINE, destroy_pipeline);
 		pipeline->device = device;
 		pipeline->layout = info->layout;
 		pipeline->bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
 		pipeline->wgpu_pipeline.compute = NULL;
 
+		WGPUShaderModule owned_compute = NULL;
+		WGPUShaderModule compute_module = shader_module_for_stage(
+		    info->stage.module, WGVK_SPV_EXEC_MODEL_GL_COMPUTE, info->layout, &owned_compute);
 		WGPUComputePipelineDescriptor desc = {
 		    .layout = info->layout ? info->layout->wgpu_layout : NULL,
 		    .compute =
 		        {
-		            .module = shader_module_for_stage(info->stage.module, WGVK_SPV_EXEC_MODEL_GL_COMPUTE),
+		            .module = compute_module,
 		            .entryPoint =
 		                (WGPUStringView){.data = info->stage.pName, .length = WGPU_STRLEN},
 		        },
 		};
 
-		pipeline->wgpu_pipeline.compute =
-		    wgpuDeviceCreateComputePipeline(device->wgpu_device, &desc);
+		VkBool32 missing_stage = info->stage.module && !compute_module;
+		if (missing_stage) {
+			WGVK_ERROR(WGVK_LOG_CAT_PIPELINE,
+			           "vkCreateComputePipelines: the shader could not be translated to WGSL");
+		} else {
+			pipeline->wgpu_pipeline.compute =
+			    wgpuDeviceCreateComputePipeline(device->wgpu_device, &desc);
+		}
+		if (owned_compute)
+			wgpuShaderModuleRelease(owned_compute);
 		if (!pipeline->wgpu_pipeline.compute) {
-			wgvk_free(pipeline);
+			wgvk_object_free(pipeline);
 			for (uint32_t j = 0; j < i; j++) {
 				wgvk_object_release(&pPipelines[j]->base);
 			}
-			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+			return missing_stage ? VK_ERROR_INVALID_SHADER_NV : VK_ERROR_OUT_OF_DEVICE_MEMORY;
 		}
 
 		pPipelines[i] = pipeline;
@@ -354,6 +578,7 @@ VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache
 
 void vkDestroyPipeline(VkDevice device, VkPipeline pipeline,
                        const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyPipeline);
 	(void)device;
 	(void)pAllocator;
 	if (pipeline) {
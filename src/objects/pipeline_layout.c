@@ -3,9 +3,7 @@
 static void destroy_pipeline_layout(void *obj) {
 	VkPipelineLayout layout = (VkPipelineLayout)obj;
 
-	if (layout->wgpu_layout) {
-		wgpuPipelineLayoutRelease(layout->wgpu_layout);
-	}
+	wgvk_cache_release(&layout->device->pipeline_layout_cache, layout->interned);
 
 	for (uint32_t i = 0; i < layout->set_layout_count; i++) {
 		if (layout->set_layouts[i]) {
@@ -13,26 +11,29 @@ static void destroy_pipeline_layout(void *obj) {
 		}
 	}
 
-	wgvk_free(layout);
+	wgvk_object_free(layout);
 }
 
 VkResult vkCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInfo *pCreateInfo,
                                 const VkAllocationCallbacks *pAllocator,
                                 VkPipelineLayout *pPipelineLayout) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreatePipelineLayout);
 
 	if (!device || !pCreateInfo || !pPipelineLayout) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	VkPipelineLayout layout = wgvk_alloc(sizeof(struct VkPipelineLayout_T));
+	VkPipelineLayout layout =
+	    wgvk_object_alloc(sizeof(struct VkPipelineLayout_T), VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+	                      pAllocator, device->base.allocator);
 	if (!layout) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&layout->base, destroy_pipeline_layout);
+	wgvk_object_init(&layout->base, VK_OBJECT_TYPE_PIPELINE_LAYOUT, destroy_pipeline_layout);
 	layout->device = device;
 	layout->wgpu_layout = NULL;
+	layout->interned = NULL;
 	layout->set_layout_count = pCreateInfo->setLayoutCount;
 	layout->push_constant_size = 0;
 
@@ -66,14 +67,36 @@ VkResult vkCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInf
 		}
 	}
 
-	// Create WebGPU pipeline layout
-	WGPUPipelineLayoutDescriptor desc = {0};
-	desc.nextInChain = NULL;
-	desc.label = (WGPUStringView){.data = "VkPipelineLayout", .length = WGPU_STRLEN};
-	desc.bindGroupLayoutCount = count;
-	desc.bindGroupLayouts = bind_group_layouts;
+	// Bind group layouts are interned, so their cache entries identify them
+	uint32_t key[WGVK_MAX_BIND_GROUPS * 2];
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t id =
+		    layout->set_layouts[i] ? (uint64_t)(uintptr_t)layout->set_layouts[i]->interned : 0;
+		key[i * 2] = (uint32_t)id;
+		key[i * 2 + 1] = (uint32_t)(id >> 32);
+	}
 
-	layout->wgpu_layout = wgpuDeviceCreatePipelineLayout(device->wgpu_device, &desc);
+	layout->interned = wgvk_cache_acquire(&device->pipeline_layout_cache, key, count * 2);
+	if (!layout->interned) {
+		WGPUPipelineLayoutDescriptor desc = {0};
+		desc.nextInChain = NULL;
+		desc.label = (WGPUStringView){.data = "VkPipelineLayout", .length = WGPU_STRLEN};
+		desc.bindGroupLayoutCount = count;
+		desc.bindGroupLayouts = bind_group_layouts;
+
+		WGPUPipelineLayout wgpu_layout =
+		    wgpuDeviceCreatePipelineLayout(device->wgpu_device, &desc);
+		layout->interned =
+		    wgvk_cache_insert(&device->pipeline_layout_cache, key, count * 2, wgpu_layout);
+		if (!layout->interned) {
+			if (wgpu_layout) {
+				wgpuPipelineLayoutRelease(wgpu_layout);
+			}
+			wgvk_object_release(&layout->base);
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
+	}
+	layout->wgpu_layout = layout->interned->object;
 
 	*pPipelineLayout = layout;
 	return VK_SUCCESS;
@@ -81,6 +104,7 @@ VkResult vkCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInf
 
 void vkDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout,
                              const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyPipelineLayout);
 	(void)device;
 	(void)pAllocator;
 
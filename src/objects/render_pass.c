@@ -1,27 +1,36 @@
 #include "webvulkan_internal.h"
+#include "../commands/subpass.h"
 
 static void destroy_render_pass(void *obj) {
 	VkRenderPass pass = (VkRenderPass)obj;
-	wgvk_free(pass);
+	wgvk_free(pass->subpass_info);
+	wgvk_object_free(pass);
 }
 
 VkResult vkCreateRenderPass(VkDevice device, const VkRenderPassCreateInfo *pCreateInfo,
                             const VkAllocationCallbacks *pAllocator, VkRenderPass *pRenderPass) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateRenderPass);
 
 	if (!device || !pRenderPass) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
+	// Framebuffers hold at most this many views
+	if (pCreateInfo && pCreateInfo->pAttachments &&
+	    pCreateInfo->attachmentCount > WGVK_MAX_COLOR_ATTACHMENTS + 1) {
+		WGVK_ERROR(WGVK_LOG_CAT_COMMAND, "vkCreateRenderPass: %u attachments, at most %d",
+		           pCreateInfo->attachmentCount, WGVK_MAX_COLOR_ATTACHMENTS + 1);
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
 
-	VkRenderPass pass = wgvk_alloc(sizeof(struct VkRenderPass_T));
+	VkRenderPass pass = wgvk_object_alloc(sizeof(struct VkRenderPass_T), VK_OBJECT_TYPE_RENDER_PASS,
+	                                      pAllocator, device->base.allocator);
 	if (!pass) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&pass->base, destroy_render_pass);
+	wgvk_object_init(&pass->base, VK_OBJECT_TYPE_RENDER_PASS, destroy_render_pass);
 	pass->device = device;
 	pass->attachment_count = 0;
-	pass->depth_stencil_format = 0;
 	pass->depth_stencil_index = UINT32_MAX;
 	pass->sample_count = 1;
 
@@ -35,12 +44,19 @@ VkResult vkCreateRenderPass(VkDevice device, const VkRenderPassCreateInfo *pCrea
 		const VkAttachmentDescription *attachments = pCreateInfo->pAttachments;
 
 		uint32_t color_idx = 0;
-		for (uint32_t i = 0; i < pCreateInfo->attachmentCount; i++) {
+		for (uint32_t i = 0; i < pass->attachment_count; i++) {
 			uint32_t fmt = attachments[i].format;
 			pass->sample_count = attachments[i].samples;
 
+			WgvkAttachmentInfo *info = &pass->attachments[i];
+			info->format = fmt;
+			info->samples = attachments[i].samples;
+			info->load_op = attachments[i].loadOp;
+			info->store_op = attachments[i].storeOp;
+			info->stencil_load_op = attachments[i].stencilLoadOp;
+			info->stencil_store_op = attachments[i].stencilStoreOp;
+
 			if ((fmt >= VK_FORMAT_D16_UNORM && fmt <= VK_FORMAT_D32_SFLOAT_S8_UINT)) {
-				pass->depth_stencil_format = fmt;
 				pass->depth_stencil_index = i;
 			} else if (color_idx < WGVK_MAX_COLOR_ATTACHMENTS) {
 				pass->color_formats[color_idx++] = fmt;
@@ -48,12 +64,26 @@ VkResult vkCreateRenderPass(VkDevice device, const VkRenderPassCreateInfo *pCrea
 		}
 	}
 
+	pass->subpass_info = wgvk_alloc(sizeof(WgvkRenderPassInfo));
+	if (!pass->subpass_info) {
+		wgvk_object_free(pass);
+		return VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	VkResult result = wgvk_subpass_analyze(pCreateInfo, pass, pass->subpass_info);
+	if (result != VK_SUCCESS) {
+		wgvk_free(pass->subpass_info);
+		wgvk_object_free(pass);
+		return result;
+	}
+
 	*pRenderPass = pass;
 	return VK_SUCCESS;
 }
 
 void vkDestroyRenderPass(VkDevice device, VkRenderPass renderPass,
                          const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyRenderPass);
 	(void)device;
 	(void)pAllocator;
 	if (renderPass) {
@@ -1,56 +1,156 @@
 #include "webvulkan_internal.h"
+#include "../util/log.h"
+
+#define WGVK_SAMPLER_KEY_WORDS 10
+#define WGVK_MAX_ANISOTROPY 16
 
 static void destroy_sampler(void *obj) {
 	VkSampler sampler = (VkSampler)obj;
-	if (sampler->wgpu_sampler) {
-		wgpuSamplerRelease(sampler->wgpu_sampler);
+	wgvk_cache_release(&sampler->device->sampler_cache, sampler->interned);
+	wgvk_object_free(sampler);
+}
+
+static WGPUFilterMode translate_filter(VkFilter filter) {
+	/* VK_FILTER_CUBIC_EXT has no WebGPU equivalent; linear is the closest. */
+	return filter == VK_FILTER_NEAREST ? WGPUFilterMode_Nearest : WGPUFilterMode_Linear;
+}
+
+static WGPUAddressMode translate_address_mode(VkSamplerAddressMode mode) {
+	switch (mode) {
+	case VK_SAMPLER_ADDRESS_MODE_REPEAT:
+		return WGPUAddressMode_Repeat;
+	case VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT:
+		return WGPUAddressMode_MirrorRepeat;
+	case VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE:
+		return WGPUAddressMode_ClampToEdge;
+	case VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER:
+		WGVK_WARN(WGVK_LOG_CAT_CORE,
+		          "vkCreateSampler: CLAMP_TO_BORDER unsupported, using CLAMP_TO_EDGE");
+		return WGPUAddressMode_ClampToEdge;
+	default:
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "vkCreateSampler: address mode %d unsupported, using "
+		                             "CLAMP_TO_EDGE",
+		          (int)mode);
+		return WGPUAddressMode_ClampToEdge;
 	}
-	free(sampler);
 }
 
-VkResult vkCreateSampler(VkDevice device, const void *pCreateInfo,
+static WGPUCompareFunction translate_compare_op(VkCompareOp op) {
+	static const WGPUCompareFunction vk_compare_to_wgpu[] = {
+	    WGPUCompareFunction_Never,        /* VK_COMPARE_OP_NEVER */
+	    WGPUCompareFunction_Less,         /* VK_COMPARE_OP_LESS */
+	    WGPUCompareFunction_Equal,        /* VK_COMPARE_OP_EQUAL */
+	    WGPUCompareFunction_LessEqual,    /* VK_COMPARE_OP_LESS_OR_EQUAL */
+	    WGPUCompareFunction_Greater,      /* VK_COMPARE_OP_GREATER */
+	    WGPUCompareFunction_NotEqual,     /* VK_COMPARE_OP_NOT_EQUAL */
+	    WGPUCompareFunction_GreaterEqual, /* VK_COMPARE_OP_GREATER_OR_EQUAL */
+	    WGPUCompareFunction_Always,       /* VK_COMPARE_OP_ALWAYS */
+	};
+	uint32_t idx = (uint32_t)op;
+	if (idx >= 8)
+		idx = 7; /* clamp to Always */
+	return vk_compare_to_wgpu[idx];
+}
+
+/* Translate to a WebGPU descriptor, normalized so that create infos which
+ * WebGPU cannot tell apart produce identical descriptors. */
+static void translate_sampler(const VkSamplerCreateInfo *info, WGPUSamplerDescriptor *desc) {
+	desc->addressModeU = translate_address_mode(info->addressModeU);
+	desc->addressModeV = translate_address_mode(info->addressModeV);
+	desc->addressModeW = translate_address_mode(info->addressModeW);
+	desc->magFilter = translate_filter(info->magFilter);
+	desc->minFilter = translate_filter(info->minFilter);
+	desc->mipmapFilter = info->mipmapMode == VK_SAMPLER_MIPMAP_MODE_NEAREST
+	                         ? WGPUMipmapFilterMode_Nearest
+	                         : WGPUMipmapFilterMode_Linear;
+
+	float min_lod = info->minLod > 0.0f ? info->minLod : 0.0f;
+	float max_lod = info->maxLod < 32.0f ? info->maxLod : 32.0f; /* VK_LOD_CLAMP_NONE */
+	desc->lodMinClamp = min_lod;
+	desc->lodMaxClamp = max_lod > min_lod ? max_lod : min_lod;
+
+	desc->compare =
+	    info->compareEnable ? translate_compare_op(info->compareOp) : WGPUCompareFunction_Undefined;
+
+	/* WebGPU only allows anisotropy when every filter is linear. */
+	desc->maxAnisotropy = 1;
+	if (info->anisotropyEnable && info->maxAnisotropy > 1.0f &&
+	    desc->magFilter == WGPUFilterMode_Linear && desc->minFilter == WGPUFilterMode_Linear &&
+	    desc->mipmapFilter == WGPUMipmapFilterMode_Linear) {
+		float clamped = info->maxAnisotropy < WGVK_MAX_ANISOTROPY ? info->maxAnisotropy
+		                                                          : WGVK_MAX_ANISOTROPY;
+		desc->maxAnisotropy = (uint16_t)(clamped + 0.5f);
+	}
+
+	if (info->mipLodBias != 0.0f) {
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "vkCreateSampler: mipLodBias %.2f ignored", info->mipLodBias);
+	}
+	if (info->unnormalizedCoordinates) {
+		WGVK_WARN(WGVK_LOG_CAT_CORE, "vkCreateSampler: unnormalizedCoordinates unsupported");
+	}
+}
+
+static void write_sampler_key(uint32_t *key, const WGPUSamplerDescriptor *desc) {
+	key[0] = (uint32_t)desc->addressModeU;
+	key[1] = (uint32_t)desc->addressModeV;
+	key[2] = (uint32_t)desc->addressModeW;
+	key[3] = (uint32_t)desc->magFilter;
+	key[4] = (uint32_t)desc->minFilter;
+	key[5] = (uint32_t)desc->mipmapFilter;
+	memcpy(&key[6], &desc->lodMinClamp, sizeof(float));
+	memcpy(&key[7], &desc->lodMaxClamp, sizeof(float));
+	key[8] = (uint32_t)desc->compare;
+	key[9] = (uint32_t)desc->maxAnisotropy;
+}
+
+VkResult vkCreateSampler(VkDevice device, const VkSamplerCreateInfo *pCreateInfo,
                          const VkAllocationCallbacks *pAllocator, VkSampler *pSampler) {
-	(void)pCreateInfo;
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateSampler);
 
-	if (!device || !pSampler) {
+	if (!device || !pCreateInfo || !pSampler) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkSampler sampler = wgvk_alloc(sizeof(struct VkSampler_T));
+	VkSampler sampler = wgvk_object_alloc(sizeof(struct VkSampler_T), VK_OBJECT_TYPE_SAMPLER,
+	                                      pAllocator, device->base.allocator);
 	if (!sampler) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&sampler->base, destroy_sampler);
+	wgvk_object_init(&sampler->base, VK_OBJECT_TYPE_SAMPLER, destroy_sampler);
 	sampler->device = device;
 	sampler->wgpu_sampler = NULL;
+	sampler->interned = NULL;
 
-	WGPUSamplerDescriptor desc = {
-	    .addressModeU = WGPUAddressMode_ClampToEdge,
-	    .addressModeV = WGPUAddressMode_ClampToEdge,
-	    .addressModeW = WGPUAddressMode_ClampToEdge,
-	    .magFilter = WGPUFilterMode_Linear,
-	    .minFilter = WGPUFilterMode_Linear,
-	    .mipmapFilter = WGPUMipmapFilterMode_Linear,
-	    .lodMinClamp = 0.0f,
-	    .lodMaxClamp = 32.0f,
-	    .compare = WGPUCompareFunction_Undefined,
-	    .maxAnisotropy = 1,
-	};
+	WGPUSamplerDescriptor desc = {0};
+	translate_sampler(pCreateInfo, &desc);
 
-	sampler->wgpu_sampler = wgpuDeviceCreateSampler(device->wgpu_device, &desc);
+	uint32_t key[WGVK_SAMPLER_KEY_WORDS];
+	write_sampler_key(key, &desc);
 
-	if (!sampler->wgpu_sampler) {
-		free(sampler);
-		return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+	sampler->interned = wgvk_cache_acquire(&device->sampler_cache, key, WGVK_SAMPLER_KEY_WORDS);
+	if (!sampler->interned) {
+		WGPUSampler wgpu_sampler = wgpuDeviceCreateSampler(device->wgpu_device, &desc);
+		if (!wgpu_sampler) {
+			wgvk_object_free(sampler);
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+		}
+		sampler->interned =
+		    wgvk_cache_insert(&device->sampler_cache, key, WGVK_SAMPLER_KEY_WORDS, wgpu_sampler);
+		if (!sampler->interned) {
+			wgpuSamplerRelease(wgpu_sampler);
+			wgvk_object_free(sampler);
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+		}
 	}
+	sampler->wgpu_sampler = sampler->interned->object;
 
 	*pSampler = sampler;
 	return VK_SUCCESS;
 }
 
 void vkDestroySampler(VkDevice device, VkSampler sampler, const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroySampler);
 	(void)device;
 	(void)pAllocator;
 	if (sampler) {
@@ -2,18 +2,20 @@
 
 static void destroy_semaphore(void *obj) {
 	VkSemaphore semaphore = (VkSemaphore)obj;
-	wgvk_free(semaphore);
+	wgvk_object_free(semaphore);
 }
 
 VkResult vkCreateSemaphore(VkDevice device, const void *pCreateInfo,
                            const VkAllocationCallbacks *pAllocator, VkSemaphore *pSemaphore) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateSemaphore);
 
 	if (!device || !pSemaphore) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkSemaphore semaphore = wgvk_alloc(sizeof(struct VkSemaphore_T));
+	VkSemaphore semaphore =
+	    wgvk_object_alloc(sizeof(struct VkSemaphore_T), VK_OBJECT_TYPE_SEMAPHORE, pAllocator,
+	                      device->base.allocator);
 	if (!semaphore) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
@@ -50,7 +52,7 @@ VkResult vkCreateSemaphore(VkDevice device, const void *pCreateInfo,
 		}
 	}
 
-	wgvk_object_init(&semaphore->base, destroy_semaphore);
+	wgvk_object_init(&semaphore->base, VK_OBJECT_TYPE_SEMAPHORE, destroy_semaphore);
 	semaphore->device = device;
 	semaphore->value = initial_value;
 	semaphore->signaled = is_timeline ? VK_TRUE : VK_FALSE;
@@ -62,6 +64,7 @@ VkResult vkCreateSemaphore(VkDevice device, const void *pCreateInfo,
 
 void vkDestroySemaphore(VkDevice device, VkSemaphore semaphore,
                         const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroySemaphore);
 	(void)device;
 	(void)pAllocator;
 	if (semaphore) {
@@ -70,6 +73,7 @@ void vkDestroySemaphore(VkDevice device, VkSemaphore semaphore,
 }
 
 VkResult vkGetSemaphoreCounterValue(VkDevice device, VkSemaphore semaphore, uint64_t *pValue) {
+	WGVK_STAT_CALL(vkGetSemaphoreCounterValue);
 	(void)device;
 
 	if (!semaphore || !pValue) {
@@ -81,6 +85,7 @@ VkResult vkGetSemaphoreCounterValue(VkDevice device, VkSemaphore semaphore, uint
 }
 
 VkResult vkSignalSemaphore(VkDevice device, const void *pSignalInfo) {
+	WGVK_STAT_CALL(vkSignalSemaphore);
 	(void)device;
 
 	if (!pSignalInfo) {
@@ -103,6 +108,7 @@ VkResult vkSignalSemaphore(VkDevice device, const void *pSignalInfo) {
 }
 
 VkResult vkWaitSemaphores(VkDevice device, const void *pWaitInfo, uint64_t timeout) {
+	WGVK_STAT_CALL(vkWaitSemaphores);
 	(void)device;
 	(void)timeout;
 
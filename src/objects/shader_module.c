@@ -3,6 +3,7 @@
 #include "../shaders/spirv_parser.h"
 #include "../shaders/wgsl_gen.h"
 #include "../util/log.h"
+#include "../util/trace.h"
 #include "webvulkan_internal.h"
 
 static void destroy_shader_module(void *obj) {
@@ -21,7 +22,7 @@ static void destroy_shader_module(void *obj) {
 	if (module->spirv_code) {
 		wgvk_free(module->spirv_code);
 	}
-	wgvk_free(module);
+	wgvk_object_free(module);
 }
 
 static VkBool32 is_wgsl_source(const uint32_t *code, size_t size) {
@@ -30,21 +31,97 @@ static VkBool32 is_wgsl_source(const uint32_t *code, size_t size) {
 	return (code[0] == 0x07230203) ? VK_FALSE : VK_TRUE;
 }
 
+/* Generate WGSL for one stage and compile it, or NULL on failure. */
+static WGPUShaderModule translate_stage(VkDevice device, WgvkSpvModule *spv_module,
+                                        uint32_t exec_model, const WgvkWgslBindingRemap *remaps,
+                                        uint32_t remap_count) {
+	WgvkWgslGenerator gen = {0};
+	if (wgvk_wgsl_init(&gen, spv_module, exec_model) != 0)
+		return NULL;
+	gen.remaps = remaps;
+	gen.remap_count = remap_count;
+	char *wgsl = wgvk_wgsl_generate(&gen);
+	wgvk_wgsl_free(&gen);
+	if (!wgsl)
+		return NULL;
+
+	WGPUShaderSourceWGSL wgsl_desc = {
+	    .chain = {.next = NULL, .sType = WGPUSType_ShaderSourceWGSL},
+	    .code = (WGPUStringView){.data = wgsl, .length = WGPU_STRLEN},
+	};
+	WGPUShaderModuleDescriptor desc = {
+	    .nextInChain = (const WGPUChainedStruct *)&wgsl_desc,
+	};
+	WGPUShaderModule sm = wgpuDeviceCreateShaderModule(device->wgpu_device, &desc);
+	free(wgsl);
+	return sm;
+}
+
+/* Remaps for the arrayed bindings of @p layout; non-arrayed bindings keep
+ * their numbers and need none. Returns the count written. */
+static uint32_t layout_binding_remaps(VkPipelineLayout layout, WgvkWgslBindingRemap *remaps,
+                                      uint32_t capacity) {
+	uint32_t count = 0;
+	for (uint32_t s = 0; s < layout->set_layout_count; s++) {
+		VkDescriptorSetLayout set_layout = layout->set_layouts[s];
+		for (uint32_t b = 0; set_layout && b < set_layout->binding_count; b++) {
+			const WgvkDescriptorBinding *info = &set_layout->bindings[b];
+			if (info->descriptor_count < 2)
+				continue;
+			if (remaps && count < capacity) {
+				remaps[count] = (WgvkWgslBindingRemap){
+				    .set = s,
+				    .binding = info->binding,
+				    .count = info->descriptor_count,
+				    .first_extra = info->first_extra,
+				};
+			}
+			count++;
+		}
+	}
+	return count;
+}
+
+VkBool32 wgvk_shader_module_for_layout(VkShaderModule module, uint32_t exec_model,
+                                       VkPipelineLayout layout, WGPUShaderModule *out) {
+	*out = NULL;
+	if (!module || !module->spirv_code || !layout)
+		return VK_TRUE;
+	uint32_t remap_count = layout_binding_remaps(layout, NULL, 0);
+	if (remap_count == 0)
+		return VK_TRUE;
+
+	WGVK_SPAN(WGVK_LOG_CAT_SHADER, "transpile SPIR-V for layout");
+	WgvkWgslBindingRemap *remaps = wgvk_alloc(sizeof(*remaps) * remap_count);
+	WgvkSpvModule spv_module = {0};
+	WGPUShaderModule sm = NULL;
+	if (remaps && wgvk_spirv_parse(&spv_module, module->spirv_code, module->spirv_size / 4) == 0) {
+		layout_binding_remaps(layout, remaps, remap_count);
+		sm = translate_stage(module->device, &spv_module, exec_model, remaps, remap_count);
+	}
+	wgvk_spirv_free(&spv_module);
+	wgvk_free(remaps);
+	*out = sm;
+	return sm ? VK_TRUE : VK_FALSE;
+}
+
 VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
                               const VkAllocationCallbacks *pAllocator,
                               VkShaderModule *pShaderModule) {
-	(void)pAllocator;
+	WGVK_STAT_CALL(vkCreateShaderModule);
 
 	if (!device || !pCreateInfo || !pShaderModule) {
 		return VK_ERROR_INITIALIZATION_FAILED;
 	}
 
-	VkShaderModule module = wgvk_alloc(sizeof(struct VkShaderModule_T));
+	VkShaderModule module =
+	    wgvk_object_alloc(sizeof(struct VkShaderModule_T), VK_OBJECT_TYPE_SHADER_MODULE, pAllocator,
+	                      device->base.allocator);
 	if (!module) {
 		return VK_ERROR_OUT_OF_HOST_MEMORY;
 	}
 
-	wgvk_object_init(&module->base, destroy_shader_module);
+	wgvk_object_init(&module->base, VK_OBJECT_TYPE_SHADER_MODULE, destroy_shader_module);
 	module->device = device;
 	module->wgpu_shader = NULL;
 	module->wgsl_source = NULL;
@@ -58,7 +135,7 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 			size_t wgsl_len = pCreateInfo->codeSize;
 			module->wgsl_source = wgvk_alloc(wgsl_len + 1);
 			if (!module->wgsl_source) {
-				wgvk_free(module);
+				wgvk_object_free(module);
 				return VK_ERROR_OUT_OF_HOST_MEMORY;
 			}
 			memcpy(module->wgsl_source, pCreateInfo->pCode, wgsl_len);
@@ -78,13 +155,14 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 			module->wgpu_shader = wgpuDeviceCreateShaderModule(device->wgpu_device, &desc);
 			if (!module->wgpu_shader) {
 				wgvk_free(module->wgsl_source);
-				wgvk_free(module);
+				wgvk_object_free(module);
 				return VK_ERROR_OUT_OF_DEVICE_MEMORY;
 			}
 		} else {
+			WGVK_SPAN(WGVK_LOG_CAT_SHADER, "transpile SPIR-V");
 			module->spirv_code = wgvk_alloc(pCreateInfo->codeSize);
 			if (!module->spirv_code) {
-				wgvk_free(module);
+				wgvk_object_free(module);
 				return VK_ERROR_OUT_OF_HOST_MEMORY;
 			}
 			memcpy(module->spirv_code, pCreateInfo->pCode, pCreateInfo->codeSize);
@@ -93,7 +171,7 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 			WgvkSpvModule spv_module = {0};
 			if (wgvk_spirv_parse(&spv_module, pCreateInfo->pCode, pCreateInfo->codeSize / 4) != 0) {
 				wgvk_free(module->spirv_code);
-				wgvk_free(module);
+				wgvk_object_free(module);
 				return VK_ERROR_INVALID_SHADER_NV;
 			}
 
@@ -103,23 +181,7 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 				if (em >= (uint32_t)WGVK_SHADER_STAGE_COUNT)
 					continue;
 
-				WgvkWgslGenerator gen = {0};
-				if (wgvk_wgsl_init(&gen, &spv_module, em) != 0)
-					continue;
-				char *wgsl = wgvk_wgsl_generate(&gen);
-				wgvk_wgsl_free(&gen);
-				if (!wgsl)
-					continue;
-
-				WGPUShaderSourceWGSL wgsl_desc = {
-				    .chain = {.next = NULL, .sType = WGPUSType_ShaderSourceWGSL},
-				    .code = (WGPUStringView){.data = wgsl, .length = WGPU_STRLEN},
-				};
-				WGPUShaderModuleDescriptor desc = {
-				    .nextInChain = (const WGPUChainedStruct *)&wgsl_desc,
-				};
-				WGPUShaderModule sm = wgpuDeviceCreateShaderModule(device->wgpu_device, &desc);
-				free(wgsl);
+				WGPUShaderModule sm = translate_stage(device, &spv_module, em, NULL, 0);
 				if (sm) {
 					module->stage_shaders[em] = sm;
 					any_ok = 1;
@@ -132,7 +194,7 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 				           "SPIR-V to WGSL transpilation failed: no entry point produced a "
 				           "valid WGPUShaderModule. Consider passing WGSL source directly.");
 				wgvk_free(module->spirv_code);
-				wgvk_free(module);
+				wgvk_object_free(module);
 				return VK_ERROR_INVALID_SHADER_NV;
 			}
 		}
@@ -144,6 +206,7 @@ VkResult vkCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *p
 
 void vkDestroyShaderModule(VkDevice device, VkShaderModule shaderModule,
                            const VkAllocationCallbacks *pAllocator) {
+	WGVK_STAT_CALL(vkDestroyShaderModule);
 	(void)device;
 	(void)pAllocator;
 	if (shaderModule) {
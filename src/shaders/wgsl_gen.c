@@ -195,53 +195,249 @@ static void emit_struct_definitions(WgvkWgslGenerator *gen) {
 	}
 }
 
-static void emit_resource_bindings(WgvkWgslGenerator *gen) {
-	WgvkSpvModule *mod = gen->module;
+#define WGVK_WGSL_MAX_SETS 8
 
+/* The descriptor variable @p id, or NULL for any other id. */
+static WgvkSpvVariable *find_resource(WgvkSpvModule *mod, uint32_t id) {
 	for (uint32_t i = 0; i < mod->variable_count; i++) {
 		WgvkSpvVariable *var = &mod->variables[i];
-
-		uint32_t storage_class = var->storage_class;
-		if (storage_class == WGVK_SPV_STORAGE_CLASS_INPUT ||
-		    storage_class == WGVK_SPV_STORAGE_CLASS_OUTPUT) {
+		if (var->id != id)
 			continue;
+		if (var->storage_class == WGVK_SPV_STORAGE_CLASS_INPUT ||
+		    var->storage_class == WGVK_SPV_STORAGE_CLASS_OUTPUT ||
+		    var->storage_class == WGVK_SPV_STORAGE_CLASS_FUNCTION)
+			return NULL;
+		return wgvk_spirv_get_decoration(mod, id, WGVK_SPV_DECORATION_BINDING) ? var : NULL;
+	}
+	return NULL;
+}
+
+static void resource_location(WgvkSpvModule *mod, const WgvkSpvVariable *var, uint32_t *set,
+                              uint32_t *binding) {
+	WgvkSpvDecorationInfo *binding_dec =
+	    wgvk_spirv_get_decoration(mod, var->id, WGVK_SPV_DECORATION_BINDING);
+	WgvkSpvDecorationInfo *set_dec =
+	    wgvk_spirv_get_decoration(mod, var->id, WGVK_SPV_DECORATION_DESCRIPTOR_SET);
+	*binding = binding_dec ? binding_dec->value : 0;
+	*set = set_dec ? set_dec->value : 0;
+}
+
+/* Element count of a descriptor array, or 0 for a single descriptor. The
+ * type of one descriptor is stored in @p element_type. */
+static uint32_t descriptor_array_length(WgvkSpvModule *mod, const WgvkSpvVariable *var,
+                                        WgvkSpvType **element_type) {
+	WgvkSpvType *ptr_type = wgvk_spirv_get_type(mod, var->type_id);
+	WgvkSpvType *var_type = ptr_type ? wgvk_spirv_get_type(mod, ptr_type->element_type) : NULL;
+	*element_type = var_type;
+	if (!var_type || var_type->op != WGVK_SPV_OP_TYPE_ARRAY)
+		return 0;
+	*element_type = wgvk_spirv_get_type(mod, var_type->element_type);
+	WgvkSpvConstant *len = wgvk_spirv_get_constant(mod, var_type->length);
+	return len && len->value[0] > 0 ? len->value[0] : 1;
+}
+
+static int is_opaque_type(const WgvkSpvType *type) {
+	return type &&
+	       (type->op == WGVK_SPV_OP_TYPE_IMAGE || type->op == WGVK_SPV_OP_TYPE_SAMPLER ||
+	        type->op == WGVK_SPV_OP_TYPE_SAMPLED_IMAGE);
+}
+
+/* The access chain defining @p id when it indexes a descriptor array with a
+ * value that is not a constant, else NULL. */
+static WgvkSpvInstruction *dynamic_descriptor_chain(WgvkSpvModule *mod, uint32_t id) {
+	for (uint32_t f = 0; f < mod->function_count; f++) {
+		WgvkSpvFunction *func = mod->functions[f];
+		for (uint32_t b = 0; b < func->block_count; b++) {
+			WgvkSpvBlock *block = &func->blocks[b];
+			for (uint32_t i = 0; i < block->instruction_count; i++) {
+				WgvkSpvInstruction *inst = &block->instructions[i];
+				if (inst->result_id != id)
+					continue;
+				if ((inst->opcode != WGVK_SPV_OP_ACCESS_CHAIN &&
+				     inst->opcode != WGVK_SPV_OP_IN_BOUNDS_ACCESS_CHAIN) ||
+				    inst->operand_count < 2 || wgvk_spirv_get_constant(mod, inst->operands[1]))
+					return NULL;
+				WgvkSpvVariable *var = find_resource(mod, inst->operands[0]);
+				WgvkSpvType *element_type = NULL;
+				return var && descriptor_array_length(mod, var, &element_type) ? inst : NULL;
+			}
 		}
+	}
+	return NULL;
+}
 
-		WgvkSpvDecorationInfo *binding_dec =
-		    wgvk_spirv_get_decoration(mod, var->id, WGVK_SPV_DECORATION_BINDING);
-		WgvkSpvDecorationInfo *set_dec =
-		    wgvk_spirv_get_decoration(mod, var->id, WGVK_SPV_DECORATION_DESCRIPTOR_SET);
+/* Whether any access chain indexes descriptor array @p var_id with a value
+ * that is not a constant. */
+static int indexed_dynamically(WgvkSpvModule *mod, uint32_t var_id) {
+	for (uint32_t f = 0; f < mod->function_count; f++) {
+		WgvkSpvFunction *func = mod->functions[f];
+		for (uint32_t b = 0; b < func->block_count; b++) {
+			WgvkSpvBlock *block = &func->blocks[b];
+			for (uint32_t i = 0; i < block->instruction_count; i++) {
+				WgvkSpvInstruction *inst = &block->instructions[i];
+				if ((inst->opcode == WGVK_SPV_OP_ACCESS_CHAIN ||
+				     inst->opcode == WGVK_SPV_OP_IN_BOUNDS_ACCESS_CHAIN) &&
+				    inst->operand_count >= 2 && inst->operands[0] == var_id &&
+				    !wgvk_spirv_get_constant(mod, inst->operands[1]))
+					return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* WebGPU binding of @p element of a descriptor binding: the caller's remap
+ * table when it has the binding, else the next number past the module's own
+ * bindings in the set. */
+static uint32_t wgpu_binding(const WgvkWgslGenerator *gen, uint32_t set, uint32_t binding,
+                             uint32_t element, uint32_t *next_extra) {
+	if (element == 0)
+		return binding;
+	for (uint32_t r = 0; r < gen->remap_count; r++) {
+		const WgvkWgslBindingRemap *remap = &gen->remaps[r];
+		if (remap->set == set && remap->binding == binding && element < remap->count)
+			return remap->first_extra + element - 1;
+	}
+	return set < WGVK_WGSL_MAX_SETS ? next_extra[set]++ : binding + element;
+}
 
-		if (!binding_dec)
+static void emit_resource_bindings(WgvkWgslGenerator *gen) {
+	WgvkSpvModule *mod = gen->module;
+
+	uint32_t next_extra[WGVK_WGSL_MAX_SETS] = {0};
+	for (uint32_t i = 0; i < mod->variable_count; i++) {
+		uint32_t set, binding;
+		if (!find_resource(mod, mod->variables[i].id))
 			continue;
+		resource_location(mod, &mod->variables[i], &set, &binding);
+		if (set < WGVK_WGSL_MAX_SETS && binding + 1 > next_extra[set])
+			next_extra[set] = binding + 1;
+	}
 
-		uint32_t binding = binding_dec->value;
-		uint32_t set = set_dec ? set_dec->value : 0;
+	for (uint32_t i = 0; i < mod->variable_count; i++) {
+		WgvkSpvVariable *var = &mod->variables[i];
+		if (!find_resource(mod, var->id))
+			continue;
 
-		WgvkSpvType *ptr_type = wgvk_spirv_get_type(mod, var->type_id);
-		WgvkSpvType *var_type = ptr_type ? wgvk_spirv_get_type(mod, ptr_type->element_type) : NULL;
+		uint32_t set, binding;
+		resource_location(mod, var, &set, &binding);
 
-		emit(gen, "@group(%u) @binding(%u)\n", set, binding);
+		/* A top-level array is a descriptor array. WGSL has no binding arrays,
+		 * so each element is its own variable, numbered like the layout
+		 * entries vkCreateDescriptorSetLayout creates for it. */
+		WgvkSpvType *var_type = NULL;
+		uint32_t array_len = descriptor_array_length(mod, var, &var_type);
 
-		const char *addr_space = storage_class_to_address_space(storage_class);
+		const char *addr_space = storage_class_to_address_space(var->storage_class);
 		if (!addr_space)
 			addr_space = "uniform";
 
-		emit(gen, "var");
+		for (uint32_t e = 0; e < (array_len ? array_len : 1); e++) {
+			emit(gen, "@group(%u) @binding(%u)\n", set,
+			     wgpu_binding(gen, set, binding, e, next_extra));
+			emit(gen, "var");
 
-		if (var_type &&
-		    (var_type->op == WGVK_SPV_OP_TYPE_IMAGE || var_type->op == WGVK_SPV_OP_TYPE_SAMPLER ||
-		     var_type->op == WGVK_SPV_OP_TYPE_SAMPLED_IMAGE)) {
-		} else {
-			emit(gen, "<%s>", addr_space);
+			if (!is_opaque_type(var_type)) {
+				emit(gen, "<%s>", addr_space);
+			}
+
+			if (array_len) {
+				emit(gen, " resource_%u_%u_%u: ", set, binding, e);
+			} else {
+				emit(gen, " resource_%u_%u: ", set, binding);
+			}
+			emit_type(gen, var_type);
+			emit(gen, ";\n\n");
 		}
 
-		emit(gen, " resource_%u_%u: ", set, binding);
-		emit_type(gen, var_type);
-		emit(gen, ";\n\n");
+		/* Buffer elements picked by a dynamic index are switched over at each
+		 * load and store. Textures and samplers cannot be: WGSL has no
+		 * pointers to them, and the translator no image instructions. */
+		int opaque = is_opaque_type(var_type) ||
+		             var->storage_class == WGVK_SPV_STORAGE_CLASS_UNIFORM_CONSTANT;
+		if (array_len && opaque && indexed_dynamically(mod, var->id)) {
+			WGVK_ERROR(WGVK_LOG_CAT_SHADER,
+			           "descriptor array %u.%u: dynamic indexing of textures and samplers "
+			           "is not supported",
+			           set, binding);
+			gen->failed = 1;
+		}
+	}
+}
+
+/* Name of the value @p id: the declared variable for descriptors, else v<id>. */
+static void emit_ref(WgvkWgslGenerator *gen, uint32_t id) {
+	WgvkSpvVariable *var = find_resource(gen->module, id);
+	if (var) {
+		uint32_t set, binding;
+		resource_location(gen->module, var, &set, &binding);
+		emit(gen, "resource_%u_%u", set, binding);
+	} else {
+		emit(gen, "v%u", id);
 	}
 }
 
+/* Access chain whose base is a descriptor array: the first index picks the
+ * element variable, the rest index into it. A dynamic index has no single
+ * variable to point at, so nothing is emitted here and each load and store
+ * through the chain switches over the elements instead. */
+static void emit_descriptor_array_chain(WgvkWgslGenerator *gen, WgvkSpvInstruction *inst,
+                                        const WgvkSpvVariable *var) {
+	WgvkSpvModule *mod = gen->module;
+	WgvkSpvConstant *index = wgvk_spirv_get_constant(mod, inst->operands[1]);
+	if (!index)
+		return;
+
+	uint32_t set, binding;
+	resource_location(mod, var, &set, &binding);
+	WgvkSpvType *result_type = wgvk_spirv_get_type(mod, inst->result_type_id);
+	emit(gen, "    let v%u: ", inst->result_id);
+	emit_type(gen, result_type);
+	emit(gen, " = &resource_%u_%u_%u", set, binding, index->value[0]);
+	for (uint32_t i = 2; i < inst->operand_count; i++) {
+		emit(gen, "[v%u]", inst->operands[i]);
+	}
+	emit(gen, ";\n");
+}
+
+/* Load or store through @p chain, a dynamically indexed descriptor array
+ * chain: one case per element, with out-of-range indices using element 0.
+ * Loads go into v<result_id>, stores write v<value_id>. */
+static void emit_descriptor_array_access(WgvkWgslGenerator *gen, WgvkSpvInstruction *chain,
+                                         uint32_t result_id, uint32_t value_id) {
+	WgvkSpvModule *mod = gen->module;
+	WgvkSpvVariable *var = find_resource(mod, chain->operands[0]);
+	WgvkSpvType *element_type = NULL;
+	uint32_t array_len = descriptor_array_length(mod, var, &element_type);
+	uint32_t set, binding;
+	resource_location(mod, var, &set, &binding);
+
+	if (result_id) {
+		WgvkSpvType *ptr_type = wgvk_spirv_get_type(mod, chain->result_type_id);
+		emit(gen, "    var v%u: ", result_id);
+		emit_type(gen, ptr_type);
+		emit(gen, ";\n");
+	}
+	emit(gen, "    switch u32(v%u) {\n", chain->operands[1]);
+	for (uint32_t e = 0; e < array_len; e++) {
+		if (e == 0) {
+			emit(gen, "        case 0u, default: { ");
+		} else {
+			emit(gen, "        case %uu: { ", e);
+		}
+		if (result_id)
+			emit(gen, "v%u = ", result_id);
+		emit(gen, "resource_%u_%u_%u", set, binding, e);
+		for (uint32_t i = 2; i < chain->operand_count; i++) {
+			emit(gen, "[v%u]", chain->operands[i]);
+		}
+		if (!result_id)
+			emit(gen, " = v%u", value_id);
+		emit(gen, "; }\n");
+	}
+	emit(gen, "    }\n");
+}
+
 static void emit_io_struct(WgvkWgslGenerator *gen, const char *name, uint32_t storage_class) {
 	WgvkSpvModule *mod = gen->module;
 	int has_members = 0;
@@ -488,25 +684,53 @@ static void emit_instruction(WgvkWgslGenerator *gen, WgvkSpvInstruction *inst) {
 	switch (inst->opcode) {
 	case WGVK_SPV_OP_LOAD: {
 		if (inst->result_id && inst->operand_count >= 1) {
+			WgvkSpvInstruction *chain = dynamic_descriptor_chain(mod, inst->operands[0]);
+			if (chain) {
+				emit_descriptor_array_access(gen, chain, inst->result_id, 0);
+				break;
+			}
 			WgvkSpvType *result_type = wgvk_spirv_get_type(mod, inst->result_type_id);
 			emit(gen, "    let v%u: ", inst->result_id);
 			emit_type(gen, result_type);
-			emit(gen, " = v%u;\n", inst->operands[0]);
+			emit(gen, " = ");
+			emit_ref(gen, inst->operands[0]);
+			emit(gen, ";\n");
 		}
 		break;
 	}
 	case WGVK_SPV_OP_STORE: {
 		if (inst->operand_count >= 2) {
+			WgvkSpvInstruction *chain = dynamic_descriptor_chain(mod, inst->operands[0]);
+			if (chain) {
+				emit_descriptor_array_access(gen, chain, 0, inst->operands[1]);
+				break;
+			}
 			emit(gen, "    v%u = v%u;\n", inst->operands[0], inst->operands[1]);
 		}
 		break;
 	}
 	case WGVK_SPV_OP_ACCESS_CHAIN: {
 		if (inst->result_id && inst->operand_count >= 2) {
+			WgvkSpvVariable *base = find_resource(mod, inst->operands[0]);
+			WgvkSpvType *element_type = NULL;
+			if (base && descriptor_array_length(mod, base, &element_type)) {
+				emit_descriptor_array_chain(gen, inst, base);
+				break;
+			}
+			if (dynamic_descriptor_chain(mod, inst->operands[0])) {
+				WGVK_ERROR(WGVK_LOG_CAT_SHADER,
+				           "access chain %u: chains through a dynamically indexed descriptor "
+				           "array are not supported",
+				           inst->result_id);
+				gen->failed = 1;
+				break;
+			}
 			WgvkSpvType *result_type = wgvk_spirv_get_type(mod, inst->result_type_id);
 			emit(gen, "    let v%u: ", inst->result_id);
 			emit_type(gen, result_type);
-			emit(gen, " = &v%u[", inst->operands[0]);
+			emit(gen, " = &");
+			emit_ref(gen, inst->operands[0]);
+			emit(gen, "[");
 			for (uint32_t i = 1; i < inst->operand_count; i++) {
 				if (i > 1)
 					emit(gen, "][");
@@ -604,6 +828,8 @@ char *wgvk_wgsl_generate(WgvkWgslGenerator *gen) {
 	}
 	emit_resource_bindings(gen);
 	emit_entry_function(gen);
+	if (gen->failed)
+		return NULL;
 
 	char *result = malloc(gen->cursor + 1);
 	if (result) {
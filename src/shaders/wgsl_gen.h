@@ -33,6 +33,19 @@
  *   free(gen);             // caller frees the generator itself
  *   free(wgsl);
  */
+/**
+ * WebGPU binding numbers of one Vulkan descriptor binding. Core WebGPU has
+ * no binding arrays, so every element is its own binding: element 0 keeps
+ * the Vulkan number and elements 1..count-1 take first_extra onwards.
+ * vkCreateDescriptorSetLayout assigns the same numbers to its entries.
+ */
+typedef struct {
+	uint32_t set;
+	uint32_t binding;
+	uint32_t count;
+	uint32_t first_extra;
+} WgvkWgslBindingRemap;
+
 typedef struct {
 	char *buffer;
 	size_t cursor;
@@ -40,6 +53,13 @@ typedef struct {
 	WgvkSpvModule *module;
 	uint32_t entry_point_id;
 	int exec_model;
+	/* Optional, set after wgvk_wgsl_init. Without a table, extra array
+	 * elements follow the highest binding the module declares in the set. */
+	const WgvkWgslBindingRemap *remaps;
+	uint32_t remap_count;
+	/* Set when the module needs something WGSL cannot express faithfully;
+	 * wgvk_wgsl_generate() then returns NULL rather than a wrong shader. */
+	int failed;
 } WgvkWgslGenerator;
 
 /** Initialise gen for the given module and execution model. Returns 0 on success, -1 on error. */
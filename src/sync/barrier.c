@@ -5,6 +5,7 @@ void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask,
                           uint32_t memoryBarrierCount, const void *pMemoryBarriers,
                           uint32_t bufferMemoryBarrierCount, const void *pBufferMemoryBarriers,
                           uint32_t imageMemoryBarrierCount, const void *pImageMemoryBarriers) {
+	WGVK_STAT_CALL(vkCmdPipelineBarrier);
 	(void)srcStageMask;
 	(void)dstStageMask;
 	(void)dependencyFlags;
@@ -22,6 +23,7 @@ void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask,
 
 void vkCmdMemoryBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask, uint32_t dstStageMask,
                         const void *pMemoryBarrier) {
+	WGVK_STAT_CALL(vkCmdMemoryBarrier);
 	(void)srcStageMask;
 	(void)dstStageMask;
 	(void)pMemoryBarrier;
@@ -33,6 +35,7 @@ void vkCmdMemoryBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask, ui
 
 void vkCmdBufferBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask, uint32_t dstStageMask,
                         const void *pBufferMemoryBarrier) {
+	WGVK_STAT_CALL(vkCmdBufferBarrier);
 	(void)srcStageMask;
 	(void)dstStageMask;
 	(void)pBufferMemoryBarrier;
@@ -44,6 +47,7 @@ void vkCmdBufferBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask, ui
 
 void vkCmdImageBarrier(VkCommandBuffer commandBuffer, uint32_t srcStageMask, uint32_t dstStageMask,
                        const void *pImageMemoryBarrier) {
+	WGVK_STAT_CALL(vkCmdImageBarrier);
 	(void)srcStageMask;
 	(void)dstStageMask;
 	(void)pImageMemoryBarrier;
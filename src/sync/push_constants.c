@@ -24,6 +24,7 @@ void wgvk_push_constants_cleanup(VkDevice device) {
 
 void vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t stageFlags,
                         uint32_t offset, uint32_t size, const void *pValues) {
+	WGVK_STAT_CALL(vkCmdPushConstants);
 	(void)stageFlags;
 	(void)layout;
 
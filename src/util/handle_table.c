@@ -0,0 +1,110 @@
+/**
+ * @file handle_table.c
+ * @brief Generation-checked slot table
+ */
+
+#include "handle_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WGVK_HANDLE_GENERATION_MASK ((1u << WGVK_HANDLE_GENERATION_BITS) - 1)
+
+static WgvkHandleSlot *slot_at(WgvkHandleTable *table, uint32_t index) {
+	WgvkHandleSlot *page = atomic_load_explicit(&table->pages[index / WGVK_HANDLE_PAGE_SLOTS],
+	                                            memory_order_acquire);
+	return page ? &page[index % WGVK_HANDLE_PAGE_SLOTS] : NULL;
+}
+
+static void table_lock(WgvkHandleTable *table) {
+	while (atomic_flag_test_and_set_explicit(&table->lock, memory_order_acquire)) {
+	}
+}
+
+static void table_unlock(WgvkHandleTable *table) {
+	atomic_flag_clear_explicit(&table->lock, memory_order_release);
+}
+
+uint32_t wgvk_handle_alloc(WgvkHandleTable *table, void *value) {
+	WgvkHandleSlot *slot = NULL;
+	uint32_t index = 0;
+
+	table_lock(table);
+	if (table->free_head) {
+		index = table->free_head - 1;
+		slot = slot_at(table, index);
+		table->free_head = slot->next_free;
+	} else if (table->slot_count < (1u << WGVK_HANDLE_INDEX_BITS)) {
+		index = table->slot_count;
+		uint32_t page = index / WGVK_HANDLE_PAGE_SLOTS;
+		if (!table->pages[page]) {
+			WgvkHandleSlot *slots = calloc(WGVK_HANDLE_PAGE_SLOTS, sizeof(WgvkHandleSlot));
+			atomic_store_explicit(&table->pages[page], slots, memory_order_release);
+		}
+		slot = slot_at(table, index);
+		if (slot) {
+			table->slot_count++;
+			atomic_store_explicit(&slot->generation, 1, memory_order_relaxed);
+		}
+	}
+	if (!slot) {
+		table_unlock(table);
+		return 0;
+	}
+
+	atomic_store_explicit(&slot->value, value, memory_order_release);
+	uint32_t generation = atomic_load_explicit(&slot->generation, memory_order_relaxed);
+	table->live++;
+	table_unlock(table);
+	return (generation << WGVK_HANDLE_INDEX_BITS) | index;
+}
+
+void *wgvk_handle_lookup(WgvkHandleTable *table, uint32_t handle) {
+	if (!handle) {
+		return NULL;
+	}
+	WgvkHandleSlot *slot = slot_at(table, wgvk_handle_index(handle));
+	if (!slot) {
+		return NULL;
+	}
+	void *value = atomic_load_explicit(&slot->value, memory_order_acquire);
+	// Checked after the load, so a concurrent free makes this fail rather
+	// than hand back the slot's next occupant
+	if (atomic_load_explicit(&slot->generation, memory_order_acquire) !=
+	    handle >> WGVK_HANDLE_INDEX_BITS) {
+		return NULL;
+	}
+	return value;
+}
+
+int wgvk_handle_free(WgvkHandleTable *table, uint32_t handle) {
+	uint32_t index = wgvk_handle_index(handle);
+
+	table_lock(table);
+	WgvkHandleSlot *slot = handle ? slot_at(table, index) : NULL;
+	uint32_t generation = handle >> WGVK_HANDLE_INDEX_BITS;
+	if (!slot || atomic_load_explicit(&slot->generation, memory_order_relaxed) != generation) {
+		table_unlock(table);
+		return 0;
+	}
+
+	generation = (generation + 1) & WGVK_HANDLE_GENERATION_MASK;
+	atomic_store_explicit(&slot->generation, generation ? generation : 1, memory_order_release);
+	atomic_store_explicit(&slot->value, NULL, memory_order_relaxed);
+	slot->next_free = table->free_head;
+	table->free_head = index + 1;
+	table->live--;
+	table_unlock(table);
+	return 1;
+}
+
+void wgvk_handle_table_destroy(WgvkHandleTable *table) {
+	table_lock(table);
+	for (uint32_t i = 0; i < WGVK_HANDLE_MAX_PAGES; i++) {
+		free(atomic_load_explicit(&table->pages[i], memory_order_relaxed));
+		atomic_store_explicit(&table->pages[i], NULL, memory_order_relaxed);
+	}
+	table->slot_count = 0;
+	table->free_head = 0;
+	table->live = 0;
+	table_unlock(table);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file handle_table.h
+ * @brief Dense slot table addressed by generation-checked 32-bit handles
+ */
+
+#ifndef WGVK_HANDLE_TABLE_H
+#define WGVK_HANDLE_TABLE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A handle keeps the slot index in its low bits and the slot's generation in
+ * the high bits. Freeing a slot bumps its generation, so handles to the old
+ * occupant stop resolving. Generation 0 is never used, which keeps 0 free to
+ * mean no handle. */
+#define WGVK_HANDLE_INDEX_BITS 20
+#define WGVK_HANDLE_GENERATION_BITS (32 - WGVK_HANDLE_INDEX_BITS)
+#define WGVK_HANDLE_PAGE_SLOTS 1024
+#define WGVK_HANDLE_MAX_PAGES ((1u << WGVK_HANDLE_INDEX_BITS) / WGVK_HANDLE_PAGE_SLOTS)
+
+typedef struct WgvkHandleSlot {
+	void *_Atomic value;
+	atomic_uint generation;
+	uint32_t next_free;
+} WgvkHandleSlot;
+
+/* Zero-initialized tables are empty and ready to use. Slots live in pages
+ * that never move, so lookups take no lock; alloc and free serialize on a
+ * spinlock. */
+typedef struct WgvkHandleTable {
+	WgvkHandleSlot *_Atomic pages[WGVK_HANDLE_MAX_PAGES];
+	atomic_flag lock;
+	uint32_t slot_count;
+	uint32_t free_head; /* index + 1 of the first free slot, 0 when none */
+	uint32_t live;
+} WgvkHandleTable;
+
+/**
+ * Store @p value in a free slot. Returns its handle, or 0 when the table is
+ * full or out of memory.
+ */
+uint32_t wgvk_handle_alloc(WgvkHandleTable *table, void *value);
+
+/**
+ * The value stored under @p handle, or NULL when the handle is 0, out of
+ * range or refers to a slot that has since been freed.
+ */
+void *wgvk_handle_lookup(WgvkHandleTable *table, uint32_t handle);
+
+/**
+ * Free the slot of @p handle. Returns 0 when the handle is already stale.
+ */
+int wgvk_handle_free(WgvkHandleTable *table, uint32_t handle);
+
+/**
+ * Release every page. Outstanding handles become invalid.
+ */
+void wgvk_handle_table_destroy(WgvkHandleTable *table);
+
+static inline uint32_t wgvk_handle_index(uint32_t handle) {
+	return handle & ((1u << WGVK_HANDLE_INDEX_BITS) - 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
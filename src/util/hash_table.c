@@ -1,183 +1,415 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include "hash_table.h"
 
-/* Open-addressing hash table with linear probing and tombstone deletion.
+/* Open-addressing hash table in the style of Abseil's Swiss tables.
  *
- * Keys are pointer-sized values mapped to pointer-sized values.  The table
- * uses two sentinel bucket states:
- *   bucket->key == NULL  → empty (never occupied)
- *   bucket->key == TOMBSTONE → deleted (was occupied, now available for reuse)
+ * Every slot has a control byte:
+ *   0x00..0x7f → full; the low 7 bits of the entry's hash (h2)
+ *   WGVK_HT_EMPTY → never occupied, ends a probe
+ *   WGVK_HT_DELETED → tombstone, skipped by lookups and reused by inserts
  *
- * The load factor is kept below 0.75; the table never shrinks.
+ * Probing visits groups of 16 control bytes and compares all of them against
+ * h2 at once (SSE2, WASM SIMD with -msimd128, or a scalar loop), so slots
+ * are only touched for likely matches. The high bits of the hash (h1) pick
+ * the first group; later groups follow a triangular sequence, which visits
+ * every group of a power-of-two table. The control array repeats its first
+ * group after the end so a group read never wraps.
+ *
+ * The load factor is kept at or below 7/8, counting tombstones. When an
+ * insert would pass it, the table is rebuilt: at the same capacity if half
+ * the budget is tombstones, otherwise at twice the capacity.
  */
 
-#define WGVK_HT_TOMBSTONE ((void *)(uintptr_t)1)
-#define WGVK_HT_MAX_LOAD_NUM 3 /* max load = 3/4 */
-#define WGVK_HT_MAX_LOAD_DEN 4
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WGVK_HT_SSE2 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define WGVK_HT_WASM_SIMD 1
+#endif
+
+#define WGVK_HT_GROUP 16
+#define WGVK_HT_EMPTY ((int8_t)-128)
+#define WGVK_HT_DELETED ((int8_t)-2)
+/* key_size of pointer-keyed entries, which compare the key pointer itself */
+#define WGVK_HT_POINTER_KEY ((size_t)-1)
 
 typedef struct {
-	void *key;
+	uint64_t hash;
+	const void *key;
+	size_t key_size;
 	void *value;
-} WgvkHashBucket;
-
-typedef struct WgvkHashTable {
-	WgvkHashBucket *buckets;
-	size_t bucket_count;
-	size_t size;     /* live entries */
-	size_t occupied; /* live + tombstone entries (used for load check) */
-} WgvkHashTable;
-
-static size_t hash_ptr(void *key, size_t bucket_count) {
-	size_t k = (size_t)key;
-	if (sizeof(size_t) >= 8) {
-		k ^= k >> 33;
-		k *= (size_t)0xff51afd7ed558ccdULL;
-		k ^= k >> 33;
-		k *= (size_t)0xc4ceb9fe1a85ec53ULL;
-		k ^= k >> 33;
+} WgvkHashSlot;
+
+struct WgvkHashTable {
+	WgvkHashSlot *slots;
+	int8_t *ctrl;    /* capacity + WGVK_HT_GROUP bytes, allocated with slots */
+	size_t capacity; /* power of two, at least WGVK_HT_GROUP */
+	size_t size;
+	size_t growth_left; /* inserts into empty slots before a rebuild */
+};
+
+/* ---- wyhash (final version 4, public domain) ---- */
+
+static const uint64_t wy_secret[4] = {
+    0x2d358dccaa6c78a5ULL,
+    0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL,
+};
+
+static inline void wy_mum(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 wy_u128;
+	wy_u128 r = (wy_u128)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), carry = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	carry += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+	wy_mum(&a, &b);
+	return a ^ b;
+}
+
+static inline uint64_t wy_r8(const uint8_t *p) {
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return v;
+}
+
+static inline uint64_t wy_r4(const uint8_t *p) {
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static inline uint64_t wy_r3(const uint8_t *p, size_t k) {
+	return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+uint64_t wgvk_hash_bytes(const void *data, size_t size) {
+	const uint8_t *p = data;
+	uint64_t seed = wy_mix(wy_secret[0], wy_secret[1]);
+	uint64_t a, b;
+
+	if (size <= 16) {
+		if (size >= 4) {
+			a = (wy_r4(p) << 32) | wy_r4(p + ((size >> 3) << 2));
+			b = (wy_r4(p + size - 4) << 32) | wy_r4(p + size - 4 - ((size >> 3) << 2));
+		} else if (size > 0) {
+			a = wy_r3(p, size);
+			b = 0;
+		} else {
+			a = b = 0;
+		}
 	} else {
-		k ^= k >> 16;
-		k *= 0x45d9f3bU;
-		k ^= k >> 16;
+		size_t i = size;
+		if (i >= 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+				see1 = wy_mix(wy_r8(p + 16) ^ wy_secret[2], wy_r8(p + 24) ^ see1);
+				see2 = wy_mix(wy_r8(p + 32) ^ wy_secret[3], wy_r8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i >= 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wy_r8(p + i - 16);
+		b = wy_r8(p + i - 8);
 	}
-	return k % bucket_count;
+	a ^= wy_secret[1];
+	b ^= seed;
+	wy_mum(&a, &b);
+	return wy_mix(a ^ wy_secret[0] ^ size, b ^ wy_secret[1]);
 }
 
-WgvkHashTable *wgvk_hash_table_create(size_t bucket_count) {
-	/* Ensure bucket_count is at least 8 and a power of two for simplicity */
-	if (bucket_count < 8)
-		bucket_count = 8;
+static inline uint64_t hash_pointer(const void *key) {
+	return wy_mix((uint64_t)(uintptr_t)key ^ wy_secret[0], wy_secret[1]);
+}
 
-	WgvkHashTable *table = malloc(sizeof(WgvkHashTable));
-	if (!table)
-		return NULL;
+/* ---- Group matching: one bit per control byte of the group ---- */
 
-	table->buckets = calloc(bucket_count, sizeof(WgvkHashBucket));
-	if (!table->buckets) {
-		free(table);
-		return NULL;
+static inline uint32_t group_match(const int8_t *ctrl, int8_t h2) {
+#if defined(WGVK_HT_SSE2)
+	__m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#elif defined(WGVK_HT_WASM_SIMD)
+	v128_t group = wasm_v128_load(ctrl);
+	return (uint32_t)wasm_i8x16_bitmask(wasm_i8x16_eq(group, wasm_i8x16_splat(h2)));
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < WGVK_HT_GROUP; i++) {
+		mask |= (uint32_t)(ctrl[i] == h2) << i;
 	}
+	return mask;
+#endif
+}
 
-	table->bucket_count = bucket_count;
-	table->size = 0;
-	table->occupied = 0;
+/* Empty or deleted slots: the only control bytes with the sign bit set. */
+static inline uint32_t group_match_free(const int8_t *ctrl) {
+#if defined(WGVK_HT_SSE2)
+	return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#elif defined(WGVK_HT_WASM_SIMD)
+	return (uint32_t)wasm_i8x16_bitmask(wasm_v128_load(ctrl));
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < WGVK_HT_GROUP; i++) {
+		mask |= (uint32_t)(ctrl[i] < 0) << i;
+	}
+	return mask;
+#endif
+}
 
-	return table;
+static inline uint32_t lowest_bit(uint32_t mask) {
+	return (uint32_t)__builtin_ctz(mask);
 }
 
-void wgvk_hash_table_destroy(WgvkHashTable *table) {
-	if (table) {
-		free(table->buckets);
-		free(table);
+static inline int8_t hash_h2(uint64_t hash) {
+	return (int8_t)(hash & 0x7f);
+}
+
+static inline size_t hash_h1(uint64_t hash) {
+	return (size_t)(hash >> 7);
+}
+
+static size_t max_load(size_t capacity) {
+	return capacity - capacity / 8;
+}
+
+static void set_ctrl(WgvkHashTable *table, size_t index, int8_t value) {
+	table->ctrl[index] = value;
+	if (index < WGVK_HT_GROUP) {
+		table->ctrl[table->capacity + index] = value;
 	}
 }
 
-/* Grow the table to 2× its current capacity, rehashing all live entries. */
-static int hash_table_grow(WgvkHashTable *table) {
-	size_t new_count = table->bucket_count * 2;
-	WgvkHashBucket *new_buckets = calloc(new_count, sizeof(WgvkHashBucket));
-	if (!new_buckets)
-		return -1;
+static int slot_matches(const WgvkHashSlot *slot, uint64_t hash, const void *key, size_t key_size) {
+	if (slot->hash != hash || slot->key_size != key_size) {
+		return 0;
+	}
+	if (key_size == WGVK_HT_POINTER_KEY) {
+		return slot->key == key;
+	}
+	return slot->key == key || memcmp(slot->key, key, key_size) == 0;
+}
 
-	for (size_t i = 0; i < table->bucket_count; i++) {
-		void *k = table->buckets[i].key;
-		if (k == NULL || k == WGVK_HT_TOMBSTONE)
-			continue;
+/* Index of the matching slot, or (size_t)-1. */
+static size_t find_index(const WgvkHashTable *table, uint64_t hash, const void *key,
+                         size_t key_size) {
+	size_t mask = table->capacity - 1;
+	size_t pos = hash_h1(hash) & mask;
+	int8_t h2 = hash_h2(hash);
+
+	for (size_t step = WGVK_HT_GROUP;; step += WGVK_HT_GROUP) {
+		const int8_t *group = table->ctrl + pos;
+		for (uint32_t match = group_match(group, h2); match; match &= match - 1) {
+			size_t index = (pos + lowest_bit(match)) & mask;
+			if (slot_matches(&table->slots[index], hash, key, key_size)) {
+				return index;
+			}
+		}
+		if (group_match(group, WGVK_HT_EMPTY)) {
+			return (size_t)-1;
+		}
+		pos = (pos + step) & mask;
+	}
+}
+
+/* First empty or deleted slot on the probe sequence of hash. */
+static size_t find_free(const WgvkHashTable *table, uint64_t hash) {
+	size_t mask = table->capacity - 1;
+	size_t pos = hash_h1(hash) & mask;
 
-		size_t idx = hash_ptr(k, new_count);
-		while (new_buckets[idx].key != NULL) {
-			idx = (idx + 1) % new_count;
+	for (size_t step = WGVK_HT_GROUP;; step += WGVK_HT_GROUP) {
+		uint32_t match = group_match_free(table->ctrl + pos);
+		if (match) {
+			return (pos + lowest_bit(match)) & mask;
 		}
-		new_buckets[idx].key = k;
-		new_buckets[idx].value = table->buckets[i].value;
+		pos = (pos + step) & mask;
 	}
+}
 
-	free(table->buckets);
-	table->buckets = new_buckets;
-	table->bucket_count = new_count;
-	table->occupied = table->size; /* tombstones gone after rehash */
+static int table_alloc(WgvkHashTable *table, size_t capacity) {
+	size_t slots_size = capacity * sizeof(WgvkHashSlot);
+	WgvkHashSlot *slots = malloc(slots_size + capacity + WGVK_HT_GROUP);
+	if (!slots) {
+		return -1;
+	}
+	table->slots = slots;
+	table->ctrl = (int8_t *)((uint8_t *)slots + slots_size);
+	memset(table->ctrl, WGVK_HT_EMPTY, capacity + WGVK_HT_GROUP);
+	table->capacity = capacity;
+	table->size = 0;
+	table->growth_left = max_load(capacity);
 	return 0;
 }
 
-void wgvk_hash_table_insert(WgvkHashTable *table, void *key, void *value) {
-	if (!table || !key || key == WGVK_HT_TOMBSTONE)
-		return;
+static int table_rehash(WgvkHashTable *table, size_t capacity) {
+	WgvkHashTable old = *table;
+	if (table_alloc(table, capacity) != 0) {
+		*table = old;
+		return -1;
+	}
+	for (size_t i = 0; i < old.capacity; i++) {
+		if (old.ctrl[i] < 0) {
+			continue;
+		}
+		size_t index = find_free(table, old.slots[i].hash);
+		set_ctrl(table, index, old.ctrl[i]);
+		table->slots[index] = old.slots[i];
+	}
+	table->size = old.size;
+	table->growth_left -= old.size;
+	free(old.slots);
+	return 0;
+}
 
-	/* Grow before inserting if load is too high. */
-	if (table->occupied * WGVK_HT_MAX_LOAD_DEN >= table->bucket_count * WGVK_HT_MAX_LOAD_NUM) {
-		if (hash_table_grow(table) != 0)
-			return; /* OOM — drop insert */
+WgvkHashTable *wgvk_hash_table_create(size_t capacity) {
+	size_t buckets = WGVK_HT_GROUP;
+	while (max_load(buckets) < capacity) {
+		buckets *= 2;
 	}
 
-	size_t idx = hash_ptr(key, table->bucket_count);
-	size_t first_tombstone = (size_t)-1;
+	WgvkHashTable *table = malloc(sizeof(WgvkHashTable));
+	if (!table) {
+		return NULL;
+	}
+	if (table_alloc(table, buckets) != 0) {
+		free(table);
+		return NULL;
+	}
+	return table;
+}
+
+void wgvk_hash_table_destroy(WgvkHashTable *table) {
+	if (table) {
+		free(table->slots);
+		free(table);
+	}
+}
+
+size_t wgvk_hash_table_size(const WgvkHashTable *table) {
+	return table ? table->size : 0;
+}
 
-	for (size_t i = 0; i < table->bucket_count; i++) {
-		void *k = table->buckets[idx].key;
+static int insert_slot(WgvkHashTable *table, uint64_t hash, const void *key, size_t key_size,
+                       void *value) {
+	size_t index = find_index(table, hash, key, key_size);
+	if (index != (size_t)-1) {
+		table->slots[index].key = key;
+		table->slots[index].value = value;
+		return 0;
+	}
 
-		if (k == NULL) {
-			/* Empty slot — use tombstone slot if found earlier, else this one */
-			size_t dest = (first_tombstone != (size_t)-1) ? first_tombstone : idx;
-			if (first_tombstone == (size_t)-1)
-				table->occupied++;
-			table->buckets[dest].key = key;
-			table->buckets[dest].value = value;
-			table->size++;
-			return;
+	index = find_free(table, hash);
+	if (table->ctrl[index] == WGVK_HT_EMPTY && table->growth_left == 0) {
+		/* Out of budget: drop the tombstones, growing unless they made up
+		 * half of it */
+		size_t capacity = table->capacity;
+		if (table->size * 2 > max_load(capacity)) {
+			capacity *= 2;
 		}
-		if (k == WGVK_HT_TOMBSTONE) {
-			if (first_tombstone == (size_t)-1)
-				first_tombstone = idx;
-		} else if (k == key) {
-			table->buckets[idx].value = value;
-			return;
+		if (table_rehash(table, capacity) != 0) {
+			return -1;
 		}
+		index = find_free(table, hash);
+	}
 
-		idx = (idx + 1) % table->bucket_count;
+	if (table->ctrl[index] == WGVK_HT_EMPTY) {
+		table->growth_left--;
 	}
+	set_ctrl(table, index, hash_h2(hash));
+	table->slots[index] = (WgvkHashSlot){hash, key, key_size, value};
+	table->size++;
+	return 0;
+}
 
-	/* Table is full of tombstones but we found one earlier — reuse it. */
-	if (first_tombstone != (size_t)-1) {
-		table->buckets[first_tombstone].key = key;
-		table->buckets[first_tombstone].value = value;
-		table->size++;
+static void *erase_slot(WgvkHashTable *table, uint64_t hash, const void *key, size_t key_size) {
+	size_t index = find_index(table, hash, key, key_size);
+	if (index == (size_t)-1) {
+		return NULL;
+	}
+	void *value = table->slots[index].value;
+
+	/* A slot can go straight back to empty when its group window has never
+	 * been full: no probe can have passed over it then. */
+	size_t mask = table->capacity - 1;
+	size_t before = (index - WGVK_HT_GROUP) & mask;
+	uint32_t empty_after = group_match(table->ctrl + index, WGVK_HT_EMPTY);
+	uint32_t empty_before = group_match(table->ctrl + before, WGVK_HT_EMPTY);
+	int was_never_full = empty_before && empty_after &&
+	                     (uint32_t)__builtin_ctz(empty_after) +
+	                             (uint32_t)__builtin_clz(empty_before << 16 | 0xffffu) <
+	                         WGVK_HT_GROUP;
+	if (was_never_full) {
+		set_ctrl(table, index, WGVK_HT_EMPTY);
+		table->growth_left++;
+	} else {
+		set_ctrl(table, index, WGVK_HT_DELETED);
+	}
+	table->size--;
+	return value;
+}
+
+int wgvk_hash_table_insert_key(WgvkHashTable *table, uint64_t hash, const void *key,
+                               size_t key_size, void *value) {
+	if (!table) {
+		return -1;
 	}
+	return insert_slot(table, hash, key, key_size, value);
 }
 
-void *wgvk_hash_table_lookup(WgvkHashTable *table, void *key) {
-	if (!table || !key || key == WGVK_HT_TOMBSTONE)
+void *wgvk_hash_table_find(const WgvkHashTable *table, uint64_t hash, const void *key,
+                           size_t key_size) {
+	if (!table) {
 		return NULL;
+	}
+	size_t index = find_index(table, hash, key, key_size);
+	return index == (size_t)-1 ? NULL : table->slots[index].value;
+}
+
+void *wgvk_hash_table_erase(WgvkHashTable *table, uint64_t hash, const void *key,
+                            size_t key_size) {
+	if (!table) {
+		return NULL;
+	}
+	return erase_slot(table, hash, key, key_size);
+}
 
-	size_t idx = hash_ptr(key, table->bucket_count);
+int wgvk_hash_table_insert(WgvkHashTable *table, void *key, void *value) {
+	if (!table) {
+		return -1;
+	}
+	return insert_slot(table, hash_pointer(key), key, WGVK_HT_POINTER_KEY, value);
+}
 
-	for (size_t i = 0; i < table->bucket_count; i++) {
-		void *k = table->buckets[idx].key;
-		if (k == NULL)
-			return NULL; /* empty → key not present */
-		if (k == key)
-			return table->buckets[idx].value;
-		idx = (idx + 1) % table->bucket_count;
+void *wgvk_hash_table_lookup(const WgvkHashTable *table, void *key) {
+	if (!table) {
+		return NULL;
 	}
-	return NULL;
+	size_t index = find_index(table, hash_pointer(key), key, WGVK_HT_POINTER_KEY);
+	return index == (size_t)-1 ? NULL : table->slots[index].value;
 }
 
 void wgvk_hash_table_remove(WgvkHashTable *table, void *key) {
-	if (!table || !key || key == WGVK_HT_TOMBSTONE)
-		return;
-
-	size_t idx = hash_ptr(key, table->bucket_count);
-
-	for (size_t i = 0; i < table->bucket_count; i++) {
-		void *k = table->buckets[idx].key;
-		if (k == NULL)
-			return; /* not found */
-		if (k == key) {
-			table->buckets[idx].key = WGVK_HT_TOMBSTONE;
-			table->buckets[idx].value = NULL;
-			table->size--;
-			return;
-		}
-		idx = (idx + 1) % table->bucket_count;
+	if (table) {
+		erase_slot(table, hash_pointer(key), key, WGVK_HT_POINTER_KEY);
 	}
 }
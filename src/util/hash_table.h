@@ -0,0 +1,72 @@
+/**
+ * @file hash_table.h
+ * @brief Open-addressing hash table with SIMD-probed control bytes
+ */
+
+#ifndef WGVK_HASH_TABLE_H
+#define WGVK_HASH_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WgvkHashTable WgvkHashTable;
+
+/**
+ * 64-bit wyhash of @p size bytes. Fast on the short descriptor blobs the
+ * caches key on, and well mixed in every bit.
+ */
+uint64_t wgvk_hash_bytes(const void *data, size_t size);
+
+/**
+ * Create a table with room for at least @p capacity entries before it
+ * grows. Returns NULL on OOM.
+ */
+WgvkHashTable *wgvk_hash_table_create(size_t capacity);
+
+void wgvk_hash_table_destroy(WgvkHashTable *table);
+
+/**
+ * Number of live entries.
+ */
+size_t wgvk_hash_table_size(const WgvkHashTable *table);
+
+/**
+ * Insert or replace the entry for a byte-string key. The table keeps only
+ * the @p key pointer, so the key must stay valid while the entry exists;
+ * callers usually store it inside @p value. Replacing also takes the new
+ * key pointer. @p hash must be wgvk_hash_bytes(key, key_size) or another
+ * function of the key bytes alone. Returns 0, or -1 when growing fails.
+ */
+int wgvk_hash_table_insert_key(WgvkHashTable *table, uint64_t hash, const void *key,
+                               size_t key_size, void *value);
+
+void *wgvk_hash_table_find(const WgvkHashTable *table, uint64_t hash, const void *key,
+                           size_t key_size);
+
+/**
+ * Remove the entry for a byte-string key. Returns its value, or NULL when
+ * there was none.
+ */
+void *wgvk_hash_table_erase(WgvkHashTable *table, uint64_t hash, const void *key,
+                            size_t key_size);
+
+/**
+ * Pointer-keyed shorthands: the key is the pointer value itself, compared
+ * by identity. Any pointer, including NULL, is a valid key. Insert returns
+ * 0, or -1 when growing fails.
+ */
+int wgvk_hash_table_insert(WgvkHashTable *table, void *key, void *value);
+
+void *wgvk_hash_table_lookup(const WgvkHashTable *table, void *key);
+
+void wgvk_hash_table_remove(WgvkHashTable *table, void *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WGVK_HASH_TABLE_H */
@@ -0,0 +1,94 @@
+/**
+ * @file list.h
+ * @brief Intrusive doubly-linked list
+ */
+
+#ifndef WGVK_LIST_H
+#define WGVK_LIST_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The struct of type @p type whose @p member is at @p ptr. */
+#define WGVK_CONTAINER_OF(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+
+/* Embedded in each element. A link belongs to at most one list at a time. */
+typedef struct WgvkListLink {
+	struct WgvkListLink *prev;
+	struct WgvkListLink *next;
+} WgvkListLink;
+
+/* Circular list around a sentinel link; nothing is ever allocated. Must be
+ * initialized with wgvk_list_init, and cannot be copied once non-empty. */
+typedef struct WgvkList {
+	WgvkListLink sentinel;
+	size_t size;
+} WgvkList;
+
+static inline void wgvk_list_init(WgvkList *list) {
+	list->sentinel.prev = &list->sentinel;
+	list->sentinel.next = &list->sentinel;
+	list->size = 0;
+}
+
+static inline int wgvk_list_empty(const WgvkList *list) {
+	return list->sentinel.next == &list->sentinel;
+}
+
+static inline size_t wgvk_list_size(const WgvkList *list) {
+	return list->size;
+}
+
+/* Link @p link in right after @p pos, which is in @p list or its sentinel. */
+static inline void wgvk_list_insert_after(WgvkList *list, WgvkListLink *pos, WgvkListLink *link) {
+	link->prev = pos;
+	link->next = pos->next;
+	pos->next->prev = link;
+	pos->next = link;
+	list->size++;
+}
+
+static inline void wgvk_list_push_front(WgvkList *list, WgvkListLink *link) {
+	wgvk_list_insert_after(list, &list->sentinel, link);
+}
+
+static inline void wgvk_list_push_back(WgvkList *list, WgvkListLink *link) {
+	wgvk_list_insert_after(list, list->sentinel.prev, link);
+}
+
+static inline void wgvk_list_remove(WgvkList *list, WgvkListLink *link) {
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+	link->prev = link->next = NULL;
+	list->size--;
+}
+
+static inline WgvkListLink *wgvk_list_front(const WgvkList *list) {
+	return wgvk_list_empty(list) ? NULL : list->sentinel.next;
+}
+
+static inline WgvkListLink *wgvk_list_back(const WgvkList *list) {
+	return wgvk_list_empty(list) ? NULL : list->sentinel.prev;
+}
+
+static inline WgvkListLink *wgvk_list_pop_front(WgvkList *list) {
+	WgvkListLink *link = wgvk_list_front(list);
+	if (link) {
+		wgvk_list_remove(list, link);
+	}
+	return link;
+}
+
+/* Iterate links front to back; @p link may be removed from the body. */
+#define WGVK_LIST_FOREACH(list, link, tmp) \
+	for (WgvkListLink *link = (list)->sentinel.next, *tmp = link->next; \
+	     link != &(list)->sentinel; link = tmp, tmp = link->next)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WGVK_LIST_H */
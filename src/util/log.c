@@ -4,10 +4,16 @@
  */
 
 #include "log.h"
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+/* Queued messages; a power of two so positions wrap with a mask. */
+#define WGVK_LOG_RING_SIZE 256
+#define WGVK_LOG_RECORD_SIZE 256
+
 static struct {
 	WgvkLogLevel level;
 	int category_enabled[WGVK_LOG_CAT_MAX];
@@ -16,11 +22,47 @@ static struct {
 	int initialized;
 } g_log = {.level = WGVK_LOG_INFO, .callback = NULL, .callback_user_data = NULL, .initialized = 0};
 
+/* Everything below INFO passes until configured otherwise. */
+unsigned char wgvk_log_thresholds[WGVK_LOG_CAT_MAX + 1] = {
+    WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1,
+    WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1, WGVK_LOG_INFO + 1,
+};
+
+/* One queued message. sequence says whose turn the slot is: equal to a
+ * producer's position when free, one past it once written. */
+typedef struct {
+	atomic_uint sequence;
+	WgvkLogLevel level;
+	WgvkLogCategory category;
+	const char *file;
+	int line;
+	const char *func;
+	time_t time;
+	char message[WGVK_LOG_RECORD_SIZE];
+} WgvkLogRecord;
+
+/* Bounded multi-producer ring; wgvk_log_flush() is the only consumer. */
+static struct {
+	WgvkLogRecord records[WGVK_LOG_RING_SIZE];
+	atomic_uint head;
+	unsigned tail;
+	atomic_uint dropped;
+	atomic_flag draining;
+	atomic_int enabled;
+} g_ring = {.draining = ATOMIC_FLAG_INIT};
+
 static const char *level_strings[] = {"ERROR", "WARN", "INFO", "DEBUG", "TRACE"};
 
 static const char *category_strings[] = {"general",  "core",    "memory", "shader",
                                          "pipeline", "command", "sync"};
 
+static void update_thresholds(void) {
+	for (int i = 0; i < WGVK_LOG_CAT_MAX; i++) {
+		wgvk_log_thresholds[i] = g_log.category_enabled[i] ? (unsigned char)(g_log.level + 1) : 0;
+	}
+	wgvk_log_thresholds[WGVK_LOG_CAT_MAX] = (unsigned char)(g_log.level + 1);
+}
+
 void wgvk_log_init(void) {
 	if (g_log.initialized) {
 		return;
@@ -35,6 +77,7 @@ void wgvk_log_init(void) {
 	}
 
 	g_log.initialized = 1;
+	update_thresholds();
 }
 
 void wgvk_log_set_level(WgvkLogLevel level) {
@@ -42,6 +85,7 @@ void wgvk_log_set_level(WgvkLogLevel level) {
 		wgvk_log_init();
 	}
 	g_log.level = level;
+	update_thresholds();
 }
 
 WgvkLogLevel wgvk_log_get_level(void) {
@@ -55,6 +99,7 @@ void wgvk_log_set_category_enabled(WgvkLogCategory category, int enabled) {
 	if (category >= 0 && category < WGVK_LOG_CAT_MAX) {
 		g_log.category_enabled[category] = enabled ? 1 : 0;
 	}
+	update_thresholds();
 }
 
 int wgvk_log_is_category_enabled(WgvkLogCategory category) {
@@ -72,20 +117,126 @@ void wgvk_log_set_callback(WgvkLogCallback callback, void *user_data) {
 	g_log.callback_user_data = user_data;
 }
 
-void wgvk_log_message_v(WgvkLogLevel level, WgvkLogCategory category, const char *file, int line,
-                        const char *func, const char *fmt, va_list args) {
+static void write_message(WgvkLogLevel level, WgvkLogCategory category, const char *file,
+                          int line, const char *func, time_t now, const char *message) {
+	if (g_log.callback) {
+		g_log.callback(level, category, message, g_log.callback_user_data);
+		return;
+	}
+
+	struct tm *tm_info = localtime(&now);
+	char time_buf[32];
+	strftime(time_buf, sizeof(time_buf), "%H:%M:%S", tm_info);
+
+	const char *filename = strrchr(file, '/');
+	filename = filename ? filename + 1 : file;
+
+	fprintf(stderr, "[%s] [%-5s] [%-8s] %s (%s:%d in %s)\n", time_buf, wgvk_log_level_string(level),
+	        wgvk_log_category_string(category), message, filename, line, func);
+	fflush(stderr);
+}
+
+/* Claim the next free slot, or return NULL when the ring is full. */
+static WgvkLogRecord *ring_reserve(unsigned *position) {
+	unsigned pos = atomic_load_explicit(&g_ring.head, memory_order_relaxed);
+	for (;;) {
+		WgvkLogRecord *record = &g_ring.records[pos & (WGVK_LOG_RING_SIZE - 1)];
+		unsigned sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+		int diff = (int)(sequence - pos);
+		if (diff == 0) {
+			if (atomic_compare_exchange_weak_explicit(&g_ring.head, &pos, pos + 1,
+			                                          memory_order_relaxed,
+			                                          memory_order_relaxed)) {
+				*position = pos;
+				return record;
+			}
+		} else if (diff < 0) {
+			return NULL;
+		} else {
+			pos = atomic_load_explicit(&g_ring.head, memory_order_relaxed);
+		}
+	}
+}
+
+void wgvk_log_set_async(int enabled) {
 	if (!g_log.initialized) {
 		wgvk_log_init();
 	}
+	if (atomic_load(&g_ring.enabled) == (enabled != 0)) {
+		return;
+	}
+	if (enabled) {
+		for (unsigned i = 0; i < WGVK_LOG_RING_SIZE; i++) {
+			atomic_store_explicit(&g_ring.records[i].sequence, i, memory_order_relaxed);
+		}
+		atomic_store_explicit(&g_ring.head, 0, memory_order_relaxed);
+		g_ring.tail = 0;
+		atomic_store(&g_ring.enabled, 1);
 
-	if (level > g_log.level) {
+		static int registered;
+		if (!registered) {
+			atexit(wgvk_log_flush);
+			registered = 1;
+		}
+	} else {
+		atomic_store(&g_ring.enabled, 0);
+		wgvk_log_flush();
+	}
+}
+
+void wgvk_log_flush(void) {
+	// A flush already under way on another thread will pick these up
+	if (atomic_flag_test_and_set_explicit(&g_ring.draining, memory_order_acquire)) {
 		return;
 	}
 
-	if (category >= 0 && category < WGVK_LOG_CAT_MAX) {
-		if (!g_log.category_enabled[category]) {
+	unsigned pos = g_ring.tail;
+	for (;;) {
+		WgvkLogRecord *record = &g_ring.records[pos & (WGVK_LOG_RING_SIZE - 1)];
+		unsigned sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+		if ((int)(sequence - (pos + 1)) < 0) {
+			break;
+		}
+		write_message(record->level, record->category, record->file, record->line, record->func,
+		              record->time, record->message);
+		atomic_store_explicit(&record->sequence, pos + WGVK_LOG_RING_SIZE, memory_order_release);
+		pos++;
+	}
+	g_ring.tail = pos;
+
+	unsigned dropped = atomic_exchange_explicit(&g_ring.dropped, 0, memory_order_relaxed);
+	if (dropped) {
+		char message[64];
+		snprintf(message, sizeof(message), "%u log messages dropped, ring buffer full", dropped);
+		write_message(WGVK_LOG_WARN, WGVK_LOG_CAT_GENERAL, __FILE__, __LINE__, __func__, time(NULL),
+		              message);
+	}
+	atomic_flag_clear_explicit(&g_ring.draining, memory_order_release);
+}
+
+void wgvk_log_message_v(WgvkLogLevel level, WgvkLogCategory category, const char *file, int line,
+                        const char *func, const char *fmt, va_list args) {
+	if (!wgvk_log_enabled(level, category)) {
+		return;
+	}
+
+	if (atomic_load_explicit(&g_ring.enabled, memory_order_relaxed) && level != WGVK_LOG_ERROR) {
+		unsigned pos;
+		WgvkLogRecord *record = ring_reserve(&pos);
+		if (!record) {
+			atomic_fetch_add_explicit(&g_ring.dropped, 1, memory_order_relaxed);
 			return;
 		}
+		// Long messages are truncated to the record size
+		vsnprintf(record->message, sizeof(record->message), fmt, args);
+		record->level = level;
+		record->category = category;
+		record->file = file;
+		record->line = line;
+		record->func = func;
+		record->time = time(NULL);
+		atomic_store_explicit(&record->sequence, pos + 1, memory_order_release);
+		return;
 	}
 
 	char message[4096];
@@ -94,22 +245,11 @@ void wgvk_log_message_v(WgvkLogLevel level, WgvkLogCategory category, const char
 		message[sizeof(message) - 1] = '\0';
 	}
 
-	if (g_log.callback) {
-		g_log.callback(level, category, message, g_log.callback_user_data);
-		return;
+	// Errors keep their place after anything already queued
+	if (atomic_load_explicit(&g_ring.enabled, memory_order_relaxed)) {
+		wgvk_log_flush();
 	}
-
-	time_t now = time(NULL);
-	struct tm *tm_info = localtime(&now);
-	char time_buf[32];
-	strftime(time_buf, sizeof(time_buf), "%H:%M:%S", tm_info);
-
-	const char *filename = strrchr(file, '/');
-	filename = filename ? filename + 1 : file;
-
-	fprintf(stderr, "[%s] [%-5s] [%-8s] %s (%s:%d in %s)\n", time_buf, wgvk_log_level_string(level),
-	        wgvk_log_category_string(category), message, filename, line, func);
-	fflush(stderr);
+	write_message(level, category, file, line, func, time(NULL), message);
 }
 
 void wgvk_log_message(WgvkLogLevel level, WgvkLogCategory category, const char *file, int line,
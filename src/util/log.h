@@ -10,6 +10,15 @@
 
 #include <stdarg.h>
 
+/**
+ * Most verbose level compiled in, as a WgvkLogLevel value; -1 strips all
+ * logging. Macros above it expand to nothing. Set by the
+ * WEBVULKAN_LOG_LEVEL CMake option.
+ */
+#ifndef WGVK_LOG_COMPILE_LEVEL
+#define WGVK_LOG_COMPILE_LEVEL 4
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -90,6 +99,36 @@ int wgvk_log_is_category_enabled(WgvkLogCategory category);
  */
 void wgvk_log_set_callback(WgvkLogCallback callback, void *user_data);
 
+/**
+ * Queue messages in a ring buffer instead of writing them from the logging
+ * call. Queued messages reach stderr or the callback at wgvk_log_flush();
+ * errors flush immediately. A full buffer drops messages rather than wait.
+ * @param enabled Non-zero to queue, zero to write synchronously
+ */
+void wgvk_log_set_async(int enabled);
+
+/**
+ * Write out queued messages. Called at frame end by wgvkDeviceEndFrame().
+ */
+void wgvk_log_flush(void);
+
+/**
+ * Per-category thresholds behind wgvk_log_enabled(), kept by the setters
+ * above. The entry past the last category applies to unknown categories.
+ */
+extern unsigned char wgvk_log_thresholds[WGVK_LOG_CAT_MAX + 1];
+
+/**
+ * Check whether a message would be logged, before formatting anything
+ * @param level Log level
+ * @param category Log category
+ * @return Non-zero if the message passes the level and category filters
+ */
+static inline int wgvk_log_enabled(WgvkLogLevel level, WgvkLogCategory category) {
+	unsigned index = (unsigned)category < WGVK_LOG_CAT_MAX ? (unsigned)category : WGVK_LOG_CAT_MAX;
+	return (unsigned)level < wgvk_log_thresholds[index];
+}
+
 /**
  * Core logging function (use macros instead)
  * @param level Log level
@@ -111,20 +150,49 @@ void wgvk_log_message_v(WgvkLogLevel level, WgvkLogCategory category, const char
 
 /* Convenience macros for logging */
 
-#define WGVK_ERROR(cat, fmt, ...) \
-	wgvk_log_message(WGVK_LOG_ERROR, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+#define WGVK_LOG_AT(level, cat, fmt, ...)                                                   \
+	do {                                                                                    \
+		if (wgvk_log_enabled(level, cat))                                                   \
+			wgvk_log_message(level, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__); \
+	} while (0)
+
+/* Compiled-out levels still type-check their arguments. */
+#define WGVK_LOG_STRIPPED(cat, fmt, ...)                                             \
+	do {                                                                             \
+		if (0)                                                                       \
+			wgvk_log_message(WGVK_LOG_TRACE, cat, __FILE__, __LINE__, __func__, fmt, \
+			                 ##__VA_ARGS__);                                         \
+	} while (0)
+
+#if WGVK_LOG_COMPILE_LEVEL >= 0
+#define WGVK_ERROR(cat, fmt, ...) WGVK_LOG_AT(WGVK_LOG_ERROR, cat, fmt, ##__VA_ARGS__)
+#else
+#define WGVK_ERROR(cat, fmt, ...) WGVK_LOG_STRIPPED(cat, fmt, ##__VA_ARGS__)
+#endif
 
-#define WGVK_WARN(cat, fmt, ...) \
-	wgvk_log_message(WGVK_LOG_WARN, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+#if WGVK_LOG_COMPILE_LEVEL >= 1
+#define WGVK_WARN(cat, fmt, ...) WGVK_LOG_AT(WGVK_LOG_WARN, cat, fmt, ##__VA_ARGS__)
+#else
+#define WGVK_WARN(cat, fmt, ...) WGVK_LOG_STRIPPED(cat, fmt, ##__VA_ARGS__)
+#endif
 
-#define WGVK_INFO(cat, fmt, ...) \
-	wgvk_log_message(WGVK_LOG_INFO, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+#if WGVK_LOG_COMPILE_LEVEL >= 2
+#define WGVK_INFO(cat, fmt, ...) WGVK_LOG_AT(WGVK_LOG_INFO, cat, fmt, ##__VA_ARGS__)
+#else
+#define WGVK_INFO(cat, fmt, ...) WGVK_LOG_STRIPPED(cat, fmt, ##__VA_ARGS__)
+#endif
 
-#define WGVK_DEBUG(cat, fmt, ...) \
-	wgvk_log_message(WGVK_LOG_DEBUG, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+#if WGVK_LOG_COMPILE_LEVEL >= 3
+#define WGVK_DEBUG(cat, fmt, ...) WGVK_LOG_AT(WGVK_LOG_DEBUG, cat, fmt, ##__VA_ARGS__)
+#else
+#define WGVK_DEBUG(cat, fmt, ...) WGVK_LOG_STRIPPED(cat, fmt, ##__VA_ARGS__)
+#endif
 
-#define WGVK_TRACE(cat, fmt, ...) \
-	wgvk_log_message(WGVK_LOG_TRACE, cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+#if WGVK_LOG_COMPILE_LEVEL >= 4
+#define WGVK_TRACE(cat, fmt, ...) WGVK_LOG_AT(WGVK_LOG_TRACE, cat, fmt, ##__VA_ARGS__)
+#else
+#define WGVK_TRACE(cat, fmt, ...) WGVK_LOG_STRIPPED(cat, fmt, ##__VA_ARGS__)
+#endif
 
 /* Category-specific convenience macros */
 
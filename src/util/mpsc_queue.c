@@ -0,0 +1,56 @@
+/**
+ * @file mpsc_queue.c
+ * @brief Intrusive lock-free multi-producer, single-consumer queue
+ */
+
+#include "mpsc_queue.h"
+
+void wgvk_mpsc_queue_init(WgvkMpscQueue *queue) {
+	atomic_init(&queue->stub.next, NULL);
+	atomic_init(&queue->head, &queue->stub);
+	queue->tail = &queue->stub;
+}
+
+void wgvk_mpsc_queue_push(WgvkMpscQueue *queue, WgvkMpscNode *node) {
+	atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+	WgvkMpscNode *prev = atomic_exchange_explicit(&queue->head, node, memory_order_acq_rel);
+	// Until this store the consumer sees the chain end at prev
+	atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+WgvkMpscNode *wgvk_mpsc_queue_pop(WgvkMpscQueue *queue) {
+	WgvkMpscNode *tail = queue->tail;
+	WgvkMpscNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+	if (tail == &queue->stub) {
+		if (!next) {
+			return NULL;
+		}
+		queue->tail = next;
+		tail = next;
+		next = atomic_load_explicit(&next->next, memory_order_acquire);
+	}
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+
+	// tail is the last linked node. Unless a push is half done, it is also
+	// the head; park the stub behind it so tail can be handed out.
+	if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) {
+		return NULL;
+	}
+	wgvk_mpsc_queue_push(queue, &queue->stub);
+	next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+int wgvk_mpsc_queue_empty(WgvkMpscQueue *queue) {
+	return queue->tail == &queue->stub &&
+	       atomic_load_explicit(&queue->stub.next, memory_order_acquire) == NULL &&
+	       atomic_load_explicit(&queue->head, memory_order_acquire) == &queue->stub;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Intrusive lock-free multi-producer, single-consumer queue
+ */
+
+#ifndef WGVK_MPSC_QUEUE_H
+#define WGVK_MPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Embedded in each element; recover the element with WGVK_CONTAINER_OF
+ * from util/list.h. A node may be pushed again once it has been popped. */
+typedef struct WgvkMpscNode {
+	struct WgvkMpscNode *_Atomic next;
+} WgvkMpscNode;
+
+/* Vyukov's queue: producers swap themselves in at the head with one atomic
+ * exchange and never wait; the consumer walks from the tail. Elements come
+ * out in push order for each producer. Must be initialized with
+ * wgvk_mpsc_queue_init and must not move afterwards, since it links to its
+ * own stub node. */
+typedef struct WgvkMpscQueue {
+	WgvkMpscNode *_Atomic head; /* last pushed, written by producers */
+	WgvkMpscNode *tail;         /* next to pop, consumer only */
+	WgvkMpscNode stub;
+} WgvkMpscQueue;
+
+void wgvk_mpsc_queue_init(WgvkMpscQueue *queue);
+
+/**
+ * Append @p node. Safe from any number of threads at once.
+ */
+void wgvk_mpsc_queue_push(WgvkMpscQueue *queue, WgvkMpscNode *node);
+
+/**
+ * Take the oldest node, or NULL when the queue is empty. Consumer thread
+ * only. May also return NULL while a producer is between its two stores;
+ * that node shows up on a later call.
+ */
+WgvkMpscNode *wgvk_mpsc_queue_pop(WgvkMpscQueue *queue);
+
+/**
+ * Whether nothing has been pushed that is not yet popped. Consumer thread
+ * only; pushes racing with the call may or may not be seen.
+ */
+int wgvk_mpsc_queue_empty(WgvkMpscQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WGVK_MPSC_QUEUE_H */
@@ -0,0 +1,111 @@
+/**
+ * @file stats.c
+ * @brief Counter storage and the wgvkGetStatistics() query
+ */
+
+#include "stats.h"
+#include "webvulkan.h"
+#include <string.h>
+#include <time.h>
+
+WgvkStatData wgvk_stats;
+
+#define WGVK_STAT_NAME(name) #name,
+static const char *const entry_names[WGVK_STAT_ENTRY_COUNT] = {
+    WGVK_STAT_ENTRY_POINTS(WGVK_STAT_NAME)};
+static const char *const wgpu_names[WGVK_STAT_WGPU_COUNT] = {
+    WGVK_WGPU_FUNCTIONS(WGVK_STAT_NAME)};
+#undef WGVK_STAT_NAME
+
+static const char *const object_names[WGVK_STAT_OBJECT_COUNT] = {
+    "Unknown",
+    "VkInstance",
+    "VkPhysicalDevice",
+    "VkDevice",
+    "VkQueue",
+    "VkSemaphore",
+    "VkCommandBuffer",
+    "VkFence",
+    "VkDeviceMemory",
+    "VkBuffer",
+    "VkImage",
+    "VkEvent",
+    "VkQueryPool",
+    "VkBufferView",
+    "VkImageView",
+    "VkShaderModule",
+    "VkPipelineCache",
+    "VkPipelineLayout",
+    "VkRenderPass",
+    "VkPipeline",
+    "VkDescriptorSetLayout",
+    "VkSampler",
+    "VkDescriptorPool",
+    "VkDescriptorSet",
+    "VkFramebuffer",
+    "VkCommandPool",
+    "VkDescriptorUpdateTemplate",
+};
+
+/* Filled by wgvkGetStatistics(); valid until the next query. */
+static WgvkCallStatistics g_entry_stats[WGVK_STAT_ENTRY_COUNT];
+static WgvkCallStatistics g_wgpu_stats[WGVK_STAT_WGPU_COUNT];
+static WgvkObjectStatistics g_object_stats[WGVK_STAT_OBJECT_COUNT];
+
+uint64_t wgvk_stat_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t wgvk_stat_object_index(VkObjectType type) {
+	if ((uint32_t)type <= (uint32_t)VK_OBJECT_TYPE_COMMAND_POOL) {
+		return (uint32_t)type;
+	}
+	if (type == VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE) {
+		return WGVK_STAT_OBJECT_COUNT - 1;
+	}
+	return 0;
+}
+
+void wgvkGetStatistics(WgvkStatistics *pStatistics) {
+	if (!pStatistics) {
+		return;
+	}
+
+	uint64_t wgpu_total = 0;
+	for (uint32_t i = 0; i < WGVK_STAT_ENTRY_COUNT; i++) {
+		g_entry_stats[i].name = entry_names[i];
+		g_entry_stats[i].callCount = wgvk_stats.entry_calls[i];
+		g_entry_stats[i].totalNanoseconds = wgvk_stats.entry_ns[i];
+	}
+	for (uint32_t i = 0; i < WGVK_STAT_WGPU_COUNT; i++) {
+		g_wgpu_stats[i].name = wgpu_names[i];
+		g_wgpu_stats[i].callCount = wgvk_stats.wgpu_calls[i];
+		g_wgpu_stats[i].totalNanoseconds = 0;
+		wgpu_total += wgvk_stats.wgpu_calls[i];
+	}
+	for (uint32_t i = 0; i < WGVK_STAT_OBJECT_COUNT; i++) {
+		g_object_stats[i].typeName = object_names[i];
+		g_object_stats[i].createdCount = wgvk_stats.objects_created[i];
+		g_object_stats[i].destroyedCount = wgvk_stats.objects_destroyed[i];
+	}
+
+#ifdef WGVK_ENABLE_STATS
+	pStatistics->enabled = 1;
+#else
+	pStatistics->enabled = 0;
+#endif
+	pStatistics->entryPointCount = WGVK_STAT_ENTRY_COUNT;
+	pStatistics->pEntryPoints = g_entry_stats;
+	pStatistics->webgpuFunctionCount = WGVK_STAT_WGPU_COUNT;
+	pStatistics->pWebGPUFunctions = g_wgpu_stats;
+	pStatistics->webgpuCallCount = wgpu_total;
+	pStatistics->bytesUploaded = wgvk_stats.bytes_uploaded;
+	pStatistics->objectTypeCount = WGVK_STAT_OBJECT_COUNT;
+	pStatistics->pObjectTypes = g_object_stats;
+}
+
+void wgvkResetStatistics(void) {
+	memset(&wgvk_stats, 0, sizeof(wgvk_stats));
+}
@@ -0,0 +1,277 @@
+/**
+ * @file stats.h
+ * @brief Per-call counters and timers, compiled in with WEBVULKAN_STATS
+ */
+
+#ifndef WGVK_STATS_H
+#define WGVK_STATS_H
+
+#include <stdint.h>
+#include <vulkan/vulkan_core.h>
+#include "wgpu_calls.h"
+
+/* Every vk* entry point implemented under src/. */
+#define WGVK_STAT_ENTRY_POINTS(X) \
+	X(vkCreateDescriptorSetLayout) \
+	X(vkDestroyDescriptorSetLayout) \
+	X(vkCreatePipelineLayout) \
+	X(vkDestroyPipelineLayout) \
+	X(vkCreateImage) \
+	X(vkDestroyImage) \
+	X(vkCreateEvent) \
+	X(vkDestroyEvent) \
+	X(vkSetEvent) \
+	X(vkResetEvent) \
+	X(vkGetEventStatus) \
+	X(vkCreateDescriptorPool) \
+	X(vkDestroyDescriptorPool) \
+	X(vkAllocateDescriptorSets) \
+	X(vkFreeDescriptorSets) \
+	X(vkUpdateDescriptorSets) \
+	X(vkCreateDescriptorUpdateTemplate) \
+	X(vkDestroyDescriptorUpdateTemplate) \
+	X(vkUpdateDescriptorSetWithTemplate) \
+	X(vkCreateGraphicsPipelines) \
+	X(vkCreateComputePipelines) \
+	X(vkDestroyPipeline) \
+	X(vkCreateSemaphore) \
+	X(vkDestroySemaphore) \
+	X(vkGetSemaphoreCounterValue) \
+	X(vkSignalSemaphore) \
+	X(vkWaitSemaphores) \
+	X(vkCreateSampler) \
+	X(vkDestroySampler) \
+	X(vkCreateCommandPool) \
+	X(vkDestroyCommandPool) \
+	X(vkResetCommandPool) \
+	X(vkAllocateCommandBuffers) \
+	X(vkFreeCommandBuffers) \
+	X(vkBeginCommandBuffer) \
+	X(vkEndCommandBuffer) \
+	X(vkCreateRenderPass) \
+	X(vkDestroyRenderPass) \
+	X(vkCreateImageView) \
+	X(vkDestroyImageView) \
+	X(vkCreateShaderModule) \
+	X(vkDestroyShaderModule) \
+	X(vkCreateFramebuffer) \
+	X(vkDestroyFramebuffer) \
+	X(vkCreateBuffer) \
+	X(vkDestroyBuffer) \
+	X(vkCreateFence) \
+	X(vkDestroyFence) \
+	X(vkResetFences) \
+	X(vkGetFenceStatus) \
+	X(vkWaitForFences) \
+	X(vkCmdPushConstants) \
+	X(vkCmdPipelineBarrier) \
+	X(vkCmdMemoryBarrier) \
+	X(vkCmdBufferBarrier) \
+	X(vkCmdImageBarrier) \
+	X(vkCreateDevice) \
+	X(vkDestroyDevice) \
+	X(vkGetDeviceQueue) \
+	X(vkDeviceWaitIdle) \
+	X(vkGetPhysicalDeviceProperties) \
+	X(vkGetPhysicalDeviceFeatures) \
+	X(vkGetPhysicalDeviceMemoryProperties) \
+	X(vkGetPhysicalDeviceQueueFamilyProperties) \
+	X(vkGetPhysicalDeviceFormatProperties) \
+	X(vkQueueSubmit) \
+	X(vkQueueWaitIdle) \
+	X(vkCreateInstance) \
+	X(vkDestroyInstance) \
+	X(vkEnumeratePhysicalDevices) \
+	X(vkCmdDispatch) \
+	X(vkCmdDispatchIndirect) \
+	X(vkCmdSetEvent) \
+	X(vkCmdResetEvent) \
+	X(vkCmdWaitEvents) \
+	X(vkCmdCopyBuffer) \
+	X(vkCmdCopyImage) \
+	X(vkCmdCopyBufferToImage) \
+	X(vkCmdCopyImageToBuffer) \
+	X(vkCmdFillBuffer) \
+	X(vkCmdUpdateBuffer) \
+	X(vkCmdCopyQueryPoolResults) \
+	X(vkCmdBeginRenderPass) \
+	X(vkCmdEndRenderPass) \
+	X(vkCmdNextSubpass) \
+	X(vkCmdBeginRendering) \
+	X(vkCmdEndRendering) \
+	X(vkCmdSetViewport) \
+	X(vkCmdSetScissor) \
+	X(vkCmdSetLineWidth) \
+	X(vkCmdSetDepthBias) \
+	X(vkCmdSetBlendConstants) \
+	X(vkCmdSetDepthBounds) \
+	X(vkCmdSetStencilCompareMask) \
+	X(vkCmdSetStencilWriteMask) \
+	X(vkCmdSetStencilReference) \
+	X(vkCmdBindPipeline) \
+	X(vkCmdBindVertexBuffers) \
+	X(vkCmdBindIndexBuffer) \
+	X(vkCmdBindDescriptorSets) \
+	X(vkCmdDraw) \
+	X(vkCmdDrawIndexed) \
+	X(vkCmdDrawIndirect) \
+	X(vkCmdDrawIndexedIndirect) \
+	X(vkCmdBlitImage) \
+	X(vkCmdResolveImage) \
+	X(vkAllocateMemory) \
+	X(vkFreeMemory) \
+	X(vkMapMemory) \
+	X(vkUnmapMemory) \
+	X(vkBindBufferMemory) \
+	X(vkBindImageMemory) \
+	X(vkGetBufferMemoryRequirements) \
+	X(vkGetImageMemoryRequirements)
+
+#define WGVK_STAT_ENUM(name) WGVK_STAT_##name,
+typedef enum { WGVK_STAT_ENTRY_POINTS(WGVK_STAT_ENUM) WGVK_STAT_ENTRY_COUNT } WgvkStatEntry;
+typedef enum { WGVK_WGPU_FUNCTIONS(WGVK_STAT_ENUM) WGVK_STAT_WGPU_COUNT } WgvkStatWgpu;
+#undef WGVK_STAT_ENUM
+
+/* Core object types plus the descriptor update template. */
+#define WGVK_STAT_OBJECT_COUNT 27
+
+typedef struct WgvkStatData {
+	uint64_t entry_calls[WGVK_STAT_ENTRY_COUNT];
+	uint64_t entry_ns[WGVK_STAT_ENTRY_COUNT];
+	uint64_t wgpu_calls[WGVK_STAT_WGPU_COUNT];
+	uint64_t bytes_uploaded;
+	uint64_t objects_created[WGVK_STAT_OBJECT_COUNT];
+	uint64_t objects_destroyed[WGVK_STAT_OBJECT_COUNT];
+} WgvkStatData;
+
+extern WgvkStatData wgvk_stats;
+
+uint64_t wgvk_stat_now_ns(void);
+uint32_t wgvk_stat_object_index(VkObjectType type);
+
+#ifdef WGVK_ENABLE_STATS
+
+typedef struct WgvkStatTimer {
+	WgvkStatEntry entry;
+	uint64_t start;
+} WgvkStatTimer;
+
+static inline void wgvk_stat_timer_end(WgvkStatTimer *timer) {
+	wgvk_stats.entry_calls[timer->entry]++;
+	wgvk_stats.entry_ns[timer->entry] += wgvk_stat_now_ns() - timer->start;
+}
+
+/* First statement of an entry point; the timer stops on every return path. */
+#define WGVK_STAT_CALL(name)                                                        \
+	WgvkStatTimer wgvk_stat_timer __attribute__((cleanup(wgvk_stat_timer_end))) = { \
+	    WGVK_STAT_##name, wgvk_stat_now_ns()}
+
+#define WGVK_STAT_OBJECT_CREATED(type) wgvk_stats.objects_created[wgvk_stat_object_index(type)]++
+#define WGVK_STAT_OBJECT_DESTROYED(type) \
+	wgvk_stats.objects_destroyed[wgvk_stat_object_index(type)]++
+
+/* Count each WebGPU call at the call site. A function-like macro is not
+ * expanded again inside its own replacement, so fn() still calls through. */
+#define WGVK_STAT_WGPU(fn, ...) (wgvk_stats.wgpu_calls[WGVK_STAT_##fn]++, fn(__VA_ARGS__))
+
+#define wgpuAdapterHasFeature(...) WGVK_STAT_WGPU(wgpuAdapterHasFeature, __VA_ARGS__)
+#define wgpuAdapterRelease(...) WGVK_STAT_WGPU(wgpuAdapterRelease, __VA_ARGS__)
+#define wgpuAdapterRequestDeviceSync(...) WGVK_STAT_WGPU(wgpuAdapterRequestDeviceSync, __VA_ARGS__)
+#define wgpuBindGroupLayoutRelease(...) WGVK_STAT_WGPU(wgpuBindGroupLayoutRelease, __VA_ARGS__)
+#define wgpuBindGroupRelease(...) WGVK_STAT_WGPU(wgpuBindGroupRelease, __VA_ARGS__)
+#define wgpuBufferRelease(...) WGVK_STAT_WGPU(wgpuBufferRelease, __VA_ARGS__)
+#define wgpuCommandBufferRelease(...) WGVK_STAT_WGPU(wgpuCommandBufferRelease, __VA_ARGS__)
+#define wgpuCommandEncoderBeginComputePass(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderBeginComputePass, __VA_ARGS__)
+#define wgpuCommandEncoderBeginRenderPass(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderBeginRenderPass, __VA_ARGS__)
+#define wgpuCommandEncoderCopyBufferToBuffer(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderCopyBufferToBuffer, __VA_ARGS__)
+#define wgpuCommandEncoderCopyBufferToTexture(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderCopyBufferToTexture, __VA_ARGS__)
+#define wgpuCommandEncoderCopyTextureToBuffer(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderCopyTextureToBuffer, __VA_ARGS__)
+#define wgpuCommandEncoderCopyTextureToTexture(...) \
+	WGVK_STAT_WGPU(wgpuCommandEncoderCopyTextureToTexture, __VA_ARGS__)
+#define wgpuCommandEncoderFinish(...) WGVK_STAT_WGPU(wgpuCommandEncoderFinish, __VA_ARGS__)
+#define wgpuCommandEncoderRelease(...) WGVK_STAT_WGPU(wgpuCommandEncoderRelease, __VA_ARGS__)
+#define wgpuComputePassEncoderDispatchWorkgroups(...) \
+	WGVK_STAT_WGPU(wgpuComputePassEncoderDispatchWorkgroups, __VA_ARGS__)
+#define wgpuComputePassEncoderDispatchWorkgroupsIndirect(...) \
+	WGVK_STAT_WGPU(wgpuComputePassEncoderDispatchWorkgroupsIndirect, __VA_ARGS__)
+#define wgpuComputePassEncoderEnd(...) WGVK_STAT_WGPU(wgpuComputePassEncoderEnd, __VA_ARGS__)
+#define wgpuComputePassEncoderRelease(...) \
+	WGVK_STAT_WGPU(wgpuComputePassEncoderRelease, __VA_ARGS__)
+#define wgpuComputePassEncoderSetBindGroup(...) \
+	WGVK_STAT_WGPU(wgpuComputePassEncoderSetBindGroup, __VA_ARGS__)
+#define wgpuComputePassEncoderSetPipeline(...) \
+	WGVK_STAT_WGPU(wgpuComputePassEncoderSetPipeline, __VA_ARGS__)
+#define wgpuComputePipelineRelease(...) WGVK_STAT_WGPU(wgpuComputePipelineRelease, __VA_ARGS__)
+#define wgpuCreateInstance(...) WGVK_STAT_WGPU(wgpuCreateInstance, __VA_ARGS__)
+#define wgpuDeviceCreateBindGroup(...) WGVK_STAT_WGPU(wgpuDeviceCreateBindGroup, __VA_ARGS__)
+#define wgpuDeviceCreateBindGroupLayout(...) \
+	WGVK_STAT_WGPU(wgpuDeviceCreateBindGroupLayout, __VA_ARGS__)
+#define wgpuDeviceCreateBuffer(...) WGVK_STAT_WGPU(wgpuDeviceCreateBuffer, __VA_ARGS__)
+#define wgpuDeviceCreateCommandEncoder(...) \
+	WGVK_STAT_WGPU(wgpuDeviceCreateCommandEncoder, __VA_ARGS__)
+#define wgpuDeviceCreateComputePipeline(...) \
+	WGVK_STAT_WGPU(wgpuDeviceCreateComputePipeline, __VA_ARGS__)
+#define wgpuDeviceCreatePipelineLayout(...) \
+	WGVK_STAT_WGPU(wgpuDeviceCreatePipelineLayout, __VA_ARGS__)
+#define wgpuDeviceCreateRenderPipeline(...) \
+	WGVK_STAT_WGPU(wgpuDeviceCreateRenderPipeline, __VA_ARGS__)
+#define wgpuDeviceCreateSampler(...) WGVK_STAT_WGPU(wgpuDeviceCreateSampler, __VA_ARGS__)
+#define wgpuDeviceCreateShaderModule(...) WGVK_STAT_WGPU(wgpuDeviceCreateShaderModule, __VA_ARGS__)
+#define wgpuDeviceCreateTexture(...) WGVK_STAT_WGPU(wgpuDeviceCreateTexture, __VA_ARGS__)
+#define wgpuDeviceGetQueue(...) WGVK_STAT_WGPU(wgpuDeviceGetQueue, __VA_ARGS__)
+#define wgpuDeviceHasFeature(...) WGVK_STAT_WGPU(wgpuDeviceHasFeature, __VA_ARGS__)
+#define wgpuDeviceRelease(...) WGVK_STAT_WGPU(wgpuDeviceRelease, __VA_ARGS__)
+#define wgpuInstanceRelease(...) WGVK_STAT_WGPU(wgpuInstanceRelease, __VA_ARGS__)
+#define wgpuPipelineLayoutRelease(...) WGVK_STAT_WGPU(wgpuPipelineLayoutRelease, __VA_ARGS__)
+#define wgpuQueueAddRef(...) WGVK_STAT_WGPU(wgpuQueueAddRef, __VA_ARGS__)
+#define wgpuQueueRelease(...) WGVK_STAT_WGPU(wgpuQueueRelease, __VA_ARGS__)
+#define wgpuQueueSubmit(...) WGVK_STAT_WGPU(wgpuQueueSubmit, __VA_ARGS__)
+#define wgpuQueueWriteBuffer(queue, buffer, offset, data, size) \
+	(wgvk_stats.bytes_uploaded += (size), \
+	 WGVK_STAT_WGPU(wgpuQueueWriteBuffer, queue, buffer, offset, data, size))
+#define wgpuRenderPassEncoderDraw(...) WGVK_STAT_WGPU(wgpuRenderPassEncoderDraw, __VA_ARGS__)
+#define wgpuRenderPassEncoderDrawIndexed(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderDrawIndexed, __VA_ARGS__)
+#define wgpuRenderPassEncoderDrawIndexedIndirect(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderDrawIndexedIndirect, __VA_ARGS__)
+#define wgpuRenderPassEncoderDrawIndirect(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderDrawIndirect, __VA_ARGS__)
+#define wgpuRenderPassEncoderEnd(...) WGVK_STAT_WGPU(wgpuRenderPassEncoderEnd, __VA_ARGS__)
+#define wgpuRenderPassEncoderRelease(...) WGVK_STAT_WGPU(wgpuRenderPassEncoderRelease, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetBindGroup(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetBindGroup, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetBlendConstant(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetBlendConstant, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetIndexBuffer(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetIndexBuffer, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetPipeline(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetPipeline, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetScissorRect(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetScissorRect, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetStencilReference(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetStencilReference, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetVertexBuffer(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetVertexBuffer, __VA_ARGS__)
+#define wgpuRenderPassEncoderSetViewport(...) \
+	WGVK_STAT_WGPU(wgpuRenderPassEncoderSetViewport, __VA_ARGS__)
+#define wgpuRenderPipelineRelease(...) WGVK_STAT_WGPU(wgpuRenderPipelineRelease, __VA_ARGS__)
+#define wgpuSamplerRelease(...) WGVK_STAT_WGPU(wgpuSamplerRelease, __VA_ARGS__)
+#define wgpuShaderModuleRelease(...) WGVK_STAT_WGPU(wgpuShaderModuleRelease, __VA_ARGS__)
+#define wgpuTextureCreateView(...) WGVK_STAT_WGPU(wgpuTextureCreateView, __VA_ARGS__)
+#define wgpuTextureRelease(...) WGVK_STAT_WGPU(wgpuTextureRelease, __VA_ARGS__)
+#define wgpuTextureViewRelease(...) WGVK_STAT_WGPU(wgpuTextureViewRelease, __VA_ARGS__)
+
+#else
+
+#define WGVK_STAT_CALL(name) ((void)0)
+#define WGVK_STAT_OBJECT_CREATED(type) ((void)0)
+#define WGVK_STAT_OBJECT_DESTROYED(type) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file trace.c
+ * @brief Per-thread span buffers and Chrome trace-event JSON export
+ */
+
+#include "trace.h"
+#include "stats.h"
+#include "webvulkan.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Events per thread; later events are dropped once a buffer fills. */
+#define WGVK_TRACE_BUFFER_EVENTS 16384
+
+typedef struct WgvkTraceEvent {
+	uint64_t timestamp_ns;
+	const char *name;
+	uint8_t category;
+	char phase;
+} WgvkTraceEvent;
+
+/* Written only by its own thread. count is published with release so a
+ * reader sees every event below it. */
+typedef struct WgvkTraceBuffer {
+	struct WgvkTraceBuffer *next;
+	uint32_t thread_id;
+	atomic_uint generation;
+	atomic_uint count;
+	atomic_uint dropped;
+	WgvkTraceEvent events[WGVK_TRACE_BUFFER_EVENTS];
+} WgvkTraceBuffer;
+
+atomic_int wgvk_trace_active;
+
+/* Buffers are pushed once per thread and kept for reuse by later traces. */
+static _Atomic(WgvkTraceBuffer *) g_buffers;
+static atomic_uint g_thread_ids;
+/* Bumped on every wgvkSetTracing(1); older buffer contents are stale. */
+static atomic_uint g_generation;
+static _Thread_local WgvkTraceBuffer *t_buffer;
+static atomic_flag g_cleanup_registered = ATOMIC_FLAG_INIT;
+
+/* Runs at exit. Tracing is switched off first; a thread still recording
+ * while the process exits is not supported. */
+static void free_buffers(void) {
+	atomic_store(&wgvk_trace_active, 0);
+	WgvkTraceBuffer *buffer = atomic_exchange(&g_buffers, NULL);
+	while (buffer) {
+		WgvkTraceBuffer *next = buffer->next;
+		free(buffer);
+		buffer = next;
+	}
+	t_buffer = NULL;
+}
+
+static WgvkTraceBuffer *thread_buffer(void) {
+	if (t_buffer) {
+		return t_buffer;
+	}
+	if (!atomic_flag_test_and_set(&g_cleanup_registered)) {
+		atexit(free_buffers);
+	}
+	WgvkTraceBuffer *buffer = calloc(1, sizeof(WgvkTraceBuffer));
+	if (!buffer) {
+		return NULL;
+	}
+	buffer->thread_id = atomic_fetch_add(&g_thread_ids, 1) + 1;
+	atomic_store(&buffer->generation, atomic_load(&g_generation));
+
+	WgvkTraceBuffer *head = atomic_load_explicit(&g_buffers, memory_order_relaxed);
+	do {
+		buffer->next = head;
+	} while (!atomic_compare_exchange_weak_explicit(&g_buffers, &head, buffer, memory_order_release,
+	                                                memory_order_relaxed));
+	t_buffer = buffer;
+	return buffer;
+}
+
+unsigned wgvk_trace_record(WgvkLogCategory category, const char *name, char phase) {
+	WgvkTraceBuffer *buffer = thread_buffer();
+	if (!buffer) {
+		return 0;
+	}
+
+	// The owning thread clears its own buffer when a new trace starts
+	unsigned generation = atomic_load_explicit(&g_generation, memory_order_relaxed);
+	if (atomic_load_explicit(&buffer->generation, memory_order_relaxed) != generation) {
+		atomic_store_explicit(&buffer->count, 0, memory_order_relaxed);
+		atomic_store_explicit(&buffer->dropped, 0, memory_order_relaxed);
+		atomic_store_explicit(&buffer->generation, generation, memory_order_release);
+	}
+
+	unsigned count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+	if (count >= WGVK_TRACE_BUFFER_EVENTS) {
+		atomic_fetch_add_explicit(&buffer->dropped, 1, memory_order_relaxed);
+		return 0;
+	}
+	WgvkTraceEvent *event = &buffer->events[count];
+	event->timestamp_ns = wgvk_stat_now_ns();
+	event->name = name;
+	event->category = (uint8_t)category;
+	event->phase = phase;
+	atomic_store_explicit(&buffer->count, count + 1, memory_order_release);
+	return generation;
+}
+
+void wgvk_trace_record_end(WgvkLogCategory category, const char *name, unsigned trace) {
+	if (atomic_load_explicit(&wgvk_trace_active, memory_order_relaxed) &&
+	    atomic_load_explicit(&g_generation, memory_order_relaxed) == trace) {
+		wgvk_trace_record(category, name, 'E');
+	}
+}
+
+void wgvkSetTracing(uint32_t enable) {
+	if (enable) {
+		atomic_fetch_add(&g_generation, 1);
+	}
+	atomic_store(&wgvk_trace_active, enable ? 1 : 0);
+}
+
+typedef struct {
+	char *data;
+	size_t size;
+	size_t length;
+} JsonWriter;
+
+static void append(JsonWriter *writer, const char *fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	size_t room = writer->length < writer->size ? writer->size - writer->length : 0;
+	int written = vsnprintf(room ? writer->data + writer->length : NULL, room, fmt, args);
+	va_end(args);
+	if (written > 0) {
+		writer->length += (size_t)written;
+	}
+}
+
+size_t wgvkGetTraceJson(char *pBuffer, size_t bufferSize) {
+	JsonWriter writer = {pBuffer, pBuffer ? bufferSize : 0, 0};
+	unsigned generation = atomic_load(&g_generation);
+	uint64_t dropped = 0;
+	const char *separator = "";
+
+	append(&writer, "{\"traceEvents\":[");
+	for (WgvkTraceBuffer *buffer = atomic_load_explicit(&g_buffers, memory_order_acquire); buffer;
+	     buffer = buffer->next) {
+		if (atomic_load_explicit(&buffer->generation, memory_order_acquire) != generation) {
+			continue;
+		}
+		unsigned count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+		for (unsigned i = 0; i < count; i++) {
+			const WgvkTraceEvent *event = &buffer->events[i];
+			// Event names are literals from this library, so need no escaping
+			append(&writer,
+			       "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,"
+			       "\"pid\":1,\"tid\":%u}",
+			       separator, event->name,
+			       wgvk_log_category_string((WgvkLogCategory)event->category), event->phase,
+			       (unsigned long long)(event->timestamp_ns / 1000),
+			       (unsigned)(event->timestamp_ns % 1000), buffer->thread_id);
+			separator = ",";
+		}
+		dropped += atomic_load_explicit(&buffer->dropped, memory_order_relaxed);
+	}
+	append(&writer, "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%llu}}",
+	       (unsigned long long)dropped);
+	return writer.length;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file trace.h
+ * @brief Begin/end spans recorded per thread and exported as Chrome trace JSON
+ */
+
+#ifndef WGVK_TRACE_H
+#define WGVK_TRACE_H
+
+#include <stdatomic.h>
+#include "log.h"
+
+/* Set by wgvkSetTracing(); spans cost one relaxed load while it is 0. */
+extern atomic_int wgvk_trace_active;
+
+/* Names must outlive the trace; pass string literals. Returns the trace the
+ * event went into, 0 when it was not recorded. */
+unsigned wgvk_trace_record(WgvkLogCategory category, const char *name, char phase);
+/* Record an end event, but only into the trace its begin went into. */
+void wgvk_trace_record_end(WgvkLogCategory category, const char *name, unsigned trace);
+
+static inline void wgvk_trace_begin(WgvkLogCategory category, const char *name) {
+	if (atomic_load_explicit(&wgvk_trace_active, memory_order_relaxed)) {
+		wgvk_trace_record(category, name, 'B');
+	}
+}
+
+static inline void wgvk_trace_end(WgvkLogCategory category, const char *name) {
+	if (atomic_load_explicit(&wgvk_trace_active, memory_order_relaxed)) {
+		wgvk_trace_record(category, name, 'E');
+	}
+}
+
+typedef struct WgvkTraceSpan {
+	WgvkLogCategory category;
+	const char *name;
+	unsigned trace; /* trace holding the begin event, 0 when none was recorded */
+} WgvkTraceSpan;
+
+static inline WgvkTraceSpan wgvk_trace_span_begin(WgvkLogCategory category, const char *name) {
+	WgvkTraceSpan span = {category, name, 0};
+	if (atomic_load_explicit(&wgvk_trace_active, memory_order_relaxed)) {
+		span.trace = wgvk_trace_record(category, name, 'B');
+	}
+	return span;
+}
+
+static inline void wgvk_trace_span_end(WgvkTraceSpan *span) {
+	// A span that began before tracing was switched on, or in an earlier
+	// trace, has no begin to close
+	if (span->trace) {
+		wgvk_trace_record_end(span->category, span->name, span->trace);
+		span->trace = 0;
+	}
+}
+
+/* Span covering the rest of the enclosing block. */
+#define WGVK_SPAN(category, name)                                                    \
+	WgvkTraceSpan wgvk_trace_span __attribute__((cleanup(wgvk_trace_span_end))) = \
+	    wgvk_trace_span_begin(category, name)
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file wgpu_calls.h
+ * @brief The WebGPU functions the translation layer calls, as an X-macro
+ */
+
+#ifndef WGVK_WGPU_CALLS_H
+#define WGVK_WGPU_CALLS_H
+
+/* Shared by the statistics counters and the recording test stubs; add new
+ * WebGPU calls here. */
+#define WGVK_WGPU_FUNCTIONS(X) \
+	X(wgpuAdapterHasFeature) \
+	X(wgpuAdapterRelease) \
+	X(wgpuAdapterRequestDeviceSync) \
+	X(wgpuBindGroupLayoutRelease) \
+	X(wgpuBindGroupRelease) \
+	X(wgpuBufferRelease) \
+	X(wgpuCommandBufferRelease) \
+	X(wgpuCommandEncoderBeginComputePass) \
+	X(wgpuCommandEncoderBeginRenderPass) \
+	X(wgpuCommandEncoderCopyBufferToBuffer) \
+	X(wgpuCommandEncoderCopyBufferToTexture) \
+	X(wgpuCommandEncoderCopyTextureToBuffer) \
+	X(wgpuCommandEncoderCopyTextureToTexture) \
+	X(wgpuCommandEncoderFinish) \
+	X(wgpuCommandEncoderRelease) \
+	X(wgpuComputePassEncoderDispatchWorkgroups) \
+	X(wgpuComputePassEncoderDispatchWorkgroupsIndirect) \
+	X(wgpuComputePassEncoderEnd) \
+	X(wgpuComputePassEncoderRelease) \
+	X(wgpuComputePassEncoderSetBindGroup) \
+	X(wgpuComputePassEncoderSetPipeline) \
+	X(wgpuComputePipelineRelease) \
+	X(wgpuCreateInstance) \
+	X(wgpuDeviceCreateBindGroup) \
+	X(wgpuDeviceCreateBindGroupLayout) \
+	X(wgpuDeviceCreateBuffer) \
+	X(wgpuDeviceCreateCommandEncoder) \
+	X(wgpuDeviceCreateComputePipeline) \
+	X(wgpuDeviceCreatePipelineLayout) \
+	X(wgpuDeviceCreateRenderPipeline) \
+	X(wgpuDeviceCreateSampler) \
+	X(wgpuDeviceCreateShaderModule) \
+	X(wgpuDeviceCreateTexture) \
+	X(wgpuDeviceGetQueue) \
+	X(wgpuDeviceHasFeature) \
+	X(wgpuDeviceRelease) \
+	X(wgpuInstanceRelease) \
+	X(wgpuPipelineLayoutRelease) \
+	X(wgpuQueueAddRef) \
+	X(wgpuQueueRelease) \
+	X(wgpuQueueSubmit) \
+	X(wgpuQueueWriteBuffer) \
+	X(wgpuRenderPassEncoderDraw) \
+	X(wgpuRenderPassEncoderDrawIndexed) \
+	X(wgpuRenderPassEncoderDrawIndexedIndirect) \
+	X(wgpuRenderPassEncoderDrawIndirect) \
+	X(wgpuRenderPassEncoderEnd) \
+	X(wgpuRenderPassEncoderRelease) \
+	X(wgpuRenderPassEncoderSetBindGroup) \
+	X(wgpuRenderPassEncoderSetBlendConstant) \
+	X(wgpuRenderPassEncoderSetIndexBuffer) \
+	X(wgpuRenderPassEncoderSetPipeline) \
+	X(wgpuRenderPassEncoderSetScissorRect) \
+	X(wgpuRenderPassEncoderSetStencilReference) \
+	X(wgpuRenderPassEncoderSetVertexBuffer) \
+	X(wgpuRenderPassEncoderSetViewport) \
+	X(wgpuRenderPipelineRelease) \
+	X(wgpuSamplerRelease) \
+	X(wgpuShaderModuleRelease) \
+	X(wgpuTextureCreateView) \
+	X(wgpuTextureRelease) \
+	X(wgpuTextureViewRelease)
+
+#endif
@@ -8,28 +8,77 @@
 #include <vulkan/vulkan_core.h>
 #include <webgpu/webgpu.h>
 #include "vulkan_platform.h"
+#include "util/hash_table.h"
+#include "util/stats.h"
+#include "util/trace.h"
 
 #define WGVK_MAX_BIND_GROUPS 4
 #define WGVK_MAX_VERTEX_BUFFERS 16
 #define WGVK_MAX_COLOR_ATTACHMENTS 8
 #define WGVK_PUSH_CONSTANT_SIZE 128
+#define WGVK_MAX_DYNAMIC_OFFSETS 16
+#define WGVK_MAX_BINDING_NUMBER 1000 /* WebGPU maxBindingsPerBindGroup */
+
+/* Memory types: 0 is the general type; 1 is lazily allocated and backed by
+ * nothing, for transient attachments. */
+#define WGVK_MEMORY_TYPE_GENERAL 0
+#define WGVK_MEMORY_TYPE_LAZY 1
+
+/* Storage images and storage texel buffers are bound with this format. */
+#define WGVK_STORAGE_TEXTURE_FORMAT WGPUTextureFormat_RGBA8Unorm
+
+/* Stand-in textures for unwritten image and texel buffer descriptors, one
+ * per bind group layout entry shape. */
+enum WgvkPlaceholderTexture {
+	WGVK_PLACEHOLDER_SAMPLED_2D,
+	WGVK_PLACEHOLDER_SAMPLED_1D,
+	WGVK_PLACEHOLDER_STORAGE_2D,
+	WGVK_PLACEHOLDER_STORAGE_1D,
+	WGVK_PLACEHOLDER_TEXTURE_COUNT,
+};
 
 struct WgvkObject {
 	volatile int32_t ref_count;
+	VkObjectType type;
 	void (*destroy)(void *obj);
+	/* Copy of the callbacks the object was allocated with, stored after the
+	 * object; NULL for the built-in allocator. */
+	const VkAllocationCallbacks *allocator;
 };
 
-static inline void wgvk_object_init(struct WgvkObject *obj, void (*destroy)(void *)) {
+#ifdef WGVK_ENABLE_HANDLE_TABLE
+/* Debug check: whether obj is the address of a live object. Only the
+ * address is looked up, never the object, so passing a destroyed one is
+ * safe; logs and returns 0 for it. Freed memory is held back for a while
+ * before reuse; once a new object lands there the stale pointer passes
+ * again. */
+int wgvk_object_handle_valid(const struct WgvkObject *obj);
+#define WGVK_OBJECT_CHECK(obj) wgvk_object_handle_valid(obj)
+#else
+#define WGVK_OBJECT_CHECK(obj) 1
+#endif
+
+static inline void wgvk_object_init(struct WgvkObject *obj, VkObjectType type,
+                                    void (*destroy)(void *)) {
 	obj->ref_count = 1;
+	obj->type = type;
 	obj->destroy = destroy;
+	WGVK_STAT_OBJECT_CREATED(type);
 }
 
 static inline void wgvk_object_retain(struct WgvkObject *obj) {
+	if (!WGVK_OBJECT_CHECK(obj)) {
+		return;
+	}
 	__sync_fetch_and_add(&obj->ref_count, 1);
 }
 
 static inline void wgvk_object_release(struct WgvkObject *obj) {
+	if (!WGVK_OBJECT_CHECK(obj)) {
+		return;
+	}
 	if (__sync_sub_and_fetch(&obj->ref_count, 1) == 0) {
+		WGVK_STAT_OBJECT_DESTROYED(obj->type);
 		if (obj->destroy) {
 			obj->destroy(obj);
 		}
@@ -53,13 +102,80 @@ struct VkPhysicalDevice_T {
 	uint32_t api_version;
 };
 
+/* Refcounted interning of immutable WebGPU objects. Entries are keyed by
+ * a canonical word array, which the hash table compares in place. */
+typedef struct WgvkCacheEntry {
+	uint64_t hash;
+	uint32_t ref_count;
+	uint32_t key_words;
+	void *object;
+	uint32_t key[];
+} WgvkCacheEntry;
+
+typedef struct {
+	WgvkHashTable *table;
+	void (*release)(void *object);
+	uint32_t entry_count;
+} WgvkObjectCache;
+
+/* Released textures kept for reuse. Each sits on a per-key chain for
+ * lookup and on one list ordered by release time for cleanup. */
+#define WGVK_TEXTURE_KEY_WORDS 8
+typedef struct WgvkPooledTexture {
+	struct WgvkPooledTexture *next; /* same-key chain, newest first */
+	struct WgvkPooledTexture *older;
+	struct WgvkPooledTexture *newer;
+	uint64_t hash;
+	uint64_t frame; /* pool frame at release */
+	WGPUTexture texture;
+	uint32_t key[WGVK_TEXTURE_KEY_WORDS];
+} WgvkPooledTexture;
+
+#define WGVK_TEXTURE_POOL_DEFAULT_FRAMES 8
+#define WGVK_TEXTURE_POOL_MAX_TEXTURES 32 /* the oldest go first beyond this */
+typedef struct {
+	WgvkHashTable *table; /* key hash -> chain head */
+	WgvkPooledTexture *oldest;
+	WgvkPooledTexture *newest;
+	uint32_t free_count;
+	uint64_t frame;
+	uint32_t max_frames;  /* textures idle this many frames are released */
+	VkBool32 all_images;  /* pool every image, not only transient ones */
+	VkBool32 explicit_frames; /* wgvkDeviceEndFrame marks frames, not submits */
+} WgvkTexturePool;
+
 struct VkDevice_T {
 	struct WgvkObject base;
 	VkPhysicalDevice physical_device;
 	WGPUDevice wgpu_device;
 	WGPUQueue wgpu_queue;
+	struct VkQueue_T *queue; /* the one queue, created by the first vkGetDeviceQueue */
 	WGPUBuffer push_constant_buffer;
 	uint32_t queue_family_index;
+
+	/* Stand-ins for unwritten descriptors, created on first use. */
+	WGPUBuffer placeholder_buffer;
+	WGPUSampler placeholder_sampler;
+	WGPUTexture placeholder_textures[WGVK_PLACEHOLDER_TEXTURE_COUNT];
+	WGPUTextureView placeholder_views[WGVK_PLACEHOLDER_TEXTURE_COUNT];
+
+	/* Identical layouts share one WebGPU object so identity checks match. */
+	WgvkObjectCache bind_group_layout_cache;
+	WgvkObjectCache pipeline_layout_cache;
+	WgvkObjectCache sampler_cache;
+
+	struct WgvkBlitState *blit_state; /* see commands/blit.h, created on first blit */
+	WgvkTexturePool texture_pool;
+	VkBool32 transient_attachments; /* WGPUTextureUsage_TransientAttachment usable */
+	/* Block-compression families sampled natively; others are transcoded. */
+	VkBool32 texture_compression_bc;
+	VkBool32 texture_compression_etc2;
+	VkBool32 texture_compression_astc;
+	struct WgvkTranscodeState *transcode_state; /* see commands/transcode.h */
+
+	/* Repitches buffer rows WebGPU cannot copy directly, created on first use. */
+	WGPUComputePipeline repack_pipeline;
+	WGPUBindGroupLayout repack_layout;
 };
 
 struct VkQueue_T {
@@ -99,18 +215,25 @@ struct VkImage_T {
 	uint32_t mip_levels;
 	uint32_t array_layers;
 	uint32_t format;
+	WGPUTextureFormat wgpu_format; /* the texture's format, decoded when transcoded */
+	VkBool32 transcoded;           /* uploads decode blocks, see commands/transcode.h */
 	uint32_t image_type;
 	uint32_t samples;
 	VkImageUsageFlags usage;
 	VkDeviceMemory bound_memory;
 	VkDeviceSize memory_offset;
+	VkBool32 pooled; /* texture returns to the device pool on destroy */
+	uint32_t pool_key[WGVK_TEXTURE_KEY_WORDS];
+	/* WebGPU views of this texture, keyed by format, dimension and range. */
+	WgvkObjectCache view_cache;
 };
 
 struct VkImageView_T {
 	struct WgvkObject base;
 	VkDevice device;
-	VkImage image;
+	VkImage image; /* retained; owns the cache holding wgpu_view */
 	WGPUTextureView wgpu_view;
+	WgvkCacheEntry *interned;
 	uint32_t view_type;
 	uint32_t format;
 };
@@ -129,7 +252,8 @@ struct VkShaderModule_T {
 struct VkPipelineLayout_T {
 	struct WgvkObject base;
 	VkDevice device;
-	WGPUPipelineLayout wgpu_layout;
+	WGPUPipelineLayout wgpu_layout; /* owned by interned */
+	WgvkCacheEntry *interned;
 	uint32_t set_layout_count;
 	VkDescriptorSetLayout set_layouts[WGVK_MAX_BIND_GROUPS];
 	uint32_t push_constant_size;
@@ -146,12 +270,23 @@ struct VkPipeline_T {
 	VkPipelineBindPoint bind_point;
 };
 
+/* Per-attachment state vkCmdBeginRenderPass needs, indexed by attachment. */
+typedef struct {
+	uint32_t format;
+	uint32_t samples;
+	uint32_t load_op;
+	uint32_t store_op;
+	uint32_t stencil_load_op;
+	uint32_t stencil_store_op;
+} WgvkAttachmentInfo;
+
 struct VkRenderPass_T {
 	struct WgvkObject base;
 	VkDevice device;
 	uint32_t attachment_count;
+	WgvkAttachmentInfo attachments[WGVK_MAX_COLOR_ATTACHMENTS + 1];
+	struct WgvkRenderPassInfo *subpass_info; /* see commands/subpass.h */
 	uint32_t color_formats[WGVK_MAX_COLOR_ATTACHMENTS];
-	uint32_t depth_stencil_format;
 	uint32_t depth_stencil_index;
 	uint32_t sample_count;
 };
@@ -173,6 +308,14 @@ struct VkCommandPool_T {
 	uint32_t queue_family_index;
 };
 
+/* Dynamic state a command buffer has recorded. */
+enum WgvkDynamicStateBit {
+	WGVK_DYNAMIC_VIEWPORT = 1u << 0,
+	WGVK_DYNAMIC_SCISSOR = 1u << 1,
+	WGVK_DYNAMIC_BLEND_CONSTANTS = 1u << 2,
+	WGVK_DYNAMIC_STENCIL_REFERENCE = 1u << 3,
+};
+
 struct VkCommandBuffer_T {
 	struct WgvkObject base;
 	VkDevice device;
@@ -184,6 +327,7 @@ struct VkCommandBuffer_T {
 	VkBool32 recording;
 	VkBool32 in_render_pass;
 	VkBool32 in_compute_pass;
+	WgvkTraceSpan pass_span; /* open from render pass or rendering begin to end */
 	uint32_t push_constant_offset;
 
 	VkPipeline bound_pipeline;
@@ -194,6 +338,22 @@ struct VkCommandBuffer_T {
 	VkDeviceSize bound_index_offset;
 	VkIndexType bound_index_type;
 	VkDescriptorSet bound_descriptor_sets[WGVK_MAX_BIND_GROUPS];
+	uint32_t bound_dynamic_offsets[WGVK_MAX_BIND_GROUPS][WGVK_MAX_DYNAMIC_OFFSETS];
+	uint32_t bound_dynamic_offset_counts[WGVK_MAX_BIND_GROUPS];
+
+	/* Dynamic state, re-applied to every pass encoder the buffer begins. */
+	uint32_t dynamic_state_set; /* WGVK_DYNAMIC_* bits */
+	VkViewport viewport;
+	VkRect2D scissor;
+	float blend_constants[4];
+	uint32_t stencil_reference;
+
+	/* Render pass instance being recorded, for vkCmdNextSubpass. */
+	VkRenderPass active_render_pass;
+	VkFramebuffer active_framebuffer;
+	uint32_t active_subpass;
+	uint32_t clear_value_count;
+	VkClearValue clear_values[WGVK_MAX_COLOR_ATTACHMENTS + 1];
 };
 
 struct VkSemaphore_T {
@@ -215,11 +375,34 @@ struct VkFence_T {
 	VkDevice device;
 	VkBool32 signaled;
 };
+/* One Vulkan binding of a set layout, sorted by binding number. */
+typedef struct {
+	uint32_t binding;
+	uint32_t descriptor_type;
+	uint32_t descriptor_count;
+	uint32_t entry_index; /* first slot in VkDescriptorSet_T::entries */
+	uint32_t first_extra; /* WebGPU binding of element 1, see wgvk_descriptor_wgpu_binding */
+} WgvkDescriptorBinding;
+
+/* WebGPU binding number of @p element of an arrayed binding. */
+static inline uint32_t wgvk_descriptor_wgpu_binding(const WgvkDescriptorBinding *info,
+                                                    uint32_t element) {
+	return element == 0 ? info->binding : info->first_extra + element - 1;
+}
+
 struct VkDescriptorSetLayout_T {
 	struct WgvkObject base;
 	VkDevice device;
-	WGPUBindGroupLayout wgpu_layout;
+	WGPUBindGroupLayout wgpu_layout; /* owned by interned */
+	WgvkCacheEntry *interned;
 	uint32_t binding_count;
+	WgvkDescriptorBinding *bindings;
+	uint32_t entry_count;
+	uint32_t dynamic_offset_count; /* consumed from pDynamicOffsets, binding order */
+	/* For each dynamic WebGPU entry, in WebGPU binding order, the index of
+	 * its offset in the set's Vulkan offsets. The orders differ once an
+	 * arrayed binding's extra elements are numbered past later bindings. */
+	uint8_t dynamic_offset_order[WGVK_MAX_DYNAMIC_OFFSETS];
 };
 
 struct VkDescriptorPool_T {
@@ -232,16 +415,102 @@ struct VkDescriptorSet_T {
 	VkDevice device;
 	VkDescriptorSetLayout layout;
 	WGPUBindGroup wgpu_bind_group;
-	WGPUBindGroupEntry entries[32];
+	WGPUBindGroupEntry *entries; /* one per layout entry */
 	uint32_t entry_count;
+	VkBool32 dirty;
+};
+
+enum WgvkTemplateOpKind {
+	WGVK_TEMPLATE_OP_BUFFER,
+	WGVK_TEMPLATE_OP_SAMPLER,
+	WGVK_TEMPLATE_OP_TEXTURE,
+};
+
+/* One precompiled descriptor copy: read pData + src_offset into entries[entry_index]. */
+typedef struct {
+	size_t src_offset;
+	uint32_t entry_index;
+	uint32_t kind;
+} WgvkTemplateOp;
+
+struct VkDescriptorUpdateTemplate_T {
+	struct WgvkObject base;
+	VkDevice device;
+	uint32_t op_count;
+	WgvkTemplateOp *ops;
 };
 
 struct VkSampler_T {
 	struct WgvkObject base;
 	VkDevice device;
-	WGPUSampler wgpu_sampler;
+	WGPUSampler wgpu_sampler; /* owned by interned */
+	WgvkCacheEntry *interned;
 };
 
+WGPUTextureFormat wgvk_format_to_wgpu(uint32_t vk_format);
+WGPUTextureSampleType wgvk_format_sample_type(uint32_t vk_format);
+VkBool32 wgvk_format_is_color_renderable(uint32_t vk_format);
+VkBool32 wgvk_format_has_depth(uint32_t vk_format);
+VkBool32 wgvk_format_has_stencil(uint32_t vk_format);
+WGPUTextureAspect wgvk_aspect_to_wgpu(VkImageAspectFlags aspect);
+/* The sRGB or linear twin of a format, the only reinterpretation WebGPU allows. */
+WGPUTextureFormat wgvk_format_srgb_pair(WGPUTextureFormat format);
+VkBool32 wgvk_format_feature(uint32_t vk_format, WGPUFeatureName *feature);
+VkBool32 wgvk_format_is_native(VkDevice device, uint32_t vk_format);
+/* Whether devices created from a physical device get an optional feature. */
+VkBool32 wgvk_physical_device_has_feature(VkPhysicalDevice physicalDevice,
+                                          WGPUFeatureName feature);
+
+/* Texel block footprint in buffer copies; 1x1 blocks for uncompressed formats. */
+typedef struct {
+	uint32_t block_size; /* bytes, 0 when the aspect cannot be copied */
+	uint32_t block_width;
+	uint32_t block_height;
+} WgvkFormatBlock;
+
+WgvkFormatBlock wgvk_format_block(uint32_t vk_format, VkImageAspectFlags aspect);
+
+/* Hash of a canonical key, as the hash table expects for its bytes. */
+uint64_t wgvk_hash_words(const uint32_t *key, uint32_t key_words);
+void wgvk_cache_init(WgvkObjectCache *cache, void (*release)(void *object));
+void wgvk_cache_destroy(WgvkObjectCache *cache);
+WgvkCacheEntry *wgvk_cache_acquire(WgvkObjectCache *cache, const uint32_t *key, uint32_t key_words);
+WgvkCacheEntry *wgvk_cache_insert(WgvkObjectCache *cache, const uint32_t *key, uint32_t key_words,
+                                  void *object);
+void wgvk_cache_release(WgvkObjectCache *cache, WgvkCacheEntry *entry);
+
+void wgvk_texture_pool_init(WgvkTexturePool *pool);
+void wgvk_texture_pool_destroy(WgvkTexturePool *pool);
+void wgvk_texture_pool_key(const WGPUTextureDescriptor *desc, uint32_t *key);
+/* Reuse a released texture with the same key, or create one. */
+WGPUTexture wgvk_texture_pool_acquire(VkDevice device, const WGPUTextureDescriptor *desc,
+                                      const uint32_t *key);
+void wgvk_texture_pool_release(WgvkTexturePool *pool, const uint32_t *key, WGPUTexture texture);
+/* Release textures idle for at least max_frames frames; 0 empties the pool. */
+void wgvk_texture_pool_trim(WgvkTexturePool *pool, uint32_t max_frames);
+/* Age the pool by one frame. Each vkQueueSubmit counts as a frame until the
+ * application marks frames itself with wgvkDeviceEndFrame. */
+void wgvk_texture_pool_end_frame(WgvkTexturePool *pool, VkBool32 explicit_frame);
+
+/* Recompile the stage with the arrayed-binding numbers of @p layout into
+ * @p out, owned by the caller. *out is NULL when the module's own
+ * translation already fits. Returns VK_FALSE when recompiling fails. */
+VkBool32 wgvk_shader_module_for_layout(VkShaderModule module, uint32_t exec_model,
+                                       VkPipelineLayout layout, WGPUShaderModule *out);
+
+void wgvk_cmd_rebind_descriptor_sets(VkCommandBuffer cmd, VkPipelineBindPoint bind_point);
+void wgvk_cmd_rebind_vertex_input(VkCommandBuffer cmd);
+
+/* Allocate a zeroed API object of the given type. pAllocator takes
+ * precedence over the parent's allocator; without either, small hot objects
+ * come from slab pools and the rest from calloc. The destroy callback frees
+ * with wgvk_object_free. */
+void *wgvk_object_alloc(size_t size, VkObjectType type, const VkAllocationCallbacks *pAllocator,
+                        const VkAllocationCallbacks *parent);
+void wgvk_object_free(void *obj);
+/* Return slabs with no live objects to the system. */
+void wgvk_object_pools_trim(void);
+
 static inline void *wgvk_alloc(size_t size) {
 	void *ptr = calloc(1, size);
 	return ptr;
@@ -262,4 +531,12 @@ static inline char *wgvk_strdup(const char *str) {
 	return dup;
 }
 
+static inline uint32_t wgvk_div_round_up(uint32_t value, uint32_t divisor) {
+	return (value + divisor - 1) / divisor;
+}
+
+static inline uint64_t wgvk_align_up(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
 #endif
@@ -0,0 +1,200 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include "webvulkan_internal.h"
+
+static VkInstance g_instance;
+static VkPhysicalDevice g_phys_dev;
+static VkDevice g_device;
+
+/* Callbacks that count what they are asked for. */
+typedef struct Tracker {
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t scopes[VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1];
+	size_t max_alignment;
+} Tracker;
+
+static void *tracked_alloc(void *user_data, size_t size, size_t alignment,
+                           VkSystemAllocationScope scope) {
+	Tracker *tracker = user_data;
+	tracker->allocs++;
+	tracker->scopes[scope]++;
+	if (alignment > tracker->max_alignment) {
+		tracker->max_alignment = alignment;
+	}
+	return malloc(size);
+}
+
+static void *tracked_realloc(void *user_data, void *original, size_t size, size_t alignment,
+                             VkSystemAllocationScope scope) {
+	(void)user_data;
+	(void)alignment;
+	(void)scope;
+	return realloc(original, size);
+}
+
+static void tracked_free(void *user_data, void *memory) {
+	Tracker *tracker = user_data;
+	if (memory) {
+		tracker->frees++;
+	}
+	free(memory);
+}
+
+static VkAllocationCallbacks tracker_callbacks(Tracker *tracker) {
+	memset(tracker, 0, sizeof(*tracker));
+	VkAllocationCallbacks callbacks = {
+	    .pUserData = tracker,
+	    .pfnAllocation = tracked_alloc,
+	    .pfnReallocation = tracked_realloc,
+	    .pfnFree = tracked_free,
+	};
+	return callbacks;
+}
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &g_phys_dev) == VK_SUCCESS);
+	g_phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(g_phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static void test_object_callbacks(void) {
+	Tracker tracker;
+	VkAllocationCallbacks callbacks = tracker_callbacks(&tracker);
+
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence fence = NULL;
+	assert(vkCreateFence(g_device, &info, &callbacks, &fence) == VK_SUCCESS);
+	assert(tracker.allocs == 1);
+	assert(tracker.scopes[VK_SYSTEM_ALLOCATION_SCOPE_OBJECT] == 1);
+	assert(tracker.max_alignment >= sizeof(void *));
+	assert(fence->base.allocator && fence->base.allocator->pUserData == &tracker);
+
+	/* The object keeps its own copy, so the caller's struct can go away */
+	memset(&callbacks, 0, sizeof(callbacks));
+	vkDestroyFence(g_device, fence, NULL);
+	assert(tracker.frees == 1);
+	printf("[PASS] test_object_callbacks\n");
+}
+
+static void test_pool_callbacks(void) {
+	Tracker tracker;
+	VkAllocationCallbacks callbacks = tracker_callbacks(&tracker);
+
+	VkCommandPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+	VkCommandPool pool = NULL;
+	assert(vkCreateCommandPool(g_device, &pool_info, &callbacks, &pool) == VK_SUCCESS);
+
+	VkCommandBufferAllocateInfo cmd_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandPool = pool,
+	    .commandBufferCount = 2,
+	};
+	VkCommandBuffer cmds[2] = {NULL, NULL};
+	assert(vkAllocateCommandBuffers(g_device, &cmd_info, cmds) == VK_SUCCESS);
+	/* Command buffers come from their pool's callbacks */
+	assert(tracker.allocs == 3);
+
+	vkFreeCommandBuffers(g_device, pool, 2, cmds);
+	vkDestroyCommandPool(g_device, pool, NULL);
+	assert(tracker.frees == 3);
+	printf("[PASS] test_pool_callbacks\n");
+}
+
+static void test_parent_callbacks(void) {
+	Tracker tracker;
+	VkAllocationCallbacks callbacks = tracker_callbacks(&tracker);
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	VkDevice device = NULL;
+	assert(vkCreateDevice(g_phys_dev, &dev_info, &callbacks, &device) == VK_SUCCESS);
+	assert(tracker.scopes[VK_SYSTEM_ALLOCATION_SCOPE_DEVICE] == 1);
+
+	/* Children created without callbacks fall back to the device's */
+	VkSemaphoreCreateInfo info = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	VkSemaphore semaphore = NULL;
+	assert(vkCreateSemaphore(device, &info, NULL, &semaphore) == VK_SUCCESS);
+	assert(tracker.scopes[VK_SYSTEM_ALLOCATION_SCOPE_OBJECT] == 1);
+
+	vkDestroySemaphore(device, semaphore, NULL);
+	vkDestroyDevice(device, NULL);
+	assert(tracker.frees == tracker.allocs);
+	printf("[PASS] test_parent_callbacks\n");
+}
+
+static void test_instance_scope(void) {
+	Tracker tracker;
+	VkAllocationCallbacks callbacks = tracker_callbacks(&tracker);
+
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	VkInstance instance = NULL;
+	assert(vkCreateInstance(&info, &callbacks, &instance) == VK_SUCCESS);
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(instance, &count, &phys_dev) == VK_SUCCESS);
+	assert(tracker.scopes[VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE] == 2);
+
+	/* The physical device goes with its instance */
+	vkDestroyInstance(instance, NULL);
+	assert(tracker.frees == 2);
+	printf("[PASS] test_instance_scope\n");
+}
+
+static void test_slab_objects(void) {
+	VkFenceCreateInfo signaled = {
+	    .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+	    .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+	};
+	VkFenceCreateInfo unsignaled = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence first = NULL, second = NULL;
+	assert(vkCreateFence(g_device, &signaled, NULL, &first) == VK_SUCCESS);
+	assert(first->base.allocator == NULL);
+	vkDestroyFence(g_device, first, NULL);
+	assert(vkCreateFence(g_device, &unsignaled, NULL, &second) == VK_SUCCESS);
+	/* Reused slots start out zeroed like calloc'd ones */
+	assert(second->signaled == VK_FALSE);
+	vkDestroyFence(g_device, second, NULL);
+
+	/* Enough semaphores to span several slabs */
+	enum { COUNT = 200 };
+	static VkSemaphore semaphores[COUNT];
+	VkSemaphoreCreateInfo info = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	for (uint32_t i = 0; i < COUNT; i++) {
+		assert(vkCreateSemaphore(g_device, &info, NULL, &semaphores[i]) == VK_SUCCESS);
+		assert(semaphores[i]->base.ref_count == 1);
+		for (uint32_t j = 0; j < i; j++) {
+			assert(semaphores[j] != semaphores[i]);
+		}
+	}
+	for (uint32_t i = 0; i < COUNT; i++) {
+		vkDestroySemaphore(g_device, semaphores[i], NULL);
+	}
+	printf("[PASS] test_slab_objects\n");
+}
+
+int main(void) {
+	setup_device();
+	test_object_callbacks();
+	test_pool_callbacks();
+	test_parent_callbacks();
+	test_instance_scope();
+	test_slab_objects();
+	teardown_device();
+	printf("test_alloc: ALL PASSED\n");
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webgpu_recorder.h"
+#include "webvulkan_internal.h"
+#include "commands/blit.h"
+
+/* Captured by webgpu_stubs.c */
+extern WGPURenderPassColorAttachment wgvk_stub_color_attachments[8];
+extern uint32_t wgvk_stub_render_pass_count;
+extern uint32_t wgvk_stub_draw_count;
+extern float wgvk_stub_viewport[4];
+extern uint8_t wgvk_stub_write_data[1024];
+extern size_t wgvk_stub_write_size;
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static VkImage create_image(VkFormat format, uint32_t size, uint32_t mips, uint32_t layers,
+                            VkSampleCountFlagBits samples) {
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = format,
+	    .extent = {size, size, 1},
+	    .mipLevels = mips,
+	    .arrayLayers = layers,
+	    .samples = samples,
+	    .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	};
+	VkImage image = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &image) == VK_SUCCESS);
+	return image;
+}
+
+static VkCommandBuffer begin_command_buffer(void) {
+	VkCommandBufferAllocateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &info, &cmd) == VK_SUCCESS);
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin) == VK_SUCCESS);
+	return cmd;
+}
+
+static VkImageBlit full_blit(uint32_t src_size, uint32_t dst_size) {
+	VkImageBlit blit = {
+	    .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .srcOffsets = {{0, 0, 0}, {(int32_t)src_size, (int32_t)src_size, 1}},
+	    .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .dstOffsets = {{0, 0, 0}, {(int32_t)dst_size, (int32_t)dst_size, 1}},
+	};
+	return blit;
+}
+
+static void test_blit_pipelines_cached(void) {
+	VkImage src = create_image(VK_FORMAT_R8G8B8A8_UNORM, 64, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkImage dst = create_image(VK_FORMAT_R8G8B8A8_UNORM, 32, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkImage hdr = create_image(VK_FORMAT_R16G16B16A16_SFLOAT, 32, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkImageBlit blit = full_blit(64, 32);
+
+	uint32_t passes = wgvk_stub_render_pass_count;
+	uint32_t draws = wgvk_stub_draw_count;
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+	assert(wgvk_stub_render_pass_count == passes + 1);
+	assert(wgvk_stub_draw_count == draws + 1);
+	assert(wgvk_stub_viewport[2] == 32.0f && wgvk_stub_viewport[3] == 32.0f);
+	/* The blit covers the whole level, so the old contents are not loaded. */
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(g_device->blit_state->pipeline_count == 1);
+
+	/* Same destination format and filter: the pipeline is reused. */
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+	assert(g_device->blit_state->pipeline_count == 1);
+
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+	assert(g_device->blit_state->pipeline_count == 2);
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, hdr,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+	assert(g_device->blit_state->pipeline_count == 3);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, src, NULL);
+	vkDestroyImage(g_device, dst, NULL);
+	vkDestroyImage(g_device, hdr, NULL);
+	printf("[PASS] test_blit_pipelines_cached\n");
+}
+
+static void test_blit_mirrored_region(void) {
+	VkImage src = create_image(VK_FORMAT_R8G8B8A8_UNORM, 64, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkImage dst = create_image(VK_FORMAT_R8G8B8A8_UNORM, 64, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+
+	/* Flip horizontally into the top-left quarter of the destination. */
+	VkImageBlit blit = full_blit(64, 32);
+	blit.dstOffsets[0].x = 32;
+	blit.dstOffsets[1].x = 0;
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+	assert(wgvk_stub_viewport[0] == 0.0f && wgvk_stub_viewport[2] == 32.0f);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Load);
+	float rect[4];
+	memcpy(rect, wgvk_stub_write_data, sizeof(rect));
+	assert(rect[0] == 1.0f && rect[2] == 0.0f);
+	assert(rect[1] == 0.0f && rect[3] == 1.0f);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, src, NULL);
+	vkDestroyImage(g_device, dst, NULL);
+	printf("[PASS] test_blit_mirrored_region\n");
+}
+
+static void test_blit_unsupported_format(void) {
+	VkImage src = create_image(VK_FORMAT_R32_UINT, 64, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkImage dst = create_image(VK_FORMAT_R32_UINT, 32, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkImageBlit blit = full_blit(64, 32);
+
+	uint32_t passes = wgvk_stub_render_pass_count;
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+	assert(wgvk_stub_render_pass_count == passes);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, src, NULL);
+	vkDestroyImage(g_device, dst, NULL);
+	printf("[PASS] test_blit_unsupported_format\n");
+}
+
+static void test_generate_mipmaps(void) {
+	VkImage image = create_image(VK_FORMAT_R8G8B8A8_SRGB, 64, 4, 2, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+
+	uint32_t passes = wgvk_stub_render_pass_count;
+	wgvk_rec_begin(0);
+	wgvkCmdGenerateMipmaps(cmd, image, VK_FILTER_LINEAR);
+	wgvk_rec_end();
+	/* Three levels below the base, for each of the two layers. */
+	assert(wgvk_stub_render_pass_count == passes + 6);
+	assert(wgvk_stub_viewport[2] == 8.0f && wgvk_stub_viewport[3] == 8.0f);
+	/* Every level samples the whole level above, a rectangle earlier blits
+	 * already uploaded. */
+	assert(wgvk_rec_count(WGVK_REC_wgpuDeviceCreateBuffer) == 0);
+	assert(wgvk_rec_count(WGVK_REC_wgpuQueueWriteBuffer) == 0);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_generate_mipmaps\n");
+}
+
+static void test_blit_rect_slots(void) {
+	enum { REGIONS = WGVK_BLIT_RECT_SLOTS + 1 };
+	VkImage src = create_image(VK_FORMAT_R8G8B8A8_UNORM, 512, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkImage dst = create_image(VK_FORMAT_R8G8B8A8_UNORM, 64, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+	static VkImageBlit blits[REGIONS];
+	for (uint32_t i = 0; i < REGIONS; i++) {
+		blits[i] = full_blit(64, 64);
+		blits[i].srcOffsets[0].x = (int32_t)i;
+		blits[i].srcOffsets[1].x = (int32_t)i + 64;
+	}
+
+	wgvk_rec_begin(0);
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, REGIONS, blits, VK_FILTER_LINEAR);
+	wgvk_rec_end();
+	/* Each new rectangle is uploaded once; filling the buffer replaces it. */
+	assert(wgvk_rec_count(WGVK_REC_wgpuQueueWriteBuffer) == REGIONS);
+	assert(wgvk_rec_count(WGVK_REC_wgpuDeviceCreateBuffer) == 1);
+	/* One source subresource: a bind group per uniform buffer, not per region. */
+	assert(wgvk_rec_count(WGVK_REC_wgpuDeviceCreateBindGroup) == 2);
+	assert(g_device->blit_state->rect_count <= WGVK_BLIT_RECT_SLOTS);
+
+	/* Blitting the same regions again uploads only what the new buffer lacks. */
+	uint32_t held = g_device->blit_state->rect_count;
+	wgvk_rec_begin(0);
+	vkCmdBlitImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, held, blits + REGIONS - held,
+	               VK_FILTER_LINEAR);
+	wgvk_rec_end();
+	assert(wgvk_rec_count(WGVK_REC_wgpuQueueWriteBuffer) == 0);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, src, NULL);
+	vkDestroyImage(g_device, dst, NULL);
+	printf("[PASS] test_blit_rect_slots\n");
+}
+
+static void test_resolve_image(void) {
+	VkImage msaa = create_image(VK_FORMAT_R8G8B8A8_UNORM, 32, 1, 1, VK_SAMPLE_COUNT_4_BIT);
+	VkImage single = create_image(VK_FORMAT_R8G8B8A8_UNORM, 32, 1, 1, VK_SAMPLE_COUNT_1_BIT);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkImageResolve region = {
+	    .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .extent = {32, 32, 1},
+	};
+
+	uint32_t passes = wgvk_stub_render_pass_count;
+	uint32_t draws = wgvk_stub_draw_count;
+	vkCmdResolveImage(cmd, msaa, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, single,
+	                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_render_pass_count == passes + 1);
+	assert(wgvk_stub_draw_count == draws);
+	assert(wgvk_stub_color_attachments[0].resolveTarget != NULL);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Load);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, msaa, NULL);
+	vkDestroyImage(g_device, single, NULL);
+	printf("[PASS] test_resolve_image\n");
+}
+
+int main(void) {
+	setup_device();
+	test_blit_pipelines_cached();
+	test_blit_mirrored_region();
+	test_blit_unsupported_format();
+	test_generate_mipmaps();
+	test_blit_rect_slots();
+	test_resolve_image();
+	teardown_device();
+	printf("test_blit: ALL PASSED\n");
+	return 0;
+}
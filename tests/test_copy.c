@@ -0,0 +1,385 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webvulkan_internal.h"
+
+/* Captured by webgpu_stubs.c */
+extern WGPUTexelCopyBufferLayout wgvk_stub_copy_layout;
+extern WGPUExtent3D wgvk_stub_copy_size;
+extern uint32_t wgvk_stub_buffer_to_texture_count;
+extern uint32_t wgvk_stub_texture_to_buffer_count;
+extern uint32_t wgvk_stub_texture_to_texture_count;
+extern uint32_t wgvk_stub_dispatch_count;
+extern WGPUBindGroupEntry wgvk_stub_bind_group_entries[8];
+extern uint8_t wgvk_stub_write_data[1024];
+extern WGPUFeatureName wgvk_stub_features[8];
+extern uint32_t wgvk_stub_feature_count;
+
+static VkInstance g_instance;
+static VkPhysicalDevice g_phys_dev;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &g_phys_dev) == VK_SUCCESS);
+	g_phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	/* BC is native; ETC2 and ASTC are not. */
+	wgvk_stub_features[0] = WGPUFeatureName_TextureCompressionBC;
+	wgvk_stub_feature_count = 1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(g_phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static VkImage create_image(VkFormat format, uint32_t size) {
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = format,
+	    .extent = {size, size, 1},
+	    .mipLevels = 1,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	};
+	VkImage image = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &image) == VK_SUCCESS);
+	return image;
+}
+
+static VkBuffer create_buffer(VkDeviceSize size) {
+	VkBufferCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = size,
+	    .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	};
+	VkBuffer buffer = NULL;
+	assert(vkCreateBuffer(g_device, &info, NULL, &buffer) == VK_SUCCESS);
+	return buffer;
+}
+
+static VkCommandBuffer begin_command_buffer(void) {
+	VkCommandBufferAllocateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &info, &cmd) == VK_SUCCESS);
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin) == VK_SUCCESS);
+	return cmd;
+}
+
+static VkBufferImageCopy full_region(uint32_t size, uint32_t row_length) {
+	VkBufferImageCopy region = {
+	    .bufferRowLength = row_length,
+	    .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .imageExtent = {size, size, 1},
+	};
+	return region;
+}
+
+static void test_format_blocks(void) {
+	WgvkFormatBlock r8 = wgvk_format_block(VK_FORMAT_R8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+	assert(r8.block_size == 1 && r8.block_width == 1 && r8.block_height == 1);
+	WgvkFormatBlock rgba16f =
+	    wgvk_format_block(VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT);
+	assert(rgba16f.block_size == 8);
+	WgvkFormatBlock bc1 = wgvk_format_block(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_IMAGE_ASPECT_COLOR_BIT);
+	assert(bc1.block_size == 8 && bc1.block_width == 4 && bc1.block_height == 4);
+	WgvkFormatBlock stencil =
+	    wgvk_format_block(VK_FORMAT_D32_SFLOAT_S8_UINT, VK_IMAGE_ASPECT_STENCIL_BIT);
+	assert(stencil.block_size == 1);
+	printf("[PASS] test_format_blocks\n");
+}
+
+static void test_aligned_upload_is_direct(void) {
+	/* 64 RGBA16F texels make a 512-byte row, already WebGPU-aligned. */
+	VkImage image = create_image(VK_FORMAT_R16G16B16A16_SFLOAT, 64);
+	VkBuffer buffer = create_buffer(512 * 64);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(64, 0);
+
+	uint32_t copies = wgvk_stub_buffer_to_texture_count;
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_buffer_to_texture_count == copies + 1);
+	assert(wgvk_stub_dispatch_count == dispatches);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 512);
+	assert(wgvk_stub_copy_layout.rowsPerImage == 64);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_aligned_upload_is_direct\n");
+}
+
+static void test_unaligned_upload_is_repacked(void) {
+	/* 100-byte R8 rows must be repitched to 256 bytes before the copy. */
+	VkImage image = create_image(VK_FORMAT_R8_UNORM, 100);
+	VkBuffer buffer = create_buffer(100 * 100);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(100, 0);
+
+	uint32_t copies = wgvk_stub_buffer_to_texture_count;
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_dispatch_count == dispatches + 1);
+	assert(wgvk_stub_buffer_to_texture_count == copies + 1);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 256);
+	assert(wgvk_stub_copy_layout.offset == 0);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_unaligned_upload_is_repacked\n");
+}
+
+static void test_single_row_strides_undefined(void) {
+	/* One 100-byte row: no pitch to align, so it is copied directly. */
+	VkImage image = create_image(VK_FORMAT_R8_UNORM, 100);
+	VkBuffer buffer = create_buffer(100);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(100, 0);
+	region.imageExtent.height = 1;
+
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_dispatch_count == dispatches);
+	assert(wgvk_stub_copy_layout.bytesPerRow == WGPU_COPY_STRIDE_UNDEFINED);
+	assert(wgvk_stub_copy_layout.rowsPerImage == WGPU_COPY_STRIDE_UNDEFINED);
+
+	vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+	assert(wgvk_stub_dispatch_count == dispatches);
+	assert(wgvk_stub_copy_layout.bytesPerRow == WGPU_COPY_STRIDE_UNDEFINED);
+	assert(wgvk_stub_copy_layout.rowsPerImage == WGPU_COPY_STRIDE_UNDEFINED);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_single_row_strides_undefined\n");
+}
+
+static void test_repack_binds_region(void) {
+	/* Ten 100-byte rows at byte 1001 of a much larger buffer. */
+	VkImage image = create_image(VK_FORMAT_R8_UNORM, 100);
+	VkBuffer buffer = create_buffer(64 * 1024);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(100, 0);
+	region.bufferOffset = 1001;
+	region.imageExtent.height = 10;
+
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_dispatch_count == dispatches + 1);
+	WGPUBindGroupEntry src = wgvk_stub_bind_group_entries[0];
+	assert(src.buffer == buffer->wgpu_buffer);
+	assert(src.offset == 768);
+	assert(src.offset + src.size >= 1001 + 1000 && src.size % 4 == 0);
+	assert(src.size < 2048);
+	/* The shader's source offset is relative to the binding. */
+	uint32_t params[8];
+	memcpy(params, wgvk_stub_write_data, sizeof(params));
+	assert(params[0] == 1001 - 768 && params[1] == 100);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_repack_binds_region\n");
+}
+
+static void test_compressed_row_pitch(void) {
+	/* A 256-texel BC1 row length is 64 blocks of 8 bytes; 64 rows of texels
+	 * are 16 block rows. */
+	VkImage image = create_image(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 64);
+	VkBuffer buffer = create_buffer(512 * 16);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(64, 256);
+
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 512);
+	assert(wgvk_stub_copy_layout.rowsPerImage == 16);
+	assert(wgvk_stub_copy_size.width == 64);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_compressed_row_pitch\n");
+}
+
+static void test_transcoded_upload(void) {
+	/* Without the ETC2 feature, blocks decode to RGBA8 texels: 16 texels of
+	 * 4 bytes per row, 64 rows, in one dispatch and one copy. */
+	VkImage image = create_image(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, 64);
+	assert(image->transcoded && image->wgpu_format == WGPUTextureFormat_RGBA8Unorm);
+	VkImage native = create_image(VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 64);
+	assert(!native->transcoded && native->wgpu_format == WGPUTextureFormat_BC1RGBAUnorm);
+	VkBuffer buffer = create_buffer(16 * 8 * 16);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(64, 0);
+
+	uint32_t copies = wgvk_stub_buffer_to_texture_count;
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_dispatch_count == dispatches + 1);
+	assert(wgvk_stub_buffer_to_texture_count == copies + 1);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 256);
+	assert(wgvk_stub_copy_layout.rowsPerImage == 64);
+	assert(wgvk_stub_copy_size.width == 64 && wgvk_stub_copy_size.height == 64);
+
+	/* Decoded texels cannot be read back as blocks. */
+	copies = wgvk_stub_texture_to_buffer_count;
+	vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+	assert(wgvk_stub_texture_to_buffer_count == copies);
+
+	/* ASTC has no decoder. */
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+	    .extent = {64, 64, 1},
+	    .mipLevels = 1,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+	};
+	VkImage astc = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &astc) == VK_ERROR_FORMAT_NOT_SUPPORTED);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, native, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_transcoded_upload\n");
+}
+
+static void test_format_properties(void) {
+	VkPhysicalDeviceFeatures features;
+	vkGetPhysicalDeviceFeatures(g_phys_dev, &features);
+	assert(features.textureCompressionBC);
+	assert(!features.textureCompressionETC2 && !features.textureCompressionASTC_LDR);
+	/* The same caps the device was created with. */
+	assert(features.textureCompressionBC == g_device->texture_compression_bc);
+	assert(features.textureCompressionETC2 == g_device->texture_compression_etc2);
+	assert(features.textureCompressionASTC_LDR == g_device->texture_compression_astc);
+
+	VkFormatProperties props;
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_BC1_RGBA_UNORM_BLOCK, &props);
+	assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_SRC_BIT);
+	assert(!(props.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT));
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, &props);
+	assert(props.optimalTilingFeatures ==
+	       (VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT |
+	        VK_FORMAT_FEATURE_TRANSFER_DST_BIT));
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &props);
+	assert(props.optimalTilingFeatures == 0);
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_R8G8B8A8_UNORM, &props);
+	assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT);
+	assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_R32_UINT, &props);
+	assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT);
+	assert(!(props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT));
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_D32_SFLOAT, &props);
+	assert(props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	assert(!(props.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT));
+
+	vkGetPhysicalDeviceFormatProperties(g_phys_dev, VK_FORMAT_UNDEFINED, &props);
+	assert(props.optimalTilingFeatures == 0);
+	printf("[PASS] test_format_properties\n");
+}
+
+static void test_unaligned_download(void) {
+	VkImage image = create_image(VK_FORMAT_R8G8B8A8_UNORM, 16);
+	VkBuffer buffer = create_buffer(64 * 16 + 3);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkBufferImageCopy region = full_region(16, 0);
+
+	/* Word-aligned rows go through staging and the repitch shader. */
+	uint32_t copies = wgvk_stub_texture_to_buffer_count;
+	uint32_t dispatches = wgvk_stub_dispatch_count;
+	vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+	assert(wgvk_stub_texture_to_buffer_count == copies + 1);
+	assert(wgvk_stub_dispatch_count == dispatches + 1);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 256);
+
+	/* A byte offset defeats word stores, so every row is copied alone. */
+	region.bufferOffset = 3;
+	copies = wgvk_stub_texture_to_buffer_count;
+	vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+	assert(wgvk_stub_texture_to_buffer_count == copies + 16);
+	assert(wgvk_stub_copy_layout.offset == 3 + 15 * 64);
+	assert(wgvk_stub_copy_layout.bytesPerRow == WGPU_COPY_STRIDE_UNDEFINED);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_unaligned_download\n");
+}
+
+static void test_copy_image(void) {
+	VkImage src = create_image(VK_FORMAT_R8G8B8A8_UNORM, 32);
+	VkImage dst = create_image(VK_FORMAT_R8G8B8A8_SRGB, 32);
+	VkImage uint_dst = create_image(VK_FORMAT_R32_UINT, 32);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkImageCopy region = {
+	    .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+	    .dstOffset = {8, 8, 0},
+	    .extent = {16, 16, 1},
+	};
+
+	/* sRGB variants copy directly. */
+	uint32_t copies = wgvk_stub_texture_to_texture_count;
+	vkCmdCopyImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_texture_to_texture_count == copies + 1);
+	assert(wgvk_stub_copy_size.width == 16 && wgvk_stub_copy_size.height == 16);
+
+	/* Size-compatible formats go through a buffer. */
+	uint32_t uploads = wgvk_stub_buffer_to_texture_count;
+	vkCmdCopyImage(cmd, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, uint_dst,
+	               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	assert(wgvk_stub_texture_to_texture_count == copies + 1);
+	assert(wgvk_stub_buffer_to_texture_count == uploads + 1);
+	assert(wgvk_stub_copy_layout.bytesPerRow == 256);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImage(g_device, src, NULL);
+	vkDestroyImage(g_device, dst, NULL);
+	vkDestroyImage(g_device, uint_dst, NULL);
+	printf("[PASS] test_copy_image\n");
+}
+
+int main(void) {
+	setup_device();
+	test_format_blocks();
+	test_aligned_upload_is_direct();
+	test_unaligned_upload_is_repacked();
+	test_single_row_strides_undefined();
+	test_repack_binds_region();
+	test_compressed_row_pitch();
+	test_transcoded_upload();
+	test_format_properties();
+	test_unaligned_download();
+	test_copy_image();
+	teardown_device();
+	printf("test_copy: ALL PASSED\n");
+	return 0;
+}
@@ -0,0 +1,567 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vulkan/vulkan.h>
+#include "webvulkan_internal.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static VkDescriptorSetLayout create_dynamic_layout(void) {
+	/* Declared out of order on purpose: offsets follow binding numbers. */
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 2,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 3,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &info, NULL, &layout) == VK_SUCCESS);
+	return layout;
+}
+
+static void test_layout_counts_dynamic_offsets(void) {
+	VkDescriptorSetLayout layout = create_dynamic_layout();
+	assert(layout->dynamic_offset_count == 2);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+
+	/* More dynamic offsets than a bound set can hold are rejected up front */
+	VkDescriptorSetLayoutBinding binding = {
+	    .binding = 0,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	    .descriptorCount = WGVK_MAX_DYNAMIC_OFFSETS + 1,
+	    .stageFlags = VK_SHADER_STAGE_ALL,
+	};
+	VkDescriptorSetLayoutCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 1,
+	    .pBindings = &binding,
+	};
+	layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &info, NULL, &layout) ==
+	       VK_ERROR_INITIALIZATION_FAILED);
+	assert(layout == NULL);
+	printf("[PASS] test_layout_counts_dynamic_offsets\n");
+}
+
+static void test_bind_slices_dynamic_offsets(void) {
+	VkDescriptorSetLayout layouts[2] = {create_dynamic_layout(), create_dynamic_layout()};
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 2,
+	    .pSetLayouts = layouts,
+	};
+	VkDescriptorSet sets[2] = {NULL, NULL};
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, sets) == VK_SUCCESS);
+
+	VkCommandBufferAllocateInfo cmd_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &cmd_info, &cmd) == VK_SUCCESS);
+
+	const uint32_t offsets[4] = {256, 512, 768, 1024};
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, NULL, 1, 2, sets, 4, offsets);
+
+	assert(cmd->bound_descriptor_sets[1] == sets[0]);
+	assert(cmd->bound_descriptor_sets[2] == sets[1]);
+	assert(cmd->bound_dynamic_offset_counts[0] == 0);
+	assert(cmd->bound_dynamic_offset_counts[1] == 2);
+	assert(cmd->bound_dynamic_offsets[1][0] == 256);
+	assert(cmd->bound_dynamic_offsets[1][1] == 512);
+	assert(cmd->bound_dynamic_offset_counts[2] == 2);
+	assert(cmd->bound_dynamic_offsets[2][0] == 768);
+	assert(cmd->bound_dynamic_offsets[2][1] == 1024);
+
+	/* Too few offsets: the set takes only what is left. */
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, NULL, 0, 1, sets, 1, offsets);
+	assert(cmd->bound_dynamic_offset_counts[0] == 1);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkFreeDescriptorSets(g_device, pool, 2, sets);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layouts[0], NULL);
+	vkDestroyDescriptorSetLayout(g_device, layouts[1], NULL);
+	printf("[PASS] test_bind_slices_dynamic_offsets\n");
+}
+
+static void test_update_with_template(void) {
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 2,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &layout_info, NULL, &layout) == VK_SUCCESS);
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkDescriptorSet set = NULL;
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, &set) == VK_SUCCESS);
+
+	VkBufferCreateInfo buf_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 1024,
+	    .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	};
+	VkBuffer buffer = NULL;
+	assert(vkCreateBuffer(g_device, &buf_info, NULL, &buffer) == VK_SUCCESS);
+
+	VkSamplerCreateInfo sampler_info = {.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+	VkSampler sampler = NULL;
+	assert(vkCreateSampler(g_device, &sampler_info, NULL, &sampler) == VK_SUCCESS);
+
+	/* The app's own record layout; the template describes where each field lives. */
+	struct {
+		uint32_t padding;
+		VkDescriptorImageInfo sampler;
+		VkDescriptorBufferInfo ubo;
+	} data = {
+	    .sampler = {.sampler = sampler},
+	    .ubo = {.buffer = buffer, .offset = 256, .range = VK_WHOLE_SIZE},
+	};
+
+	VkDescriptorUpdateTemplateEntry entries[] = {
+	    {.dstBinding = 0,
+	     .descriptorCount = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .offset = offsetof(__typeof__(data), ubo),
+	     .stride = sizeof(VkDescriptorBufferInfo)},
+	    {.dstBinding = 1,
+	     .descriptorCount = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+	     .offset = offsetof(__typeof__(data), sampler),
+	     .stride = sizeof(VkDescriptorImageInfo)},
+	};
+	VkDescriptorUpdateTemplateCreateInfo tmpl_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+	    .descriptorUpdateEntryCount = 2,
+	    .pDescriptorUpdateEntries = entries,
+	    .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+	    .descriptorSetLayout = layout,
+	};
+	VkDescriptorUpdateTemplate tmpl = NULL;
+	assert(vkCreateDescriptorUpdateTemplate(g_device, &tmpl_info, NULL, &tmpl) == VK_SUCCESS);
+	assert(tmpl->op_count == 2);
+
+	vkUpdateDescriptorSetWithTemplate(g_device, set, tmpl, &data);
+	assert(set->entry_count == 2);
+	assert(set->entries[0].binding == 0);
+	assert(set->entries[0].buffer == buffer->wgpu_buffer);
+	assert(set->entries[0].offset == 256);
+	assert(set->entries[0].size == 768);
+	assert(set->entries[1].binding == 1);
+	assert(set->entries[1].sampler == sampler->wgpu_sampler);
+	assert(set->wgpu_bind_group != NULL);
+
+	vkDestroyDescriptorUpdateTemplate(g_device, tmpl, NULL);
+	vkDestroySampler(g_device, sampler, NULL);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkFreeDescriptorSets(g_device, pool, 1, &set);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+	printf("[PASS] test_update_with_template\n");
+}
+
+static void test_arrayed_binding_flattens(void) {
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 8,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+	     .descriptorCount = 8,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 2,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &layout_info, NULL, &layout) == VK_SUCCESS);
+	assert(layout->entry_count == 9);
+	assert(layout->binding_count == 2);
+	assert(layout->bindings[1].binding == 8);
+	assert(layout->bindings[1].entry_index == 8);
+	assert(layout->bindings[0].first_extra == 9);
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkDescriptorSet set = NULL;
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, &set) == VK_SUCCESS);
+	/* Element 0 keeps binding 0, elements 1..7 follow binding 8 */
+	assert(set->entries[0].binding == 0);
+	for (uint32_t i = 1; i < 8; i++) {
+		assert(set->entries[i].binding == 8 + i);
+	}
+	assert(set->entries[8].binding == 8);
+
+	VkBufferCreateInfo buf_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 256,
+	    .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	};
+	VkBuffer buffer = NULL;
+	assert(vkCreateBuffer(g_device, &buf_info, NULL, &buffer) == VK_SUCCESS);
+
+	/* Only the UBO is written: the image array is partially bound. */
+	VkDescriptorBufferInfo ubo = {.buffer = buffer, .range = VK_WHOLE_SIZE};
+	VkWriteDescriptorSet write = {
+	    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	    .dstSet = set,
+	    .dstBinding = 8,
+	    .descriptorCount = 1,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	    .pBufferInfo = &ubo,
+	};
+	vkUpdateDescriptorSets(g_device, 1, &write, 0, NULL);
+	assert(set->entries[8].buffer == buffer->wgpu_buffer);
+	assert(set->entries[3].textureView == g_device->placeholder_views[WGVK_PLACEHOLDER_SAMPLED_2D]);
+	assert(set->wgpu_bind_group != NULL);
+
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkFreeDescriptorSets(g_device, pool, 1, &set);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+	printf("[PASS] test_arrayed_binding_flattens\n");
+}
+
+/* A plain binding inside the range an array would cover if flattened in
+ * place, which Vulkan allows. */
+static void test_array_next_to_plain_binding(void) {
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+	     .descriptorCount = 4,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 2,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &layout_info, NULL, &layout) == VK_SUCCESS);
+	assert(layout->entry_count == 5);
+	assert(layout->bindings[0].first_extra == 2);
+	assert(layout->bindings[1].entry_index == 4);
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkDescriptorSet set = NULL;
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, &set) == VK_SUCCESS);
+	const uint32_t expected[] = {0, 2, 3, 4, 1};
+	for (uint32_t i = 0; i < 5; i++) {
+		assert(set->entries[i].binding == expected[i]);
+	}
+
+	VkBufferCreateInfo buf_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 256,
+	    .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	};
+	VkBuffer buffer = NULL;
+	assert(vkCreateBuffer(g_device, &buf_info, NULL, &buffer) == VK_SUCCESS);
+	VkDescriptorBufferInfo ubo = {.buffer = buffer, .range = VK_WHOLE_SIZE};
+	VkWriteDescriptorSet write = {
+	    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	    .dstSet = set,
+	    .dstBinding = 1,
+	    .descriptorCount = 1,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+	    .pBufferInfo = &ubo,
+	};
+	vkUpdateDescriptorSets(g_device, 1, &write, 0, NULL);
+	assert(set->entries[4].buffer == buffer->wgpu_buffer);
+	assert(set->wgpu_bind_group != NULL);
+
+	/* Pipeline layouts hand the same numbers to the WGSL generator */
+	VkPipelineLayoutCreateInfo pl_info = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	    .setLayoutCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkPipelineLayout pipeline_layout = NULL;
+	assert(vkCreatePipelineLayout(g_device, &pl_info, NULL, &pipeline_layout) == VK_SUCCESS);
+	assert(pipeline_layout->set_layouts[0]->bindings[0].first_extra == 2);
+
+	vkDestroyPipelineLayout(g_device, pipeline_layout, NULL);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkFreeDescriptorSets(g_device, pool, 1, &set);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+	printf("[PASS] test_array_next_to_plain_binding\n");
+}
+
+/* b0[1] is numbered past b1, so WebGPU wants b0[1]'s offset last while
+ * Vulkan passes it second. */
+static void test_arrayed_dynamic_offsets_reordered(void) {
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+	     .descriptorCount = 2,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 2,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &layout_info, NULL, &layout) == VK_SUCCESS);
+	assert(layout->dynamic_offset_count == 3);
+	assert(layout->bindings[0].first_extra == 2);
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkDescriptorSet set = NULL;
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, &set) == VK_SUCCESS);
+
+	VkCommandBufferAllocateInfo cmd_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &cmd_info, &cmd) == VK_SUCCESS);
+
+	/* Vulkan order: b0[0], b0[1], b1. WebGPU order: b0[0], b1, b0[1]. */
+	const uint32_t offsets[3] = {256, 512, 768};
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, NULL, 0, 1, &set, 3, offsets);
+	assert(cmd->bound_dynamic_offset_counts[0] == 3);
+	assert(cmd->bound_dynamic_offsets[0][0] == 256);
+	assert(cmd->bound_dynamic_offsets[0][1] == 768);
+	assert(cmd->bound_dynamic_offsets[0][2] == 512);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkFreeDescriptorSets(g_device, pool, 1, &set);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+	printf("[PASS] test_arrayed_dynamic_offsets_reordered\n");
+}
+
+static void test_storage_and_texel_placeholders(void) {
+	VkDescriptorSetLayoutBinding bindings[] = {
+	    {.binding = 0,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+	     .descriptorCount = 2,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 1,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	    {.binding = 2,
+	     .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
+	     .descriptorCount = 1,
+	     .stageFlags = VK_SHADER_STAGE_ALL},
+	};
+	VkDescriptorSetLayoutCreateInfo layout_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 3,
+	    .pBindings = bindings,
+	};
+	VkDescriptorSetLayout layout = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &layout_info, NULL, &layout) == VK_SUCCESS);
+
+	VkDescriptorPoolCreateInfo pool_info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+	VkDescriptorPool pool = NULL;
+	assert(vkCreateDescriptorPool(g_device, &pool_info, NULL, &pool) == VK_SUCCESS);
+	VkDescriptorSetAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+	    .descriptorPool = pool,
+	    .descriptorSetCount = 1,
+	    .pSetLayouts = &layout,
+	};
+	VkDescriptorSet set = NULL;
+	assert(vkAllocateDescriptorSets(g_device, &alloc_info, &set) == VK_SUCCESS);
+
+	/* Only the first storage image is written; the rest get stand-ins. */
+	VkImageViewCreateInfo view_info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	    .viewType = VK_IMAGE_VIEW_TYPE_2D,
+	    .format = VK_FORMAT_R8G8B8A8_UNORM,
+	};
+	VkImageView view = NULL;
+	assert(vkCreateImageView(g_device, &view_info, NULL, &view) == VK_SUCCESS);
+	view->wgpu_view = (WGPUTextureView)(uintptr_t)0x900;
+	VkDescriptorImageInfo image = {.imageView = view, .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+	VkWriteDescriptorSet write = {
+	    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	    .dstSet = set,
+	    .dstBinding = 0,
+	    .descriptorCount = 1,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+	    .pImageInfo = &image,
+	};
+	vkUpdateDescriptorSets(g_device, 1, &write, 0, NULL);
+	assert(set->entries[0].textureView == (WGPUTextureView)(uintptr_t)0x900);
+	assert(set->entries[1].textureView ==
+	       g_device->placeholder_views[WGVK_PLACEHOLDER_STORAGE_2D]);
+	assert(set->entries[2].textureView ==
+	       g_device->placeholder_views[WGVK_PLACEHOLDER_SAMPLED_1D]);
+	assert(set->entries[3].textureView ==
+	       g_device->placeholder_views[WGVK_PLACEHOLDER_STORAGE_1D]);
+	assert(g_device->placeholder_views[WGVK_PLACEHOLDER_STORAGE_1D] != NULL);
+	assert(set->wgpu_bind_group != NULL);
+
+	vkFreeDescriptorSets(g_device, pool, 1, &set);
+	vkDestroyImageView(g_device, view, NULL);
+	vkDestroyDescriptorPool(g_device, pool, NULL);
+	vkDestroyDescriptorSetLayout(g_device, layout, NULL);
+	printf("[PASS] test_storage_and_texel_placeholders\n");
+}
+
+static void test_identical_layouts_share_wgpu_objects(void) {
+	VkDescriptorSetLayout a = create_dynamic_layout();
+	VkDescriptorSetLayout b = create_dynamic_layout();
+	assert(a != b);
+	assert(a->interned == b->interned);
+	assert(a->interned->ref_count == 2);
+
+	VkDescriptorSetLayoutBinding other_binding = {
+	    .binding = 0,
+	    .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+	    .descriptorCount = 1,
+	    .stageFlags = VK_SHADER_STAGE_ALL,
+	};
+	VkDescriptorSetLayoutCreateInfo other_info = {
+	    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+	    .bindingCount = 1,
+	    .pBindings = &other_binding,
+	};
+	VkDescriptorSetLayout c = NULL;
+	assert(vkCreateDescriptorSetLayout(g_device, &other_info, NULL, &c) == VK_SUCCESS);
+	assert(c->interned != a->interned);
+
+	VkPipelineLayoutCreateInfo pl_info = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+	    .setLayoutCount = 1,
+	    .pSetLayouts = &a,
+	};
+	VkPipelineLayout pl_a = NULL;
+	VkPipelineLayout pl_b = NULL;
+	VkPipelineLayout pl_c = NULL;
+	assert(vkCreatePipelineLayout(g_device, &pl_info, NULL, &pl_a) == VK_SUCCESS);
+	pl_info.pSetLayouts = &b;
+	assert(vkCreatePipelineLayout(g_device, &pl_info, NULL, &pl_b) == VK_SUCCESS);
+	pl_info.pSetLayouts = &c;
+	assert(vkCreatePipelineLayout(g_device, &pl_info, NULL, &pl_c) == VK_SUCCESS);
+	assert(pl_a->interned == pl_b->interned);
+	assert(pl_a->interned != pl_c->interned);
+
+	vkDestroyPipelineLayout(g_device, pl_a, NULL);
+	assert(pl_b->interned->ref_count == 1);
+	vkDestroyPipelineLayout(g_device, pl_b, NULL);
+	vkDestroyPipelineLayout(g_device, pl_c, NULL);
+	assert(g_device->pipeline_layout_cache.entry_count == 0);
+
+	vkDestroyDescriptorSetLayout(g_device, a, NULL);
+	assert(b->interned->ref_count == 1);
+	vkDestroyDescriptorSetLayout(g_device, b, NULL);
+	vkDestroyDescriptorSetLayout(g_device, c, NULL);
+	assert(g_device->bind_group_layout_cache.entry_count == 0);
+	printf("[PASS] test_identical_layouts_share_wgpu_objects\n");
+}
+
+int main(void) {
+	setup_device();
+	test_layout_counts_dynamic_offsets();
+	test_bind_slices_dynamic_offsets();
+	test_update_with_template();
+	test_arrayed_binding_flattens();
+	test_array_next_to_plain_binding();
+	test_arrayed_dynamic_offsets_reordered();
+	test_storage_and_texel_placeholders();
+	test_identical_layouts_share_wgpu_objects();
+	teardown_device();
+	printf("test_descriptor: ALL PASSED\n");
+	return 0;
+}
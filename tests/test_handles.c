@@ -0,0 +1,231 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include "webvulkan.h"
+#include "webvulkan_internal.h"
+#include "util/handle_table.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static void test_table_basics(void) {
+	static WgvkHandleTable table;
+	int a = 0, b = 0;
+
+	uint32_t ha = wgvk_handle_alloc(&table, &a);
+	uint32_t hb = wgvk_handle_alloc(&table, &b);
+	assert(ha && hb && ha != hb);
+	assert(wgvk_handle_lookup(&table, ha) == &a);
+	assert(wgvk_handle_lookup(&table, hb) == &b);
+	assert(wgvk_handle_lookup(&table, 0) == NULL);
+	assert(table.live == 2);
+
+	assert(wgvk_handle_free(&table, ha) == 1);
+	assert(wgvk_handle_lookup(&table, ha) == NULL);
+	/* Freeing twice is reported, not corrupting */
+	assert(wgvk_handle_free(&table, ha) == 0);
+	assert(table.live == 1);
+
+	/* The slot is reused under a new generation */
+	uint32_t hc = wgvk_handle_alloc(&table, &a);
+	assert(wgvk_handle_index(hc) == wgvk_handle_index(ha));
+	assert(hc != ha);
+	assert(wgvk_handle_lookup(&table, ha) == NULL);
+	assert(wgvk_handle_lookup(&table, hc) == &a);
+
+	wgvk_handle_table_destroy(&table);
+	assert(wgvk_handle_lookup(&table, hb) == NULL);
+	printf("[PASS] test_table_basics\n");
+}
+
+static void test_table_pages(void) {
+	static WgvkHandleTable table;
+	enum { COUNT = WGVK_HANDLE_PAGE_SLOTS * 3 };
+	static uint32_t handles[COUNT];
+	static int values[COUNT];
+
+	for (uint32_t i = 0; i < COUNT; i++) {
+		handles[i] = wgvk_handle_alloc(&table, &values[i]);
+		/* Fresh slots are handed out densely */
+		assert(wgvk_handle_index(handles[i]) == i);
+	}
+	for (uint32_t i = 0; i < COUNT; i++) {
+		assert(wgvk_handle_lookup(&table, handles[i]) == &values[i]);
+	}
+	for (uint32_t i = 0; i < COUNT; i += 2) {
+		assert(wgvk_handle_free(&table, handles[i]));
+	}
+	for (uint32_t i = 0; i < COUNT; i++) {
+		assert(wgvk_handle_lookup(&table, handles[i]) == (i % 2 ? &values[i] : NULL));
+	}
+	/* Freed slots are refilled before the table grows */
+	for (uint32_t i = 0; i < COUNT / 2; i++) {
+		assert(wgvk_handle_index(wgvk_handle_alloc(&table, &values[0])) < COUNT);
+	}
+	assert(table.slot_count == COUNT);
+	wgvk_handle_table_destroy(&table);
+	printf("[PASS] test_table_pages\n");
+}
+
+static void test_generation_wrap(void) {
+	static WgvkHandleTable table;
+	int value = 0;
+	uint32_t first = wgvk_handle_alloc(&table, &value);
+	uint32_t handle = first;
+	for (uint32_t i = 0; i < (1u << WGVK_HANDLE_GENERATION_BITS); i++) {
+		assert(wgvk_handle_free(&table, handle));
+		handle = wgvk_handle_alloc(&table, &value);
+		/* Generation 0 is skipped, so no handle is ever 0 */
+		assert(handle >> WGVK_HANDLE_INDEX_BITS);
+	}
+	/* Generations cycle through 1..4095, so the last free lands one past the first */
+	assert(handle == (((first >> WGVK_HANDLE_INDEX_BITS) + 1) << WGVK_HANDLE_INDEX_BITS));
+	wgvk_handle_table_destroy(&table);
+	printf("[PASS] test_generation_wrap\n");
+}
+
+static void test_object_handles(void) {
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence fence = NULL;
+	assert(vkCreateFence(g_device, &info, NULL, &fence) == VK_SUCCESS);
+
+	uint32_t id = wgvkGetObjectHandle((uint64_t)(uintptr_t)fence);
+	assert(id != 0);
+	assert(wgvkLookupObjectHandle(VK_OBJECT_TYPE_FENCE, id) == (uint64_t)(uintptr_t)fence);
+	/* Each type has its own table */
+	assert(wgvkLookupObjectHandle(VK_OBJECT_TYPE_SEMAPHORE, id) == 0);
+	assert(wgvkGetObjectHandle((uint64_t)(uintptr_t)g_device) != 0);
+
+	vkDestroyFence(g_device, fence, NULL);
+	assert(wgvkLookupObjectHandle(VK_OBJECT_TYPE_FENCE, id) == 0);
+
+	VkFence next = NULL;
+	assert(vkCreateFence(g_device, &info, NULL, &next) == VK_SUCCESS);
+	assert(wgvkGetObjectHandle((uint64_t)(uintptr_t)next) != id);
+	assert(wgvkLookupObjectHandle(VK_OBJECT_TYPE_FENCE, id) == 0);
+	vkDestroyFence(g_device, next, NULL);
+	printf("[PASS] test_object_handles\n");
+}
+
+/* Callbacks that never return memory until the test is done, so a destroyed
+ * object can be touched again without a real use after free. */
+static void *kept[8];
+static uint32_t kept_count;
+
+static void *keep_alloc(void *user_data, size_t size, size_t alignment,
+                        VkSystemAllocationScope scope) {
+	(void)user_data;
+	(void)alignment;
+	(void)scope;
+	return calloc(1, size);
+}
+
+static void *keep_realloc(void *user_data, void *original, size_t size, size_t alignment,
+                          VkSystemAllocationScope scope) {
+	(void)user_data;
+	(void)alignment;
+	(void)scope;
+	return realloc(original, size);
+}
+
+static void keep_free(void *user_data, void *memory) {
+	(void)user_data;
+	assert(kept_count < sizeof(kept) / sizeof(kept[0]));
+	kept[kept_count++] = memory;
+}
+
+static void test_double_destroy(void) {
+	VkAllocationCallbacks callbacks = {
+	    .pfnAllocation = keep_alloc,
+	    .pfnReallocation = keep_realloc,
+	    .pfnFree = keep_free,
+	};
+	VkSemaphoreCreateInfo info = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	VkSemaphore semaphore = NULL;
+	assert(vkCreateSemaphore(g_device, &info, &callbacks, &semaphore) == VK_SUCCESS);
+	assert(wgvk_object_handle_valid(&semaphore->base));
+
+	vkDestroySemaphore(g_device, semaphore, NULL);
+	assert(kept_count == 1);
+	/* The stale handle is caught: nothing is freed a second time */
+	assert(!wgvk_object_handle_valid(&semaphore->base));
+	vkDestroySemaphore(g_device, semaphore, NULL);
+	assert(kept_count == 1);
+
+	for (uint32_t i = 0; i < kept_count; i++) {
+		free(kept[i]);
+	}
+	kept_count = 0;
+	printf("[PASS] test_double_destroy\n");
+}
+
+/* The check only looks up the address, so it is safe on freed memory */
+static void test_check_on_freed_object(void) {
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence fence = NULL;
+	assert(vkCreateFence(g_device, &info, NULL, &fence) == VK_SUCCESS);
+	uint64_t value = (uint64_t)(uintptr_t)fence;
+	vkDestroyFence(g_device, fence, NULL);
+	wgvk_object_pools_trim();
+
+	assert(!wgvk_object_handle_valid((const struct WgvkObject *)(uintptr_t)value));
+	assert(wgvkGetObjectHandle(value) == 0);
+	printf("[PASS] test_check_on_freed_object\n");
+}
+
+/* Pooled types would hand a freed slot straight to the next object; with
+ * the handle table on, the stale pointer must keep failing the check. */
+static void test_stale_pointer_not_reused(void) {
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence first = NULL;
+	assert(vkCreateFence(g_device, &info, NULL, &first) == VK_SUCCESS);
+	uint64_t stale = (uint64_t)(uintptr_t)first;
+	vkDestroyFence(g_device, first, NULL);
+
+	VkFence fences[8];
+	for (uint32_t i = 0; i < 8; i++) {
+		assert(vkCreateFence(g_device, &info, NULL, &fences[i]) == VK_SUCCESS);
+		assert((uint64_t)(uintptr_t)fences[i] != stale);
+	}
+	assert(!wgvk_object_handle_valid((const struct WgvkObject *)(uintptr_t)stale));
+	assert(wgvkGetObjectHandle(stale) == 0);
+	for (uint32_t i = 0; i < 8; i++) {
+		vkDestroyFence(g_device, fences[i], NULL);
+	}
+	printf("[PASS] test_stale_pointer_not_reused\n");
+}
+
+int main(void) {
+	test_table_basics();
+	test_table_pages();
+	test_generation_wrap();
+	setup_device();
+	test_object_handles();
+	test_double_destroy();
+	test_check_on_freed_object();
+	test_stale_pointer_not_reused();
+	teardown_device();
+	printf("test_handles: ALL PASSED\n");
+	return 0;
+}
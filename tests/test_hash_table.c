@@ -0,0 +1,163 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util/hash_table.h"
+
+static void test_hash_bytes(void) {
+	uint8_t data[64];
+	for (uint32_t i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 37 + 1);
+	}
+	/* Every length path gives a stable hash that depends on every byte */
+	for (size_t size = 0; size <= sizeof(data); size++) {
+		uint64_t hash = wgvk_hash_bytes(data, size);
+		assert(hash == wgvk_hash_bytes(data, size));
+		if (size > 0) {
+			assert(hash != wgvk_hash_bytes(data, size - 1));
+			for (size_t i = 0; i < size; i++) {
+				data[i] ^= 0x10;
+				assert(hash != wgvk_hash_bytes(data, size));
+				data[i] ^= 0x10;
+			}
+		}
+	}
+	printf("[PASS] test_hash_bytes\n");
+}
+
+static void test_pointer_keys(void) {
+	WgvkHashTable *table = wgvk_hash_table_create(0);
+	assert(table);
+	int a = 0, b = 0;
+
+	/* NULL and 1 are ordinary keys */
+	wgvk_hash_table_insert(table, NULL, &a);
+	wgvk_hash_table_insert(table, (void *)(uintptr_t)1, &b);
+	assert(wgvk_hash_table_lookup(table, NULL) == &a);
+	assert(wgvk_hash_table_lookup(table, (void *)(uintptr_t)1) == &b);
+	assert(wgvk_hash_table_size(table) == 2);
+
+	wgvk_hash_table_insert(table, NULL, &b);
+	assert(wgvk_hash_table_lookup(table, NULL) == &b);
+	assert(wgvk_hash_table_size(table) == 2);
+
+	wgvk_hash_table_remove(table, NULL);
+	assert(wgvk_hash_table_lookup(table, NULL) == NULL);
+	wgvk_hash_table_remove(table, NULL);
+	assert(wgvk_hash_table_size(table) == 1);
+
+	wgvk_hash_table_destroy(table);
+	assert(wgvk_hash_table_lookup(NULL, &a) == NULL);
+	printf("[PASS] test_pointer_keys\n");
+}
+
+static void test_byte_keys(void) {
+	WgvkHashTable *table = wgvk_hash_table_create(4);
+	assert(table);
+	uint32_t first[4] = {1, 2, 3, 4};
+	uint32_t second[4] = {1, 2, 3, 4};
+	uint32_t other[3] = {1, 2, 3};
+	int a = 0, b = 0;
+
+	assert(wgvk_hash_table_insert_key(table, wgvk_hash_bytes(first, sizeof(first)), first,
+	                                  sizeof(first), &a) == 0);
+	/* Keys compare by content, not by address */
+	assert(wgvk_hash_table_find(table, wgvk_hash_bytes(second, sizeof(second)), second,
+	                            sizeof(second)) == &a);
+	/* A prefix is a different key */
+	assert(wgvk_hash_table_find(table, wgvk_hash_bytes(other, sizeof(other)), other,
+	                            sizeof(other)) == NULL);
+
+	/* Replacing takes the new key pointer, so the old key can go away */
+	assert(wgvk_hash_table_insert_key(table, wgvk_hash_bytes(second, sizeof(second)), second,
+	                                  sizeof(second), &b) == 0);
+	memset(first, 0, sizeof(first));
+	assert(wgvk_hash_table_find(table, wgvk_hash_bytes(second, sizeof(second)), second,
+	                            sizeof(second)) == &b);
+	assert(wgvk_hash_table_size(table) == 1);
+
+	assert(wgvk_hash_table_erase(table, wgvk_hash_bytes(second, sizeof(second)), second,
+	                             sizeof(second)) == &b);
+	assert(wgvk_hash_table_size(table) == 0);
+	wgvk_hash_table_destroy(table);
+	printf("[PASS] test_byte_keys\n");
+}
+
+/* Random inserts and erases checked against a plain array. */
+static void test_against_reference(void) {
+	enum { KEYS = 4096, OPS = 200000 };
+	static uint32_t keys[KEYS][2];
+	static uint8_t present[KEYS];
+	WgvkHashTable *table = wgvk_hash_table_create(0);
+	assert(table);
+
+	for (uint32_t i = 0; i < KEYS; i++) {
+		keys[i][0] = i;
+		keys[i][1] = 0xabcd0000u;
+	}
+
+	uint32_t rng = 12345;
+	size_t live = 0;
+	for (uint32_t op = 0; op < OPS; op++) {
+		rng = rng * 1664525u + 1013904223u;
+		/* Work on a window that slides, so the table both grows and churns */
+		uint32_t window = op < OPS / 2 ? KEYS : KEYS / 8;
+		uint32_t k = (rng >> 8) % window;
+		uint64_t hash = wgvk_hash_bytes(keys[k], sizeof(keys[k]));
+		void *found = wgvk_hash_table_find(table, hash, keys[k], sizeof(keys[k]));
+		assert(found == (present[k] ? keys[k] : NULL));
+		if (rng & 0x80) {
+			assert(wgvk_hash_table_insert_key(table, hash, keys[k], sizeof(keys[k]), keys[k]) == 0);
+			live += !present[k];
+			present[k] = 1;
+		} else {
+			assert(wgvk_hash_table_erase(table, hash, keys[k], sizeof(keys[k])) ==
+			       (present[k] ? keys[k] : NULL));
+			live -= present[k];
+			present[k] = 0;
+		}
+		assert(wgvk_hash_table_size(table) == live);
+	}
+	for (uint32_t k = 0; k < KEYS; k++) {
+		uint64_t hash = wgvk_hash_bytes(keys[k], sizeof(keys[k]));
+		assert(wgvk_hash_table_find(table, hash, keys[k], sizeof(keys[k])) ==
+		       (present[k] ? keys[k] : NULL));
+	}
+	wgvk_hash_table_destroy(table);
+	printf("[PASS] test_against_reference\n");
+}
+
+/* Entries whose hashes all share h2 and the first group. */
+static void test_colliding_hashes(void) {
+	enum { COUNT = 100 };
+	static uint32_t keys[COUNT];
+	WgvkHashTable *table = wgvk_hash_table_create(0);
+	assert(table);
+	for (uint32_t i = 0; i < COUNT; i++) {
+		keys[i] = i;
+		assert(wgvk_hash_table_insert_key(table, 42, &keys[i], sizeof(keys[i]), &keys[i]) == 0);
+	}
+	for (uint32_t i = 0; i < COUNT; i++) {
+		assert(wgvk_hash_table_find(table, 42, &keys[i], sizeof(keys[i])) == &keys[i]);
+	}
+	for (uint32_t i = 0; i < COUNT; i += 2) {
+		assert(wgvk_hash_table_erase(table, 42, &keys[i], sizeof(keys[i])) == &keys[i]);
+	}
+	for (uint32_t i = 0; i < COUNT; i++) {
+		void *expected = i % 2 ? &keys[i] : NULL;
+		assert(wgvk_hash_table_find(table, 42, &keys[i], sizeof(keys[i])) == expected);
+	}
+	wgvk_hash_table_destroy(table);
+	printf("[PASS] test_colliding_hashes\n");
+}
+
+int main(void) {
+	test_hash_bytes();
+	test_pointer_keys();
+	test_byte_keys();
+	test_against_reference();
+	test_colliding_hashes();
+	printf("test_hash_table: ALL PASSED\n");
+	return 0;
+}
@@ -1,6 +1,15 @@
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webvulkan_internal.h"
+
+/* Captured by webgpu_stubs.c */
+extern WGPUTextureViewDescriptor wgvk_stub_view_desc;
+extern uint32_t wgvk_stub_view_count;
+extern uint32_t wgvk_stub_texture_count;
+extern uint32_t wgvk_stub_texture_release_count;
 
 static void test_create_null_device(void) {
 	VkImageCreateInfo info = {0};
@@ -33,11 +42,208 @@ static void test_destroy_null(void) {
 	printf("[PASS] test_destroy_null\n");
 }
 
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static VkImage create_cube_array(void) {
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT | VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = VK_FORMAT_R8G8B8A8_UNORM,
+	    .extent = {64, 64, 1},
+	    .mipLevels = 7,
+	    .arrayLayers = 12,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+	};
+	VkImage image = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &image) == VK_SUCCESS);
+	return image;
+}
+
+static VkImageView create_view(VkImage image, VkImageViewType type, VkFormat format,
+                               uint32_t base_mip, uint32_t mips, uint32_t base_layer,
+                               uint32_t layers) {
+	VkImageViewCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	    .image = image,
+	    .viewType = type,
+	    .format = format,
+	    .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, base_mip, mips, base_layer, layers},
+	};
+	VkImageView view = NULL;
+	assert(vkCreateImageView(g_device, &info, NULL, &view) == VK_SUCCESS);
+	return view;
+}
+
+static void test_view_subresources(void) {
+	VkImage image = create_cube_array();
+
+	VkImageView cubes = create_view(image, VK_IMAGE_VIEW_TYPE_CUBE_ARRAY, VK_FORMAT_R8G8B8A8_UNORM,
+	                                0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+	assert(wgvk_stub_view_desc.dimension == WGPUTextureViewDimension_CubeArray);
+	assert(wgvk_stub_view_desc.mipLevelCount == 7);
+	assert(wgvk_stub_view_desc.arrayLayerCount == 12);
+
+	VkImageView face = create_view(image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_SRGB, 3, 1, 8, 1);
+	assert(wgvk_stub_view_desc.dimension == WGPUTextureViewDimension_2D);
+	assert(wgvk_stub_view_desc.format == WGPUTextureFormat_RGBA8UnormSrgb);
+	assert(wgvk_stub_view_desc.baseMipLevel == 3 && wgvk_stub_view_desc.mipLevelCount == 1);
+	assert(wgvk_stub_view_desc.baseArrayLayer == 8 && wgvk_stub_view_desc.arrayLayerCount == 1);
+
+	vkDestroyImageView(g_device, cubes, NULL);
+	vkDestroyImageView(g_device, face, NULL);
+	vkDestroyImage(g_device, image, NULL);
+	printf("[PASS] test_view_subresources\n");
+}
+
+static void test_view_cache(void) {
+	VkImage image = create_cube_array();
+
+	uint32_t created = wgvk_stub_view_count;
+	VkImageView a = create_view(image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM, 2, 1, 5, 1);
+	VkImageView b = create_view(image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM, 2, 1, 5, 1);
+	VkImageView c = create_view(image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM, 2, 1, 6, 1);
+	assert(wgvk_stub_view_count == created + 2);
+	assert(a->interned == b->interned);
+	assert(a->interned != c->interned);
+
+	/* Views keep the image, and its cache, alive until they are gone. */
+	vkDestroyImage(g_device, image, NULL);
+	vkDestroyImageView(g_device, a, NULL);
+	assert(b->wgpu_view != NULL);
+	vkDestroyImageView(g_device, b, NULL);
+	vkDestroyImageView(g_device, c, NULL);
+	printf("[PASS] test_view_cache\n");
+}
+
+static VkImage create_target(uint32_t width, uint32_t height) {
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = VK_FORMAT_R16G16B16A16_SFLOAT,
+	    .extent = {width, height, 1},
+	    .mipLevels = 1,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+	};
+	VkImage image = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &image) == VK_SUCCESS);
+	return image;
+}
+
+static void test_texture_pool_ages_on_submit(void) {
+	VkQueue queue = NULL;
+	vkGetDeviceQueue(g_device, 0, 0, &queue);
+	wgvkSetTexturePool(g_device, VK_TRUE, 2);
+	vkDestroyImage(g_device, create_target(256, 256), NULL);
+	assert(g_device->texture_pool.free_count == 1);
+
+	/* Without wgvkDeviceEndFrame, submits count as frames. */
+	assert(vkQueueSubmit(queue, 0, NULL, NULL) == VK_SUCCESS);
+	assert(g_device->texture_pool.free_count == 1);
+	assert(vkQueueSubmit(queue, 0, NULL, NULL) == VK_SUCCESS);
+	assert(g_device->texture_pool.free_count == 0);
+	wgvkSetTexturePool(g_device, VK_FALSE, 0);
+	printf("[PASS] test_texture_pool_ages_on_submit\n");
+}
+
+static void test_texture_pool(void) {
+	/* Off by default: destroying an image releases its texture. */
+	uint32_t released = wgvk_stub_texture_release_count;
+	vkDestroyImage(g_device, create_target(1280, 720), NULL);
+	assert(wgvk_stub_texture_release_count == released + 1);
+
+	wgvkSetTexturePool(g_device, VK_TRUE, 2);
+	VkImage a = create_target(1280, 720);
+	VkImage b = create_target(640, 360);
+	vkDestroyImage(g_device, a, NULL);
+	vkDestroyImage(g_device, b, NULL);
+	assert(g_device->texture_pool.free_count == 2);
+
+	/* A matching description reuses the texture; a new size does not. */
+	uint32_t created = wgvk_stub_texture_count;
+	a = create_target(1280, 720);
+	assert(wgvk_stub_texture_count == created);
+	VkImage c = create_target(1920, 1080);
+	assert(wgvk_stub_texture_count == created + 1);
+	assert(g_device->texture_pool.free_count == 1);
+
+	/* The 640x360 texture goes once it has been idle for two frames. */
+	released = wgvk_stub_texture_release_count;
+	wgvkDeviceEndFrame(g_device);
+	assert(g_device->texture_pool.free_count == 1);
+	wgvkDeviceEndFrame(g_device);
+	assert(g_device->texture_pool.free_count == 0);
+	assert(wgvk_stub_texture_release_count == released + 1);
+
+	/* Once the application marks frames, submits no longer age the pool. */
+	vkDestroyImage(g_device, create_target(320, 180), NULL);
+	VkQueue queue = NULL;
+	vkGetDeviceQueue(g_device, 0, 0, &queue);
+	assert(vkQueueSubmit(queue, 0, NULL, NULL) == VK_SUCCESS);
+	assert(vkQueueSubmit(queue, 0, NULL, NULL) == VK_SUCCESS);
+	assert(g_device->texture_pool.free_count == 1);
+	wgvkDeviceEndFrame(g_device);
+	wgvkDeviceEndFrame(g_device);
+	assert(g_device->texture_pool.free_count == 0);
+
+	/* Turning the pool off empties it. */
+	vkDestroyImage(g_device, a, NULL);
+	vkDestroyImage(g_device, c, NULL);
+	assert(g_device->texture_pool.free_count == 2);
+	wgvkSetTexturePool(g_device, VK_FALSE, 0);
+	assert(g_device->texture_pool.free_count == 0);
+
+	/* Without frames ever ending the pool still stops growing. */
+	wgvkSetTexturePool(g_device, VK_TRUE, 0);
+	released = wgvk_stub_texture_release_count;
+	for (uint32_t i = 0; i < WGVK_TEXTURE_POOL_MAX_TEXTURES + 4; i++) {
+		vkDestroyImage(g_device, create_target(64 + i, 64), NULL);
+	}
+	assert(g_device->texture_pool.free_count == WGVK_TEXTURE_POOL_MAX_TEXTURES);
+	assert(wgvk_stub_texture_release_count == released + 4);
+	/* The oldest went first: the newest size is still there. */
+	created = wgvk_stub_texture_count;
+	vkDestroyImage(g_device, create_target(64 + WGVK_TEXTURE_POOL_MAX_TEXTURES + 3, 64), NULL);
+	assert(wgvk_stub_texture_count == created);
+	vkDestroyImage(g_device, create_target(64, 64), NULL);
+	assert(wgvk_stub_texture_count == created + 1);
+	wgvkSetTexturePool(g_device, VK_FALSE, 0);
+	printf("[PASS] test_texture_pool\n");
+}
+
 int main(void) {
 	test_create_null_device();
 	test_create_null_create_info();
 	test_create_null_out_ptr();
 	test_destroy_null();
+	setup_device();
+	test_view_subresources();
+	test_view_cache();
+	test_texture_pool_ages_on_submit();
+	test_texture_pool();
+	teardown_device();
 	printf("test_image: ALL PASSED\n");
 	return 0;
 }
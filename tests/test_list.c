@@ -0,0 +1,163 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "util/list.h"
+#include "util/mpsc_queue.h"
+
+typedef struct Item {
+	uint32_t value;
+	WgvkListLink link;
+} Item;
+
+static uint32_t item_value(WgvkListLink *link) {
+	return WGVK_CONTAINER_OF(link, Item, link)->value;
+}
+
+static void test_list_order(void) {
+	Item items[4] = {{.value = 0}, {.value = 1}, {.value = 2}, {.value = 3}};
+	WgvkList list;
+	wgvk_list_init(&list);
+	assert(wgvk_list_empty(&list) && wgvk_list_front(&list) == NULL);
+	assert(wgvk_list_pop_front(&list) == NULL);
+
+	wgvk_list_push_back(&list, &items[1].link);
+	wgvk_list_push_back(&list, &items[2].link);
+	wgvk_list_push_front(&list, &items[0].link);
+	wgvk_list_insert_after(&list, &items[2].link, &items[3].link);
+	assert(wgvk_list_size(&list) == 4);
+	assert(item_value(wgvk_list_front(&list)) == 0);
+	assert(item_value(wgvk_list_back(&list)) == 3);
+
+	uint32_t expected = 0;
+	WGVK_LIST_FOREACH(&list, link, next) {
+		assert(item_value(link) == expected++);
+	}
+	assert(expected == 4);
+
+	wgvk_list_remove(&list, &items[2].link);
+	assert(wgvk_list_size(&list) == 3);
+	assert(item_value(wgvk_list_pop_front(&list)) == 0);
+	assert(item_value(wgvk_list_pop_front(&list)) == 1);
+	assert(item_value(wgvk_list_pop_front(&list)) == 3);
+	assert(wgvk_list_empty(&list) && wgvk_list_size(&list) == 0);
+	printf("[PASS] test_list_order\n");
+}
+
+static void test_list_remove_while_iterating(void) {
+	enum { COUNT = 10 };
+	Item items[COUNT];
+	WgvkList list;
+	wgvk_list_init(&list);
+	for (uint32_t i = 0; i < COUNT; i++) {
+		items[i].value = i;
+		wgvk_list_push_back(&list, &items[i].link);
+	}
+	WGVK_LIST_FOREACH(&list, link, next) {
+		if (item_value(link) % 2 == 0) {
+			wgvk_list_remove(&list, link);
+		}
+	}
+	assert(wgvk_list_size(&list) == COUNT / 2);
+	uint32_t expected = 1;
+	WGVK_LIST_FOREACH(&list, link, next) {
+		assert(item_value(link) == expected);
+		expected += 2;
+	}
+	printf("[PASS] test_list_remove_while_iterating\n");
+}
+
+typedef struct Message {
+	uint32_t producer;
+	uint32_t sequence;
+	WgvkMpscNode node;
+} Message;
+
+static void test_queue_single_thread(void) {
+	Message messages[3] = {{.sequence = 0}, {.sequence = 1}, {.sequence = 2}};
+	static WgvkMpscQueue queue;
+	wgvk_mpsc_queue_init(&queue);
+	assert(wgvk_mpsc_queue_empty(&queue));
+	assert(wgvk_mpsc_queue_pop(&queue) == NULL);
+
+	for (uint32_t round = 0; round < 2; round++) {
+		for (uint32_t i = 0; i < 3; i++) {
+			wgvk_mpsc_queue_push(&queue, &messages[i].node);
+		}
+		assert(!wgvk_mpsc_queue_empty(&queue));
+		/* Popped nodes can be pushed again */
+		for (uint32_t i = 0; i < 3; i++) {
+			WgvkMpscNode *node = wgvk_mpsc_queue_pop(&queue);
+			assert(node && WGVK_CONTAINER_OF(node, Message, node)->sequence == i);
+		}
+		assert(wgvk_mpsc_queue_pop(&queue) == NULL);
+		assert(wgvk_mpsc_queue_empty(&queue));
+	}
+	printf("[PASS] test_queue_single_thread\n");
+}
+
+enum { PRODUCERS = 4, MESSAGES_PER_PRODUCER = 50000 };
+
+typedef struct Producer {
+	WgvkMpscQueue *queue;
+	uint32_t id;
+	Message *messages;
+} Producer;
+
+static void *produce(void *arg) {
+	Producer *producer = arg;
+	for (uint32_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+		Message *message = &producer->messages[i];
+		message->producer = producer->id;
+		message->sequence = i;
+		wgvk_mpsc_queue_push(producer->queue, &message->node);
+	}
+	return NULL;
+}
+
+/* Producers push while the main thread drains: nothing may be lost or
+ * duplicated, and each producer's messages arrive in order. */
+static void test_queue_stress(void) {
+	static WgvkMpscQueue queue;
+	static Message messages[PRODUCERS][MESSAGES_PER_PRODUCER];
+	Producer producers[PRODUCERS];
+	pthread_t threads[PRODUCERS];
+	uint32_t next_sequence[PRODUCERS] = {0};
+
+	wgvk_mpsc_queue_init(&queue);
+	for (uint32_t p = 0; p < PRODUCERS; p++) {
+		producers[p] = (Producer){&queue, p, messages[p]};
+		assert(pthread_create(&threads[p], NULL, produce, &producers[p]) == 0);
+	}
+
+	uint64_t received = 0;
+	while (received < (uint64_t)PRODUCERS * MESSAGES_PER_PRODUCER) {
+		WgvkMpscNode *node = wgvk_mpsc_queue_pop(&queue);
+		if (!node) {
+			continue;
+		}
+		Message *message = WGVK_CONTAINER_OF(node, Message, node);
+		assert(message->producer < PRODUCERS);
+		assert(message->sequence == next_sequence[message->producer]);
+		next_sequence[message->producer]++;
+		received++;
+	}
+
+	for (uint32_t p = 0; p < PRODUCERS; p++) {
+		assert(pthread_join(threads[p], NULL) == 0);
+		assert(next_sequence[p] == MESSAGES_PER_PRODUCER);
+	}
+	assert(wgvk_mpsc_queue_pop(&queue) == NULL);
+	assert(wgvk_mpsc_queue_empty(&queue));
+	printf("[PASS] test_queue_stress\n");
+}
+
+int main(void) {
+	test_list_order();
+	test_list_remove_while_iterating();
+	test_queue_single_thread();
+	test_queue_stress();
+	printf("test_list: ALL PASSED\n");
+	return 0;
+}
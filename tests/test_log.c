@@ -0,0 +1,131 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/util/log.h"
+
+static int g_count;
+static WgvkLogLevel g_last_level;
+static char g_last_message[256];
+
+static void capture(WgvkLogLevel level, WgvkLogCategory category, const char *message,
+                    void *user_data) {
+	(void)category;
+	(void)user_data;
+	g_count++;
+	g_last_level = level;
+	snprintf(g_last_message, sizeof(g_last_message), "%s", message);
+}
+
+static void reset(void) {
+	g_count = 0;
+	g_last_message[0] = '\0';
+	wgvk_log_set_level(WGVK_LOG_TRACE);
+	for (int i = 0; i < WGVK_LOG_CAT_MAX; i++) {
+		wgvk_log_set_category_enabled((WgvkLogCategory)i, 1);
+	}
+}
+
+static void test_callback_receives_message(void) {
+	reset();
+	wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "value %d", 7);
+	assert(g_count == 1);
+	assert(g_last_level == WGVK_LOG_INFO);
+	assert(strcmp(g_last_message, "value 7") == 0);
+	printf("[PASS] test_callback_receives_message\n");
+}
+
+static void test_level_filter(void) {
+	reset();
+	wgvk_log_set_level(WGVK_LOG_WARN);
+	assert(wgvk_log_enabled(WGVK_LOG_WARN, WGVK_LOG_CAT_SHADER));
+	assert(!wgvk_log_enabled(WGVK_LOG_INFO, WGVK_LOG_CAT_SHADER));
+	assert(!wgvk_log_enabled(WGVK_LOG_TRACE, WGVK_LOG_CAT_SHADER));
+	wgvk_log_message(WGVK_LOG_TRACE, WGVK_LOG_CAT_SHADER, __FILE__, __LINE__, __func__, "hidden");
+	assert(g_count == 0);
+	printf("[PASS] test_level_filter\n");
+}
+
+static void test_category_filter(void) {
+	reset();
+	wgvk_log_set_category_enabled(WGVK_LOG_CAT_SHADER, 0);
+	assert(!wgvk_log_enabled(WGVK_LOG_ERROR, WGVK_LOG_CAT_SHADER));
+	assert(wgvk_log_enabled(WGVK_LOG_ERROR, WGVK_LOG_CAT_CORE));
+	wgvk_log_message(WGVK_LOG_ERROR, WGVK_LOG_CAT_SHADER, __FILE__, __LINE__, __func__, "hidden");
+	assert(g_count == 0);
+	printf("[PASS] test_category_filter\n");
+}
+
+static void test_async_held_until_flush(void) {
+	reset();
+	wgvk_log_set_async(1);
+	wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "first");
+	wgvk_log_message(WGVK_LOG_DEBUG, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "second");
+	assert(g_count == 0);
+	wgvk_log_flush();
+	assert(g_count == 2);
+	assert(strcmp(g_last_message, "second") == 0);
+	wgvk_log_set_async(0);
+	printf("[PASS] test_async_held_until_flush\n");
+}
+
+static void test_async_drops_when_full(void) {
+	reset();
+	wgvk_log_set_async(1);
+	for (int i = 0; i < 300; i++) {
+		wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "m%d", i);
+	}
+	assert(g_count == 0);
+	wgvk_log_flush();
+	/* 256 queued messages, then one warning counting the rest */
+	assert(g_count == 257);
+	assert(g_last_level == WGVK_LOG_WARN);
+	assert(strstr(g_last_message, "44 log messages dropped") != NULL);
+
+	/* The ring is reusable after draining */
+	wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "again");
+	wgvk_log_flush();
+	assert(g_count == 258);
+	wgvk_log_set_async(0);
+	printf("[PASS] test_async_drops_when_full\n");
+}
+
+static void test_async_error_flushes(void) {
+	reset();
+	wgvk_log_set_async(1);
+	wgvk_log_message(WGVK_LOG_WARN, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "queued");
+	wgvk_log_message(WGVK_LOG_ERROR, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "failed");
+	assert(g_count == 2);
+	assert(g_last_level == WGVK_LOG_ERROR);
+	assert(strcmp(g_last_message, "failed") == 0);
+	wgvk_log_set_async(0);
+	printf("[PASS] test_async_error_flushes\n");
+}
+
+static void test_disable_async_flushes(void) {
+	reset();
+	wgvk_log_set_async(1);
+	wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "pending");
+	assert(g_count == 0);
+	wgvk_log_set_async(0);
+	assert(g_count == 1);
+	wgvk_log_message(WGVK_LOG_INFO, WGVK_LOG_CAT_CORE, __FILE__, __LINE__, __func__, "direct");
+	assert(g_count == 2);
+	printf("[PASS] test_disable_async_flushes\n");
+}
+
+int main(void) {
+	wgvk_log_init();
+	wgvk_log_set_callback(capture, NULL);
+
+	test_callback_receives_message();
+	test_level_filter();
+	test_category_filter();
+	test_async_held_until_flush();
+	test_async_drops_when_full();
+	test_async_error_flushes();
+	test_disable_async_flushes();
+
+	wgvk_log_set_callback(NULL, NULL);
+	printf("test_log: ALL PASSED\n");
+	return 0;
+}
@@ -0,0 +1,216 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include "webgpu_recorder.h"
+#include "webvulkan_internal.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+static VkCommandBuffer g_cmd;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+
+	VkCommandBufferAllocateInfo cmd_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	assert(vkAllocateCommandBuffers(g_device, &cmd_info, &g_cmd) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkFreeCommandBuffers(g_device, NULL, 1, &g_cmd);
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+/* A render pass with draw_count draws, each after the same viewport. */
+static void record_draws(uint32_t draw_count) {
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(g_cmd, &begin) == VK_SUCCESS);
+	VkRenderPassBeginInfo pass = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+	vkCmdBeginRenderPass(g_cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	VkViewport viewport = {0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f};
+	for (uint32_t i = 0; i < draw_count; i++) {
+		vkCmdSetViewport(g_cmd, 0, 1, &viewport);
+		vkCmdDraw(g_cmd, 3, 1, 0, 0);
+	}
+	vkCmdEndRenderPass(g_cmd);
+	assert(vkEndCommandBuffer(g_cmd) == VK_SUCCESS);
+}
+
+/* Copy of the last recording's trace, which the next begin discards. */
+static uint8_t *copy_trace(size_t *size) {
+	const uint8_t *trace = wgvk_rec_trace(size);
+	uint8_t *copy = malloc(*size);
+	assert(copy);
+	memcpy(copy, trace, *size);
+	return copy;
+}
+
+static void test_counts_and_cost(void) {
+	wgvk_rec_set_default_cost(100);
+	wgvk_rec_set_cost(WGVK_REC_wgpuRenderPassEncoderDraw, 1000);
+	wgvk_rec_begin(0);
+	record_draws(3);
+	wgvk_rec_end();
+
+	assert(wgvk_rec_count(WGVK_REC_wgpuRenderPassEncoderDraw) == 3);
+	assert(wgvk_rec_count(WGVK_REC_wgpuCommandEncoderBeginRenderPass) == 1);
+	assert(wgvk_rec_count(WGVK_REC_wgpuDeviceCreateCommandEncoder) == 1);
+	/* The same viewport is set before every draw; an upper bound for now */
+	uint64_t viewports = wgvk_rec_count(WGVK_REC_wgpuRenderPassEncoderSetViewport);
+	assert(viewports >= 1 && viewports <= 3);
+
+	uint64_t calls = wgvk_rec_total_calls();
+	assert(wgvk_rec_total_cost_ns() == (calls - 3) * 100 + 3 * 1000);
+
+	/* Counting mode keeps no trace */
+	size_t size = 0;
+	wgvk_rec_trace(&size);
+	assert(size == 0);
+
+	wgvk_rec_set_default_cost(0);
+	wgvk_rec_set_cost(WGVK_REC_wgpuRenderPassEncoderDraw, 0);
+	printf("[PASS] test_counts_and_cost\n");
+}
+
+static void test_distinct_handles(void) {
+	VkBufferCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 256,
+	    .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	};
+	VkBuffer a = NULL, b = NULL, c = NULL;
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	assert(vkCreateBuffer(g_device, &info, NULL, &a) == VK_SUCCESS);
+	assert(vkCreateBuffer(g_device, &info, NULL, &b) == VK_SUCCESS);
+	wgvk_rec_end();
+	assert(vkCreateBuffer(g_device, &info, NULL, &c) == VK_SUCCESS);
+
+	assert(a->wgpu_buffer != b->wgpu_buffer);
+	assert((uintptr_t)a->wgpu_buffer >= 0x10000 && (uintptr_t)b->wgpu_buffer >= 0x10000);
+	assert((uintptr_t)c->wgpu_buffer == 1);
+
+	vkDestroyBuffer(g_device, a, NULL);
+	vkDestroyBuffer(g_device, b, NULL);
+	vkDestroyBuffer(g_device, c, NULL);
+	printf("[PASS] test_distinct_handles\n");
+}
+
+typedef struct DrawVisit {
+	uint32_t draws;
+	int args_ok;
+} DrawVisit;
+
+static void visit_draw(const WgvkRecCall *call, void *user_data) {
+	DrawVisit *visit = user_data;
+	if (call->op != WGVK_REC_wgpuRenderPassEncoderDraw) {
+		return;
+	}
+	visit->draws++;
+	visit->args_ok &= call->arg_count == 5 && call->args[1] == 3 && call->args[2] == 1 &&
+	                  call->args[3] == 0 && call->args[4] == 0;
+}
+
+static void test_replay(void) {
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	record_draws(2);
+	wgvk_rec_end();
+
+	size_t size = 0;
+	const uint8_t *trace = wgvk_rec_trace(&size);
+	assert(size > 8 && memcmp(trace, "WGVKREC1", 8) == 0);
+
+	DrawVisit visit = {0, 1};
+	assert(wgvk_rec_replay(trace, size, visit_draw, &visit) == (long)wgvk_rec_total_calls());
+	assert(visit.draws == 2 && visit.args_ok);
+
+	/* Truncated and foreign data are rejected */
+	assert(wgvk_rec_replay(trace, size - 1, NULL, NULL) == -1);
+	assert(wgvk_rec_replay((const uint8_t *)"NOTATRACE", 9, NULL, NULL) == -1);
+	printf("[PASS] test_replay\n");
+}
+
+static void test_diff(void) {
+	size_t a_size, b_size, c_size;
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	record_draws(2);
+	uint8_t *a = copy_trace(&a_size);
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	record_draws(2);
+	uint8_t *b = copy_trace(&b_size);
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	record_draws(3);
+	wgvk_rec_end();
+	uint8_t *c = copy_trace(&c_size);
+
+	assert(wgvk_rec_diff(a, a_size, b, b_size, NULL) == -1);
+
+	/* Both traces agree up to the end of the second draw */
+	long index = wgvk_rec_diff(a, a_size, c, c_size, NULL);
+	assert(index > 0);
+	assert(wgvk_rec_diff(c, c_size, a, a_size, NULL) == index);
+
+	FILE *report = tmpfile();
+	assert(report);
+	wgvk_rec_diff(a, a_size, c, c_size, report);
+	char text[1024] = {0};
+	rewind(report);
+	size_t read = fread(text, 1, sizeof(text) - 1, report);
+	text[read] = '\0';
+	fclose(report);
+	assert(strstr(text, "traces differ at call"));
+	assert(strstr(text, "wgpuRenderPassEncoderDraw: 2 -> 3"));
+
+	free(a);
+	free(b);
+	free(c);
+	printf("[PASS] test_diff\n");
+}
+
+static void test_save_load(void) {
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	record_draws(1);
+	wgvk_rec_end();
+
+	char path[] = "test_recorder_trace.bin";
+	assert(wgvk_rec_save(path) == 0);
+	size_t size = 0;
+	uint8_t *loaded = wgvk_rec_load(path, &size);
+	remove(path);
+	assert(loaded);
+
+	size_t original_size = 0;
+	const uint8_t *original = wgvk_rec_trace(&original_size);
+	assert(size == original_size);
+	assert(wgvk_rec_diff(original, original_size, loaded, size, NULL) == -1);
+	free(loaded);
+
+	assert(wgvk_rec_load("does/not/exist.bin", &size) == NULL);
+	printf("[PASS] test_save_load\n");
+}
+
+int main(void) {
+	setup_device();
+	test_counts_and_cost();
+	test_distinct_handles();
+	test_replay();
+	test_diff();
+	test_save_load();
+	teardown_device();
+	printf("test_recorder: ALL PASSED\n");
+	return 0;
+}
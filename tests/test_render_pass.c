@@ -0,0 +1,1050 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include "webgpu_recorder.h"
+#include "webvulkan_internal.h"
+#include "commands/subpass.h"
+
+/* Captured by webgpu_stubs.c */
+extern WGPURenderPassColorAttachment wgvk_stub_color_attachments[8];
+extern uint32_t wgvk_stub_color_attachment_count;
+extern WGPURenderPassDepthStencilAttachment wgvk_stub_depth_attachment;
+extern int wgvk_stub_has_depth_attachment;
+extern uint32_t wgvk_stub_render_pass_count;
+extern WGPUColorTargetState wgvk_stub_color_targets[8];
+extern WGPUBlendState wgvk_stub_blend_states[8];
+extern uint32_t wgvk_stub_color_target_count;
+extern int wgvk_stub_has_fragment;
+extern WGPUMultisampleState wgvk_stub_multisample;
+extern WGPUTextureFormat wgvk_stub_depth_stencil_format;
+extern uint32_t wgvk_stub_texture_count;
+extern WGPUTextureUsage wgvk_stub_texture_usage;
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+/* A view with a recognizable fake WebGPU handle, so attachments can be told apart. */
+static VkImageView create_view(uintptr_t id, VkFormat format) {
+	VkImageViewCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	    .viewType = VK_IMAGE_VIEW_TYPE_2D,
+	    .format = format,
+	};
+	VkImageView view = NULL;
+	assert(vkCreateImageView(g_device, &info, NULL, &view) == VK_SUCCESS);
+	view->wgpu_view = (WGPUTextureView)id;
+	return view;
+}
+
+static VkCommandBuffer begin_command_buffer(void) {
+	VkCommandBufferAllocateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &info, &cmd) == VK_SUCCESS);
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin) == VK_SUCCESS);
+	return cmd;
+}
+
+static void test_load_store_ops_and_clear_values(void) {
+	VkAttachmentDescription attachments[] = {
+	    {.format = VK_FORMAT_R8G8B8A8_UNORM,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_STORE},
+	    {.format = VK_FORMAT_R32_UINT,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	    {.format = VK_FORMAT_D32_SFLOAT,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+	     .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE},
+	};
+	VkAttachmentReference color_refs[] = {
+	    {.attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+	    {.attachment = 1, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+	};
+	VkAttachmentReference depth_ref = {
+	    .attachment = 2,
+	    .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+	};
+	VkSubpassDescription subpass = {
+	    .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	    .colorAttachmentCount = 2,
+	    .pColorAttachments = color_refs,
+	    .pDepthStencilAttachment = &depth_ref,
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 3,
+	    .pAttachments = attachments,
+	    .subpassCount = 1,
+	    .pSubpasses = &subpass,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+
+	VkImageView views[3] = {
+	    create_view(0x10, VK_FORMAT_R8G8B8A8_UNORM),
+	    create_view(0x20, VK_FORMAT_R32_UINT),
+	    create_view(0x30, VK_FORMAT_D32_SFLOAT),
+	};
+	VkFramebufferCreateInfo fb_info = {
+	    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+	    .renderPass = rp,
+	    .attachmentCount = 3,
+	    .pAttachments = views,
+	    .width = 64,
+	    .height = 64,
+	    .layers = 1,
+	};
+	VkFramebuffer fb = NULL;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_SUCCESS);
+
+	VkClearValue clears[3] = {0};
+	clears[0].color.float32[0] = 0.25f;
+	clears[0].color.float32[3] = 1.0f;
+	clears[1].color.uint32[0] = 7;
+	clears[2].depthStencil.depth = 0.5f;
+
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkRenderPassBeginInfo begin = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+	    .renderPass = rp,
+	    .framebuffer = fb,
+	    .renderArea = {.extent = {64, 64}},
+	    .clearValueCount = 3,
+	    .pClearValues = clears,
+	};
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+
+	assert(wgvk_stub_color_attachment_count == 2);
+	assert(wgvk_stub_color_attachments[0].view == (WGPUTextureView)0x10);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Store);
+	assert(wgvk_stub_color_attachments[0].clearValue.r == 0.25);
+	assert(wgvk_stub_color_attachments[0].clearValue.a == 1.0);
+	assert(wgvk_stub_color_attachments[1].view == (WGPUTextureView)0x20);
+	assert(wgvk_stub_color_attachments[1].loadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_color_attachments[1].storeOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_color_attachments[1].clearValue.r == 7.0);
+
+	assert(wgvk_stub_has_depth_attachment);
+	assert(wgvk_stub_depth_attachment.view == (WGPUTextureView)0x30);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_depth_attachment.depthClearValue == 0.5f);
+	/* D32_SFLOAT has no stencil aspect, so its stencil ops must stay unset. */
+	assert(wgvk_stub_depth_attachment.stencilLoadOp == WGPULoadOp_Undefined);
+	assert(wgvk_stub_depth_attachment.stencilStoreOp == WGPUStoreOp_Undefined);
+
+	vkCmdEndRenderPass(cmd);
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyFramebuffer(g_device, fb, NULL);
+	for (uint32_t i = 0; i < 3; i++) {
+		vkDestroyImageView(g_device, views[i], NULL);
+	}
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_load_store_ops_and_clear_values\n");
+}
+
+static void test_attachment_limit(void) {
+	VkAttachmentDescription attachments[WGVK_MAX_COLOR_ATTACHMENTS + 2];
+	for (uint32_t i = 0; i < WGVK_MAX_COLOR_ATTACHMENTS + 2; i++) {
+		attachments[i] = (VkAttachmentDescription){
+		    .format = VK_FORMAT_R8G8B8A8_UNORM,
+		    .samples = VK_SAMPLE_COUNT_1_BIT,
+		    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+		};
+	}
+	VkAttachmentReference color_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpass = {
+	    .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachments = &color_ref,
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = WGVK_MAX_COLOR_ATTACHMENTS + 2,
+	    .pAttachments = attachments,
+	    .subpassCount = 1,
+	    .pSubpasses = &subpass,
+	};
+	/* More attachments than a framebuffer holds are rejected, not cut off. */
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_ERROR_INITIALIZATION_FAILED);
+	assert(rp == NULL);
+	rp_info.attachmentCount = 1;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+
+	VkImageView view = create_view(0x80, VK_FORMAT_R8G8B8A8_UNORM);
+	VkImageView views[WGVK_MAX_COLOR_ATTACHMENTS + 2];
+	for (uint32_t i = 0; i < WGVK_MAX_COLOR_ATTACHMENTS + 2; i++) {
+		views[i] = view;
+	}
+	VkFramebufferCreateInfo fb_info = {
+	    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+	    .renderPass = rp,
+	    .attachmentCount = WGVK_MAX_COLOR_ATTACHMENTS + 2,
+	    .pAttachments = views,
+	    .width = 64,
+	    .height = 64,
+	    .layers = 1,
+	};
+	VkFramebuffer fb = NULL;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_ERROR_INITIALIZATION_FAILED);
+	assert(fb == NULL);
+	fb_info.attachmentCount = 1;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_SUCCESS);
+
+	/* Clear values past the render pass's attachments are ignored. */
+	VkClearValue clears[WGVK_MAX_COLOR_ATTACHMENTS + 2] = {0};
+	clears[0].color.float32[1] = 0.5f;
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkRenderPassBeginInfo begin = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+	    .renderPass = rp,
+	    .framebuffer = fb,
+	    .renderArea = {.extent = {64, 64}},
+	    .clearValueCount = WGVK_MAX_COLOR_ATTACHMENTS + 2,
+	    .pClearValues = clears,
+	};
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+	assert(cmd->clear_value_count == 1);
+	assert(wgvk_stub_color_attachments[0].clearValue.g == 0.5);
+	vkCmdEndRenderPass(cmd);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyFramebuffer(g_device, fb, NULL);
+	vkDestroyImageView(g_device, view, NULL);
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_attachment_limit\n");
+}
+
+static void test_subpasses_split_and_merge(void) {
+	/* Subpasses 0 and 1 draw to the same targets and share a WebGPU pass;
+	 * subpass 2 reads attachment 0 as an input and needs a pass of its own. */
+	VkAttachmentDescription attachments[] = {
+	    {.format = VK_FORMAT_R8G8B8A8_UNORM,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	    {.format = VK_FORMAT_B8G8R8A8_UNORM,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_STORE},
+	    {.format = VK_FORMAT_D24_UNORM_S8_UINT,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+	     .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+	     .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	};
+	VkAttachmentReference gbuffer_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference depth_ref = {2, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference input_ref = {0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+	VkAttachmentReference output_ref = {1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpasses[] = {
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &gbuffer_ref,
+	     .pDepthStencilAttachment = &depth_ref},
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &gbuffer_ref,
+	     .pDepthStencilAttachment = &depth_ref},
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .inputAttachmentCount = 1,
+	     .pInputAttachments = &input_ref,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &output_ref},
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 3,
+	    .pAttachments = attachments,
+	    .subpassCount = 3,
+	    .pSubpasses = subpasses,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+	assert(rp->subpass_info->subpass_count == 3);
+	assert(rp->subpass_info->pass_count == 2);
+	assert(rp->subpass_info->subpasses[1].merged);
+	assert(!rp->subpass_info->subpasses[2].merged);
+
+	VkImageView views[3] = {
+	    create_view(0x10, VK_FORMAT_R8G8B8A8_UNORM),
+	    create_view(0x20, VK_FORMAT_B8G8R8A8_UNORM),
+	    create_view(0x30, VK_FORMAT_D24_UNORM_S8_UINT),
+	};
+	VkFramebufferCreateInfo fb_info = {
+	    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+	    .renderPass = rp,
+	    .attachmentCount = 3,
+	    .pAttachments = views,
+	    .width = 64,
+	    .height = 64,
+	    .layers = 1,
+	};
+	VkFramebuffer fb = NULL;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_SUCCESS);
+
+	VkClearValue clears[3] = {0};
+	clears[1].color.float32[2] = 1.0f;
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkRenderPassBeginInfo begin = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+	    .renderPass = rp,
+	    .framebuffer = fb,
+	    .renderArea = {.extent = {64, 64}},
+	    .clearValueCount = 3,
+	    .pClearValues = clears,
+	};
+
+	uint32_t passes_before = wgvk_stub_render_pass_count;
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+	assert(wgvk_stub_color_attachment_count == 1);
+	assert(wgvk_stub_color_attachments[0].view == (WGPUTextureView)0x10);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	/* Read by subpass 2, so its DONT_CARE store only applies there. */
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Store);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_depth_attachment.stencilLoadOp == WGPULoadOp_Clear);
+
+	vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+	assert(wgvk_stub_render_pass_count == passes_before + 1);
+
+	vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+	assert(wgvk_stub_render_pass_count == passes_before + 2);
+	assert(wgvk_stub_color_attachment_count == 1);
+	assert(wgvk_stub_color_attachments[0].view == (WGPUTextureView)0x20);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_color_attachments[0].clearValue.b == 1.0);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Store);
+	assert(!wgvk_stub_has_depth_attachment);
+
+	/* Past the last subpass: ignored. */
+	vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+	assert(wgvk_stub_render_pass_count == passes_before + 2);
+
+	vkCmdEndRenderPass(cmd);
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyFramebuffer(g_device, fb, NULL);
+	for (uint32_t i = 0; i < 3; i++) {
+		vkDestroyImageView(g_device, views[i], NULL);
+	}
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_subpasses_split_and_merge\n");
+}
+
+/* Calls made to the last pass encoder of a recording. */
+typedef struct {
+	uint32_t begins;
+	uint64_t counts[WGVK_REC_OP_COUNT];
+	WgvkRecCall viewport;
+	WgvkRecCall index_buffer;
+} LastPassCalls;
+
+static void count_last_pass_call(const WgvkRecCall *call, void *user_data) {
+	LastPassCalls *calls = user_data;
+	if (call->op == WGVK_REC_wgpuCommandEncoderBeginRenderPass) {
+		calls->begins++;
+		memset(calls->counts, 0, sizeof(calls->counts));
+	}
+	calls->counts[call->op]++;
+	if (call->op == WGVK_REC_wgpuRenderPassEncoderSetViewport) {
+		calls->viewport = *call;
+	} else if (call->op == WGVK_REC_wgpuRenderPassEncoderSetIndexBuffer) {
+		calls->index_buffer = *call;
+	}
+}
+
+static void test_next_subpass_restores_state(void) {
+	/* Subpass 1 reads subpass 0's output, so it starts a new WebGPU pass. */
+	VkAttachmentDescription attachments[] = {
+	    {.format = VK_FORMAT_R8G8B8A8_UNORM,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	    {.format = VK_FORMAT_B8G8R8A8_UNORM,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_STORE},
+	};
+	VkAttachmentReference first_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference input_ref = {0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+	VkAttachmentReference second_ref = {1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpasses[] = {
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &first_ref},
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .inputAttachmentCount = 1,
+	     .pInputAttachments = &input_ref,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &second_ref},
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 2,
+	    .pAttachments = attachments,
+	    .subpassCount = 2,
+	    .pSubpasses = subpasses,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+	assert(!rp->subpass_info->subpasses[1].merged);
+
+	VkImageView views[2] = {
+	    create_view(0x10, VK_FORMAT_R8G8B8A8_UNORM),
+	    create_view(0x20, VK_FORMAT_B8G8R8A8_UNORM),
+	};
+	VkFramebufferCreateInfo fb_info = {
+	    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+	    .renderPass = rp,
+	    .attachmentCount = 2,
+	    .pAttachments = views,
+	    .width = 64,
+	    .height = 64,
+	    .layers = 1,
+	};
+	VkFramebuffer fb = NULL;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_SUCCESS);
+
+	VkBufferCreateInfo buf_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .size = 1024,
+	    .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+	};
+	VkBuffer buffer = NULL;
+	assert(vkCreateBuffer(g_device, &buf_info, NULL, &buffer) == VK_SUCCESS);
+
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkRenderPassBeginInfo begin = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+	    .renderPass = rp,
+	    .framebuffer = fb,
+	    .renderArea = {.extent = {64, 64}},
+	};
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+
+	VkBuffer vertex_buffers[2] = {buffer, buffer};
+	VkDeviceSize offsets[2] = {0, 256};
+	vkCmdBindVertexBuffers(cmd, 0, 2, vertex_buffers, offsets);
+	vkCmdBindIndexBuffer(cmd, buffer, 512, VK_INDEX_TYPE_UINT16);
+	VkViewport viewport = {0.0f, 0.0f, 32.0f, 16.0f, 0.0f, 1.0f};
+	vkCmdSetViewport(cmd, 0, 1, &viewport);
+	VkRect2D scissor = {{4, 4}, {8, 8}};
+	vkCmdSetScissor(cmd, 0, 1, &scissor);
+	const float blend[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+	vkCmdSetBlendConstants(cmd, blend);
+	vkCmdSetStencilReference(cmd, VK_STENCIL_FACE_FRONT_AND_BACK, 7);
+
+	vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdEndRenderPass(cmd);
+	assert(vkEndCommandBuffer(cmd) == VK_SUCCESS);
+	wgvk_rec_end();
+
+	size_t size = 0;
+	const uint8_t *trace = wgvk_rec_trace(&size);
+	LastPassCalls calls = {0};
+	assert(wgvk_rec_replay(trace, size, count_last_pass_call, &calls) > 0);
+	assert(calls.begins == 2);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetVertexBuffer] == 2);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetIndexBuffer] == 1);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetViewport] == 1);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetScissorRect] == 1);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetBlendConstant] == 1);
+	assert(calls.counts[WGVK_REC_wgpuRenderPassEncoderSetStencilReference] == 1);
+	assert(calls.viewport.args[3] == wgvk_rec_float(32.0f));
+	assert(calls.viewport.args[4] == wgvk_rec_float(16.0f));
+
+	/* A new recording starts without the old bindings */
+	LastPassCalls fresh = {0};
+	wgvk_rec_begin(WGVK_REC_TRACE);
+	VkCommandBufferBeginInfo begin_info = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin_info) == VK_SUCCESS);
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdEndRenderPass(cmd);
+	assert(vkEndCommandBuffer(cmd) == VK_SUCCESS);
+	wgvk_rec_end();
+	trace = wgvk_rec_trace(&size);
+	assert(wgvk_rec_replay(trace, size, count_last_pass_call, &fresh) > 0);
+	assert(fresh.counts[WGVK_REC_wgpuRenderPassEncoderSetVertexBuffer] == 0);
+	assert(fresh.counts[WGVK_REC_wgpuRenderPassEncoderSetViewport] == 0);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyBuffer(g_device, buffer, NULL);
+	vkDestroyFramebuffer(g_device, fb, NULL);
+	for (uint32_t i = 0; i < 2; i++) {
+		vkDestroyImageView(g_device, views[i], NULL);
+	}
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_next_subpass_restores_state\n");
+}
+
+static void test_dynamic_rendering(void) {
+	VkImageView color = create_view(0x400, VK_FORMAT_R8G8B8A8_UNORM);
+	VkImageView resolve = create_view(0x401, VK_FORMAT_R8G8B8A8_UNORM);
+	VkImageView depth = create_view(0x402, VK_FORMAT_D24_UNORM_S8_UINT);
+
+	VkRenderingAttachmentInfo color_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = color,
+	    .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+	    .resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT,
+	    .resolveImageView = resolve,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+	    .clearValue = {.color = {.float32 = {0.25f, 0.5f, 0.75f, 1.0f}}},
+	};
+	VkRenderingAttachmentInfo depth_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = depth,
+	    .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+	    .clearValue = {.depthStencil = {0.5f, 0}},
+	};
+	VkRenderingInfo rendering = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+	    .renderArea = {{0, 0}, {64, 64}},
+	    .layerCount = 1,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachments = &color_att,
+	    .pDepthAttachment = &depth_att,
+	};
+
+	VkCommandBuffer cmd = begin_command_buffer();
+	uint32_t passes_before = wgvk_stub_render_pass_count;
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_render_pass_count == passes_before + 1);
+	assert(wgvk_stub_color_attachment_count == 1);
+	assert(wgvk_stub_color_attachments[0].view == (WGPUTextureView)0x400);
+	assert(wgvk_stub_color_attachments[0].resolveTarget == (WGPUTextureView)0x401);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_color_attachments[0].clearValue.b == 0.75);
+
+	/* No stencil attachment: the stencil aspect is preserved. */
+	assert(wgvk_stub_has_depth_attachment);
+	assert(wgvk_stub_depth_attachment.view == (WGPUTextureView)0x402);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_depth_attachment.depthClearValue == 0.5f);
+	assert(wgvk_stub_depth_attachment.stencilLoadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_depth_attachment.stencilStoreOp == WGPUStoreOp_Store);
+
+	/* A second begin inside the pass is ignored. */
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_render_pass_count == passes_before + 1);
+	vkCmdEndRendering(cmd);
+	assert(!cmd->in_render_pass);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImageView(g_device, color, NULL);
+	vkDestroyImageView(g_device, resolve, NULL);
+	vkDestroyImageView(g_device, depth, NULL);
+	printf("[PASS] test_dynamic_rendering\n");
+}
+
+static void test_suspend_resume_rendering(void) {
+	VkImageView color = create_view(0x410, VK_FORMAT_R8G8B8A8_UNORM);
+	VkImageView resolve = create_view(0x411, VK_FORMAT_R8G8B8A8_UNORM);
+	VkImageView depth = create_view(0x412, VK_FORMAT_D32_SFLOAT);
+
+	VkRenderingAttachmentInfo color_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = color,
+	    .resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT,
+	    .resolveImageView = resolve,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+	};
+	VkRenderingAttachmentInfo depth_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = depth,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+	};
+	VkRenderingInfo rendering = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+	    .flags = VK_RENDERING_SUSPENDING_BIT,
+	    .renderArea = {{0, 0}, {64, 64}},
+	    .layerCount = 1,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachments = &color_att,
+	    .pDepthAttachment = &depth_att,
+	};
+
+	/* The first part clears, then keeps its contents for the next part. */
+	VkCommandBuffer cmd = begin_command_buffer();
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Store);
+	assert(wgvk_stub_color_attachments[0].resolveTarget == NULL);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Store);
+	vkCmdEndRendering(cmd);
+
+	/* A middle part neither clears nor discards. */
+	rendering.flags = VK_RENDERING_SUSPENDING_BIT | VK_RENDERING_RESUMING_BIT;
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Store);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Store);
+	vkCmdEndRendering(cmd);
+
+	/* The last part loads, then applies the store op and resolves. */
+	rendering.flags = VK_RENDERING_RESUMING_BIT;
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_color_attachments[0].resolveTarget == (WGPUTextureView)0x411);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Load);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Discard);
+	vkCmdEndRendering(cmd);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyImageView(g_device, color, NULL);
+	vkDestroyImageView(g_device, resolve, NULL);
+	vkDestroyImageView(g_device, depth, NULL);
+	printf("[PASS] test_suspend_resume_rendering\n");
+}
+
+static VkImage create_transient_image(VkFormat format, VkImageUsageFlags usage) {
+	VkImageCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+	    .imageType = VK_IMAGE_TYPE_2D,
+	    .format = format,
+	    .extent = {64, 64, 1},
+	    .mipLevels = 1,
+	    .arrayLayers = 1,
+	    .samples = VK_SAMPLE_COUNT_4_BIT,
+	    .usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | usage,
+	};
+	VkImage image = NULL;
+	assert(vkCreateImage(g_device, &info, NULL, &image) == VK_SUCCESS);
+	return image;
+}
+
+static void test_transient_attachments(void) {
+	/* Transient images take lazily allocated memory, which has no backing. */
+	VkImage msaa = create_transient_image(VK_FORMAT_R8G8B8A8_UNORM,
+	                                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+	VkMemoryRequirements reqs;
+	vkGetImageMemoryRequirements(g_device, msaa, &reqs);
+	assert(reqs.memoryTypeBits & (1u << WGVK_MEMORY_TYPE_LAZY));
+	VkMemoryAllocateInfo alloc = {
+	    .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+	    .allocationSize = reqs.size,
+	    .memoryTypeIndex = WGVK_MEMORY_TYPE_LAZY,
+	};
+	VkDeviceMemory memory = NULL;
+	assert(vkAllocateMemory(g_device, &alloc, NULL, &memory) == VK_SUCCESS);
+	assert(memory->wgpu_buffer == NULL);
+	assert(vkBindImageMemory(g_device, msaa, memory, 0) == VK_SUCCESS);
+
+	/* Without WebGPU transient usage, textures are recycled by key. */
+	uint32_t textures = wgvk_stub_texture_count;
+	vkDestroyImage(g_device, msaa, NULL);
+	msaa = create_transient_image(VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+	assert(wgvk_stub_texture_count == textures);
+	assert(g_device->texture_pool.free_count == 0);
+	VkImage depth = create_transient_image(VK_FORMAT_D32_SFLOAT,
+	                                       VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	assert(wgvk_stub_texture_count == textures + 1);
+
+	VkImageViewCreateInfo view_info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+	    .image = msaa,
+	    .viewType = VK_IMAGE_VIEW_TYPE_2D,
+	    .format = VK_FORMAT_R8G8B8A8_UNORM,
+	    .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+	};
+	VkImageView color_view = NULL;
+	assert(vkCreateImageView(g_device, &view_info, NULL, &color_view) == VK_SUCCESS);
+	view_info.image = depth;
+	view_info.format = VK_FORMAT_D32_SFLOAT;
+	view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	VkImageView depth_view = NULL;
+	assert(vkCreateImageView(g_device, &view_info, NULL, &depth_view) == VK_SUCCESS);
+
+	/* Asking to keep a transient attachment still discards it. */
+	VkRenderingAttachmentInfo color_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = color_view,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+	};
+	VkRenderingAttachmentInfo depth_att = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+	    .imageView = depth_view,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+	};
+	VkRenderingInfo rendering = {
+	    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+	    .renderArea = {{0, 0}, {64, 64}},
+	    .layerCount = 1,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachments = &color_att,
+	    .pDepthAttachment = &depth_att,
+	};
+	VkCommandBuffer cmd = begin_command_buffer();
+	vkCmdBeginRendering(cmd, &rendering);
+	assert(wgvk_stub_color_attachments[0].loadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Discard);
+	assert(wgvk_stub_depth_attachment.depthLoadOp == WGPULoadOp_Clear);
+	assert(wgvk_stub_depth_attachment.depthStoreOp == WGPUStoreOp_Discard);
+	vkCmdEndRendering(cmd);
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+
+	vkDestroyImageView(g_device, color_view, NULL);
+	vkDestroyImageView(g_device, depth_view, NULL);
+	vkDestroyImage(g_device, msaa, NULL);
+	vkDestroyImage(g_device, depth, NULL);
+	vkFreeMemory(g_device, memory, NULL);
+	assert(g_device->texture_pool.free_count == 2);
+
+	/* With WebGPU transient usage, pure attachments bypass the pool. */
+	g_device->transient_attachments = VK_TRUE;
+	VkImage memoryless = create_transient_image(VK_FORMAT_D32_SFLOAT,
+	                                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	assert(wgvk_stub_texture_usage & WGPUTextureUsage_TransientAttachment);
+	assert(!memoryless->pooled);
+	VkImage input = create_transient_image(VK_FORMAT_R8G8B8A8_UNORM,
+	                                       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+	                                           VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT);
+	assert(input->pooled);
+	g_device->transient_attachments = VK_FALSE;
+	vkDestroyImage(g_device, memoryless, NULL);
+	vkDestroyImage(g_device, input, NULL);
+	printf("[PASS] test_transient_attachments\n");
+}
+
+static void test_hdr_msaa_pipeline_and_resolve(void) {
+	VkAttachmentDescription attachments[] = {
+	    {.format = VK_FORMAT_R16G16B16A16_SFLOAT,
+	     .samples = VK_SAMPLE_COUNT_4_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	    {.format = VK_FORMAT_R16G16B16A16_SFLOAT,
+	     .samples = VK_SAMPLE_COUNT_1_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_STORE},
+	    {.format = VK_FORMAT_D32_SFLOAT,
+	     .samples = VK_SAMPLE_COUNT_4_BIT,
+	     .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	     .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE},
+	};
+	VkAttachmentReference color_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference resolve_ref = {1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference depth_ref = {2, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpass = {
+	    .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachments = &color_ref,
+	    .pResolveAttachments = &resolve_ref,
+	    .pDepthStencilAttachment = &depth_ref,
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 3,
+	    .pAttachments = attachments,
+	    .subpassCount = 1,
+	    .pSubpasses = &subpass,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+
+	VkPipelineShaderStageCreateInfo stages[] = {
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_VERTEX_BIT,
+	     .pName = "main"},
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+	     .pName = "main"},
+	};
+	VkPipelineColorBlendAttachmentState blend = {
+	    .blendEnable = VK_TRUE,
+	    .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+	    .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+	    .colorBlendOp = VK_BLEND_OP_ADD,
+	    .srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+	    .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+	    .alphaBlendOp = VK_BLEND_OP_MAX,
+	    .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+	                      VK_COLOR_COMPONENT_B_BIT,
+	};
+	VkPipelineColorBlendStateCreateInfo blend_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+	    .attachmentCount = 1,
+	    .pAttachments = &blend,
+	};
+	VkSampleMask sample_mask = 0x7;
+	VkPipelineMultisampleStateCreateInfo ms_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+	    .rasterizationSamples = VK_SAMPLE_COUNT_4_BIT,
+	    .pSampleMask = &sample_mask,
+	    .alphaToCoverageEnable = VK_TRUE,
+	};
+	VkPipelineDepthStencilStateCreateInfo ds_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+	    .depthTestEnable = VK_TRUE,
+	    .depthCompareOp = VK_COMPARE_OP_LESS,
+	};
+	VkGraphicsPipelineCreateInfo pipe_info = {
+	    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+	    .stageCount = 2,
+	    .pStages = stages,
+	    .pMultisampleState = &ms_state,
+	    .pDepthStencilState = &ds_state,
+	    .pColorBlendState = &blend_state,
+	    .renderPass = rp,
+	};
+	VkPipeline pipeline = NULL;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+
+	assert(wgvk_stub_color_target_count == 1);
+	assert(wgvk_stub_color_targets[0].format == WGPUTextureFormat_RGBA16Float);
+	assert(wgvk_stub_color_targets[0].writeMask ==
+	       (WGPUColorWriteMask_Red | WGPUColorWriteMask_Green | WGPUColorWriteMask_Blue));
+	assert(wgvk_stub_blend_states[0].color.srcFactor == WGPUBlendFactor_SrcAlpha);
+	assert(wgvk_stub_blend_states[0].color.dstFactor == WGPUBlendFactor_OneMinusSrcAlpha);
+	assert(wgvk_stub_blend_states[0].color.operation == WGPUBlendOperation_Add);
+	/* Min/max ignore factors in Vulkan; WebGPU requires One. */
+	assert(wgvk_stub_blend_states[0].alpha.operation == WGPUBlendOperation_Max);
+	assert(wgvk_stub_blend_states[0].alpha.srcFactor == WGPUBlendFactor_One);
+	assert(wgvk_stub_multisample.count == 4);
+	assert(wgvk_stub_multisample.mask == 0x7);
+	assert(wgvk_stub_multisample.alphaToCoverageEnabled);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Depth32Float);
+
+	VkImageView views[3] = {
+	    create_view(0x500, VK_FORMAT_R16G16B16A16_SFLOAT),
+	    create_view(0x501, VK_FORMAT_R16G16B16A16_SFLOAT),
+	    create_view(0x502, VK_FORMAT_D32_SFLOAT),
+	};
+	VkFramebufferCreateInfo fb_info = {
+	    .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+	    .renderPass = rp,
+	    .attachmentCount = 3,
+	    .pAttachments = views,
+	    .width = 64,
+	    .height = 64,
+	    .layers = 1,
+	};
+	VkFramebuffer fb = NULL;
+	assert(vkCreateFramebuffer(g_device, &fb_info, NULL, &fb) == VK_SUCCESS);
+
+	VkCommandBuffer cmd = begin_command_buffer();
+	VkRenderPassBeginInfo begin = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+	    .renderPass = rp,
+	    .framebuffer = fb,
+	    .renderArea = {.extent = {64, 64}},
+	};
+	vkCmdBeginRenderPass(cmd, &begin, VK_SUBPASS_CONTENTS_INLINE);
+	assert(wgvk_stub_color_attachment_count == 1);
+	assert(wgvk_stub_color_attachments[0].view == (WGPUTextureView)0x500);
+	assert(wgvk_stub_color_attachments[0].resolveTarget == (WGPUTextureView)0x501);
+	assert(wgvk_stub_color_attachments[0].storeOp == WGPUStoreOp_Discard);
+	vkCmdEndRenderPass(cmd);
+
+	vkFreeCommandBuffers(g_device, NULL, 1, &cmd);
+	vkDestroyFramebuffer(g_device, fb, NULL);
+	for (uint32_t i = 0; i < 3; i++) {
+		vkDestroyImageView(g_device, views[i], NULL);
+	}
+	vkDestroyPipeline(g_device, pipeline, NULL);
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_hdr_msaa_pipeline_and_resolve\n");
+}
+
+static void test_depth_only_pipeline_keeps_fragment(void) {
+	VkAttachmentDescription depth = {
+	    .format = VK_FORMAT_D32_SFLOAT,
+	    .samples = VK_SAMPLE_COUNT_1_BIT,
+	    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+	    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+	};
+	VkAttachmentReference depth_ref = {0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpass = {
+	    .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	    .pDepthStencilAttachment = &depth_ref,
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 1,
+	    .pAttachments = &depth,
+	    .subpassCount = 1,
+	    .pSubpasses = &subpass,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+
+	VkPipelineShaderStageCreateInfo stages[] = {
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_VERTEX_BIT,
+	     .pName = "main"},
+	    {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	     .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+	     .pName = "main"},
+	};
+	VkPipelineDepthStencilStateCreateInfo ds_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+	    .depthTestEnable = VK_TRUE,
+	    .depthWriteEnable = VK_TRUE,
+	    .depthCompareOp = VK_COMPARE_OP_LESS,
+	};
+	VkGraphicsPipelineCreateInfo pipe_info = {
+	    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+	    .stageCount = 2,
+	    .pStages = stages,
+	    .pDepthStencilState = &ds_state,
+	    .renderPass = rp,
+	};
+	VkPipeline pipeline = NULL;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(wgvk_stub_has_fragment);
+	assert(wgvk_stub_color_target_count == 0);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Depth32Float);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+
+	/* Without a fragment stage there is no fragment state */
+	pipe_info.stageCount = 1;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(!wgvk_stub_has_fragment);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+
+	vkDestroyRenderPass(g_device, rp, NULL);
+	printf("[PASS] test_depth_only_pipeline_keeps_fragment\n");
+}
+
+static void test_pipeline_depth_format_per_subpass(void) {
+	VkAttachmentDescription attachments[] = {
+	    {.format = VK_FORMAT_R8G8B8A8_UNORM, .samples = VK_SAMPLE_COUNT_1_BIT},
+	    {.format = VK_FORMAT_D32_SFLOAT, .samples = VK_SAMPLE_COUNT_1_BIT},
+	};
+	VkAttachmentReference color_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkAttachmentReference depth_ref = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpasses[] = {
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &color_ref,
+	     .pDepthStencilAttachment = &depth_ref},
+	    {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+	     .colorAttachmentCount = 1,
+	     .pColorAttachments = &color_ref},
+	};
+	VkRenderPassCreateInfo rp_info = {
+	    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+	    .attachmentCount = 2,
+	    .pAttachments = attachments,
+	    .subpassCount = 2,
+	    .pSubpasses = subpasses,
+	};
+	VkRenderPass rp = NULL;
+	assert(vkCreateRenderPass(g_device, &rp_info, NULL, &rp) == VK_SUCCESS);
+
+	VkPipelineShaderStageCreateInfo stage = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+	    .stage = VK_SHADER_STAGE_VERTEX_BIT,
+	    .pName = "main",
+	};
+	VkPipelineDepthStencilStateCreateInfo ds_state = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+	    .depthTestEnable = VK_TRUE,
+	    .depthCompareOp = VK_COMPARE_OP_LESS,
+	};
+	VkGraphicsPipelineCreateInfo pipe_info = {
+	    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+	    .stageCount = 1,
+	    .pStages = &stage,
+	    .pDepthStencilState = &ds_state,
+	    .renderPass = rp,
+	};
+	VkPipeline pipeline = NULL;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Depth32Float);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+
+	/* The second subpass has no depth attachment, so no depth state. */
+	pipe_info.subpass = 1;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Undefined);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+	vkDestroyRenderPass(g_device, rp, NULL);
+
+	/* Dynamic rendering takes the format from the rendering info. */
+	VkFormat color_format = VK_FORMAT_R8G8B8A8_UNORM;
+	VkPipelineRenderingCreateInfo rendering = {
+	    .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+	    .colorAttachmentCount = 1,
+	    .pColorAttachmentFormats = &color_format,
+	};
+	pipe_info.pNext = &rendering;
+	pipe_info.renderPass = NULL;
+	pipe_info.subpass = 0;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Undefined);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+
+	rendering.stencilAttachmentFormat = VK_FORMAT_D24_UNORM_S8_UINT;
+	assert(vkCreateGraphicsPipelines(g_device, NULL, 1, &pipe_info, NULL, &pipeline) ==
+	       VK_SUCCESS);
+	assert(wgvk_stub_depth_stencil_format == WGPUTextureFormat_Depth24PlusStencil8);
+	vkDestroyPipeline(g_device, pipeline, NULL);
+	printf("[PASS] test_pipeline_depth_format_per_subpass\n");
+}
+
+int main(void) {
+	setup_device();
+	test_load_store_ops_and_clear_values();
+	test_attachment_limit();
+	test_subpasses_split_and_merge();
+	test_next_subpass_restores_state();
+	test_dynamic_rendering();
+	test_suspend_resume_rendering();
+	test_hdr_msaa_pipeline_and_resolve();
+	test_depth_only_pipeline_keeps_fragment();
+	test_pipeline_depth_format_per_subpass();
+	test_transient_attachments();
+	teardown_device();
+	printf("test_render_pass: ALL PASSED\n");
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vulkan/vulkan.h>
+#include "webvulkan_internal.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static VkSamplerCreateInfo linear_repeat_info(void) {
+	VkSamplerCreateInfo info = {
+	    .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+	    .magFilter = VK_FILTER_LINEAR,
+	    .minFilter = VK_FILTER_LINEAR,
+	    .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+	    .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+	    .maxLod = VK_LOD_CLAMP_NONE,
+	};
+	return info;
+}
+
+static void test_null_create_info(void) {
+	VkSampler sampler = NULL;
+	assert(vkCreateSampler(g_device, NULL, NULL, &sampler) == VK_ERROR_INITIALIZATION_FAILED);
+	printf("[PASS] test_null_create_info\n");
+}
+
+static void test_identical_samplers_shared(void) {
+	VkSamplerCreateInfo info = linear_repeat_info();
+	VkSampler a = NULL;
+	VkSampler b = NULL;
+	assert(vkCreateSampler(g_device, &info, NULL, &a) == VK_SUCCESS);
+	assert(vkCreateSampler(g_device, &info, NULL, &b) == VK_SUCCESS);
+	assert(a != b);
+	assert(a->interned == b->interned);
+	assert(a->interned->ref_count == 2);
+	assert(g_device->sampler_cache.entry_count == 1);
+
+	info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	VkSampler c = NULL;
+	assert(vkCreateSampler(g_device, &info, NULL, &c) == VK_SUCCESS);
+	assert(c->interned != a->interned);
+	assert(g_device->sampler_cache.entry_count == 2);
+
+	vkDestroySampler(g_device, a, NULL);
+	vkDestroySampler(g_device, b, NULL);
+	vkDestroySampler(g_device, c, NULL);
+	assert(g_device->sampler_cache.entry_count == 0);
+	printf("[PASS] test_identical_samplers_shared\n");
+}
+
+static void test_canonicalized_equivalents_shared(void) {
+	/* Anisotropy is dropped when a filter is nearest, so these are one sampler. */
+	VkSamplerCreateInfo plain = linear_repeat_info();
+	plain.minFilter = VK_FILTER_NEAREST;
+	VkSamplerCreateInfo aniso = plain;
+	aniso.anisotropyEnable = VK_TRUE;
+	aniso.maxAnisotropy = 8.0f;
+	/* The compare op only matters when comparison is enabled. */
+	aniso.compareOp = VK_COMPARE_OP_LESS;
+
+	VkSampler a = NULL;
+	VkSampler b = NULL;
+	assert(vkCreateSampler(g_device, &plain, NULL, &a) == VK_SUCCESS);
+	assert(vkCreateSampler(g_device, &aniso, NULL, &b) == VK_SUCCESS);
+	assert(a->interned == b->interned);
+
+	vkDestroySampler(g_device, a, NULL);
+	vkDestroySampler(g_device, b, NULL);
+	printf("[PASS] test_canonicalized_equivalents_shared\n");
+}
+
+static void test_anisotropy_clamped(void) {
+	VkSamplerCreateInfo info = linear_repeat_info();
+	info.anisotropyEnable = VK_TRUE;
+	info.maxAnisotropy = 64.0f;
+	VkSampler a = NULL;
+	assert(vkCreateSampler(g_device, &info, NULL, &a) == VK_SUCCESS);
+
+	info.maxAnisotropy = 16.0f;
+	VkSampler b = NULL;
+	assert(vkCreateSampler(g_device, &info, NULL, &b) == VK_SUCCESS);
+	assert(a->interned == b->interned);
+
+	vkDestroySampler(g_device, a, NULL);
+	vkDestroySampler(g_device, b, NULL);
+	printf("[PASS] test_anisotropy_clamped\n");
+}
+
+int main(void) {
+	setup_device();
+	test_null_create_info();
+	test_identical_samplers_shared();
+	test_canonicalized_equivalents_shared();
+	test_anisotropy_clamped();
+	teardown_device();
+	printf("test_sampler: ALL PASSED\n");
+	return 0;
+}
@@ -105,6 +105,142 @@ static void test_simple_vertex_shader(void) {
     printf("[PASS] test_simple_vertex_shader\n");
 }
 
+/*
+ * Fragment shader with a descriptor array next to a plain binding:
+ *   layout(set = 0, binding = 0) uniform A { float x; } a[4];
+ *   layout(set = 0, binding = 1) uniform B { float x; } b;
+ * and an access chain a[i] with a non-constant i.
+ */
+static const uint32_t descriptor_array_spv[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x00000014, 0x00000000,
+    /* OpCapability Shader; OpMemoryModel Logical GLSL450 */
+    0x00020011, 0x00000001,
+    0x0003000E, 0x00000000, 0x00000001,
+    /* OpEntryPoint Fragment %1 "main" */
+    0x0005000F, 0x00000004, 0x00000001, 0x6E69616D, 0x00000000,
+    /* OpDecorate %10/%11 DescriptorSet 0, Binding 0/1 */
+    0x00040047, 10, 34, 0,
+    0x00040047, 10, 33, 0,
+    0x00040047, 11, 34, 0,
+    0x00040047, 11, 33, 1,
+    /* %2 void, %3 fn() -> void, %5 f32, %6 struct { f32 }, %7 u32 */
+    0x00020013, 2,
+    0x00030021, 3, 2,
+    0x00030016, 5, 32,
+    0x0003001E, 6, 5,
+    0x00040015, 7, 32, 0,
+    /* %8 = OpConstant u32 4; %9 = array<%6, 4> */
+    0x0004002B, 7, 8, 4,
+    0x0004001C, 9, 6, 8,
+    /* %12 Uniform ptr to %9, %13 Uniform ptr to %6, %14 Function ptr to u32 */
+    0x00040020, 12, 2, 9,
+    0x00040020, 13, 2, 6,
+    0x00040020, 14, 7, 7,
+    /* %10 = a, %11 = b */
+    0x0004003B, 12, 10, 2,
+    0x0004003B, 13, 11, 2,
+    /* main: %15 local index, %16 = load %15, %17 = &a[%16] */
+    0x00050036, 2, 1, 0, 3,
+    0x000200F8, 4,
+    0x0004003B, 14, 15, 7,
+    0x0004003D, 7, 16, 15,
+    0x00050041, 13, 17, 10, 16,
+    /* %19 = load %17; store %17 %19 */
+    0x0004003D, 6, 19, 17,
+    0x0003003E, 17, 19,
+    0x000100FD,
+    0x00010038,
+};
+
+/*
+ * Fragment shader indexing a sampler array dynamically:
+ *   layout(set = 0, binding = 0) uniform sampler s[4];  ... s[i]
+ */
+static const uint32_t sampler_array_spv[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x00000014, 0x00000000,
+    0x00020011, 0x00000001,
+    0x0003000E, 0x00000000, 0x00000001,
+    0x0005000F, 0x00000004, 0x00000001, 0x6E69616D, 0x00000000,
+    0x00040047, 10, 34, 0,
+    0x00040047, 10, 33, 0,
+    /* %2 void, %3 fn() -> void, %5 sampler, %7 u32, %9 array<%5, 4> */
+    0x00020013, 2,
+    0x00030021, 3, 2,
+    0x0002001A, 5,
+    0x00040015, 7, 32, 0,
+    0x0004002B, 7, 8, 4,
+    0x0004001C, 9, 5, 8,
+    /* %12 UniformConstant ptr to %9, %13 to %5, %14 Function ptr to u32 */
+    0x00040020, 12, 0, 9,
+    0x00040020, 13, 0, 5,
+    0x00040020, 14, 7, 7,
+    0x0004003B, 12, 10, 0,
+    0x00050036, 2, 1, 0, 3,
+    0x000200F8, 4,
+    0x0004003B, 14, 15, 7,
+    0x0004003D, 7, 16, 15,
+    0x00050041, 13, 17, 10, 16,
+    0x000100FD,
+    0x00010038,
+};
+
+static char* generate_descriptor_array_wgsl(const WgvkWgslBindingRemap* remaps,
+                                            uint32_t remap_count) {
+    WgvkSpvModule* module = calloc(1, sizeof(WgvkSpvModule));
+    assert(module);
+    assert(wgvk_spirv_parse(module, descriptor_array_spv,
+                            sizeof(descriptor_array_spv) / sizeof(uint32_t)) == 0);
+    WgvkWgslGenerator gen = {0};
+    assert(wgvk_wgsl_init(&gen, module, WGVK_SPV_EXEC_MODEL_FRAGMENT) == 0);
+    gen.remaps = remaps;
+    gen.remap_count = remap_count;
+    char* wgsl = wgvk_wgsl_generate(&gen);
+    assert(wgsl);
+    wgvk_wgsl_free(&gen);
+    wgvk_spirv_free(module);
+    free(module);
+    return wgsl;
+}
+
+static void test_descriptor_array_bindings(void) {
+    /* Without a table, elements 1..3 follow the highest declared binding. */
+    char* wgsl = generate_descriptor_array_wgsl(NULL, 0);
+    assert(strstr(wgsl, "@binding(0)\nvar<uniform> resource_0_0_0: Struct_6;"));
+    assert(strstr(wgsl, "@binding(2)\nvar<uniform> resource_0_0_1: Struct_6;"));
+    assert(strstr(wgsl, "@binding(4)\nvar<uniform> resource_0_0_3: Struct_6;"));
+    assert(strstr(wgsl, "@binding(1)\nvar<uniform> resource_0_1: Struct_6;"));
+    free(wgsl);
+
+    /* The layout's table wins, and a dynamic index goes through the accessor. */
+    WgvkWgslBindingRemap remap = {.set = 0, .binding = 0, .count = 4, .first_extra = 7};
+    wgsl = generate_descriptor_array_wgsl(&remap, 1);
+    assert(strstr(wgsl, "@binding(0)\nvar<uniform> resource_0_0_0: Struct_6;"));
+    assert(strstr(wgsl, "@binding(7)\nvar<uniform> resource_0_0_1: Struct_6;"));
+    assert(strstr(wgsl, "@binding(9)\nvar<uniform> resource_0_0_3: Struct_6;"));
+    assert(strstr(wgsl, "@binding(1)\nvar<uniform> resource_0_1: Struct_6;"));
+    /* Loads and stores through a dynamic index switch over the elements */
+    assert(strstr(wgsl, "var v19: Struct_6;\n    switch u32(v16) {\n"
+                        "        case 0u, default: { v19 = resource_0_0_0; }\n"
+                        "        case 1u: { v19 = resource_0_0_1; }\n"));
+    assert(strstr(wgsl, "        case 3u: { resource_0_0_3 = v19; }\n    }\n"));
+    assert(!strstr(wgsl, "v17"));
+    free(wgsl);
+
+    /* A dynamically indexed sampler array cannot be translated faithfully */
+    WgvkSpvModule* module = calloc(1, sizeof(WgvkSpvModule));
+    assert(module);
+    assert(wgvk_spirv_parse(module, sampler_array_spv,
+                            sizeof(sampler_array_spv) / sizeof(uint32_t)) == 0);
+    WgvkWgslGenerator gen = {0};
+    assert(wgvk_wgsl_init(&gen, module, WGVK_SPV_EXEC_MODEL_FRAGMENT) == 0);
+    assert(wgvk_wgsl_generate(&gen) == NULL);
+    wgvk_wgsl_free(&gen);
+    wgvk_spirv_free(module);
+    free(module);
+
+    printf("[PASS] test_descriptor_array_bindings\n");
+}
+
 static void test_get_type(void) {
     WgvkSpvModule* module = calloc(1, sizeof(WgvkSpvModule));
     if (!module) { printf("[SKIP] test_get_type (OOM)\n"); return; }
@@ -216,6 +352,8 @@ int main(void) {
     test_get_variable();
     printf("Running test_simple_vertex_shader...\n"); fflush(stdout);
     test_simple_vertex_shader();
+    printf("Running test_descriptor_array_bindings...\n"); fflush(stdout);
+    test_descriptor_array_bindings();
     
     printf("\n=== All tests passed ===\n");
     return 0;
@@ -0,0 +1,133 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webvulkan_internal.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static const WgvkCallStatistics *find_call(const WgvkCallStatistics *calls, uint32_t count,
+                                           const char *name) {
+	for (uint32_t i = 0; i < count; i++) {
+		if (strcmp(calls[i].name, name) == 0) {
+			return &calls[i];
+		}
+	}
+	return NULL;
+}
+
+static const WgvkObjectStatistics *find_object(const WgvkStatistics *stats, const char *name) {
+	for (uint32_t i = 0; i < stats->objectTypeCount; i++) {
+		if (strcmp(stats->pObjectTypes[i].typeName, name) == 0) {
+			return &stats->pObjectTypes[i];
+		}
+	}
+	return NULL;
+}
+
+static void test_entry_points_counted(void) {
+	wgvkResetStatistics();
+
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	for (int i = 0; i < 3; i++) {
+		VkFence fence = NULL;
+		assert(vkCreateFence(g_device, &info, NULL, &fence) == VK_SUCCESS);
+		vkDestroyFence(g_device, fence, NULL);
+	}
+	/* Failed calls are still calls */
+	assert(vkCreateFence(NULL, &info, NULL, NULL) != VK_SUCCESS);
+
+	WgvkStatistics stats;
+	wgvkGetStatistics(&stats);
+	assert(stats.enabled);
+	const WgvkCallStatistics *create =
+	    find_call(stats.pEntryPoints, stats.entryPointCount, "vkCreateFence");
+	const WgvkCallStatistics *destroy =
+	    find_call(stats.pEntryPoints, stats.entryPointCount, "vkDestroyFence");
+	assert(create && create->callCount == 4);
+	assert(destroy && destroy->callCount == 3);
+	assert(find_call(stats.pEntryPoints, stats.entryPointCount, "vkCmdDraw")->callCount == 0);
+
+	const WgvkObjectStatistics *fences = find_object(&stats, "VkFence");
+	assert(fences && fences->createdCount == 3 && fences->destroyedCount == 3);
+	printf("[PASS] test_entry_points_counted\n");
+}
+
+static void test_uploads_counted(void) {
+	wgvkResetStatistics();
+
+	VkMemoryAllocateInfo alloc = {
+	    .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+	    .allocationSize = 256,
+	};
+	VkDeviceMemory memory = NULL;
+	assert(vkAllocateMemory(g_device, &alloc, NULL, &memory) == VK_SUCCESS);
+	void *data = NULL;
+	assert(vkMapMemory(g_device, memory, 0, VK_WHOLE_SIZE, 0, &data) == VK_SUCCESS);
+	memset(data, 0xab, 256);
+	vkUnmapMemory(g_device, memory);
+	vkFreeMemory(g_device, memory, NULL);
+
+	WgvkStatistics stats;
+	wgvkGetStatistics(&stats);
+	assert(stats.bytesUploaded == 256);
+	const WgvkCallStatistics *write =
+	    find_call(stats.pWebGPUFunctions, stats.webgpuFunctionCount, "wgpuQueueWriteBuffer");
+	const WgvkCallStatistics *create =
+	    find_call(stats.pWebGPUFunctions, stats.webgpuFunctionCount, "wgpuDeviceCreateBuffer");
+	assert(write && write->callCount == 1);
+	assert(create && create->callCount == 1);
+	/* The create, the write and the buffer's release */
+	assert(stats.webgpuCallCount == 3);
+	printf("[PASS] test_uploads_counted\n");
+}
+
+static void test_reset_clears(void) {
+	VkFenceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	VkFence fence = NULL;
+	assert(vkCreateFence(g_device, &info, NULL, &fence) == VK_SUCCESS);
+	vkDestroyFence(g_device, fence, NULL);
+
+	wgvkResetStatistics();
+	WgvkStatistics stats;
+	wgvkGetStatistics(&stats);
+	for (uint32_t i = 0; i < stats.entryPointCount; i++) {
+		assert(stats.pEntryPoints[i].callCount == 0);
+		assert(stats.pEntryPoints[i].totalNanoseconds == 0);
+	}
+	assert(stats.webgpuCallCount == 0);
+	assert(stats.bytesUploaded == 0);
+	assert(find_object(&stats, "VkFence")->createdCount == 0);
+	printf("[PASS] test_reset_clears\n");
+}
+
+int main(void) {
+	setup_device();
+	test_entry_points_counted();
+	test_uploads_counted();
+	test_reset_clears();
+	teardown_device();
+	printf("test_stats: ALL PASSED\n");
+	return 0;
+}
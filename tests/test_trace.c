@@ -0,0 +1,224 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+#include <webvulkan.h>
+#include "webvulkan_internal.h"
+#include "util/trace.h"
+
+static VkInstance g_instance;
+static VkDevice g_device;
+static char g_json[65536];
+
+static void setup_device(void) {
+	VkInstanceCreateInfo info = {.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+	assert(vkCreateInstance(&info, NULL, &g_instance) == VK_SUCCESS);
+
+	uint32_t count = 1;
+	VkPhysicalDevice phys_dev = NULL;
+	assert(vkEnumeratePhysicalDevices(g_instance, &count, &phys_dev) == VK_SUCCESS);
+	phys_dev->wgpu_adapter = (WGPUAdapter)(uintptr_t)1;
+
+	VkDeviceCreateInfo dev_info = {.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+	assert(vkCreateDevice(phys_dev, &dev_info, NULL, &g_device) == VK_SUCCESS);
+}
+
+static void teardown_device(void) {
+	vkDestroyDevice(g_device, NULL);
+	vkDestroyInstance(g_instance, NULL);
+}
+
+static int count_occurrences(const char *haystack, const char *needle) {
+	int count = 0;
+	for (const char *p = strstr(haystack, needle); p; p = strstr(p + 1, needle)) {
+		count++;
+	}
+	return count;
+}
+
+static void test_disabled_records_nothing(void) {
+	wgvkSetTracing(1);
+	wgvkSetTracing(0);
+	VkQueue queue = NULL;
+	vkGetDeviceQueue(g_device, 0, 0, &queue);
+	assert(vkQueueSubmit(queue, 0, NULL, VK_NULL_HANDLE) == VK_SUCCESS);
+
+	size_t length = wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(length < sizeof(g_json));
+	assert(strstr(g_json, "{\"traceEvents\":[]") == g_json);
+	printf("[PASS] test_disabled_records_nothing\n");
+}
+
+static void test_spans_exported(void) {
+	VkQueue queue = NULL;
+	vkGetDeviceQueue(g_device, 0, 0, &queue);
+
+	VkCommandBufferAllocateInfo alloc = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &alloc, &cmd) == VK_SUCCESS);
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin) == VK_SUCCESS);
+
+	wgvkSetTracing(1);
+	VkRenderPassBeginInfo pass = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+	vkCmdBeginRenderPass(cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdEndRenderPass(cmd);
+	assert(vkEndCommandBuffer(cmd) == VK_SUCCESS);
+	VkSubmitInfo submit = {
+	    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+	    .commandBufferCount = 1,
+	    .pCommandBuffers = &cmd,
+	};
+	assert(vkQueueSubmit(queue, 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
+	wgvkSetTracing(0);
+
+	size_t length = wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(length == strlen(g_json));
+	assert(count_occurrences(g_json, "\"name\":\"render pass\",\"cat\":\"command\",\"ph\":\"B\"") ==
+	       1);
+	assert(count_occurrences(g_json, "\"name\":\"render pass\",\"cat\":\"command\",\"ph\":\"E\"") ==
+	       1);
+	assert(count_occurrences(g_json, "\"name\":\"vkQueueSubmit\",\"cat\":\"sync\",\"ph\":\"B\"") ==
+	       1);
+	assert(count_occurrences(g_json, "\"name\":\"vkQueueSubmit\",\"cat\":\"sync\",\"ph\":\"E\"") ==
+	       1);
+	assert(strstr(g_json, "\"droppedEvents\":0}}") != NULL);
+
+	vkFreeCommandBuffers(g_device, VK_NULL_HANDLE, 1, &cmd);
+	printf("[PASS] test_spans_exported\n");
+}
+
+static VkCommandBuffer begin_recording(void) {
+	VkCommandBufferAllocateInfo alloc = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandBufferCount = 1,
+	};
+	VkCommandBuffer cmd = NULL;
+	assert(vkAllocateCommandBuffers(g_device, &alloc, &cmd) == VK_SUCCESS);
+	VkCommandBufferBeginInfo begin = {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	assert(vkBeginCommandBuffer(cmd, &begin) == VK_SUCCESS);
+	return cmd;
+}
+
+static void test_rendering_span(void) {
+	VkCommandBuffer cmd = begin_recording();
+	wgvkSetTracing(1);
+	VkRenderingInfo rendering = {.sType = VK_STRUCTURE_TYPE_RENDERING_INFO, .layerCount = 1};
+	vkCmdBeginRendering(cmd, &rendering);
+	vkCmdEndRendering(cmd);
+	wgvkSetTracing(0);
+
+	wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(count_occurrences(g_json, "\"name\":\"rendering\",\"cat\":\"command\",\"ph\":\"B\"") ==
+	       1);
+	assert(count_occurrences(g_json, "\"name\":\"rendering\",\"cat\":\"command\",\"ph\":\"E\"") ==
+	       1);
+
+	assert(vkEndCommandBuffer(cmd) == VK_SUCCESS);
+	vkFreeCommandBuffers(g_device, VK_NULL_HANDLE, 1, &cmd);
+	printf("[PASS] test_rendering_span\n");
+}
+
+/* A pass that began outside the current trace must not end in it. */
+static void test_toggle_mid_pass_leaves_no_end(void) {
+	VkCommandBuffer cmd = begin_recording();
+	VkRenderPassBeginInfo pass = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+
+	vkCmdBeginRenderPass(cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	wgvkSetTracing(1);
+	vkCmdEndRenderPass(cmd);
+	wgvkSetTracing(0);
+	wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(strstr(g_json, "\"render pass\"") == NULL);
+
+	wgvkSetTracing(1);
+	vkCmdBeginRenderPass(cmd, &pass, VK_SUBPASS_CONTENTS_INLINE);
+	wgvkSetTracing(1);
+	vkCmdEndRenderPass(cmd);
+	wgvkSetTracing(0);
+	wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(strstr(g_json, "\"render pass\"") == NULL);
+
+	assert(vkEndCommandBuffer(cmd) == VK_SUCCESS);
+	vkFreeCommandBuffers(g_device, VK_NULL_HANDLE, 1, &cmd);
+	printf("[PASS] test_toggle_mid_pass_leaves_no_end\n");
+}
+
+static void test_truncated_output_reports_length(void) {
+	wgvkSetTracing(1);
+	wgvk_trace_begin(WGVK_LOG_CAT_GENERAL, "outer");
+	wgvk_trace_end(WGVK_LOG_CAT_GENERAL, "outer");
+	wgvkSetTracing(0);
+
+	size_t full = wgvkGetTraceJson(NULL, 0);
+	char small[16];
+	assert(wgvkGetTraceJson(small, sizeof(small)) == full);
+	assert(strlen(small) == sizeof(small) - 1);
+	assert(wgvkGetTraceJson(g_json, sizeof(g_json)) == full);
+	assert(strlen(g_json) == full);
+	printf("[PASS] test_truncated_output_reports_length\n");
+}
+
+static void test_restart_discards_previous(void) {
+	wgvkSetTracing(1);
+	wgvk_trace_begin(WGVK_LOG_CAT_GENERAL, "first");
+	wgvk_trace_end(WGVK_LOG_CAT_GENERAL, "first");
+	wgvkSetTracing(1);
+	wgvk_trace_begin(WGVK_LOG_CAT_GENERAL, "second");
+	wgvk_trace_end(WGVK_LOG_CAT_GENERAL, "second");
+	wgvkSetTracing(0);
+
+	wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(strstr(g_json, "\"first\"") == NULL);
+	assert(count_occurrences(g_json, "\"second\"") == 2);
+	printf("[PASS] test_restart_discards_previous\n");
+}
+
+static void *record_on_thread(void *arg) {
+	(void)arg;
+	for (int i = 0; i < 100; i++) {
+		WGVK_SPAN(WGVK_LOG_CAT_SHADER, "worker");
+	}
+	return NULL;
+}
+
+static void test_threads_get_own_buffers(void) {
+	wgvkSetTracing(1);
+	wgvk_trace_begin(WGVK_LOG_CAT_GENERAL, "main");
+	pthread_t threads[2];
+	for (int i = 0; i < 2; i++) {
+		assert(pthread_create(&threads[i], NULL, record_on_thread, NULL) == 0);
+	}
+	for (int i = 0; i < 2; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	wgvk_trace_end(WGVK_LOG_CAT_GENERAL, "main");
+	wgvkSetTracing(0);
+
+	wgvkGetTraceJson(g_json, sizeof(g_json));
+	assert(count_occurrences(g_json, "\"worker\"") == 400);
+	assert(count_occurrences(g_json, "\"main\"") == 2);
+	/* The main thread plus one buffer per worker */
+	assert(strstr(g_json, "\"tid\":2}") != NULL);
+	assert(strstr(g_json, "\"tid\":3}") != NULL);
+	printf("[PASS] test_threads_get_own_buffers\n");
+}
+
+int main(void) {
+	setup_device();
+	test_disabled_records_nothing();
+	test_spans_exported();
+	test_rendering_span();
+	test_toggle_mid_pass_leaves_no_end();
+	test_truncated_output_reports_length();
+	test_restart_discards_previous();
+	test_threads_get_own_buffers();
+	teardown_device();
+	printf("test_trace: ALL PASSED\n");
+	return 0;
+}
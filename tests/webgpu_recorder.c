@@ -0,0 +1,306 @@
+#include "webgpu_recorder.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define WGVK_REC_MAGIC "WGVKREC1"
+#define WGVK_REC_MAGIC_SIZE 8
+/* Handles handed out while recording start here, clear of the constants
+ * the stubs otherwise return. */
+#define WGVK_REC_FIRST_HANDLE 0x10000
+
+int wgvk_rec_active;
+
+#define WGVK_REC_NAME(name) #name,
+static const char *const op_names[WGVK_REC_OP_COUNT] = {WGVK_WGPU_FUNCTIONS(WGVK_REC_NAME)};
+#undef WGVK_REC_NAME
+
+static struct {
+	uint32_t flags;
+	uint64_t counts[WGVK_REC_OP_COUNT];
+	uint64_t total_cost_ns;
+	uint64_t default_cost_ns;
+	uint64_t costs[WGVK_REC_OP_COUNT];
+	int has_cost[WGVK_REC_OP_COUNT];
+	uintptr_t next_handle;
+	uint8_t *trace;
+	size_t trace_size;
+	size_t trace_capacity;
+} g_rec;
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int reserve(size_t extra) {
+	if (g_rec.trace_size + extra <= g_rec.trace_capacity) {
+		return 1;
+	}
+	size_t capacity = g_rec.trace_capacity ? g_rec.trace_capacity * 2 : 4096;
+	while (capacity < g_rec.trace_size + extra) {
+		capacity *= 2;
+	}
+	uint8_t *trace = realloc(g_rec.trace, capacity);
+	if (!trace) {
+		return 0;
+	}
+	g_rec.trace = trace;
+	g_rec.trace_capacity = capacity;
+	return 1;
+}
+
+static void put_varint(uint64_t value) {
+	do {
+		uint8_t byte = value & 0x7f;
+		value >>= 7;
+		g_rec.trace[g_rec.trace_size++] = byte | (value ? 0x80 : 0);
+	} while (value);
+}
+
+static int get_varint(const uint8_t *trace, size_t size, size_t *pos, uint64_t *value) {
+	uint64_t result = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7) {
+		if (*pos >= size) {
+			return 0;
+		}
+		uint8_t byte = trace[(*pos)++];
+		result |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void wgvk_rec_begin(uint32_t flags) {
+	g_rec.flags = flags;
+	memset(g_rec.counts, 0, sizeof(g_rec.counts));
+	g_rec.total_cost_ns = 0;
+	g_rec.next_handle = WGVK_REC_FIRST_HANDLE;
+	g_rec.trace_size = 0;
+	if ((flags & WGVK_REC_TRACE) && reserve(WGVK_REC_MAGIC_SIZE)) {
+		memcpy(g_rec.trace, WGVK_REC_MAGIC, WGVK_REC_MAGIC_SIZE);
+		g_rec.trace_size = WGVK_REC_MAGIC_SIZE;
+	}
+	wgvk_rec_active = 1;
+}
+
+void wgvk_rec_end(void) {
+	wgvk_rec_active = 0;
+}
+
+void wgvk_rec_set_default_cost(uint64_t ns) {
+	g_rec.default_cost_ns = ns;
+}
+
+void wgvk_rec_set_cost(WgvkRecOp op, uint64_t ns) {
+	if (op < WGVK_REC_OP_COUNT) {
+		g_rec.costs[op] = ns;
+		g_rec.has_cost[op] = 1;
+	}
+}
+
+uint64_t wgvk_rec_count(WgvkRecOp op) {
+	return op < WGVK_REC_OP_COUNT ? g_rec.counts[op] : 0;
+}
+
+uint64_t wgvk_rec_total_calls(void) {
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < WGVK_REC_OP_COUNT; i++) {
+		total += g_rec.counts[i];
+	}
+	return total;
+}
+
+uint64_t wgvk_rec_total_cost_ns(void) {
+	return g_rec.total_cost_ns;
+}
+
+const char *wgvk_rec_op_name(WgvkRecOp op) {
+	return op < WGVK_REC_OP_COUNT ? op_names[op] : "unknown";
+}
+
+uintptr_t wgvk_rec_handle(void) {
+	return wgvk_rec_active ? g_rec.next_handle++ : 1;
+}
+
+uint32_t wgvk_rec_hash(const void *data, size_t size) {
+	const uint8_t *bytes = data;
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; bytes && i < size; i++) {
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+void wgvk_rec_call(WgvkRecOp op, const uint64_t *args, uint32_t arg_count) {
+	g_rec.counts[op]++;
+	uint64_t cost = g_rec.has_cost[op] ? g_rec.costs[op] : g_rec.default_cost_ns;
+	g_rec.total_cost_ns += cost;
+	if ((g_rec.flags & WGVK_REC_SPIN) && cost) {
+		uint64_t until = now_ns() + cost;
+		while (now_ns() < until) {
+		}
+	}
+
+	if (!(g_rec.flags & WGVK_REC_TRACE)) {
+		return;
+	}
+	if (arg_count > WGVK_REC_MAX_ARGS) {
+		arg_count = WGVK_REC_MAX_ARGS;
+	}
+	// Varints take at most 10 bytes each
+	if (!reserve(10 * (2 + (size_t)arg_count))) {
+		return;
+	}
+	put_varint(op);
+	put_varint(arg_count);
+	for (uint32_t i = 0; i < arg_count; i++) {
+		put_varint(args[i]);
+	}
+}
+
+const uint8_t *wgvk_rec_trace(size_t *size) {
+	*size = g_rec.trace_size;
+	return g_rec.trace;
+}
+
+int wgvk_rec_save(const char *path) {
+	FILE *file = fopen(path, "wb");
+	if (!file) {
+		return -1;
+	}
+	size_t written = fwrite(g_rec.trace, 1, g_rec.trace_size, file);
+	int closed = fclose(file);
+	return written == g_rec.trace_size && closed == 0 ? 0 : -1;
+}
+
+uint8_t *wgvk_rec_load(const char *path, size_t *size) {
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		return NULL;
+	}
+	uint8_t *trace = NULL;
+	if (fseek(file, 0, SEEK_END) == 0) {
+		long length = ftell(file);
+		if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+			trace = malloc(length ? (size_t)length : 1);
+			if (trace && fread(trace, 1, (size_t)length, file) == (size_t)length) {
+				*size = (size_t)length;
+			} else {
+				free(trace);
+				trace = NULL;
+			}
+		}
+	}
+	fclose(file);
+	return trace;
+}
+
+static int next_call(const uint8_t *trace, size_t size, size_t *pos, WgvkRecCall *call) {
+	uint64_t op, count;
+	if (!get_varint(trace, size, pos, &op) || op >= WGVK_REC_OP_COUNT ||
+	    !get_varint(trace, size, pos, &count) || count > WGVK_REC_MAX_ARGS) {
+		return 0;
+	}
+	call->op = (WgvkRecOp)op;
+	call->arg_count = (uint32_t)count;
+	for (uint32_t i = 0; i < call->arg_count; i++) {
+		if (!get_varint(trace, size, pos, &call->args[i])) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static int has_magic(const uint8_t *trace, size_t size) {
+	return trace && size >= WGVK_REC_MAGIC_SIZE &&
+	       memcmp(trace, WGVK_REC_MAGIC, WGVK_REC_MAGIC_SIZE) == 0;
+}
+
+long wgvk_rec_replay(const uint8_t *trace, size_t size, WgvkRecVisitor visitor, void *user_data) {
+	if (!has_magic(trace, size)) {
+		return -1;
+	}
+	size_t pos = WGVK_REC_MAGIC_SIZE;
+	long calls = 0;
+	while (pos < size) {
+		WgvkRecCall call;
+		if (!next_call(trace, size, &pos, &call)) {
+			return -1;
+		}
+		if (visitor) {
+			visitor(&call, user_data);
+		}
+		calls++;
+	}
+	return calls;
+}
+
+void wgvk_rec_print_call(const WgvkRecCall *call, FILE *out) {
+	fprintf(out, "%s(", wgvk_rec_op_name(call->op));
+	for (uint32_t i = 0; i < call->arg_count; i++) {
+		fprintf(out, i ? ", 0x%llx" : "0x%llx", (unsigned long long)call->args[i]);
+	}
+	fprintf(out, ")\n");
+}
+
+static void count_call(const WgvkRecCall *call, void *user_data) {
+	((int64_t *)user_data)[call->op]++;
+}
+
+static int same_call(const WgvkRecCall *a, const WgvkRecCall *b) {
+	return a->op == b->op && a->arg_count == b->arg_count &&
+	       memcmp(a->args, b->args, a->arg_count * sizeof(a->args[0])) == 0;
+}
+
+long wgvk_rec_diff(const uint8_t *a, size_t a_size, const uint8_t *b, size_t b_size, FILE *report) {
+	if (!has_magic(a, a_size) || !has_magic(b, b_size)) {
+		return 0;
+	}
+	size_t a_pos = WGVK_REC_MAGIC_SIZE;
+	size_t b_pos = WGVK_REC_MAGIC_SIZE;
+	long index = 0;
+	WgvkRecCall a_call, b_call;
+	int a_more, b_more;
+	for (;;) {
+		a_more = a_pos < a_size && next_call(a, a_size, &a_pos, &a_call);
+		b_more = b_pos < b_size && next_call(b, b_size, &b_pos, &b_call);
+		if (!a_more && !b_more) {
+			return -1;
+		}
+		if (a_more != b_more || !same_call(&a_call, &b_call)) {
+			break;
+		}
+		index++;
+	}
+
+	if (report) {
+		fprintf(report, "traces differ at call %ld\n  a: ", index);
+		if (a_more) {
+			wgvk_rec_print_call(&a_call, report);
+		} else {
+			fprintf(report, "<end>\n");
+		}
+		fprintf(report, "  b: ");
+		if (b_more) {
+			wgvk_rec_print_call(&b_call, report);
+		} else {
+			fprintf(report, "<end>\n");
+		}
+
+		int64_t a_counts[WGVK_REC_OP_COUNT] = {0};
+		int64_t b_counts[WGVK_REC_OP_COUNT] = {0};
+		wgvk_rec_replay(a, a_size, count_call, a_counts);
+		wgvk_rec_replay(b, b_size, count_call, b_counts);
+		for (uint32_t i = 0; i < WGVK_REC_OP_COUNT; i++) {
+			if (a_counts[i] != b_counts[i]) {
+				fprintf(report, "  %s: %lld -> %lld\n", op_names[i], (long long)a_counts[i],
+				        (long long)b_counts[i]);
+			}
+		}
+	}
+	return index;
+}
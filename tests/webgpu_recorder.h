@@ -0,0 +1,102 @@
+/*
+ * Recording layer for webgpu_stubs.c.
+ *
+ * While a recording is active every stubbed WebGPU call is counted, charged
+ * a modeled cost and, with WGVK_REC_TRACE, appended to a compact binary
+ * trace together with its scalar arguments and handles. Objects created
+ * during a recording get distinct handles, so traces show which buffer or
+ * bind group each call used.
+ *
+ * Trace format: the 8-byte magic "WGVKREC1", then one record per call made
+ * of the op, the argument count and the arguments, each a LEB128 varint.
+ * Descriptor arguments are reduced to the fields the layer sets, and
+ * uploaded data to an FNV-1a hash.
+ */
+
+#ifndef WGVK_WEBGPU_RECORDER_H
+#define WGVK_WEBGPU_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "util/wgpu_calls.h"
+
+#define WGVK_REC_ENUM(name) WGVK_REC_##name,
+typedef enum WgvkRecOp { WGVK_WGPU_FUNCTIONS(WGVK_REC_ENUM) WGVK_REC_OP_COUNT } WgvkRecOp;
+#undef WGVK_REC_ENUM
+
+#define WGVK_REC_MAX_ARGS 16
+
+/* Keep the binary trace as well as the counts. */
+#define WGVK_REC_TRACE 0x1
+/* Busy-wait for each call's modeled cost instead of only adding it up. */
+#define WGVK_REC_SPIN 0x2
+
+typedef struct WgvkRecCall {
+	WgvkRecOp op;
+	uint32_t arg_count;
+	uint64_t args[WGVK_REC_MAX_ARGS];
+} WgvkRecCall;
+
+typedef void (*WgvkRecVisitor)(const WgvkRecCall *call, void *user_data);
+
+extern int wgvk_rec_active;
+
+/* Start a recording, discarding the previous one. Costs persist. */
+void wgvk_rec_begin(uint32_t flags);
+void wgvk_rec_end(void);
+
+/* Modeled cost of one call into WebGPU; op costs override the default. */
+void wgvk_rec_set_default_cost(uint64_t ns);
+void wgvk_rec_set_cost(WgvkRecOp op, uint64_t ns);
+
+uint64_t wgvk_rec_count(WgvkRecOp op);
+uint64_t wgvk_rec_total_calls(void);
+uint64_t wgvk_rec_total_cost_ns(void);
+
+/* Trace of the current or last recording; valid until the next begin. */
+const uint8_t *wgvk_rec_trace(size_t *size);
+int wgvk_rec_save(const char *path);
+/* Returns a malloc'd trace, or NULL when the file cannot be read. */
+uint8_t *wgvk_rec_load(const char *path, size_t *size);
+
+/* Decode a trace call by call. Returns the number of calls, or -1 when the
+ * trace is malformed. */
+long wgvk_rec_replay(const uint8_t *trace, size_t size, WgvkRecVisitor visitor, void *user_data);
+
+/* One line per call: the function name and its arguments. */
+void wgvk_rec_print_call(const WgvkRecCall *call, FILE *out);
+
+/* Compare two traces call by call. Returns -1 when they match, otherwise the
+ * index of the first differing call. With a report stream, also prints that
+ * call from both sides and the per-function count changes. */
+long wgvk_rec_diff(const uint8_t *a, size_t a_size, const uint8_t *b, size_t b_size, FILE *report);
+
+const char *wgvk_rec_op_name(WgvkRecOp op);
+
+/* Handle for an object a stub creates. */
+uintptr_t wgvk_rec_handle(void);
+
+void wgvk_rec_call(WgvkRecOp op, const uint64_t *args, uint32_t arg_count);
+
+uint32_t wgvk_rec_hash(const void *data, size_t size);
+
+#define WGVK_REC_ARG(value) ((uint64_t)(uintptr_t)(value))
+
+static inline uint64_t wgvk_rec_float(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+#define WGVK_REC(fn, ...)                                                     \
+	do {                                                                      \
+		if (wgvk_rec_active) {                                                \
+			const uint64_t wgvk_rec_args[] = {__VA_ARGS__};                   \
+			wgvk_rec_call(WGVK_REC_##fn, wgvk_rec_args,                       \
+			              sizeof(wgvk_rec_args) / sizeof(wgvk_rec_args[0]));  \
+		}                                                                     \
+	} while (0)
+
+#endif
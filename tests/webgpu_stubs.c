@@ -1,310 +1,400 @@
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <webgpu/webgpu.h>
+#include "webgpu_recorder.h"
 
 WGPUInstance wgpuCreateInstance(const WGPUInstanceDescriptor *descriptor) {
-	(void)descriptor;
+	WGVK_REC(wgpuCreateInstance, descriptor != NULL);
 	return (WGPUInstance)(uintptr_t)1;
 }
 void wgpuInstanceRelease(WGPUInstance instance) {
-	(void)instance;
+	WGVK_REC(wgpuInstanceRelease, WGVK_REC_ARG(instance));
 }
 void wgpuAdapterRelease(WGPUAdapter adapter) {
-	(void)adapter;
+	WGVK_REC(wgpuAdapterRelease, WGVK_REC_ARG(adapter));
 }
 WGPUDevice wgpuAdapterRequestDeviceSync(WGPUAdapter adapter, const WGPUDeviceDescriptor *descriptor) {
-	(void)adapter;
-	(void)descriptor;
+	WGVK_REC(wgpuAdapterRequestDeviceSync, WGVK_REC_ARG(adapter),
+	         descriptor ? descriptor->requiredFeatureCount : 0);
 	return (WGPUDevice)(uintptr_t)1;
 }
+/* Features both the adapter and the device report; tests fill this in. */
+WGPUFeatureName wgvk_stub_features[8];
+uint32_t wgvk_stub_feature_count;
+static WGPUBool stub_has_feature(WGPUFeatureName feature) {
+	for (uint32_t i = 0; i < wgvk_stub_feature_count; i++) {
+		if (wgvk_stub_features[i] == feature)
+			return 1;
+	}
+	return 0;
+}
+WGPUBool wgpuAdapterHasFeature(WGPUAdapter adapter, WGPUFeatureName feature) {
+	WGVK_REC(wgpuAdapterHasFeature, WGVK_REC_ARG(adapter), feature);
+	return stub_has_feature(feature);
+}
+WGPUBool wgpuDeviceHasFeature(WGPUDevice device, WGPUFeatureName feature) {
+	WGVK_REC(wgpuDeviceHasFeature, WGVK_REC_ARG(device), feature);
+	return stub_has_feature(feature);
+}
 void wgpuDeviceRelease(WGPUDevice device) {
-	(void)device;
+	WGVK_REC(wgpuDeviceRelease, WGVK_REC_ARG(device));
 }
 WGPUQueue wgpuDeviceGetQueue(WGPUDevice device) {
-	(void)device;
+	WGVK_REC(wgpuDeviceGetQueue, WGVK_REC_ARG(device));
 	return (WGPUQueue)(uintptr_t)1;
 }
 void wgpuQueueRelease(WGPUQueue queue) {
-	(void)queue;
+	WGVK_REC(wgpuQueueRelease, WGVK_REC_ARG(queue));
 }
 void wgpuQueueAddRef(WGPUQueue queue) {
-	(void)queue;
+	WGVK_REC(wgpuQueueAddRef, WGVK_REC_ARG(queue));
 }
 void wgpuQueueSubmit(WGPUQueue queue, size_t commandCount, const WGPUCommandBuffer *commands) {
-	(void)queue;
-	(void)commandCount;
-	(void)commands;
+	WGVK_REC(wgpuQueueSubmit, WGVK_REC_ARG(queue), commandCount,
+	         wgvk_rec_hash(commands, commandCount * sizeof(*commands)));
 }
+/* Start of the last queue write, for tests to inspect. */
+uint8_t wgvk_stub_write_data[1024];
+size_t wgvk_stub_write_size;
+
 void wgpuQueueWriteBuffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t offset, const void *data,
                           size_t size) {
-	(void)queue;
-	(void)buffer;
-	(void)offset;
-	(void)data;
-	(void)size;
+	WGVK_REC(wgpuQueueWriteBuffer, WGVK_REC_ARG(queue), WGVK_REC_ARG(buffer), offset, size,
+	         wgvk_rec_hash(data, size));
+	wgvk_stub_write_size = size;
+	memcpy(wgvk_stub_write_data, data, size < sizeof(wgvk_stub_write_data) ? size
+	                                                                       : sizeof(wgvk_stub_write_data));
 }
 WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice device, const WGPUBufferDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUBuffer)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateBuffer, WGVK_REC_ARG(device), descriptor->size, descriptor->usage);
+	return (WGPUBuffer)wgvk_rec_handle();
 }
 void wgpuBufferRelease(WGPUBuffer buffer) {
-	(void)buffer;
+	WGVK_REC(wgpuBufferRelease, WGVK_REC_ARG(buffer));
 }
+/* Texture lifetime counts and the most recent texture usage. */
+uint32_t wgvk_stub_texture_count;
+uint32_t wgvk_stub_texture_release_count;
+WGPUTextureUsage wgvk_stub_texture_usage;
 WGPUTexture wgpuDeviceCreateTexture(WGPUDevice device, const WGPUTextureDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUTexture)(uintptr_t)1;
+	if (descriptor) {
+		WGVK_REC(wgpuDeviceCreateTexture, WGVK_REC_ARG(device), descriptor->format,
+		         descriptor->dimension, descriptor->size.width, descriptor->size.height,
+		         descriptor->size.depthOrArrayLayers, descriptor->mipLevelCount,
+		         descriptor->sampleCount, descriptor->usage);
+		wgvk_stub_texture_usage = descriptor->usage;
+	}
+	wgvk_stub_texture_count++;
+	return (WGPUTexture)wgvk_rec_handle();
 }
 void wgpuTextureRelease(WGPUTexture texture) {
-	(void)texture;
+	WGVK_REC(wgpuTextureRelease, WGVK_REC_ARG(texture));
+	wgvk_stub_texture_release_count++;
 }
+/* Most recent texture view descriptor and the number of views created. */
+WGPUTextureViewDescriptor wgvk_stub_view_desc;
+uint32_t wgvk_stub_view_count;
 WGPUTextureView wgpuTextureCreateView(WGPUTexture texture, const WGPUTextureViewDescriptor *descriptor) {
-	(void)texture;
-	(void)descriptor;
-	return (WGPUTextureView)(uintptr_t)1;
+	if (descriptor) {
+		WGVK_REC(wgpuTextureCreateView, WGVK_REC_ARG(texture), descriptor->format,
+		         descriptor->dimension, descriptor->baseMipLevel, descriptor->mipLevelCount,
+		         descriptor->baseArrayLayer, descriptor->arrayLayerCount, descriptor->aspect);
+		wgvk_stub_view_desc = *descriptor;
+	} else {
+		WGVK_REC(wgpuTextureCreateView, WGVK_REC_ARG(texture));
+	}
+	wgvk_stub_view_count++;
+	return (WGPUTextureView)wgvk_rec_handle();
 }
 void wgpuTextureViewRelease(WGPUTextureView view) {
-	(void)view;
+	WGVK_REC(wgpuTextureViewRelease, WGVK_REC_ARG(view));
 }
 WGPUTextureFormat wgpuTextureGetFormat(WGPUTexture texture) {
 	(void)texture;
     return WGPUTextureFormat_Undefined;
 }
 WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice device, const WGPUShaderModuleDescriptor *descriptor) {
-	(void)device;
 	(void)descriptor;
-	return (WGPUShaderModule)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateShaderModule, WGVK_REC_ARG(device));
+	return (WGPUShaderModule)wgvk_rec_handle();
 }
 void wgpuShaderModuleRelease(WGPUShaderModule module) {
-	(void)module;
-}
+	WGVK_REC(wgpuShaderModuleRelease, WGVK_REC_ARG(module));
+}
+/* Last render pipeline descriptor, for tests to inspect. */
+WGPUColorTargetState wgvk_stub_color_targets[8];
+WGPUBlendState wgvk_stub_blend_states[8];
+uint32_t wgvk_stub_color_target_count;
+int wgvk_stub_has_fragment;
+WGPUMultisampleState wgvk_stub_multisample;
+WGPUTextureFormat wgvk_stub_depth_stencil_format;
+
 WGPURenderPipeline wgpuDeviceCreateRenderPipeline(WGPUDevice device, const WGPURenderPipelineDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPURenderPipeline)(uintptr_t)1;
+	wgvk_stub_color_target_count = 0;
+	wgvk_stub_has_fragment = descriptor->fragment != NULL;
+	if (descriptor->fragment) {
+		wgvk_stub_color_target_count = (uint32_t)descriptor->fragment->targetCount;
+		for (uint32_t i = 0; i < wgvk_stub_color_target_count && i < 8; i++) {
+			wgvk_stub_color_targets[i] = descriptor->fragment->targets[i];
+			if (descriptor->fragment->targets[i].blend) {
+				wgvk_stub_blend_states[i] = *descriptor->fragment->targets[i].blend;
+			}
+		}
+	}
+	wgvk_stub_multisample = descriptor->multisample;
+	wgvk_stub_depth_stencil_format = descriptor->depthStencil ? descriptor->depthStencil->format
+	                                                          : WGPUTextureFormat_Undefined;
+	WGVK_REC(wgpuDeviceCreateRenderPipeline, WGVK_REC_ARG(device), WGVK_REC_ARG(descriptor->layout),
+	         wgvk_stub_color_target_count, descriptor->multisample.count,
+	         wgvk_stub_depth_stencil_format);
+	return (WGPURenderPipeline)wgvk_rec_handle();
 }
 void wgpuRenderPipelineRelease(WGPURenderPipeline pipeline) {
-	(void)pipeline;
+	WGVK_REC(wgpuRenderPipelineRelease, WGVK_REC_ARG(pipeline));
 }
 WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice device, const WGPUComputePipelineDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUComputePipeline)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateComputePipeline, WGVK_REC_ARG(device),
+	         WGVK_REC_ARG(descriptor->layout));
+	return (WGPUComputePipeline)wgvk_rec_handle();
 }
 void wgpuComputePipelineRelease(WGPUComputePipeline pipeline) {
-	(void)pipeline;
+	WGVK_REC(wgpuComputePipelineRelease, WGVK_REC_ARG(pipeline));
 }
 WGPUPipelineLayout wgpuDeviceCreatePipelineLayout(WGPUDevice device, const WGPUPipelineLayoutDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUPipelineLayout)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreatePipelineLayout, WGVK_REC_ARG(device),
+	         descriptor->bindGroupLayoutCount);
+	return (WGPUPipelineLayout)wgvk_rec_handle();
 }
 void wgpuPipelineLayoutRelease(WGPUPipelineLayout layout) {
-	(void)layout;
+	WGVK_REC(wgpuPipelineLayoutRelease, WGVK_REC_ARG(layout));
 }
 WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice device, const WGPUBindGroupLayoutDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUBindGroupLayout)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateBindGroupLayout, WGVK_REC_ARG(device), descriptor->entryCount);
+	return (WGPUBindGroupLayout)wgvk_rec_handle();
 }
 void wgpuBindGroupLayoutRelease(WGPUBindGroupLayout layout) {
-	(void)layout;
+	WGVK_REC(wgpuBindGroupLayoutRelease, WGVK_REC_ARG(layout));
 }
+/* Entries of the last bind group created. */
+WGPUBindGroupEntry wgvk_stub_bind_group_entries[8];
+uint32_t wgvk_stub_bind_group_entry_count;
+
 WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice device, const WGPUBindGroupDescriptor *descriptor) {
-	(void)device;
-	(void)descriptor;
-	return (WGPUBindGroup)(uintptr_t)1;
+	wgvk_stub_bind_group_entry_count = (uint32_t)descriptor->entryCount;
+	for (uint32_t i = 0; i < descriptor->entryCount && i < 8; i++) {
+		wgvk_stub_bind_group_entries[i] = descriptor->entries[i];
+	}
+	WGVK_REC(wgpuDeviceCreateBindGroup, WGVK_REC_ARG(device), WGVK_REC_ARG(descriptor->layout),
+	         descriptor->entryCount);
+	return (WGPUBindGroup)wgvk_rec_handle();
 }
 void wgpuBindGroupRelease(WGPUBindGroup group) {
-	(void)group;
+	WGVK_REC(wgpuBindGroupRelease, WGVK_REC_ARG(group));
 }
 WGPUSampler wgpuDeviceCreateSampler(WGPUDevice device, const WGPUSamplerDescriptor *descriptor) {
-	(void)device;
 	(void)descriptor;
-	return (WGPUSampler)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateSampler, WGVK_REC_ARG(device));
+	return (WGPUSampler)wgvk_rec_handle();
 }
 void wgpuSamplerRelease(WGPUSampler sampler) {
-	(void)sampler;
+	WGVK_REC(wgpuSamplerRelease, WGVK_REC_ARG(sampler));
 }
 WGPUCommandEncoder wgpuDeviceCreateCommandEncoder(WGPUDevice device, const WGPUCommandEncoderDescriptor *descriptor) {
-	(void)device;
 	(void)descriptor;
-	return (WGPUCommandEncoder)(uintptr_t)1;
+	WGVK_REC(wgpuDeviceCreateCommandEncoder, WGVK_REC_ARG(device));
+	return (WGPUCommandEncoder)wgvk_rec_handle();
 }
 void wgpuCommandEncoderRelease(WGPUCommandEncoder encoder) {
-	(void)encoder;
+	WGVK_REC(wgpuCommandEncoderRelease, WGVK_REC_ARG(encoder));
 }
 WGPUCommandBuffer wgpuCommandEncoderFinish(WGPUCommandEncoder encoder, const WGPUCommandBufferDescriptor *descriptor) {
-	(void)encoder;
 	(void)descriptor;
-	return (WGPUCommandBuffer)(uintptr_t)1;
+	WGVK_REC(wgpuCommandEncoderFinish, WGVK_REC_ARG(encoder));
+	return (WGPUCommandBuffer)wgvk_rec_handle();
 }
 void wgpuCommandBufferRelease(WGPUCommandBuffer buffer) {
-	(void)buffer;
+	WGVK_REC(wgpuCommandBufferRelease, WGVK_REC_ARG(buffer));
 }
 void wgpuCommandEncoderCopyBufferToBuffer(WGPUCommandEncoder encoder, WGPUBuffer src,
                                           uint64_t srcOffset, WGPUBuffer dst, uint64_t dstOffset,
                                           uint64_t size) {
-	(void)encoder;
-	(void)src;
-	(void)srcOffset;
-	(void)dst;
-	(void)dstOffset;
-	(void)size;
-}
+	WGVK_REC(wgpuCommandEncoderCopyBufferToBuffer, WGVK_REC_ARG(encoder), WGVK_REC_ARG(src),
+	         srcOffset, WGVK_REC_ARG(dst), dstOffset, size);
+}
+/* Most recent buffer side of a texel copy and per-kind counts. */
+WGPUTexelCopyBufferLayout wgvk_stub_copy_layout;
+WGPUExtent3D wgvk_stub_copy_size;
+uint32_t wgvk_stub_buffer_to_texture_count;
+uint32_t wgvk_stub_texture_to_buffer_count;
+uint32_t wgvk_stub_texture_to_texture_count;
+uint32_t wgvk_stub_dispatch_count;
 void wgpuCommandEncoderCopyBufferToTexture(WGPUCommandEncoder encoder,
                                            const WGPUTexelCopyBufferInfo *src,
                                            const WGPUTexelCopyTextureInfo *dst,
                                            const WGPUExtent3D *size) {
-	(void)encoder;
-	(void)src;
-	(void)dst;
-	(void)size;
+	WGVK_REC(wgpuCommandEncoderCopyBufferToTexture, WGVK_REC_ARG(encoder),
+	         WGVK_REC_ARG(src->buffer), src->layout.offset, src->layout.bytesPerRow,
+	         src->layout.rowsPerImage, WGVK_REC_ARG(dst->texture), dst->mipLevel, dst->origin.x,
+	         dst->origin.y, dst->origin.z, size->width, size->height, size->depthOrArrayLayers);
+	wgvk_stub_copy_layout = src->layout;
+	wgvk_stub_copy_size = *size;
+	wgvk_stub_buffer_to_texture_count++;
 }
 void wgpuCommandEncoderCopyTextureToBuffer(WGPUCommandEncoder encoder,
                                            const WGPUTexelCopyTextureInfo *src,
                                            const WGPUTexelCopyBufferInfo *dst,
                                            const WGPUExtent3D *size) {
-	(void)encoder;
-	(void)src;
-	(void)dst;
-	(void)size;
-}
+	WGVK_REC(wgpuCommandEncoderCopyTextureToBuffer, WGVK_REC_ARG(encoder),
+	         WGVK_REC_ARG(src->texture), src->mipLevel, src->origin.x, src->origin.y, src->origin.z,
+	         WGVK_REC_ARG(dst->buffer), dst->layout.offset, dst->layout.bytesPerRow,
+	         dst->layout.rowsPerImage, size->width, size->height, size->depthOrArrayLayers);
+	wgvk_stub_copy_layout = dst->layout;
+	wgvk_stub_copy_size = *size;
+	wgvk_stub_texture_to_buffer_count++;
+}
+void wgpuCommandEncoderCopyTextureToTexture(WGPUCommandEncoder encoder,
+                                            const WGPUTexelCopyTextureInfo *src,
+                                            const WGPUTexelCopyTextureInfo *dst,
+                                            const WGPUExtent3D *size) {
+	WGVK_REC(wgpuCommandEncoderCopyTextureToTexture, WGVK_REC_ARG(encoder),
+	         WGVK_REC_ARG(src->texture), src->mipLevel, src->origin.x, src->origin.y, src->origin.z,
+	         WGVK_REC_ARG(dst->texture), dst->mipLevel, dst->origin.x, dst->origin.y, dst->origin.z,
+	         size->width, size->height, size->depthOrArrayLayers);
+	wgvk_stub_copy_size = *size;
+	wgvk_stub_texture_to_texture_count++;
+}
+/* Copy of the most recent render pass descriptor, for tests to inspect. */
+WGPURenderPassColorAttachment wgvk_stub_color_attachments[8];
+uint32_t wgvk_stub_color_attachment_count;
+WGPURenderPassDepthStencilAttachment wgvk_stub_depth_attachment;
+int wgvk_stub_has_depth_attachment;
+uint32_t wgvk_stub_render_pass_count;
+
 WGPURenderPassEncoder wgpuCommandEncoderBeginRenderPass(WGPUCommandEncoder encoder,
                                                         const WGPURenderPassDescriptor *descriptor) {
-	(void)encoder;
-	(void)descriptor;
-	return (WGPURenderPassEncoder)(uintptr_t)1;
+	WGVK_REC(wgpuCommandEncoderBeginRenderPass, WGVK_REC_ARG(encoder),
+	         descriptor->colorAttachmentCount,
+	         descriptor->colorAttachmentCount ? WGVK_REC_ARG(descriptor->colorAttachments[0].view) : 0,
+	         descriptor->depthStencilAttachment
+	             ? WGVK_REC_ARG(descriptor->depthStencilAttachment->view)
+	             : 0);
+	wgvk_stub_render_pass_count++;
+	wgvk_stub_color_attachment_count = (uint32_t)descriptor->colorAttachmentCount;
+	for (uint32_t i = 0; i < wgvk_stub_color_attachment_count && i < 8; i++) {
+		wgvk_stub_color_attachments[i] = descriptor->colorAttachments[i];
+	}
+	wgvk_stub_has_depth_attachment = descriptor->depthStencilAttachment != NULL;
+	if (descriptor->depthStencilAttachment) {
+		wgvk_stub_depth_attachment = *descriptor->depthStencilAttachment;
+	}
+	return (WGPURenderPassEncoder)wgvk_rec_handle();
 }
 void wgpuRenderPassEncoderEnd(WGPURenderPassEncoder encoder) {
-	(void)encoder;
+	WGVK_REC(wgpuRenderPassEncoderEnd, WGVK_REC_ARG(encoder));
 }
 void wgpuRenderPassEncoderRelease(WGPURenderPassEncoder encoder) {
-	(void)encoder;
+	WGVK_REC(wgpuRenderPassEncoderRelease, WGVK_REC_ARG(encoder));
 }
 void wgpuRenderPassEncoderSetPipeline(WGPURenderPassEncoder encoder, WGPURenderPipeline pipeline) {
-	(void)encoder;
-	(void)pipeline;
+	WGVK_REC(wgpuRenderPassEncoderSetPipeline, WGVK_REC_ARG(encoder), WGVK_REC_ARG(pipeline));
 }
 void wgpuRenderPassEncoderSetVertexBuffer(WGPURenderPassEncoder encoder, uint32_t slot,
                                           WGPUBuffer buffer, uint64_t offset, uint64_t size) {
-	(void)encoder;
-	(void)slot;
-	(void)buffer;
-	(void)offset;
-	(void)size;
+	WGVK_REC(wgpuRenderPassEncoderSetVertexBuffer, WGVK_REC_ARG(encoder), slot,
+	         WGVK_REC_ARG(buffer), offset, size);
 }
 void wgpuRenderPassEncoderSetIndexBuffer(WGPURenderPassEncoder encoder, WGPUBuffer buffer,
                                          WGPUIndexFormat format, uint64_t offset, uint64_t size) {
-	(void)encoder;
-	(void)buffer;
-	(void)format;
-	(void)offset;
-	(void)size;
+	WGVK_REC(wgpuRenderPassEncoderSetIndexBuffer, WGVK_REC_ARG(encoder), WGVK_REC_ARG(buffer),
+	         format, offset, size);
 }
 void wgpuRenderPassEncoderSetBindGroup(WGPURenderPassEncoder encoder, uint32_t groupIndex,
                                        WGPUBindGroup group, size_t dynamicOffsetCount,
                                        const uint32_t *dynamicOffsets) {
-	(void)encoder;
-	(void)groupIndex;
-	(void)group;
-	(void)dynamicOffsetCount;
-	(void)dynamicOffsets;
+	WGVK_REC(wgpuRenderPassEncoderSetBindGroup, WGVK_REC_ARG(encoder), groupIndex,
+	         WGVK_REC_ARG(group), dynamicOffsetCount,
+	         wgvk_rec_hash(dynamicOffsets, dynamicOffsetCount * sizeof(*dynamicOffsets)));
 }
+uint32_t wgvk_stub_draw_count;
+
 void wgpuRenderPassEncoderDraw(WGPURenderPassEncoder encoder, uint32_t vertexCount,
                                uint32_t instanceCount, uint32_t firstVertex,
                                uint32_t firstInstance) {
-	(void)encoder;
-	(void)vertexCount;
-	(void)instanceCount;
-	(void)firstVertex;
-	(void)firstInstance;
+	WGVK_REC(wgpuRenderPassEncoderDraw, WGVK_REC_ARG(encoder), vertexCount, instanceCount,
+	         firstVertex, firstInstance);
+	wgvk_stub_draw_count++;
 }
 void wgpuRenderPassEncoderDrawIndexed(WGPURenderPassEncoder encoder, uint32_t indexCount,
                                       uint32_t instanceCount, uint32_t firstIndex,
                                       int32_t baseVertex, uint32_t firstInstance) {
-	(void)encoder;
-	(void)indexCount;
-	(void)instanceCount;
-	(void)firstIndex;
-	(void)baseVertex;
-	(void)firstInstance;
+	WGVK_REC(wgpuRenderPassEncoderDrawIndexed, WGVK_REC_ARG(encoder), indexCount, instanceCount,
+	         firstIndex, (uint32_t)baseVertex, firstInstance);
 }
 void wgpuRenderPassEncoderDrawIndirect(WGPURenderPassEncoder encoder, WGPUBuffer buffer,
                                        uint64_t offset) {
-	(void)encoder;
-	(void)buffer;
-	(void)offset;
+	WGVK_REC(wgpuRenderPassEncoderDrawIndirect, WGVK_REC_ARG(encoder), WGVK_REC_ARG(buffer),
+	         offset);
 }
 void wgpuRenderPassEncoderDrawIndexedIndirect(WGPURenderPassEncoder encoder, WGPUBuffer buffer,
                                               uint64_t offset) {
-	(void)encoder;
-	(void)buffer;
-	(void)offset;
+	WGVK_REC(wgpuRenderPassEncoderDrawIndexedIndirect, WGVK_REC_ARG(encoder),
+	         WGVK_REC_ARG(buffer), offset);
 }
+float wgvk_stub_viewport[4];
+
 void wgpuRenderPassEncoderSetViewport(WGPURenderPassEncoder encoder, float x, float y, float width,
                                       float height, float minDepth, float maxDepth) {
-	(void)encoder;
-	(void)x;
-	(void)y;
-	(void)width;
-	(void)height;
-	(void)minDepth;
-	(void)maxDepth;
+	WGVK_REC(wgpuRenderPassEncoderSetViewport, WGVK_REC_ARG(encoder), wgvk_rec_float(x),
+	         wgvk_rec_float(y), wgvk_rec_float(width), wgvk_rec_float(height),
+	         wgvk_rec_float(minDepth), wgvk_rec_float(maxDepth));
+	wgvk_stub_viewport[0] = x;
+	wgvk_stub_viewport[1] = y;
+	wgvk_stub_viewport[2] = width;
+	wgvk_stub_viewport[3] = height;
 }
 void wgpuRenderPassEncoderSetScissorRect(WGPURenderPassEncoder encoder, uint32_t x, uint32_t y,
                                          uint32_t width, uint32_t height) {
-	(void)encoder;
-	(void)x;
-	(void)y;
-	(void)width;
-	(void)height;
+	WGVK_REC(wgpuRenderPassEncoderSetScissorRect, WGVK_REC_ARG(encoder), x, y, width, height);
 }
 void wgpuRenderPassEncoderSetBlendConstant(WGPURenderPassEncoder encoder, const WGPUColor *color) {
-	(void)encoder;
-	(void)color;
+	WGVK_REC(wgpuRenderPassEncoderSetBlendConstant, WGVK_REC_ARG(encoder),
+	         wgvk_rec_float((float)color->r), wgvk_rec_float((float)color->g),
+	         wgvk_rec_float((float)color->b), wgvk_rec_float((float)color->a));
 }
 void wgpuRenderPassEncoderSetStencilReference(WGPURenderPassEncoder encoder, uint32_t reference) {
-	(void)encoder;
-	(void)reference;
+	WGVK_REC(wgpuRenderPassEncoderSetStencilReference, WGVK_REC_ARG(encoder), reference);
 }
 WGPUComputePassEncoder wgpuCommandEncoderBeginComputePass(WGPUCommandEncoder encoder,
                                                           const void *descriptor) {
-	(void)encoder;
 	(void)descriptor;
-	return (WGPUComputePassEncoder)(uintptr_t)1;
+	WGVK_REC(wgpuCommandEncoderBeginComputePass, WGVK_REC_ARG(encoder));
+	return (WGPUComputePassEncoder)wgvk_rec_handle();
 }
 void wgpuComputePassEncoderEnd(WGPUComputePassEncoder encoder) {
-	(void)encoder;
+	WGVK_REC(wgpuComputePassEncoderEnd, WGVK_REC_ARG(encoder));
 }
 void wgpuComputePassEncoderRelease(WGPUComputePassEncoder encoder) {
-	(void)encoder;
+	WGVK_REC(wgpuComputePassEncoderRelease, WGVK_REC_ARG(encoder));
 }
 void wgpuComputePassEncoderSetPipeline(WGPUComputePassEncoder encoder,
                                        WGPUComputePipeline pipeline) {
-	(void)encoder;
-	(void)pipeline;
+	WGVK_REC(wgpuComputePassEncoderSetPipeline, WGVK_REC_ARG(encoder), WGVK_REC_ARG(pipeline));
 }
 void wgpuComputePassEncoderSetBindGroup(WGPUComputePassEncoder encoder, uint32_t groupIndex,
                                         WGPUBindGroup group, size_t dynamicOffsetCount,
                                         const uint32_t *dynamicOffsets) {
-	(void)encoder;
-	(void)groupIndex;
-	(void)group;
-	(void)dynamicOffsetCount;
-	(void)dynamicOffsets;
+	WGVK_REC(wgpuComputePassEncoderSetBindGroup, WGVK_REC_ARG(encoder), groupIndex,
+	         WGVK_REC_ARG(group), dynamicOffsetCount,
+	         wgvk_rec_hash(dynamicOffsets, dynamicOffsetCount * sizeof(*dynamicOffsets)));
 }
 void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder encoder, uint32_t x,
                                               uint32_t y, uint32_t z) {
-	(void)encoder;
-	(void)x;
-	(void)y;
-	(void)z;
+	WGVK_REC(wgpuComputePassEncoderDispatchWorkgroups, WGVK_REC_ARG(encoder), x, y, z);
+	wgvk_stub_dispatch_count++;
 }
 void wgpuComputePassEncoderDispatchWorkgroupsIndirect(WGPUComputePassEncoder encoder,
                                                       WGPUBuffer buffer, uint64_t offset) {
-	(void)encoder;
-	(void)buffer;
-	(void)offset;
+	WGVK_REC(wgpuComputePassEncoderDispatchWorkgroupsIndirect, WGVK_REC_ARG(encoder),
+	         WGVK_REC_ARG(buffer), offset);
 }